@@ -52,7 +52,7 @@ end
 local function applyOSAndArchDefines()
     filter "system:windows"
         defines { "PLATFORM_WINDOWS" }
-        removefiles { "src/**.c" }
+        removefiles { "src/**.c", "src/distributed/**.cpp", "src/metrics/metrics_server.cpp" }
         links { "ws2_32", "winmm" }
         removebuildoptions { "-Wno-deprecated-declarations", "-Wno-c++11-narrowing" }
         buildoptions { "/W3" }
@@ -62,7 +62,7 @@ local function applyOSAndArchDefines()
         defines { "PLATFORM_MACOS" }
 
     filter "system:linux"
-        links { "m", "dl", "pthread" }
+        links { "m", "dl", "pthread", "rt" }
         defines { "PLATFORM_LINUX" }
 
     filter "architecture:x64"
@@ -176,6 +176,7 @@ project "extlib_raylib"
 
 project "particles"
     projectBase()
+    removefiles { "src/capi/**" }
 
     addFmt()
     addTinydir()
@@ -197,12 +198,212 @@ project "particles"
         buildoptions { "-O3", "-ffast-math", "-fno-math-errno", "-fno-trapping-math" }
         applyOutDir("release")
 
+project "particles_headless"
+    applyBaseConfig()
+
+    -- CPU-only frame exporter: raylib headers for shared types, no raylib/ImGui link
+    files {
+        "tools/headless/main.cpp",
+        "src/simulation/simulation.cpp",
+        "src/simulation/stepper.cpp",
+        "src/simulation/analytics.cpp",
+        "src/simulation/clusters.cpp",
+        "src/simulation/force_table.cpp",
+        "src/simulation/world.cpp",
+        "src/simulation/multicore.cpp",
+        "src/mailbox/render/drawbuffer.cpp",
+        "src/render/software_renderer.cpp",
+        "src/save_manager.cpp",
+        "src/distributed/channel.cpp",
+        "src/distributed/slab_worker.cpp",
+        "src/distributed/slab_coordinator.cpp",
+        "src/distributed/frame_ring.cpp",
+        "src/distributed/frame_export.cpp",
+        "src/metrics/prometheus.cpp",
+        "src/metrics/metrics_server.cpp",
+    }
+
+    includedirs {
+        "src",
+        "extlib/raylib/src",
+        "extlib/nlohmann-json/single_include"
+    }
+
+    applyOSAndArchDefines()
+
+    filter "configurations:Debug"
+        defines { "DEBUG" }
+        symbols "On"
+        optimize "Off"
+        buildoptions { "-O1", "-fsanitize=address,undefined", "-fno-omit-frame-pointer"}
+        linkoptions { "-fsanitize=address,undefined" }
+        applyOutDir("debug")
+
+    filter "configurations:Release"
+        defines { "NDEBUG" }
+        optimize "On"
+        buildoptions { "-O3", "-ffast-math", "-fno-math-errno", "-fno-trapping-math" }
+        applyOutDir("release")
+
+    filter {}
+
+-- shm_open/mmap reader; the ring is POSIX-only like src/distributed
+if not os.istarget("windows") then
+    project "particles_frame_reader"
+        applyBaseConfig()
+
+        -- Example viewer-side process: maps a headless run's frame ring read-only
+        files {
+            "tools/frame_reader/main.cpp",
+            "src/distributed/frame_ring.cpp",
+        }
+
+        includedirs {
+            "src"
+        }
+
+        applyOSAndArchDefines()
+
+        filter "configurations:Debug"
+            defines { "DEBUG" }
+            symbols "On"
+            optimize "Off"
+            buildoptions { "-O1", "-fsanitize=address,undefined", "-fno-omit-frame-pointer"}
+            linkoptions { "-fsanitize=address,undefined" }
+            applyOutDir("debug")
+
+        filter "configurations:Release"
+            defines { "NDEBUG" }
+            optimize "On"
+            buildoptions { "-O3" }
+            applyOutDir("release")
+
+        filter {}
+end
+
+-- libparticles: the simulation behind the C API in src/capi/particles.h,
+-- without raylib windowing or ImGui (raylib headers only, for shared types)
+local function libparticles(name, libKind)
+    project(name)
+        kind(libKind)
+        language "C++"
+        targetname(libKind == "SharedLib" and "particles" or "particles_static")
+        pic "On"
+
+        buildoptions {
+            "-std=c++20",
+            "-Wno-deprecated-declarations",
+            "-Wno-c++11-narrowing",
+        }
+
+        files {
+            "src/capi/particles.h",
+            "src/capi/particles.cpp",
+            "src/simulation/simulation.cpp",
+            "src/simulation/stepper.cpp",
+            "src/simulation/analytics.cpp",
+            "src/simulation/clusters.cpp",
+            "src/simulation/force_table.cpp",
+            "src/simulation/world.cpp",
+            "src/simulation/multicore.cpp",
+            "src/mailbox/render/drawbuffer.cpp",
+        }
+
+        includedirs {
+            "src",
+            "extlib/raylib/src"
+        }
+
+        applyOSAndArchDefines()
+
+        -- Only the PARTICLES_API functions are exported from the shared library
+        filter { "kind:SharedLib" }
+            defines { "PARTICLES_BUILD_SHARED" }
+        filter { "kind:SharedLib", "system:not windows" }
+            buildoptions { "-fvisibility=hidden" }
+
+        filter "configurations:Debug"
+            defines { "DEBUG" }
+            symbols "On"
+            optimize "Off"
+            applyOutDir("debug")
+
+        filter "configurations:Release"
+            defines { "NDEBUG" }
+            optimize "On"
+            buildoptions { "-O3", "-ffast-math", "-fno-math-errno", "-fno-trapping-math" }
+            applyOutDir("release")
+
+        filter {}
+end
+
+libparticles("libparticles", "SharedLib")
+libparticles("libparticles_static", "StaticLib")
+
+project "particles_rule_search"
+    applyBaseConfig()
+
+    -- CPU-only evolutionary rule search; writes projects for the main app
+    files {
+        "tools/rule_search/main.cpp",
+        "src/search/rule_search.cpp",
+        "src/simulation/ensemble.cpp",
+        "src/simulation/fitness.cpp",
+        "src/simulation/stepper.cpp",
+        "src/simulation/analytics.cpp",
+        "src/simulation/clusters.cpp",
+        "src/simulation/force_table.cpp",
+        "src/simulation/world.cpp",
+        "src/simulation/multicore.cpp",
+        "src/save_manager.cpp",
+    }
+
+    includedirs {
+        "src",
+        "extlib/raylib/src",
+        "extlib/nlohmann-json/single_include"
+    }
+
+    applyOSAndArchDefines()
+
+    filter "configurations:Debug"
+        defines { "DEBUG" }
+        symbols "On"
+        optimize "Off"
+        buildoptions { "-O1", "-fsanitize=address,undefined", "-fno-omit-frame-pointer"}
+        linkoptions { "-fsanitize=address,undefined" }
+        applyOutDir("debug")
+
+    filter "configurations:Release"
+        defines { "NDEBUG" }
+        optimize "On"
+        buildoptions { "-O3", "-ffast-math", "-fno-math-errno", "-fno-trapping-math" }
+        applyOutDir("release")
+
+    filter {}
+
 unitTest("test_uniformgrid")
+unitTest("test_counter_rng")
+unitTest("test_latency_histogram")
+unitTest("test_aligned_allocator", { "extlib/raylib/src" }, { "src/simulation/world.cpp" })
+unitTest("test_sparsegrid", { "extlib/raylib/src" }, { "src/simulation/world.cpp" })
+unitTest("test_force_table", { "extlib/raylib/src" }, { "src/simulation/force_table.cpp", "src/simulation/stepper.cpp", "src/simulation/analytics.cpp", "src/simulation/clusters.cpp", "src/simulation/world.cpp", "src/simulation/multicore.cpp" })
+unitTest("test_clusters", { "extlib/raylib/src" }, { "src/simulation/clusters.cpp", "src/simulation/stepper.cpp", "src/simulation/analytics.cpp", "src/simulation/force_table.cpp", "src/simulation/world.cpp", "src/simulation/multicore.cpp" })
+unitTest("test_ensemble", { "extlib/raylib/src" }, { "src/simulation/ensemble.cpp", "src/simulation/stepper.cpp", "src/simulation/analytics.cpp", "src/simulation/clusters.cpp", "src/simulation/force_table.cpp", "src/simulation/world.cpp", "src/simulation/multicore.cpp" })
+unitTest("test_rule_search", { "extlib/raylib/src" }, { "src/search/rule_search.cpp", "src/simulation/fitness.cpp", "src/simulation/ensemble.cpp", "src/simulation/stepper.cpp", "src/simulation/analytics.cpp", "src/simulation/clusters.cpp", "src/simulation/force_table.cpp", "src/simulation/world.cpp", "src/simulation/multicore.cpp" })
+unitTest("test_distributed", { "extlib/raylib/src" }, { "src/distributed/channel.cpp", "src/distributed/frame_ring.cpp", "src/distributed/frame_export.cpp", "src/distributed/slab_worker.cpp", "src/distributed/slab_coordinator.cpp", "src/simulation/stepper.cpp", "src/simulation/analytics.cpp", "src/simulation/clusters.cpp", "src/simulation/force_table.cpp", "src/simulation/world.cpp", "src/simulation/multicore.cpp" })
 unitTest("test_world", { "extlib/raylib/src" }, { "src/simulation/world.cpp" })
 unitTest("test_multicore", { "extlib/raylib/src" }, { "src/simulation/multicore.cpp" })
 unitTest("test_mailboxes", { "extlib/raylib/src" }, { "src/mailbox/render/drawbuffer.cpp" })
 unitTest("test_save_manager", { "extlib/raylib/src", "extlib/nlohmann-json/single_include" }, { "src/save_manager.cpp", "src/simulation/world.cpp" })
-unitTest("test_simulation", { "extlib/raylib/src" }, { "src/simulation/simulation.cpp", "src/simulation/world.cpp", "src/simulation/multicore.cpp", "src/mailbox/render/drawbuffer.cpp" })
+unitTest("test_simulation", { "extlib/raylib/src" }, { "src/simulation/simulation.cpp", "src/simulation/ensemble.cpp", "src/simulation/stepper.cpp", "src/simulation/analytics.cpp", "src/simulation/clusters.cpp", "src/simulation/force_table.cpp", "src/simulation/world.cpp", "src/simulation/multicore.cpp", "src/mailbox/render/drawbuffer.cpp" })
 unitTest("test_undo_manager", { "extlib/imgui", "extlib/rlimgui", "extlib/raylib/src" }, { "src/undo/undo_manager.cpp", "src/undo/add_group_action.cpp", "src/undo/remove_group_action.cpp", "src/undo/resize_group_action.cpp", "src/undo/clear_all_groups_action.cpp" })
 unitTest("test_file_dialog", { "extlib/imgui", "extlib/rlimgui", "extlib/raylib/src", "extlib/tinydir", "extlib/nlohmann-json/single_include" }, { "src/render/ui/file_dialog.cpp", "src/save_manager.cpp", "extlib/imgui/imgui.cpp", "extlib/imgui/imgui_draw.cpp", "extlib/imgui/imgui_widgets.cpp", "extlib/imgui/imgui_tables.cpp", "extlib/imgui/misc/cpp/imgui_stdlib.cpp" })
-unitTest("test_version_tracking", { "extlib/imgui", "extlib/rlimgui", "extlib/raylib/src", "extlib/nlohmann-json/single_include", "extlib/tinydir" }, { "src/undo/undo_manager.cpp", "src/save_manager.cpp", "src/undo/add_group_action.cpp", "src/render/ui/menu_bar_ui.cpp", "src/render/ui/file_dialog.cpp", "src/simulation/simulation.cpp", "src/simulation/world.cpp", "src/simulation/multicore.cpp", "src/mailbox/render/drawbuffer.cpp", "extlib/imgui/imgui.cpp", "extlib/imgui/imgui_draw.cpp", "extlib/imgui/imgui_widgets.cpp", "extlib/imgui/imgui_tables.cpp", "extlib/imgui/misc/cpp/imgui_stdlib.cpp" })
+unitTest("test_version_tracking", { "extlib/imgui", "extlib/rlimgui", "extlib/raylib/src", "extlib/nlohmann-json/single_include", "extlib/tinydir" }, { "src/undo/undo_manager.cpp", "src/save_manager.cpp", "src/undo/add_group_action.cpp", "src/render/ui/menu_bar_ui.cpp", "src/render/ui/file_dialog.cpp", "src/simulation/simulation.cpp", "src/simulation/stepper.cpp", "src/simulation/analytics.cpp", "src/simulation/clusters.cpp", "src/simulation/force_table.cpp", "src/simulation/world.cpp", "src/simulation/multicore.cpp", "src/mailbox/render/drawbuffer.cpp", "extlib/imgui/imgui.cpp", "extlib/imgui/imgui_draw.cpp", "extlib/imgui/imgui_widgets.cpp", "extlib/imgui/imgui_tables.cpp", "extlib/imgui/misc/cpp/imgui_stdlib.cpp" })
+unitTest("test_software_renderer", { "extlib/raylib/src" }, { "src/render/software_renderer.cpp", "src/simulation/multicore.cpp" })
+unitTest("test_particle_batch", { "extlib/raylib/src" }, { "src/render/particle_batch.cpp" })
+unitTest("test_density_splat", { "extlib/raylib/src" }, { "src/render/density_splat.cpp", "src/render/particle_batch.cpp" })
+unitTest("test_region_index", { "extlib/raylib/src" }, { "src/render/region_index.cpp" })
+unitTest("test_position_decoder", { "extlib/raylib/src" }, { "src/render/position_decoder.cpp" })
+unitTest("test_capi", { "extlib/raylib/src" }, { "src/capi/particles.cpp", "src/simulation/simulation.cpp", "src/simulation/stepper.cpp", "src/simulation/analytics.cpp", "src/simulation/clusters.cpp", "src/simulation/force_table.cpp", "src/simulation/world.cpp", "src/simulation/multicore.cpp", "src/mailbox/render/drawbuffer.cpp" })
+unitTest("test_metrics", { "extlib/raylib/src" }, { "src/metrics/prometheus.cpp", "src/metrics/metrics_server.cpp" })
@@ -0,0 +1,299 @@
+#include "particles.h"
+
+#include <memory>
+#include <string>
+
+#include "../simulation/simulation.hpp"
+#include "../utility/exceptions.hpp"
+
+struct particles_sim {
+    std::unique_ptr<Simulation> sim;
+};
+
+namespace {
+
+thread_local std::string last_error;
+
+particles_status fail(particles_status status, const std::string &message) {
+    last_error = message;
+    return status;
+}
+
+/**
+ * @brief Runs an API call, turning exceptions into a status
+ * @param sim Handle the call needs (checked for null)
+ * @param call Callable returning a particles_status
+ * @return The call's status, or the error the exception maps to
+ */
+template <typename Handle, typename Call>
+particles_status guarded(Handle *sim, Call &&call) noexcept {
+    if (!sim) {
+        return fail(PARTICLES_ERROR_ARGUMENT, "Null simulation handle");
+    }
+    try {
+        return call(*sim->sim);
+    } catch (const particles::ConfigError &e) {
+        return fail(PARTICLES_ERROR_ARGUMENT, e.what());
+    } catch (const std::exception &e) {
+        return fail(PARTICLES_ERROR_INTERNAL, e.what());
+    }
+}
+
+mailbox::SimulationConfigSnapshot to_snapshot(const particles_config &cfg) {
+    mailbox::SimulationConfigSnapshot out = {};
+    out.bounds_width = cfg.bounds_width;
+    out.bounds_height = cfg.bounds_height;
+    out.time_scale = cfg.time_scale;
+    out.viscosity = cfg.viscosity;
+    out.wall_repel = cfg.wall_repel;
+    out.wall_strength = cfg.wall_strength;
+    out.gravity_x = cfg.gravity_x;
+    out.gravity_y = cfg.gravity_y;
+    out.target_tps = cfg.target_tps;
+    out.sim_threads = cfg.sim_threads;
+    // Only full-precision positions are handed out, and nothing draws cells
+    out.draw_report = {};
+    out.draw_report.velocities = cfg.publish_velocities != 0;
+    return out;
+}
+
+Color to_color(const particles_group &group) {
+    return Color{group.r, group.g, group.b, group.a};
+}
+
+} // namespace
+
+extern "C" {
+
+particles_config particles_default_config(float bounds_width,
+                                          float bounds_height) {
+    particles_config cfg = {};
+    cfg.bounds_width = bounds_width;
+    cfg.bounds_height = bounds_height;
+    cfg.time_scale = 1.0f;
+    cfg.viscosity = 0.271f;
+    cfg.wall_repel = 86.0f;
+    cfg.wall_strength = 0.129f;
+    cfg.target_tps = 0;
+    cfg.sim_threads = -1;
+    return cfg;
+}
+
+const char *particles_last_error(void) { return last_error.c_str(); }
+
+particles_status particles_create(const particles_config *cfg,
+                                  particles_sim **out) {
+    if (!cfg || !out) {
+        return fail(PARTICLES_ERROR_ARGUMENT, "Null config or output");
+    }
+    *out = nullptr;
+    try {
+        auto handle = std::make_unique<particles_sim>();
+        handle->sim = std::make_unique<Simulation>(to_snapshot(*cfg));
+        *out = handle.release();
+        return PARTICLES_OK;
+    } catch (const particles::ConfigError &e) {
+        return fail(PARTICLES_ERROR_ARGUMENT, e.what());
+    } catch (const std::exception &e) {
+        return fail(PARTICLES_ERROR_INTERNAL, e.what());
+    }
+}
+
+void particles_destroy(particles_sim *sim) {
+    try {
+        delete sim;
+    } catch (...) {
+        // Nothing can be reported from here; the handle is gone either way
+    }
+}
+
+particles_status particles_start(particles_sim *sim) {
+    return guarded(sim, [](Simulation &s) {
+        if (s.has_started()) {
+            return fail(PARTICLES_ERROR_STATE, "Simulation already started");
+        }
+        s.begin();
+        return PARTICLES_OK;
+    });
+}
+
+particles_status particles_pause(particles_sim *sim) {
+    return guarded(sim, [](Simulation &s) {
+        s.pause();
+        return PARTICLES_OK;
+    });
+}
+
+particles_status particles_resume(particles_sim *sim) {
+    return guarded(sim, [](Simulation &s) {
+        s.resume();
+        return PARTICLES_OK;
+    });
+}
+
+particles_status particles_step(particles_sim *sim) {
+    return guarded(sim, [](Simulation &s) {
+        s.push_command(mailbox::command::OneStep{});
+        return PARTICLES_OK;
+    });
+}
+
+particles_status particles_set_config(particles_sim *sim,
+                                      const particles_config *cfg) {
+    if (!cfg) {
+        return fail(PARTICLES_ERROR_ARGUMENT, "Null config");
+    }
+    return guarded(sim, [&](Simulation &s) {
+        auto snapshot = to_snapshot(*cfg);
+        s.update_config(snapshot);
+        return PARTICLES_OK;
+    });
+}
+
+particles_status particles_seed(particles_sim *sim,
+                                const particles_group *groups,
+                                int group_count, const float *rules,
+                                uint64_t rng_seed) {
+    if (group_count < 0 || (group_count > 0 && !groups)) {
+        return fail(PARTICLES_ERROR_ARGUMENT, "Invalid groups");
+    }
+    return guarded(sim, [&](Simulation &s) {
+        mailbox::command::SeedSpec seed;
+        for (int g = 0; g < group_count; ++g) {
+            const particles_group &group = groups[g];
+            if (group.size < 0) {
+                return fail(PARTICLES_ERROR_ARGUMENT,
+                            "Negative size for group " + std::to_string(g));
+            }
+            seed.add_group(group.size, to_color(group),
+                           group.radius * group.radius, group.enabled != 0);
+        }
+        if (rules) {
+            seed.rules.assign(rules, rules + group_count * group_count);
+        }
+        seed.rng_seed = rng_seed;
+        s.push_command(mailbox::command::SeedWorld{seed});
+        return PARTICLES_OK;
+    });
+}
+
+particles_status particles_set_rules(particles_sim *sim, int group_count,
+                                     const float *rules, const float *radii) {
+    if (group_count < 0 || !rules) {
+        return fail(PARTICLES_ERROR_ARGUMENT, "Invalid rules");
+    }
+    return guarded(sim, [&](Simulation &s) {
+        mailbox::command::RulePatch patch;
+        patch.groups = group_count;
+        patch.rules.assign(rules, rules + group_count * group_count);
+        if (radii) {
+            patch.r2.resize((size_t)group_count);
+            for (int g = 0; g < group_count; ++g) {
+                patch.r2[(size_t)g] = radii[g] * radii[g];
+            }
+        }
+        s.push_command(mailbox::command::ApplyRules{patch});
+        return PARTICLES_OK;
+    });
+}
+
+particles_status particles_add_group(particles_sim *sim,
+                                     const particles_group *group) {
+    if (!group || group->size < 0) {
+        return fail(PARTICLES_ERROR_ARGUMENT, "Invalid group");
+    }
+    return guarded(sim, [&](Simulation &s) {
+        s.push_command(mailbox::command::AddGroup{
+            group->size, to_color(*group), group->radius * group->radius});
+        return PARTICLES_OK;
+    });
+}
+
+particles_status particles_remove_group(particles_sim *sim, int group_index) {
+    if (group_index < 0) {
+        return fail(PARTICLES_ERROR_ARGUMENT, "Invalid group index");
+    }
+    return guarded(sim, [&](Simulation &s) {
+        s.push_command(mailbox::command::RemoveGroup{group_index});
+        return PARTICLES_OK;
+    });
+}
+
+particles_status particles_resize_group(particles_sim *sim, int group_index,
+                                        int size) {
+    if (group_index < 0 || size < 0) {
+        return fail(PARTICLES_ERROR_ARGUMENT, "Invalid group index or size");
+    }
+    return guarded(sim, [&](Simulation &s) {
+        s.push_command(mailbox::command::ResizeGroup{group_index, size});
+        return PARTICLES_OK;
+    });
+}
+
+particles_status particles_reset(particles_sim *sim) {
+    return guarded(sim, [](Simulation &s) {
+        s.reset();
+        return PARTICLES_OK;
+    });
+}
+
+particles_status particles_get_stats(const particles_sim *sim,
+                                     particles_stats *out) {
+    if (!out) {
+        return fail(PARTICLES_ERROR_ARGUMENT, "Null output");
+    }
+    return guarded(sim, [&](const Simulation &s) {
+        const mailbox::SimulationStatsSnapshot st = s.get_stats();
+        out->effective_tps = st.effective_tps;
+        out->particles = st.particles;
+        out->groups = st.groups;
+        out->sim_threads = st.sim_threads;
+        out->last_step_ns = st.last_step_ns;
+        out->published_ns = st.published_ns;
+        out->num_steps = st.num_steps;
+        out->step_p50_ns = st.step_latency.p50_ns;
+        out->step_p95_ns = st.step_latency.p95_ns;
+        out->step_p99_ns = st.step_latency.p99_ns;
+        out->step_max_ns = st.step_latency.max_ns;
+        return PARTICLES_OK;
+    });
+}
+
+particles_status particles_begin_read(particles_sim *sim,
+                                      particles_frame *out) {
+    if (!out) {
+        return fail(PARTICLES_ERROR_ARGUMENT, "Null output");
+    }
+    return guarded(sim, [&](Simulation &s) {
+        // Pins the frame's slots; the simulation writes around them
+        const mailbox::render::ReadView view = s.begin_read_draw();
+        out->count = (int)(view.curr->size() / 2);
+        out->positions = out->count > 0 ? view.curr->data() : nullptr;
+        out->velocities = view.curr_vel->size() == view.curr->size() &&
+                                  out->count > 0
+                              ? view.curr_vel->data()
+                              : nullptr;
+        out->stamp_ns = view.t1;
+        out->pinned[0] = view.prev_slot;
+        out->pinned[1] = view.curr_slot;
+        return PARTICLES_OK;
+    });
+}
+
+particles_status particles_end_read(particles_sim *sim,
+                                    particles_frame *frame) {
+    if (!frame || frame->pinned[0] < 0 || frame->pinned[1] < 0) {
+        return fail(PARTICLES_ERROR_ARGUMENT, "Frame is not being read");
+    }
+    return guarded(sim, [&](Simulation &s) {
+        mailbox::render::ReadView view;
+        view.prev_slot = frame->pinned[0];
+        view.curr_slot = frame->pinned[1];
+        s.end_read_draw(view);
+        *frame = particles_frame{};
+        frame->pinned[0] = frame->pinned[1] = -1;
+        return PARTICLES_OK;
+    });
+}
+
+} // extern "C"
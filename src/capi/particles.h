@@ -0,0 +1,163 @@
+#ifndef PARTICLES_CAPI_H
+#define PARTICLES_CAPI_H
+
+/*
+ * C interface of libparticles: runs a particle simulation on its own thread
+ * without a window, UI or GPU.
+ *
+ * Every function returns PARTICLES_OK or an error status; the message of the
+ * latest error on the calling thread is available from particles_last_error.
+ * Commands are queued and applied by the simulation thread before its next
+ * step, so they return immediately.
+ */
+
+#include <stdint.h>
+
+#if defined(_WIN32) && defined(PARTICLES_BUILD_SHARED)
+#define PARTICLES_API __declspec(dllexport)
+#elif defined(_WIN32) && defined(PARTICLES_SHARED)
+#define PARTICLES_API __declspec(dllimport)
+#elif defined(__GNUC__)
+#define PARTICLES_API __attribute__((visibility("default")))
+#else
+#define PARTICLES_API
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum particles_status {
+    PARTICLES_OK = 0,
+    PARTICLES_ERROR_ARGUMENT = 1, /* Null handle, bad size or index */
+    PARTICLES_ERROR_STATE = 2,    /* Not allowed in the current state */
+    PARTICLES_ERROR_INTERNAL = 3  /* The simulation raised an error */
+} particles_status;
+
+/* Opaque simulation handle */
+typedef struct particles_sim particles_sim;
+
+/* Simulation parameters; start from particles_default_config */
+typedef struct particles_config {
+    float bounds_width;
+    float bounds_height;
+    float time_scale;
+    float viscosity;
+    float wall_repel;
+    float wall_strength;
+    float gravity_x;
+    float gravity_y;
+    int target_tps;          /* Steps per second (0 = unlimited) */
+    int sim_threads;         /* Worker threads (-1 = all cores) */
+    int publish_velocities;  /* Non-zero to fill particles_frame.velocities */
+} particles_config;
+
+/* One particle group */
+typedef struct particles_group {
+    int size;
+    uint8_t r, g, b, a;
+    float radius; /* Interaction radius */
+    int enabled;  /* Zero freezes the group */
+} particles_group;
+
+/* Latest statistics published by the simulation thread */
+typedef struct particles_stats {
+    int effective_tps;
+    int particles;
+    int groups;
+    int sim_threads;
+    long long last_step_ns;
+    long long published_ns;
+    long long num_steps;
+    long long step_p50_ns;
+    long long step_p95_ns;
+    long long step_p99_ns;
+    long long step_max_ns;
+} particles_stats;
+
+/*
+ * Borrowed view of the latest published frame. The arrays belong to the
+ * simulation and stay valid and unchanged until particles_end_read; the
+ * simulation never waits for a reader.
+ */
+typedef struct particles_frame {
+    const float *positions;  /* count (x, y) pairs */
+    const float *velocities; /* count (vx, vy) pairs, or NULL */
+    int count;
+    long long stamp_ns;
+    int pinned[2]; /* Internal; keep unchanged for particles_end_read */
+} particles_frame;
+
+/* Returns a config with the app's defaults for the given bounds */
+PARTICLES_API particles_config particles_default_config(float bounds_width,
+                                                        float bounds_height);
+
+/* Message of the latest error on this thread ("" if none) */
+PARTICLES_API const char *particles_last_error(void);
+
+/* Creates a simulation; it is idle until particles_start */
+PARTICLES_API particles_status particles_create(const particles_config *cfg,
+                                                particles_sim **out);
+
+/* Stops the simulation thread and frees the handle (NULL is ignored) */
+PARTICLES_API void particles_destroy(particles_sim *sim);
+
+/* Starts the simulation thread, running */
+PARTICLES_API particles_status particles_start(particles_sim *sim);
+
+PARTICLES_API particles_status particles_pause(particles_sim *sim);
+PARTICLES_API particles_status particles_resume(particles_sim *sim);
+
+/* Takes one step while paused */
+PARTICLES_API particles_status particles_step(particles_sim *sim);
+
+/* Replaces the simulation parameters (bounds, time scale, threads, ...) */
+PARTICLES_API particles_status
+particles_set_config(particles_sim *sim, const particles_config *cfg);
+
+/*
+ * Replaces the world with new groups at random positions.
+ * rules: group_count * group_count row-major (rules[i * G + j] is the pull
+ * of group j on group i), or NULL for all zero.
+ * rng_seed: the same seed places the particles the same way.
+ */
+PARTICLES_API particles_status particles_seed(particles_sim *sim,
+                                              const particles_group *groups,
+                                              int group_count,
+                                              const float *rules,
+                                              uint64_t rng_seed);
+
+/*
+ * Changes the rules (and radii, if not NULL) of the current groups without
+ * moving particles. If group_count does not match the world's group count
+ * when the command is applied, the groups are placed anew instead.
+ */
+PARTICLES_API particles_status particles_set_rules(particles_sim *sim,
+                                                   int group_count,
+                                                   const float *rules,
+                                                   const float *radii);
+
+PARTICLES_API particles_status
+particles_add_group(particles_sim *sim, const particles_group *group);
+PARTICLES_API particles_status particles_remove_group(particles_sim *sim,
+                                                      int group_index);
+PARTICLES_API particles_status
+particles_resize_group(particles_sim *sim, int group_index, int size);
+
+/* Restores the world the first particles_seed created */
+PARTICLES_API particles_status particles_reset(particles_sim *sim);
+
+PARTICLES_API particles_status particles_get_stats(const particles_sim *sim,
+                                                   particles_stats *out);
+
+/* Borrows the latest frame; pair every success with particles_end_read */
+PARTICLES_API particles_status particles_begin_read(particles_sim *sim,
+                                                    particles_frame *out);
+PARTICLES_API particles_status particles_end_read(particles_sim *sim,
+                                                  particles_frame *frame);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PARTICLES_CAPI_H */
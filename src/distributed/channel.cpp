@@ -0,0 +1,250 @@
+#include "channel.hpp"
+
+#include <cerrno>
+#include <cstring>
+#include <string>
+
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "../utility/exceptions.hpp"
+
+namespace distributed {
+
+namespace {
+
+#ifdef MSG_NOSIGNAL
+constexpr int SEND_FLAGS = MSG_NOSIGNAL;
+#else
+constexpr int SEND_FLAGS = 0;
+#endif
+
+std::string errno_message(const char *what) {
+    return std::string(what) + ": " + std::strerror(errno);
+}
+
+void write_all(int fd, const void *data, size_t size) {
+    const char *bytes = (const char *)data;
+    while (size > 0) {
+        const ssize_t written = ::send(fd, bytes, size, SEND_FLAGS);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            throw particles::IOError(errno_message("Slab channel send"));
+        }
+        bytes += written;
+        size -= (size_t)written;
+    }
+}
+
+void read_all(int fd, void *data, size_t size) {
+    char *bytes = (char *)data;
+    while (size > 0) {
+        const ssize_t got = ::recv(fd, bytes, size, 0);
+        if (got < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            throw particles::IOError(errno_message("Slab channel receive"));
+        }
+        if (got == 0) {
+            throw particles::IOError("Slab channel closed by peer");
+        }
+        bytes += got;
+        size -= (size_t)got;
+    }
+}
+
+void check_tag(const MessageHeader &header, MessageTag tag) {
+    if (header.tag != (uint32_t)tag) {
+        throw particles::SimulationError(
+            "Unexpected slab message " + std::to_string(header.tag) +
+            " (expected " + std::to_string((uint32_t)tag) + ")");
+    }
+}
+
+/**
+ * @brief Progress of one Exchange inside exchange()
+ */
+struct TransferState {
+    std::vector<char> out;
+    size_t out_done = 0;
+    MessageHeader header{};
+    size_t header_done = 0;
+    size_t payload_done = 0;
+    bool received = false;
+};
+
+} // namespace
+
+Channel::~Channel() { close(); }
+
+Channel::Channel(Channel &&other) noexcept : m_fd(other.m_fd) {
+    other.m_fd = -1;
+}
+
+Channel &Channel::operator=(Channel &&other) noexcept {
+    if (this != &other) {
+        close();
+        m_fd = other.m_fd;
+        other.m_fd = -1;
+    }
+    return *this;
+}
+
+std::pair<Channel, Channel> Channel::pair() {
+    int fds[2];
+    if (::socketpair(AF_UNIX, SOCK_STREAM, 0, fds) != 0) {
+        throw particles::IOError(errno_message("socketpair"));
+    }
+#ifdef SO_NOSIGPIPE
+    const int on = 1;
+    ::setsockopt(fds[0], SOL_SOCKET, SO_NOSIGPIPE, &on, sizeof(on));
+    ::setsockopt(fds[1], SOL_SOCKET, SO_NOSIGPIPE, &on, sizeof(on));
+#endif
+    return {Channel(fds[0]), Channel(fds[1])};
+}
+
+void Channel::close() noexcept {
+    if (m_fd >= 0) {
+        ::close(m_fd);
+        m_fd = -1;
+    }
+}
+
+void Channel::send(MessageTag tag, uint32_t value,
+                   const std::vector<ParticleRecord> &records) {
+    const MessageHeader header{(uint32_t)tag, value, (uint32_t)records.size()};
+    write_all(m_fd, &header, sizeof(header));
+    if (!records.empty()) {
+        write_all(m_fd, records.data(),
+                  records.size() * sizeof(ParticleRecord));
+    }
+}
+
+MessageHeader Channel::receive(std::vector<ParticleRecord> &records) {
+    MessageHeader header;
+    read_all(m_fd, &header, sizeof(header));
+    records.resize(header.count);
+    if (header.count > 0) {
+        read_all(m_fd, records.data(), records.size() * sizeof(ParticleRecord));
+    }
+    return header;
+}
+
+MessageHeader Channel::expect(MessageTag tag,
+                              std::vector<ParticleRecord> &records) {
+    const MessageHeader header = receive(records);
+    check_tag(header, tag);
+    return header;
+}
+
+void exchange(std::vector<Exchange> &exchanges) {
+    const size_t n = exchanges.size();
+    std::vector<TransferState> states(n);
+    for (size_t k = 0; k < n; ++k) {
+        const auto &records = *exchanges[k].outgoing;
+        const MessageHeader header{(uint32_t)exchanges[k].tag, 0,
+                                   (uint32_t)records.size()};
+        const size_t payload = records.size() * sizeof(ParticleRecord);
+        auto &out = states[k].out;
+        out.resize(sizeof(header) + payload);
+        std::memcpy(out.data(), &header, sizeof(header));
+        if (payload > 0) {
+            std::memcpy(out.data() + sizeof(header), records.data(), payload);
+        }
+    }
+
+    std::vector<pollfd> fds(n);
+    for (;;) {
+        bool pending = false;
+        for (size_t k = 0; k < n; ++k) {
+            const TransferState &state = states[k];
+            fds[k].fd = exchanges[k].channel->fd();
+            fds[k].events = 0;
+            fds[k].revents = 0;
+            if (state.out_done < state.out.size()) {
+                fds[k].events |= POLLOUT;
+            }
+            if (!state.received) {
+                fds[k].events |= POLLIN;
+            }
+            pending = pending || fds[k].events != 0;
+        }
+        if (!pending) {
+            return;
+        }
+
+        if (::poll(fds.data(), (nfds_t)n, -1) < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            throw particles::IOError(errno_message("Slab channel poll"));
+        }
+
+        for (size_t k = 0; k < n; ++k) {
+            TransferState &state = states[k];
+            const int fd = fds[k].fd;
+
+            if ((fds[k].revents & POLLOUT) &&
+                state.out_done < state.out.size()) {
+                const ssize_t written =
+                    ::send(fd, state.out.data() + state.out_done,
+                           state.out.size() - state.out_done,
+                           SEND_FLAGS | MSG_DONTWAIT);
+                if (written < 0 && errno != EAGAIN && errno != EWOULDBLOCK &&
+                    errno != EINTR) {
+                    throw particles::IOError(
+                        errno_message("Slab channel send"));
+                }
+                state.out_done += written > 0 ? (size_t)written : 0;
+            }
+
+            if (!(fds[k].revents & (POLLIN | POLLHUP | POLLERR)) ||
+                state.received) {
+                continue;
+            }
+
+            char *target;
+            size_t wanted;
+            if (state.header_done < sizeof(MessageHeader)) {
+                target = (char *)&state.header + state.header_done;
+                wanted = sizeof(MessageHeader) - state.header_done;
+            } else {
+                target = (char *)exchanges[k].incoming->data() +
+                         state.payload_done;
+                wanted = exchanges[k].incoming->size() *
+                             sizeof(ParticleRecord) -
+                         state.payload_done;
+            }
+            const ssize_t got = ::recv(fd, target, wanted, MSG_DONTWAIT);
+            if (got == 0) {
+                throw particles::IOError("Slab channel closed by peer");
+            }
+            if (got < 0) {
+                if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) {
+                    continue;
+                }
+                throw particles::IOError(errno_message("Slab channel receive"));
+            }
+
+            if (state.header_done < sizeof(MessageHeader)) {
+                state.header_done += (size_t)got;
+                if (state.header_done == sizeof(MessageHeader)) {
+                    check_tag(state.header, exchanges[k].tag);
+                    exchanges[k].incoming->resize(state.header.count);
+                    state.received = state.header.count == 0;
+                }
+            } else {
+                state.payload_done += (size_t)got;
+                state.received = state.payload_done ==
+                                 exchanges[k].incoming->size() *
+                                     sizeof(ParticleRecord);
+            }
+        }
+    }
+}
+
+} // namespace distributed
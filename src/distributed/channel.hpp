@@ -0,0 +1,128 @@
+#pragma once
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "slab_layout.hpp"
+
+namespace distributed {
+
+/**
+ * @brief Message types of the slab protocol
+ */
+enum class MessageTag : uint32_t {
+    Step = 1, // coordinator -> worker, value = tick count
+    Done,     // worker -> coordinator, value = owned particle count
+    Gather,   // coordinator -> worker
+    Records,  // worker -> coordinator, owned particles
+    Halo,     // worker -> neighbor, particles near the shared boundary
+    Migrate,  // worker -> neighbor, particles that crossed the boundary
+    Quit,     // coordinator -> worker
+};
+
+/**
+ * @brief Fixed-size frame header; count ParticleRecords follow it
+ */
+struct MessageHeader {
+    uint32_t tag;
+    uint32_t value;
+    uint32_t count;
+};
+
+/**
+ * @brief Owning wrapper around one end of a local stream socket
+ *
+ * Messages are a MessageHeader followed by raw ParticleRecords. Both ends
+ * run on the same machine and binary, so records are sent in native layout.
+ */
+class Channel {
+  public:
+    Channel() = default;
+    explicit Channel(int fd) noexcept : m_fd(fd) {}
+    ~Channel();
+    Channel(const Channel &) = delete;
+    Channel &operator=(const Channel &) = delete;
+    Channel(Channel &&other) noexcept;
+    Channel &operator=(Channel &&other) noexcept;
+
+    /**
+     * @brief Creates a connected pair of Unix domain stream sockets
+     * @return Both ends of the connection
+     * @throws IOError if the sockets cannot be created
+     */
+    static std::pair<Channel, Channel> pair();
+
+    /**
+     * @brief Checks whether the channel holds an open socket
+     * @return True if open
+     */
+    bool valid() const noexcept { return m_fd >= 0; }
+
+    /**
+     * @brief Gets the underlying file descriptor
+     * @return Socket descriptor, or -1
+     */
+    int fd() const noexcept { return m_fd; }
+
+    /**
+     * @brief Closes the socket (no-op if already closed)
+     */
+    void close() noexcept;
+
+    /**
+     * @brief Sends one message, blocking until it is fully written
+     * @param tag Message type
+     * @param value Tag-specific value
+     * @param records Payload records
+     * @throws IOError if the peer is gone
+     */
+    void send(MessageTag tag, uint32_t value,
+              const std::vector<ParticleRecord> &records = {});
+
+    /**
+     * @brief Receives one message, blocking until it is complete
+     * @param records Receives the payload records
+     * @return Message header
+     * @throws IOError if the peer closed the connection
+     */
+    MessageHeader receive(std::vector<ParticleRecord> &records);
+
+    /**
+     * @brief Receives one message and checks its type
+     * @param tag Expected message type
+     * @param records Receives the payload records
+     * @return Message header
+     * @throws IOError if the peer closed the connection
+     * @throws SimulationError if a different message arrives
+     */
+    MessageHeader expect(MessageTag tag, std::vector<ParticleRecord> &records);
+
+  private:
+    int m_fd = -1;
+};
+
+/**
+ * @brief One send plus one receive on a channel, for exchange()
+ */
+struct Exchange {
+    Channel *channel = nullptr;
+    MessageTag tag = MessageTag::Halo;
+    const std::vector<ParticleRecord> *outgoing = nullptr;
+    std::vector<ParticleRecord> *incoming = nullptr;
+};
+
+/**
+ * @brief Sends and receives one message per channel concurrently
+ *
+ * Neighbors push their halos at each other at the same time; with blocking
+ * writes, two payloads larger than the socket buffers would deadlock. This
+ * interleaves all reads and writes with poll() until every transfer is done.
+ * @param exchanges Transfers to perform; each incoming message must carry the
+ * same tag as the exchange
+ * @throws IOError if a peer closed the connection
+ * @throws SimulationError if an unexpected message arrives
+ */
+void exchange(std::vector<Exchange> &exchanges);
+
+} // namespace distributed
@@ -0,0 +1,28 @@
+#include "frame_export.hpp"
+
+namespace distributed {
+
+FrameExport::FrameExport(std::string name, int slots)
+    : m_ring(std::move(name), slots) {}
+
+void FrameExport::write(const World &world, float width, float height,
+                        long long stamp_ns) {
+    const int groups = world.get_groups_size();
+    m_groups.resize((size_t)groups);
+    for (int g = 0; g < groups; ++g) {
+        const Color color = world.get_group_color(g);
+        FrameGroup &out = m_groups[(size_t)g];
+        out.begin = (uint32_t)world.get_group_start(g);
+        out.end = (uint32_t)world.get_group_end(g);
+        out.r = color.r;
+        out.g = color.g;
+        out.b = color.b;
+        out.a = color.a;
+        out.enabled = world.is_group_enabled(g) ? 1u : 0u;
+    }
+    m_ring.write(stamp_ns, width, height, world.get_px_array(),
+                 world.get_py_array(), world.get_particles_size(),
+                 m_groups.data(), groups);
+}
+
+} // namespace distributed
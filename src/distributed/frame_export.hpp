@@ -0,0 +1,41 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "../simulation/frame_sink.hpp"
+#include "frame_ring.hpp"
+
+namespace distributed {
+
+/**
+ * @brief Frame sink that writes every published frame to a frame ring
+ *
+ * Install it with Simulation::set_frame_sink to let other processes map the
+ * frames read-only (see FrameRingReader and tools/frame_reader).
+ */
+class FrameExport : public IFrameSink {
+  public:
+    /**
+     * @brief Creates the ring
+     * @param name POSIX shared-memory name, e.g. "/particles"
+     * @param slots Frames kept in the ring
+     * @throws IOError if the ring cannot be created
+     */
+    explicit FrameExport(std::string name,
+                         int slots = FrameRingWriter::DEFAULT_SLOTS);
+
+    void write(const World &world, float width, float height,
+               long long stamp_ns) override;
+
+    /**
+     * @brief Gets the ring the frames go to
+     */
+    const FrameRingWriter &ring() const noexcept { return m_ring; }
+
+  private:
+    FrameRingWriter m_ring;
+    std::vector<FrameGroup> m_groups;
+};
+
+} // namespace distributed
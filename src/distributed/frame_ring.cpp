@@ -0,0 +1,270 @@
+#include "frame_ring.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <new>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "../utility/exceptions.hpp"
+
+namespace distributed {
+
+namespace {
+
+constexpr size_t ALIGN = 64;
+
+std::string errno_message(const std::string &what) {
+    return what + ": " + std::strerror(errno);
+}
+
+size_t round_up(size_t bytes) { return (bytes + ALIGN - 1) / ALIGN * ALIGN; }
+
+size_t slot_bytes(uint32_t max_particles, uint32_t max_groups) {
+    return round_up(sizeof(FrameSlotHeader) +
+                    sizeof(FrameGroup) * max_groups +
+                    sizeof(float) * 2 * max_particles);
+}
+
+FrameSlotHeader *slot_at(void *base, uint64_t frame) {
+    auto *header = (FrameRingHeader *)base;
+    const uint64_t slot = (frame - 1) % header->slot_count;
+    return (FrameSlotHeader *)((char *)base + header->slots_offset +
+                               slot * header->slot_bytes);
+}
+
+/**
+ * @brief Publishes a ring's retirement to its readers and unmaps it
+ */
+void retire(void *base, size_t bytes, uint32_t state) noexcept {
+    ((FrameRingHeader *)base)->stale.store(state, std::memory_order_release);
+    munmap(base, bytes);
+}
+
+const FrameSlotHeader *slot_at(const void *base, uint64_t frame) {
+    return slot_at(const_cast<void *>(base), frame);
+}
+
+FrameGroup *groups_of(FrameSlotHeader *slot) {
+    return (FrameGroup *)((char *)slot + sizeof(FrameSlotHeader));
+}
+
+float *xy_of(FrameSlotHeader *slot, uint32_t max_groups) {
+    return (float *)((char *)groups_of(slot) + sizeof(FrameGroup) * max_groups);
+}
+
+} // namespace
+
+FrameRingWriter::FrameRingWriter(std::string name, int slots,
+                                 int max_particles, int max_groups)
+    : m_name(std::move(name)), m_slots((uint32_t)std::max(2, slots)) {
+    create((uint32_t)std::max(1, max_particles),
+           (uint32_t)std::max(1, max_groups));
+}
+
+FrameRingWriter::~FrameRingWriter() { destroy(); }
+
+void FrameRingWriter::create(uint32_t max_particles, uint32_t max_groups) {
+    // Readers of a previous ring under this name keep their mapping of the
+    // unlinked object until the caller retires it
+    shm_unlink(m_name.c_str());
+    const int fd = shm_open(m_name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+    if (fd < 0) {
+        throw particles::IOError(errno_message("shm_open " + m_name));
+    }
+
+    const size_t offset = round_up(sizeof(FrameRingHeader));
+    const size_t stride = slot_bytes(max_particles, max_groups);
+    const size_t bytes = offset + stride * m_slots;
+    if (ftruncate(fd, (off_t)bytes) != 0) {
+        const std::string message = errno_message("ftruncate " + m_name);
+        ::close(fd);
+        shm_unlink(m_name.c_str());
+        throw particles::IOError(message);
+    }
+    void *base =
+        mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (base == MAP_FAILED) {
+        shm_unlink(m_name.c_str());
+        throw particles::IOError(errno_message("mmap " + m_name));
+    }
+
+    // ftruncate zero-fills, so every slot starts at sequence 0
+    auto *header = new (base) FrameRingHeader{};
+    header->slot_count = m_slots;
+    header->max_particles = max_particles;
+    header->max_groups = max_groups;
+    header->slot_bytes = stride;
+    header->slots_offset = offset;
+    header->latest.store(0, std::memory_order_relaxed);
+    header->stale.store(0, std::memory_order_relaxed);
+    header->version = FRAME_RING_VERSION;
+    // Readers check the magic last
+    std::atomic_thread_fence(std::memory_order_release);
+    header->magic = FRAME_RING_MAGIC;
+
+    m_base = base;
+    m_bytes = bytes;
+}
+
+void FrameRingWriter::destroy() noexcept {
+    if (!m_base) {
+        return;
+    }
+    retire(m_base, m_bytes, FRAME_RING_CLOSED);
+    shm_unlink(m_name.c_str());
+    m_base = nullptr;
+    m_bytes = 0;
+}
+
+void FrameRingWriter::write(long long stamp_ns, float width, float height,
+                            const float *px, const float *py, int particles,
+                            const FrameGroup *groups, int group_count) {
+    particles = std::max(0, particles);
+    group_count = std::max(0, group_count);
+    auto *header = (FrameRingHeader *)m_base;
+    if ((uint32_t)particles > header->max_particles ||
+        (uint32_t)group_count > header->max_groups) {
+        const uint32_t max_particles =
+            std::max((uint32_t)particles, header->max_particles * 2);
+        const uint32_t max_groups =
+            std::max((uint32_t)group_count, header->max_groups * 2);
+        // The new ring is complete before readers are told to reopen
+        void *const old_base = m_base;
+        const size_t old_bytes = m_bytes;
+        create(max_particles, max_groups);
+        retire(old_base, old_bytes, FRAME_RING_REPLACED);
+        header = (FrameRingHeader *)m_base;
+    }
+
+    const uint64_t frame = ++m_frame;
+    FrameSlotHeader *slot = slot_at(m_base, frame);
+    slot->sequence.store(frame * 2 - 1, std::memory_order_relaxed);
+    // Orders the odd sequence before the payload stores
+    std::atomic_thread_fence(std::memory_order_release);
+
+    slot->stamp_ns = stamp_ns;
+    slot->particles = (uint32_t)particles;
+    slot->groups = (uint32_t)group_count;
+    slot->width = width;
+    slot->height = height;
+    std::copy(groups, groups + group_count, groups_of(slot));
+    float *xy = xy_of(slot, header->max_groups);
+    for (int i = 0; i < particles; ++i) {
+        xy[(size_t)i * 2 + 0] = px[i];
+        xy[(size_t)i * 2 + 1] = py[i];
+    }
+
+    slot->sequence.store(frame * 2, std::memory_order_release);
+    header->latest.store(frame, std::memory_order_release);
+}
+
+FrameRingReader::FrameRingReader(std::string name) : m_name(std::move(name)) {
+    open();
+}
+
+FrameRingReader::~FrameRingReader() { close(); }
+
+void FrameRingReader::open() {
+    const int fd = shm_open(m_name.c_str(), O_RDONLY, 0);
+    if (fd < 0) {
+        throw particles::IOError(errno_message("shm_open " + m_name));
+    }
+    struct stat st {};
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(FrameRingHeader)) {
+        ::close(fd);
+        throw particles::IOError("Frame ring " + m_name + " is truncated");
+    }
+    const size_t bytes = (size_t)st.st_size;
+    void *base = mmap(nullptr, bytes, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (base == MAP_FAILED) {
+        throw particles::IOError(errno_message("mmap " + m_name));
+    }
+
+    const auto *header = (const FrameRingHeader *)base;
+    const bool valid =
+        header->magic == FRAME_RING_MAGIC &&
+        header->version == FRAME_RING_VERSION && header->slot_count > 0 &&
+        header->slots_offset + header->slot_bytes * header->slot_count <=
+            bytes;
+    if (!valid) {
+        munmap(base, bytes);
+        throw particles::IOError("Frame ring " + m_name +
+                                 " has an unknown layout");
+    }
+    m_base = base;
+    m_bytes = bytes;
+}
+
+void FrameRingReader::close() noexcept {
+    if (m_base) {
+        munmap(const_cast<void *>(m_base), m_bytes);
+        m_base = nullptr;
+        m_bytes = 0;
+    }
+}
+
+void FrameRingReader::reopen() {
+    // open() only takes over once the new ring checks out
+    const void *const old_base = m_base;
+    const size_t old_bytes = m_bytes;
+    open();
+    munmap(const_cast<void *>(old_base), old_bytes);
+}
+
+bool FrameRingReader::stale() const {
+    return ((const FrameRingHeader *)m_base)
+               ->stale.load(std::memory_order_acquire) != FRAME_RING_LIVE;
+}
+
+bool FrameRingReader::closed() const {
+    return ((const FrameRingHeader *)m_base)
+               ->stale.load(std::memory_order_acquire) == FRAME_RING_CLOSED;
+}
+
+bool FrameRingReader::latest(FrameView &out) const {
+    const auto *header = (const FrameRingHeader *)m_base;
+    if (header->stale.load(std::memory_order_acquire) != FRAME_RING_LIVE) {
+        return false;
+    }
+    const uint64_t frame = header->latest.load(std::memory_order_acquire);
+    if (frame == 0) {
+        return false;
+    }
+
+    const FrameSlotHeader *slot = slot_at(m_base, frame);
+    // A newer frame may already be overwriting this slot
+    if (slot->sequence.load(std::memory_order_acquire) != frame * 2) {
+        return false;
+    }
+    out.number = frame;
+    out.slot = slot;
+    out.stamp_ns = slot->stamp_ns;
+    out.particles = std::min(slot->particles, header->max_particles);
+    out.groups = std::min(slot->groups, header->max_groups);
+    out.width = slot->width;
+    out.height = slot->height;
+    out.group = (const FrameGroup *)((const char *)slot +
+                                     sizeof(FrameSlotHeader));
+    out.xy = (const float *)((const char *)out.group +
+                             sizeof(FrameGroup) * header->max_groups);
+    return still_valid(out);
+}
+
+bool FrameRingReader::still_valid(const FrameView &view) const {
+    if (!view.slot) {
+        return false;
+    }
+    // Orders the payload loads before the sequence check
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return view.slot->sequence.load(std::memory_order_relaxed) ==
+           view.number * 2;
+}
+
+} // namespace distributed
@@ -0,0 +1,235 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <type_traits>
+
+namespace distributed {
+
+/**
+ * @brief First word of a frame ring ("PRFR")
+ */
+inline constexpr uint32_t FRAME_RING_MAGIC = 0x52465250u;
+
+/**
+ * @brief Layout version; readers reject other versions
+ */
+inline constexpr uint32_t FRAME_RING_VERSION = 1;
+
+/**
+ * @brief Values of FrameRingHeader::stale
+ */
+inline constexpr uint32_t FRAME_RING_LIVE = 0;
+inline constexpr uint32_t FRAME_RING_REPLACED = 1; // A bigger ring took over
+inline constexpr uint32_t FRAME_RING_CLOSED = 2;   // The writer went away
+
+/**
+ * @brief Shared header at offset 0 of a frame ring
+ *
+ * A ring is one POSIX shared-memory object: this header, then slot_count
+ * slots of slot_bytes each, starting at slots_offset. Frame n (counting from
+ * 1) lives in slot (n - 1) % slot_count.
+ */
+struct FrameRingHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t slot_count;
+    uint32_t max_particles;
+    uint32_t max_groups;
+    uint32_t reserved;
+    uint64_t slot_bytes;
+    uint64_t slots_offset;
+    std::atomic<uint64_t> latest; // Newest complete frame (0 = none yet)
+    std::atomic<uint32_t> stale;  // FRAME_RING_LIVE until retired
+};
+
+/**
+ * @brief One group's particle range and color
+ */
+struct FrameGroup {
+    uint32_t begin;
+    uint32_t end;
+    uint8_t r, g, b, a;
+    uint32_t enabled;
+};
+
+/**
+ * @brief Header of one slot; FrameGroup[max_groups] and then
+ * float[2 * max_particles] (x, y pairs) follow it
+ *
+ * sequence is a seqlock: 2n - 1 while frame n is written, 2n once it is
+ * complete. A reader that sees the same even value before and after reading
+ * the slot read a whole frame.
+ */
+struct FrameSlotHeader {
+    std::atomic<uint64_t> sequence;
+    int64_t stamp_ns;
+    uint32_t particles;
+    uint32_t groups;
+    float width;
+    float height;
+};
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free &&
+                  std::atomic<uint32_t>::is_always_lock_free,
+              "Ring atomics are shared between processes");
+static_assert(std::is_standard_layout_v<FrameRingHeader> &&
+                  std::is_standard_layout_v<FrameSlotHeader>,
+              "Ring headers are read by other processes");
+
+/**
+ * @brief Read-only view of one frame inside a mapped ring
+ *
+ * Points straight into shared memory. Check it with
+ * FrameRingReader::still_valid after using the data.
+ */
+struct FrameView {
+    uint64_t number = 0;
+    int64_t stamp_ns = 0;
+    uint32_t particles = 0;
+    uint32_t groups = 0;
+    float width = 0.f;
+    float height = 0.f;
+    const float *xy = nullptr;
+    const FrameGroup *group = nullptr;
+    const FrameSlotHeader *slot = nullptr;
+};
+
+/**
+ * @brief Writes frames into a shared-memory ring for other processes
+ *
+ * The writer never waits for readers: it overwrites the oldest slot, and a
+ * reader still looking at it finds out through the slot's sequence. When a
+ * frame outgrows the ring, a bigger ring replaces it under the same name and
+ * only then is the old one marked replaced, so a reader that reopens on that
+ * mark finds the new ring ready.
+ */
+class FrameRingWriter {
+  public:
+    /** @brief Slots of a default ring */
+    static constexpr int DEFAULT_SLOTS = 4;
+
+    /**
+     * @brief Creates (or replaces) the shared-memory object
+     * @param name POSIX shared-memory name, e.g. "/particles"
+     * @param slots Frames kept in the ring (at least 2)
+     * @param max_particles Initial particle capacity
+     * @param max_groups Initial group capacity
+     * @throws IOError if the object cannot be created or mapped
+     */
+    explicit FrameRingWriter(std::string name, int slots = DEFAULT_SLOTS,
+                             int max_particles = 1024, int max_groups = 16);
+    ~FrameRingWriter();
+    FrameRingWriter(const FrameRingWriter &) = delete;
+    FrameRingWriter &operator=(const FrameRingWriter &) = delete;
+    FrameRingWriter(FrameRingWriter &&) = delete;
+    FrameRingWriter &operator=(FrameRingWriter &&) = delete;
+
+    /**
+     * @brief Writes one frame and makes it the latest
+     * @param stamp_ns Publish timestamp
+     * @param width World width
+     * @param height World height
+     * @param px X of each particle
+     * @param py Y of each particle
+     * @param particles Particle count
+     * @param groups Group ranges and colors
+     * @param group_count Group count
+     * @throws IOError if a bigger ring is needed and cannot be created;
+     * the old ring stays in use
+     */
+    void write(long long stamp_ns, float width, float height, const float *px,
+               const float *py, int particles, const FrameGroup *groups,
+               int group_count);
+
+    /**
+     * @brief Gets the number of frames written so far (frame numbers carry
+     * on across growth)
+     */
+    uint64_t frames_written() const noexcept { return m_frame; }
+
+    /**
+     * @brief Gets the shared-memory name
+     */
+    const std::string &name() const noexcept { return m_name; }
+
+  private:
+    /**
+     * @brief Unlinks any old object and maps a fresh ring
+     * @throws IOError on failure
+     */
+    void create(uint32_t max_particles, uint32_t max_groups);
+
+    /**
+     * @brief Marks the ring closed, unmaps and unlinks it
+     */
+    void destroy() noexcept;
+
+    std::string m_name;
+    uint32_t m_slots;
+    void *m_base = nullptr;
+    size_t m_bytes = 0;
+    uint64_t m_frame = 0;
+};
+
+/**
+ * @brief Maps a frame ring read-only and hands out zero-copy frame views
+ */
+class FrameRingReader {
+  public:
+    /**
+     * @brief Opens and maps an existing ring
+     * @param name Name the writer was created with
+     * @throws IOError if the ring does not exist or has another layout
+     */
+    explicit FrameRingReader(std::string name);
+    ~FrameRingReader();
+    FrameRingReader(const FrameRingReader &) = delete;
+    FrameRingReader &operator=(const FrameRingReader &) = delete;
+    FrameRingReader(FrameRingReader &&) = delete;
+    FrameRingReader &operator=(FrameRingReader &&) = delete;
+
+    /**
+     * @brief Gets a view of the newest complete frame
+     * @param out Filled with the frame
+     * @return False if no frame is complete yet or the ring is stale
+     */
+    bool latest(FrameView &out) const;
+
+    /**
+     * @brief Tells whether a view's slot was left alone while it was read
+     * @param view View returned by latest()
+     * @return True if everything read through the view belongs to one frame
+     */
+    bool still_valid(const FrameView &view) const;
+
+    /**
+     * @brief Tells whether the writer replaced or closed this ring
+     */
+    bool stale() const;
+
+    /**
+     * @brief Tells whether the writer closed this ring rather than
+     * replacing it, so there is nothing to reopen
+     */
+    bool closed() const;
+
+    /**
+     * @brief Maps the ring currently published under the name
+     * @throws IOError if it does not exist (yet); the current mapping is
+     * kept, so the reader stays usable and may retry
+     */
+    void reopen();
+
+  private:
+    void open();
+    void close() noexcept;
+
+    std::string m_name;
+    const void *m_base = nullptr;
+    size_t m_bytes = 0;
+};
+
+} // namespace distributed
@@ -0,0 +1,189 @@
+#include "slab_coordinator.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstring>
+#include <string>
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "../utility/exceptions.hpp"
+#include "../utility/logger.hpp"
+#include "slab_worker.hpp"
+
+namespace distributed {
+
+SlabCoordinator::SlabCoordinator(const particles::WorldBase &world,
+                                 const std::vector<float> &pos,
+                                 const std::vector<float> &vel,
+                                 const mailbox::SimulationConfigSnapshot &cfg,
+                                 int slabs, int threads_per_slab) {
+    if (slabs < 1) {
+        throw particles::ConfigError("Slab count must be >= 1, got " +
+                                     std::to_string(slabs));
+    }
+    m_particles_count = world.get_particles_size();
+    if (pos.size() != (size_t)m_particles_count * 2 ||
+        vel.size() != (size_t)m_particles_count * 2) {
+        throw particles::ConfigError(
+            "Slab coordinator needs x,y position and velocity per particle");
+    }
+
+    m_layout.width = std::max(1.0f, cfg.bounds_width);
+    m_layout.slabs = slabs;
+
+    // Halos only reach the adjacent slabs, so a slab must span the radius
+    float max_r2 = 0.f;
+    for (float r2 : world.get_group_radii2()) {
+        max_r2 = std::max(max_r2, r2);
+    }
+    const float halo = std::sqrt(max_r2) + 1.f;
+    if (slabs > 1 && m_layout.slab_width() < halo) {
+        throw particles::ConfigError(
+            "Slabs of width " + std::to_string(m_layout.slab_width()) +
+            " are narrower than the interaction halo " + std::to_string(halo));
+    }
+
+    std::vector<std::vector<ParticleRecord>> owned(slabs);
+    for (int g = 0; g < world.get_groups_size(); ++g) {
+        for (int i = world.get_group_start(g); i < world.get_group_end(g);
+             ++i) {
+            const size_t b = (size_t)i * 2;
+            const ParticleRecord r{i, g, pos[b + 0], pos[b + 1], vel[b + 0],
+                                   vel[b + 1]};
+            owned[m_layout.owner_of(r.px)].push_back(r);
+        }
+    }
+
+    // All sockets exist before the first fork so every child can close the
+    // ends it does not use; a stray copy would hide a dead peer's EOF
+    std::vector<Channel> worker_control;
+    std::vector<Channel> link_left;  // slab s end of the (s-1, s) link
+    std::vector<Channel> link_right; // slab s end of the (s, s+1) link
+    link_left.resize(slabs);
+    link_right.resize(slabs);
+    for (int s = 0; s < slabs; ++s) {
+        auto [parent_end, child_end] = Channel::pair();
+        m_control.push_back(std::move(parent_end));
+        worker_control.push_back(std::move(child_end));
+    }
+    for (int s = 0; s + 1 < slabs; ++s) {
+        auto [a, b] = Channel::pair();
+        link_right[s] = std::move(a);
+        link_left[s + 1] = std::move(b);
+    }
+
+    LOG_INFO("Starting " + std::to_string(slabs) + " slab workers for " +
+             std::to_string(m_particles_count) + " particles");
+
+    m_slab_sizes.assign(slabs, 0);
+    for (int s = 0; s < slabs; ++s) {
+        m_slab_sizes[s] = (int)owned[s].size();
+        const pid_t pid = ::fork();
+        if (pid < 0) {
+            const std::string reason = std::strerror(errno);
+            shutdown();
+            throw particles::IOError("Failed to fork slab worker: " + reason);
+        }
+        if (pid == 0) {
+            for (int other = 0; other < slabs; ++other) {
+                m_control[other].close();
+                if (other != s) {
+                    worker_control[other].close();
+                    link_left[other].close();
+                    link_right[other].close();
+                }
+            }
+            int status = 0;
+            try {
+                SlabWorker worker(m_layout, s, world, std::move(owned[s]), cfg,
+                                  threads_per_slab);
+                worker.serve(worker_control[s],
+                             link_left[s].valid() ? &link_left[s] : nullptr,
+                             link_right[s].valid() ? &link_right[s]
+                                                   : nullptr);
+            } catch (const std::exception &) {
+                // The coordinator sees the closed channel and reports it
+                status = 1;
+            }
+            // Skip the parent's atexit handlers and static destructors
+            ::_exit(status);
+        }
+        m_pids.push_back(pid);
+    }
+}
+
+SlabCoordinator::~SlabCoordinator() { shutdown(); }
+
+void SlabCoordinator::step(int ticks) {
+    if (ticks <= 0) {
+        return;
+    }
+    for (Channel &control : m_control) {
+        control.send(MessageTag::Step, (uint32_t)ticks);
+    }
+    for (int s = 0; s < slabs(); ++s) {
+        const MessageHeader header =
+            m_control[s].expect(MessageTag::Done, m_scratch);
+        m_slab_sizes[s] = (int)header.value;
+    }
+}
+
+void SlabCoordinator::gather(std::vector<float> &pos,
+                             std::vector<float> &vel) {
+    for (Channel &control : m_control) {
+        control.send(MessageTag::Gather, 0);
+    }
+
+    pos.assign((size_t)m_particles_count * 2, 0.f);
+    vel.assign((size_t)m_particles_count * 2, 0.f);
+    std::vector<uint8_t> seen(m_particles_count, 0);
+    int total = 0;
+    for (int s = 0; s < slabs(); ++s) {
+        m_control[s].expect(MessageTag::Records, m_scratch);
+        m_slab_sizes[s] = (int)m_scratch.size();
+        for (const ParticleRecord &r : m_scratch) {
+            if (r.id < 0 || r.id >= m_particles_count || seen[r.id]) {
+                throw particles::SimulationError(
+                    "Slab " + std::to_string(s) +
+                    " returned invalid or duplicate particle " +
+                    std::to_string(r.id));
+            }
+            seen[r.id] = 1;
+            const size_t b = (size_t)r.id * 2;
+            pos[b + 0] = r.px;
+            pos[b + 1] = r.py;
+            vel[b + 0] = r.vx;
+            vel[b + 1] = r.vy;
+        }
+        total += (int)m_scratch.size();
+    }
+    if (total != m_particles_count) {
+        throw particles::SimulationError(
+            "Slab workers hold " + std::to_string(total) + " of " +
+            std::to_string(m_particles_count) + " particles");
+    }
+}
+
+void SlabCoordinator::shutdown() noexcept {
+    for (Channel &control : m_control) {
+        if (!control.valid()) {
+            continue;
+        }
+        try {
+            control.send(MessageTag::Quit, 0);
+        } catch (const std::exception &) {
+            // Worker already gone; reaping below is all that is left
+        }
+        control.close();
+    }
+    for (pid_t pid : m_pids) {
+        while (::waitpid(pid, nullptr, 0) < 0 && errno == EINTR) {
+        }
+    }
+    m_pids.clear();
+}
+
+} // namespace distributed
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <sys/types.h>
+#include <vector>
+
+#include "../mailbox/data_snapshot.hpp"
+#include "../world_base.hpp"
+#include "channel.hpp"
+#include "slab_layout.hpp"
+
+namespace distributed {
+
+/**
+ * @brief Runs a world as several slab processes on one machine
+ *
+ * The bounds are split into vertical slabs of equal width and one worker
+ * process is forked per slab. Workers talk to their left/right neighbors
+ * over Unix domain socket pairs for halos and migrating particles, and to
+ * the coordinator for step requests and draw output. gather() merges the
+ * workers' particles back into global-index order, in the interleaved x,y
+ * layout of the draw buffer.
+ *
+ * Construct the coordinator before starting other threads in the process:
+ * workers are created with fork() and must not inherit held locks.
+ * Rules are fixed for the coordinator's lifetime.
+ */
+class SlabCoordinator {
+  public:
+    /**
+     * @brief Forks the slab workers
+     * @param world Group layout, colors, radii, rules and enabled flags
+     * @param pos Particle positions (x,y interleaved, global order)
+     * @param vel Particle velocities (x,y interleaved, global order)
+     * @param cfg Simulation config
+     * @param slabs Number of worker processes
+     * @param threads_per_slab Kernel threads in each worker
+     * @throws ConfigError if the slab count is invalid or slabs would be
+     * narrower than the interaction radius
+     * @throws IOError if the sockets or processes cannot be created
+     */
+    SlabCoordinator(const particles::WorldBase &world,
+                    const std::vector<float> &pos,
+                    const std::vector<float> &vel,
+                    const mailbox::SimulationConfigSnapshot &cfg, int slabs,
+                    int threads_per_slab = 1);
+
+    /**
+     * @brief Stops the workers and reaps their processes
+     */
+    ~SlabCoordinator();
+    SlabCoordinator(const SlabCoordinator &) = delete;
+    SlabCoordinator &operator=(const SlabCoordinator &) = delete;
+    SlabCoordinator(SlabCoordinator &&) = delete;
+    SlabCoordinator &operator=(SlabCoordinator &&) = delete;
+
+    /**
+     * @brief Advances every slab and waits for all of them
+     * @param ticks Number of simulation steps
+     * @throws IOError if a worker died
+     */
+    void step(int ticks = 1);
+
+    /**
+     * @brief Collects all particles in global-index order
+     * @param pos Receives positions (x,y interleaved)
+     * @param vel Receives velocities (x,y interleaved)
+     * @throws IOError if a worker died
+     * @throws SimulationError if particles were lost or duplicated
+     */
+    void gather(std::vector<float> &pos, std::vector<float> &vel);
+
+    /**
+     * @brief Gets the number of slab processes
+     * @return Slab count
+     */
+    int slabs() const noexcept { return m_layout.slabs; }
+
+    /**
+     * @brief Gets the slab partition
+     * @return Layout shared with the workers
+     */
+    const SlabLayout &layout() const noexcept { return m_layout; }
+
+    /**
+     * @brief Gets how many particles each slab owned after the last step
+     * @return Particle count per slab
+     */
+    const std::vector<int> &slab_sizes() const noexcept {
+        return m_slab_sizes;
+    }
+
+  private:
+    /**
+     * @brief Sends Quit, closes the channels and waits for the workers
+     */
+    void shutdown() noexcept;
+
+    SlabLayout m_layout;
+    int m_particles_count = 0;
+    std::vector<Channel> m_control;
+    std::vector<pid_t> m_pids;
+    std::vector<int> m_slab_sizes;
+    std::vector<ParticleRecord> m_scratch;
+};
+
+} // namespace distributed
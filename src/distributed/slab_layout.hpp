@@ -0,0 +1,83 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <type_traits>
+
+namespace distributed {
+
+/**
+ * @brief One particle as exchanged between slab processes
+ *
+ * The id is the particle's index in the global world. Global indices are
+ * contiguous per group, so sorting records by id also keeps them grouped.
+ */
+struct ParticleRecord {
+    int32_t id;
+    int32_t group;
+    float px;
+    float py;
+    float vx;
+    float vy;
+};
+
+static_assert(std::is_trivially_copyable_v<ParticleRecord>,
+              "ParticleRecord is sent as raw bytes");
+
+/**
+ * @brief Splits the simulation bounds into equal-width vertical slabs
+ *
+ * Slab s owns x in [x0(s), x1(s)). Ownership is always decided through
+ * owner_of so that every process agrees on the boundaries bit for bit.
+ */
+struct SlabLayout {
+    float width = 1.f;
+    int slabs = 1;
+
+    /**
+     * @brief Gets the left edge of a slab
+     * @param slab Slab index
+     * @return Smallest x owned by the slab
+     */
+    inline float x0(int slab) const noexcept {
+        return width * (float)slab / (float)slabs;
+    }
+
+    /**
+     * @brief Gets the right edge of a slab
+     * @param slab Slab index
+     * @return One past the largest x owned by the slab
+     */
+    inline float x1(int slab) const noexcept {
+        return width * (float)(slab + 1) / (float)slabs;
+    }
+
+    /**
+     * @brief Gets the width of one slab
+     * @return Slab width in world units
+     */
+    inline float slab_width() const noexcept { return width / (float)slabs; }
+
+    /**
+     * @brief Finds the slab owning an x coordinate (clamped to the bounds)
+     * @param x Particle x position
+     * @return Slab index in [0, slabs)
+     */
+    inline int owner_of(float x) const noexcept {
+        if (!(x >= 0.f)) {
+            return 0;
+        }
+        int slab = (int)(x * (float)slabs / width);
+        slab = std::clamp(slab, 0, slabs - 1);
+        // Keep owner_of consistent with x0/x1 despite rounding
+        while (slab > 0 && x < x0(slab)) {
+            --slab;
+        }
+        while (slab < slabs - 1 && x >= x1(slab)) {
+            ++slab;
+        }
+        return slab;
+    }
+};
+
+} // namespace distributed
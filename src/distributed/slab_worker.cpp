@@ -0,0 +1,170 @@
+#include "slab_worker.hpp"
+
+#include <algorithm>
+
+namespace distributed {
+
+namespace {
+
+/**
+ * @brief Runs one exchange with whichever neighbors exist
+ */
+void exchange_with_neighbors(MessageTag tag, Channel *left, Channel *right,
+                             const std::vector<ParticleRecord> &send_left,
+                             const std::vector<ParticleRecord> &send_right,
+                             std::vector<ParticleRecord> &recv_left,
+                             std::vector<ParticleRecord> &recv_right) {
+    std::vector<Exchange> exchanges;
+    recv_left.clear();
+    recv_right.clear();
+    if (left) {
+        exchanges.push_back({left, tag, &send_left, &recv_left});
+    }
+    if (right) {
+        exchanges.push_back({right, tag, &send_right, &recv_right});
+    }
+    exchange(exchanges);
+}
+
+} // namespace
+
+SlabWorker::SlabWorker(const SlabLayout &layout, int slab,
+                       const particles::WorldBase &rules,
+                       std::vector<ParticleRecord> owned,
+                       const mailbox::SimulationConfigSnapshot &cfg,
+                       int threads)
+    : m_layout(layout), m_slab(slab), m_cfg(cfg),
+      m_group_count(rules.get_groups_size()),
+      m_pool(std::make_unique<SimulationThreadPool>(std::max(1, threads))),
+      m_owned(std::move(owned)) {
+    m_world.set_group_colors(rules.get_group_colors());
+    m_world.set_group_radii2(rules.get_group_radii2());
+    m_world.particles::WorldBase::set_group_enabled(
+        rules.get_group_enabled());
+    m_world.set_rules(rules.get_rules());
+    m_group_sizes.assign(m_group_count, 0);
+    m_world.set_group_sizes(m_group_sizes);
+
+    // One world unit of slack covers rounding in the kernel's d2 < r2 test
+    m_halo = m_world.max_interaction_radius() + 1.f;
+}
+
+void SlabWorker::tick(Channel *left, Channel *right) {
+    const float x0 = m_layout.x0(m_slab);
+    const float x1 = m_layout.x1(m_slab);
+
+    m_send_left.clear();
+    m_send_right.clear();
+    for (const ParticleRecord &p : m_owned) {
+        if (left && p.px < x0 + m_halo) {
+            m_send_left.push_back(p);
+        }
+        if (right && p.px >= x1 - m_halo) {
+            m_send_right.push_back(p);
+        }
+    }
+    exchange_with_neighbors(MessageTag::Halo, left, right, m_send_left,
+                            m_send_right, m_recv_left, m_recv_right);
+
+    build_local_world();
+    m_stepper.step(m_world, *m_pool, m_cfg);
+    collect_owned(left != nullptr, right != nullptr);
+
+    exchange_with_neighbors(MessageTag::Migrate, left, right, m_send_left,
+                            m_send_right, m_recv_left, m_recv_right);
+    m_owned.insert(m_owned.end(), m_recv_left.begin(), m_recv_left.end());
+    m_owned.insert(m_owned.end(), m_recv_right.begin(), m_recv_right.end());
+}
+
+void SlabWorker::build_local_world() {
+    m_local.clear();
+    m_local.reserve(m_owned.size() + m_recv_left.size() + m_recv_right.size());
+    for (const ParticleRecord &p : m_owned) {
+        m_local.push_back({p, true});
+    }
+    for (const ParticleRecord &p : m_recv_left) {
+        m_local.push_back({p, false});
+    }
+    for (const ParticleRecord &p : m_recv_right) {
+        m_local.push_back({p, false});
+    }
+    // Global ids are contiguous per group, so id order is also group order
+    std::sort(m_local.begin(), m_local.end(),
+              [](const LocalParticle &a, const LocalParticle &b) {
+                  return a.record.id < b.record.id;
+              });
+
+    std::fill(m_group_sizes.begin(), m_group_sizes.end(), 0);
+    for (const LocalParticle &p : m_local) {
+        m_group_sizes[p.record.group] += 1;
+    }
+    m_world.set_group_sizes(m_group_sizes);
+
+    float *const px = m_world.get_px_array_mut();
+    float *const py = m_world.get_py_array_mut();
+    float *const vx = m_world.get_vx_array_mut();
+    float *const vy = m_world.get_vy_array_mut();
+    for (size_t i = 0; i < m_local.size(); ++i) {
+        const ParticleRecord &r = m_local[i].record;
+        px[i] = r.px;
+        py[i] = r.py;
+        vx[i] = r.vx;
+        vy[i] = r.vy;
+    }
+}
+
+void SlabWorker::collect_owned(bool has_left, bool has_right) {
+    const float *const px = m_world.get_px_array();
+    const float *const py = m_world.get_py_array();
+    const float *const vx = m_world.get_vx_array();
+    const float *const vy = m_world.get_vy_array();
+
+    m_owned.clear();
+    m_send_left.clear();
+    m_send_right.clear();
+    for (size_t i = 0; i < m_local.size(); ++i) {
+        if (!m_local[i].owned) {
+            continue;
+        }
+        ParticleRecord r = m_local[i].record;
+        r.px = px[i];
+        r.py = py[i];
+        r.vx = vx[i];
+        r.vy = vy[i];
+
+        const int owner = m_layout.owner_of(r.px);
+        if (owner < m_slab && has_left) {
+            m_send_left.push_back(r);
+        } else if (owner > m_slab && has_right) {
+            m_send_right.push_back(r);
+        } else {
+            m_owned.push_back(r);
+        }
+    }
+}
+
+void SlabWorker::serve(Channel &control, Channel *left, Channel *right) {
+    std::vector<ParticleRecord> scratch;
+    for (;;) {
+        const MessageHeader header = control.receive(scratch);
+        switch ((MessageTag)header.tag) {
+        case MessageTag::Step:
+            for (uint32_t t = 0; t < header.value; ++t) {
+                tick(left, right);
+            }
+            control.send(MessageTag::Done, (uint32_t)m_owned.size());
+            break;
+        case MessageTag::Gather:
+            control.send(MessageTag::Records, (uint32_t)m_slab, m_owned);
+            break;
+        case MessageTag::Quit:
+            return;
+        default:
+            throw particles::SimulationError(
+                "Unexpected slab control message " +
+                std::to_string(header.tag));
+        }
+    }
+}
+
+} // namespace distributed
@@ -0,0 +1,123 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "../mailbox/data_snapshot.hpp"
+#include "../simulation/multicore.hpp"
+#include "../simulation/stepper.hpp"
+#include "../simulation/world.hpp"
+#include "../world_base.hpp"
+#include "channel.hpp"
+#include "slab_layout.hpp"
+
+namespace distributed {
+
+/**
+ * @brief Simulates the particles of one slab in a slab process
+ *
+ * Every tick the worker:
+ * 1. sends the owned particles within halo_width() of each shared boundary to
+ *    that neighbor and receives the neighbor's in return;
+ * 2. steps a local World holding owned + halo particles with the shared
+ *    Stepper, keeping the results for owned particles only;
+ * 3. hands particles that left the slab to the neighbor on that side.
+ *
+ * The local World lists particles in global id order, so each owned particle
+ * sees the same neighbors in the same order as in a single-process run and
+ * the results are bit-identical. A particle crossing more than one slab in a
+ * tick is forwarded one slab per tick; it only happens when a particle moves
+ * further than a slab width, which the coordinator rules out by requiring
+ * slabs wider than the interaction radius.
+ */
+class SlabWorker {
+  public:
+    /**
+     * @brief Creates a worker
+     * @param layout Slab partition of the bounds
+     * @param slab Index of the slab this worker owns
+     * @param rules Group colors, radii, rules and enabled flags
+     * @param owned Particles initially inside the slab
+     * @param cfg Simulation config (bounds are the global bounds)
+     * @param threads Kernel threads for this worker
+     */
+    SlabWorker(const SlabLayout &layout, int slab,
+               const particles::WorldBase &rules,
+               std::vector<ParticleRecord> owned,
+               const mailbox::SimulationConfigSnapshot &cfg, int threads);
+    ~SlabWorker() = default;
+    SlabWorker(const SlabWorker &) = delete;
+    SlabWorker &operator=(const SlabWorker &) = delete;
+    SlabWorker(SlabWorker &&) = delete;
+    SlabWorker &operator=(SlabWorker &&) = delete;
+
+    /**
+     * @brief Runs one tick, exchanging halos and migrants with the neighbors
+     * @param left Channel to slab - 1, or nullptr for the first slab
+     * @param right Channel to slab + 1, or nullptr for the last slab
+     */
+    void tick(Channel *left, Channel *right);
+
+    /**
+     * @brief Serves coordinator requests until Quit or a closed channel
+     * @param control Channel to the coordinator
+     * @param left Channel to slab - 1, or nullptr
+     * @param right Channel to slab + 1, or nullptr
+     */
+    void serve(Channel &control, Channel *left, Channel *right);
+
+    /**
+     * @brief Gets the particles currently owned by this worker
+     * @return Owned particles
+     */
+    const std::vector<ParticleRecord> &owned() const noexcept {
+        return m_owned;
+    }
+
+    /**
+     * @brief Gets the halo width
+     * @return Maximum interaction radius plus rounding slack
+     */
+    float halo_width() const noexcept { return m_halo; }
+
+  private:
+    /**
+     * @brief Particle in the local world
+     */
+    struct LocalParticle {
+        ParticleRecord record;
+        bool owned;
+    };
+
+    /**
+     * @brief Fills m_world from owned and halo particles in global id order
+     */
+    void build_local_world();
+
+    /**
+     * @brief Copies owned results back and splits off the migrants
+     */
+    void collect_owned(bool has_left, bool has_right);
+
+    SlabLayout m_layout;
+    int m_slab;
+    mailbox::SimulationConfigSnapshot m_cfg;
+    float m_halo;
+    int m_group_count;
+
+    World m_world;
+    Stepper m_stepper;
+    std::unique_ptr<SimulationThreadPool> m_pool;
+
+    std::vector<ParticleRecord> m_owned;
+    std::vector<LocalParticle> m_local;
+    std::vector<int> m_group_sizes;
+
+    // Exchange buffers reused every tick
+    std::vector<ParticleRecord> m_send_left;
+    std::vector<ParticleRecord> m_send_right;
+    std::vector<ParticleRecord> m_recv_left;
+    std::vector<ParticleRecord> m_recv_right;
+};
+
+} // namespace distributed
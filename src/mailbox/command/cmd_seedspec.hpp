@@ -8,6 +8,8 @@
 #include <variant>
 #include <vector>
 
+#include "../../utility/memory_usage.hpp"
+
 namespace mailbox::command {
 
 // World seeding specification
@@ -22,9 +24,18 @@ struct SeedSpec {
     std::vector<float> rules;
     // Per-group enable/disable state
     std::vector<bool> enabled;
+    // Key for the counter-based RNG that places particles; the same key
+    // always produces the same world
+    uint64_t rng_seed = 0;
 
     int group_count() const { return static_cast<int>(sizes.size()); }
 
+    particles::utility::MemoryUsage memory_usage() const noexcept {
+        particles::utility::MemoryUsage usage;
+        usage.add(sizes).add(colors).add(r2).add(rules).add(enabled);
+        return usage;
+    }
+
     void ensure_defaults() {
         const int G = group_count();
 
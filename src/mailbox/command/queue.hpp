@@ -1,9 +1,11 @@
 #pragma once
 
+#include <condition_variable>
 #include <mutex>
 #include <variant>
 #include <vector>
 
+#include "../../utility/memory_usage.hpp"
 #include "cmds.hpp"
 
 namespace mailbox::command {
@@ -14,8 +16,34 @@ using Command =
 class Queue {
   public:
     void push(const Command &cmd) {
-        std::lock_guard<std::mutex> lock(m_mutex);
-        m_queue.push_back(cmd);
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_queue.push_back(cmd);
+        }
+        m_cv.notify_one();
+    }
+
+    /**
+     * @brief Releases a wait() without queueing a command
+     * @details For changes the consumer picks up elsewhere (e.g. a new
+     * config), which it should see without waiting for the next command.
+     */
+    void wake() {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_woken = true;
+        }
+        m_cv.notify_one();
+    }
+
+    /**
+     * @brief Blocks until a command is queued or wake() is called
+     * @details Returns at once if either happened since the last wait().
+     */
+    void wait() {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_cv.wait(lock, [this] { return !m_queue.empty() || m_woken; });
+        m_woken = false;
     }
 
     std::vector<Command> drain() {
@@ -27,8 +55,17 @@ class Queue {
         return out;
     }
 
+    particles::utility::MemoryUsage memory_usage() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        particles::utility::MemoryUsage usage;
+        usage.add(m_queue);
+        return usage;
+    }
+
   private:
-    std::mutex m_mutex;
+    mutable std::mutex m_mutex;
+    std::condition_variable m_cv;
     std::vector<Command> m_queue;
+    bool m_woken{false};
 };
 } // namespace mailbox::command
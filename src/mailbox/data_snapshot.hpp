@@ -1,12 +1,15 @@
 #pragma once
 
+#include <array>
 #include <atomic>
+#include <cstdint>
 #include <mutex>
 #include <type_traits>
 #include <vector>
 
 #include <raylib.h>
 
+#include "../utility/memory_usage.hpp"
 #include "../world_base.hpp"
 
 namespace mailbox {
@@ -25,15 +28,33 @@ struct SimulationConfigSnapshot {
     float gravity_y;
     int target_tps;
     int sim_threads;
+    bool force_table = false;     // Interpolate pair forces from a table
+    int cluster_interval = 0;     // Find clusters every N steps (0 = off)
+    float cluster_distance = 8.f; // Particles closer than this share a cluster
 
     /**
      * @brief Drawing and visualization report settings
      */
     struct DrawReport {
-        bool grid_data;
+        bool grid_data = false;        // Per-cell grid stats (overlays)
+        bool cell_costs = false;       // Per-cell force pair counts
+        bool cells = false;            // CSR cell lists (cell culling)
+        bool velocities = false;       // Per-particle velocity stream
+        bool packed_positions = false; // 16-bit positions (PackedPositions)
     } draw_report;
 };
 
+/**
+ * @brief Percentiles of a duration histogram, in nanoseconds
+ */
+struct LatencySummary {
+    long long samples = 0; // Values recorded
+    long long p50_ns = 0;  // Median
+    long long p95_ns = 0;  // 95th percentile
+    long long p99_ns = 0;  // 99th percentile
+    long long max_ns = 0;  // Largest value
+};
+
 /**
  * @brief Statistics snapshot containing all simulation performance data
  */
@@ -47,6 +68,11 @@ struct SimulationStatsSnapshot {
                             // nanoseconds
     long long published_ns; // Timestamp when this snapshot was published
     long long num_steps;    // Total number of simulation steps completed
+
+    // Since num_steps was last reset to 0
+    LatencySummary step_latency{};  // Duration of each step
+    LatencySummary oversleep{};     // Sleep past wait_on_tps's deadline
+    long long missed_deadlines = 0; // Ticks that overran 1 / target_tps
 };
 
 /**
@@ -56,6 +82,7 @@ struct WorldSnapshot : public particles::WorldBase {
   public:
     int group_count;
     int particles_count; // Total number of particles
+    uint64_t rng_seed = 0; // Key the particle positions were drawn with
 
     /**
      * @brief Gets the total number of groups
@@ -72,13 +99,142 @@ struct WorldSnapshot : public particles::WorldBase {
     }
 };
 
+/**
+ * @brief Whole-world statistics gathered while stepping
+ *
+ * Sums are reduced in a fixed order, so the values are identical for any
+ * simulation thread count.
+ */
+struct AnalyticsSnapshot {
+    static constexpr int SPEED_BINS = 32;
+
+    long long num_steps = 0;     // Step count the analytics belong to
+    int particles = 0;           // Particles included in the sums
+    double kinetic_energy = 0.0; // Sum of 0.5 * |v|^2 (unit mass)
+    double momentum_x = 0.0;     // Sum of vx
+    double momentum_y = 0.0;     // Sum of vy
+    float max_speed = 0.f;       // Fastest particle after the step
+    float speed_range = 0.f;     // Upper edge of the last histogram bin
+
+    /** @brief Particles per speed bin over [0, speed_range); faster particles
+     * land in the last bin */
+    std::array<int, SPEED_BINS> speed_histogram{};
+
+    std::vector<float> centroid_x; // Mean x per group (0 for empty groups)
+    std::vector<float> centroid_y; // Mean y per group (0 for empty groups)
+
+    long long cells = 0;           // Cells spanned by the neighbor grid
+    int occupied_cells = 0;        // Cells holding at least one particle
+    int max_cell_count = 0;        // Most particles in a single cell
+    float mean_cell_count = 0.f;   // Mean particles per occupied cell
+    float cell_count_stddev = 0.f; // Spread of particles per occupied cell
+
+    long long scanned_cells = 0;     // Neighbor cells the force pass read
+    long long pruned_cells = 0;      // Neighbor cells beyond the radius
+    long long pruned_candidates = 0; // Particles in the pruned cells
+    long long examined_pairs = 0;    // Candidate pairs the force pass read
+    long long accepted_pairs = 0;    // Examined pairs inside the radius
+    float pair_acceptance = 0.f;     // accepted_pairs / examined_pairs
+};
+
+/**
+ * @brief Connected components of the "closer than link_distance" graph
+ */
+struct ClusterSnapshot {
+    static constexpr int SIZE_BINS = 20;
+    /** @brief Smallest component listed as a cluster */
+    static constexpr int MIN_SIZE = 3;
+
+    long long num_steps = 0;   // Step count the clusters were found at
+    float link_distance = 0.f; // Particles closer than this are linked
+    int particles = 0;         // Particles of enabled groups considered
+    int components = 0;        // Components, single particles included
+    int clustered = 0;         // Particles in clusters of MIN_SIZE or more
+    int largest = 0;           // Particles in the largest component
+
+    /** @brief Components per size bin: bin b counts sizes in [2^b, 2^(b+1)),
+     * larger ones land in the last bin */
+    std::array<int, SIZE_BINS> size_histogram{};
+
+    // Clusters of at least MIN_SIZE particles, largest first
+    std::vector<int> sizes;
+    std::vector<float> centroid_x;
+    std::vector<float> centroid_y;
+};
+
+/**
+ * @brief Bytes held by each part of the simulation thread's state
+ *
+ * Published about once per second. reserved_bytes well above used_bytes
+ * (see MemoryUsage::wasteful) marks storage that outlived what it held, e.g.
+ * particle columns after a group was removed.
+ */
+struct MemorySnapshot {
+    using Usage = particles::utility::MemoryUsage;
+
+    long long published_ns = 0; // Timestamp when this snapshot was published
+
+    Usage world;       // Particle columns, group tables and rules
+    Usage grid_csr;    // CSR cells, cell masks and build scratch (dense and
+                       // sparse grids)
+    Usage stepper;     // Force buffers, force table and pair counts
+    Usage draw_buffer; // DrawBuffer slots with their GridFrame
+    Usage snapshots;   // DataSnapshot double buffers
+    Usage commands;    // Queued commands
+
+    /**
+     * @brief Sums every part
+     */
+    Usage total() const noexcept {
+        Usage sum;
+        for (const Usage *part : {&world, &grid_csr, &stepper, &draw_buffer,
+                                  &snapshots, &commands}) {
+            sum.merge(*part);
+        }
+        return sum;
+    }
+};
+
+/**
+ * @brief Gets the heap storage a snapshot owns besides its own object
+ * @return Empty usage for snapshots without containers
+ */
+template <typename T>
+particles::utility::MemoryUsage heap_usage(const T &) noexcept {
+    return {};
+}
+
+inline particles::utility::MemoryUsage
+heap_usage(const WorldSnapshot &snapshot) noexcept {
+    return snapshot.memory_usage();
+}
+
+inline particles::utility::MemoryUsage
+heap_usage(const AnalyticsSnapshot &snapshot) noexcept {
+    particles::utility::MemoryUsage usage;
+    usage.add(snapshot.centroid_x).add(snapshot.centroid_y);
+    return usage;
+}
+
+inline particles::utility::MemoryUsage
+heap_usage(const ClusterSnapshot &snapshot) noexcept {
+    particles::utility::MemoryUsage usage;
+    usage.add(snapshot.sizes)
+        .add(snapshot.centroid_x)
+        .add(snapshot.centroid_y);
+    return usage;
+}
+
 /**
  * @brief Concept to constrain DataSnapshot to only accept valid snapshot types
  */
 template <typename T>
 concept ValidSnapshotType = std::is_same_v<T, SimulationConfigSnapshot> ||
                             std::is_same_v<T, SimulationStatsSnapshot> ||
-                            std::is_same_v<T, WorldSnapshot>;
+                            std::is_same_v<T, WorldSnapshot> ||
+                            std::is_same_v<T, AnalyticsSnapshot> ||
+                            std::is_same_v<T, ClusterSnapshot> ||
+                            std::is_same_v<T, MemorySnapshot>;
 
 /**
  * @brief Thread-safe double buffering template for snapshot data
@@ -124,6 +280,21 @@ class DataSnapshot {
         return m_buffer[f];
     }
 
+    /**
+     * @brief Gets the bytes held by both buffers
+     * @return Usage of the buffers and the containers inside them
+     *
+     * Call from the publishing thread, so neither buffer changes meanwhile.
+     */
+    particles::utility::MemoryUsage memory_usage() const noexcept {
+        particles::utility::MemoryUsage usage;
+        usage.add_bytes((long long)sizeof(m_buffer));
+        for (const T &buffer : m_buffer) {
+            usage.merge(heap_usage(buffer));
+        }
+        return usage;
+    }
+
   private:
     std::mutex m_write_lock;
     std::atomic<int> m_front{0};
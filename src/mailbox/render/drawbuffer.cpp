@@ -3,39 +3,47 @@
 #include "drawbuffer.hpp"
 
 static inline uint32_t pack_pair(uint32_t prev, uint32_t curr) {
-    return ((prev & 0xFFu) << 8) | (curr & 0xFFu);
+    return ((prev & 0xFFFFu) << 16) | (curr & 0xFFFFu);
 }
 
-static inline int unpack_prev(uint32_t pair) { return int((pair >> 8) & 0xFF); }
-
-static inline int unpack_curr(uint32_t pair) { return int((pair >> 0) & 0xFF); }
+static inline int unpack_prev(uint32_t pair) {
+    return int((pair >> 16) & 0xFFFF);
+}
 
-static inline uint8_t bit(int i) { return uint8_t(1u << i); }
+static inline int unpack_curr(uint32_t pair) {
+    return int((pair >> 0) & 0xFFFF);
+}
 
 namespace mailbox::render {
 
-DrawBuffer::DrawBuffer()
-    : m_pair(pack_pair(0u, 0u)), m_in_use(0), m_write_idx(0) {}
+DrawBuffer::DrawBuffer(int slots)
+    : m_slot_count(std::clamp(slots, 3, 0xFFFF)),
+      m_slots(std::make_unique<Slot[]>(m_slot_count + 1)),
+      m_pins(std::make_unique<std::atomic<int>[]>(m_slot_count)),
+      m_pair(pack_pair(0u, 0u)), m_write_idx(0) {
+    for (int i = 0; i < m_slot_count; ++i) {
+        m_pins[i].store(0, std::memory_order_relaxed);
+    }
+}
 
 int DrawBuffer::acquire_write_index() const {
-    const uint32_t p = m_pair.load(std::memory_order_acquire);
+    // Single writer: the pair only changes in publish() on this thread
+    const uint32_t p = m_pair.load(std::memory_order_relaxed);
     const int prev = unpack_prev(p);
     const int curr = unpack_curr(p);
-    const uint8_t pinned = m_in_use.load(std::memory_order_acquire);
-
-    for (int i = 0; i < N_BUFFERS; ++i) {
-        if (i != prev && i != curr && (pinned & bit(i)) == 0) {
-            return i;
-        }
-    }
 
-    for (int i = 0; i < N_BUFFERS; ++i) {
-        if (i != curr) {
+    // Start after curr so slots are reused round-robin, which keeps a slot
+    // that was just released by a reader warm for the next frame
+    for (int k = 1; k <= m_slot_count; ++k) {
+        const int i = (curr + k) % m_slot_count;
+        // seq_cst pairs with begin_read(): either the reader sees the new
+        // pair and retries, or this load sees its pin
+        if (i != prev && i != curr && m_pins[i].load() == 0) {
             return i;
         }
     }
 
-    return 0;
+    return m_slot_count;
 }
 
 std::vector<float> &DrawBuffer::begin_write_pos(size_t floats_needed) {
@@ -59,6 +67,10 @@ std::vector<float> &DrawBuffer::begin_write_vel(size_t floats_needed) {
     return v;
 }
 
+PackedPositions &DrawBuffer::begin_write_packed() {
+    return m_slots[m_write_idx].packed;
+}
+
 GridFrame &DrawBuffer::begin_write_grid(int cols, int rows, int N,
                                         float cell_size, float width,
                                         float height) {
@@ -74,11 +86,15 @@ GridFrame &DrawBuffer::begin_write_grid(int cols, int rows, int N,
 }
 
 void DrawBuffer::publish(long long stamp_ns) {
+    if (m_write_idx == m_slot_count) {
+        m_dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
     m_slots[m_write_idx].stamp_ns.store(stamp_ns, std::memory_order_relaxed);
     const uint32_t old = m_pair.load(std::memory_order_relaxed);
     const uint32_t old_curr = uint32_t(unpack_curr(old));
     const uint32_t new_pair = pack_pair(old_curr, uint32_t(m_write_idx));
-    m_pair.store(new_pair, std::memory_order_release);
+    m_pair.store(new_pair);
 }
 
 void DrawBuffer::bootstrap_same_as_current(size_t floats_needed,
@@ -95,37 +111,57 @@ const std::vector<float> &DrawBuffer::read_current_only() const {
 }
 
 ReadView DrawBuffer::begin_read() const {
+    uint32_t p = m_pair.load();
     for (;;) {
-        const uint32_t p = m_pair.load(std::memory_order_acquire);
         const int prev = unpack_prev(p);
         const int curr = unpack_curr(p);
-
-        const uint8_t want = uint8_t(bit(prev) | bit(curr));
-        uint8_t old = m_in_use.load(std::memory_order_relaxed);
-
-        if ((old & want) != 0) {
+        m_pins[prev].fetch_add(1);
+        m_pins[curr].fetch_add(1);
+
+        // A publish between the load and the pins may have handed one of
+        // the slots to the writer: drop the pins and take the new pair
+        const uint32_t now = m_pair.load();
+        if (now != p) {
+            m_pins[prev].fetch_sub(1, std::memory_order_relaxed);
+            m_pins[curr].fetch_sub(1, std::memory_order_relaxed);
+            p = now;
             continue;
         }
 
-        if (m_in_use.compare_exchange_weak(old, uint8_t(old | want),
-                                           std::memory_order_acq_rel,
-                                           std::memory_order_relaxed)) {
-            ReadView v;
-            v.prev = &m_slots[prev].pos;
-            v.curr = &m_slots[curr].pos;
-            v.curr_vel = &m_slots[curr].vel;
-            v.grid = &m_slots[curr].grid;
-            v.t0 = m_slots[prev].stamp_ns.load(std::memory_order_relaxed);
-            v.t1 = m_slots[curr].stamp_ns.load(std::memory_order_relaxed);
-            v.mask = want;
-
-            return v;
-        }
+        ReadView v;
+        v.prev = &m_slots[prev].pos;
+        v.curr = &m_slots[curr].pos;
+        v.curr_vel = &m_slots[curr].vel;
+        v.prev_packed = &m_slots[prev].packed;
+        v.curr_packed = &m_slots[curr].packed;
+        v.grid = &m_slots[curr].grid;
+        v.t0 = m_slots[prev].stamp_ns.load(std::memory_order_relaxed);
+        v.t1 = m_slots[curr].stamp_ns.load(std::memory_order_relaxed);
+        v.prev_slot = prev;
+        v.curr_slot = curr;
+
+        return v;
     }
 }
 
 void DrawBuffer::end_read(const ReadView &v) const {
-    m_in_use.fetch_and(uint8_t(~v.mask), std::memory_order_release);
+    if (v.prev_slot < 0 || v.curr_slot < 0) {
+        return;
+    }
+    m_pins[v.prev_slot].fetch_sub(1, std::memory_order_release);
+    m_pins[v.curr_slot].fetch_sub(1, std::memory_order_release);
+}
+
+particles::utility::MemoryUsage DrawBuffer::memory_usage() const noexcept {
+    particles::utility::MemoryUsage usage;
+    usage.add_bytes((long long)sizeof(Slot) * (m_slot_count + 1) +
+                    (long long)sizeof(std::atomic<int>) * m_slot_count);
+    for (int i = 0; i <= m_slot_count; ++i) {
+        const Slot &slot = m_slots[i];
+        usage.add(slot.pos).add(slot.vel).add(slot.packed.xy);
+        usage.merge(slot.grid.memory_usage());
+    }
+    return usage;
 }
 
 } // namespace mailbox::render
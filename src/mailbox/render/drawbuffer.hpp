@@ -2,6 +2,7 @@
 
 #include <atomic>
 #include <cstdint>
+#include <memory>
 #include <vector>
 
 #include "types.hpp"
@@ -9,27 +10,44 @@
 namespace mailbox::render {
 
 /**
- * @brief Number of buffer slots for triple buffering
- */
-static constexpr int N_BUFFERS = 3;
-
-/**
- * @brief Thread-safe triple-buffered draw buffer for particle rendering
+ * @brief Thread-safe multi-slot draw buffer for particle rendering
+ *
+ * This class provides a lock-free mailbox for particle data between one
+ * writer (the simulation) and any number of reader threads (renderer,
+ * recorder, external viewers). It manages position data, velocity data, and
+ * grid frame information with atomic operations to ensure thread safety.
  *
- * This class provides a lock-free triple buffering system for particle data
- * that allows concurrent reading and writing between simulation and rendering
- * threads. It manages position data, velocity data, and grid frame information
- * with atomic operations to ensure thread safety.
+ * Readers pin the published previous/current slots with per-slot counters,
+ * so readers never wait for each other, and the writer only writes into
+ * slots that are neither published nor pinned. A reader retries only when a
+ * publish lands between reading the slot pair and pinning it.
  */
 class DrawBuffer {
   public:
+    /**
+     * @brief Slot count of a default-constructed buffer (one reader)
+     */
+    static constexpr int DEFAULT_SLOTS = 5;
+
+    /**
+     * @brief Gets the slot count that always leaves the writer a free slot
+     * @param readers Readers that may hold a view at the same time
+     * @return 2 pinned slots per reader plus the published pair plus one
+     */
+    static constexpr int slots_for_readers(int readers) {
+        return 2 * (readers > 1 ? readers : 1) + 3;
+    }
+
     /**
      * @brief Construct a new DrawBuffer with default initialization
+     * @param slots Number of slots (at least 3, at most 65535)
      *
      * Initializes all buffers and atomic variables to their default state.
-     * The buffer starts with no active slots and is ready for use.
+     * The buffer starts with no active slots and is ready for use. With fewer
+     * slots than slots_for_readers(), a writer that finds every slot pinned
+     * drops the frame instead of waiting (see dropped_frames()).
      */
-    DrawBuffer();
+    explicit DrawBuffer(int slots = DEFAULT_SLOTS);
 
     /**
      * @brief Destructor (default)
@@ -63,6 +81,16 @@ class DrawBuffer {
      */
     std::vector<float> &begin_write_vel(size_t floats_needed);
 
+    /**
+     * @brief Begin writing 16-bit packed positions to the buffer
+     * @return Reference to the packed positions of the acquired write slot
+     *
+     * Fill it with PackedPositions::pack, or clear it when the float stream
+     * from begin_write_pos() carries the positions. Call after
+     * begin_write_pos().
+     */
+    PackedPositions &begin_write_packed();
+
     /**
      * @brief Begin writing grid frame data to the buffer
      * @param cols Number of columns in the grid
@@ -85,7 +113,8 @@ class DrawBuffer {
      *
      * This method atomically updates the buffer pair to make the current
      * write buffer available for reading by other threads. The timestamp
-     * is stored for interpolation purposes.
+     * is stored for interpolation purposes. A frame written into the spare
+     * slot is counted as dropped instead.
      */
     void publish(long long stamp_ns);
 
@@ -113,58 +142,92 @@ class DrawBuffer {
      * @brief Begin reading from the buffer with thread safety
      * @return ReadView containing references to current and previous data
      *
-     * This method acquires a read lock and returns a view containing
-     * both current and previous frame data for interpolation. The caller
-     * must call end_read() when finished to release the lock.
+     * This method pins the published slots and returns a view containing
+     * both current and previous frame data for interpolation. It never waits
+     * for other readers. The caller must call end_read() when finished to
+     * release the pins.
      */
     ReadView begin_read() const;
 
     /**
-     * @brief End reading and release the read lock
+     * @brief End reading and release the pins
      * @param v The ReadView returned by begin_read()
      *
-     * This method releases the read lock acquired by begin_read().
-     * Must be called for each successful begin_read() call to prevent
-     * deadlocks and resource leaks.
+     * This method releases the pins taken by begin_read(). Must be called
+     * for each begin_read() call, otherwise the writer runs out of slots and
+     * drops frames.
      */
     void end_read(const ReadView &v) const;
 
+    /**
+     * @brief Gets the number of slots
+     */
+    int slot_count() const noexcept { return m_slot_count; }
+
+    /**
+     * @brief Gets the frames the writer dropped because every slot was
+     * published or pinned
+     */
+    long long dropped_frames() const noexcept {
+        return m_dropped.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Gets the bytes held by every slot's positions, velocities,
+     * packed positions and grid frame
+     * @return Usage of all slots
+     *
+     * Call from the writing thread: readers never resize a slot, so the
+     * sizes cannot change under it.
+     */
+    particles::utility::MemoryUsage memory_usage() const noexcept;
+
   private:
     /**
      * @brief Acquire an available write index
      * @return Index of the slot to use for writing
      *
-     * This method finds an available buffer slot that is not currently
-     * being read from or used as the current/previous frame. It uses
-     * atomic operations to ensure thread safety.
+     * This method finds a slot that is neither the current/previous frame
+     * nor pinned by a reader. If there is none it returns the spare slot,
+     * which is written but never published.
      */
     int acquire_write_index() const;
 
   private:
     /**
-     * @brief Array of buffer slots for triple buffering
+     * @brief Number of publishable slots
+     */
+    int m_slot_count;
+
+    /**
+     * @brief Buffer slots followed by one spare
+     *
+     * Each slot holds position data, velocity data, grid frame data, and a
+     * timestamp. The spare at index m_slot_count takes the writes of dropped
+     * frames.
+     */
+    std::unique_ptr<Slot[]> m_slots;
+
+    /**
+     * @brief Readers holding each slot
      *
-     * Contains N_BUFFERS slots, each holding position data, velocity data,
-     * grid frame data, and a timestamp.
+     * Incremented by begin_read() for the previous and current slot and
+     * decremented by end_read(). The writer skips slots with pins.
      */
-    Slot m_slots[N_BUFFERS];
+    std::unique_ptr<std::atomic<int>[]> m_pins;
 
     /**
      * @brief Atomic pair tracking current and previous buffer indices
      *
      * Packed representation of (previous_index, current_index) using
-     * the lower 8 bits for current and upper 8 bits for previous.
+     * the lower 16 bits for current and upper 16 bits for previous.
      */
     std::atomic<uint32_t> m_pair;
 
     /**
-     * @brief Atomic bitmask tracking which buffers are currently in use
-     *
-     * Each bit represents whether the corresponding buffer slot is
-     * currently being read from. Used to prevent writing to buffers
-     * that are being read.
+     * @brief Frames written into the spare slot and never published
      */
-    mutable std::atomic<uint8_t> m_in_use;
+    std::atomic<long long> m_dropped{0};
 
     /**
      * @brief Index of the currently acquired write slot
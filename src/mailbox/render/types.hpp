@@ -1,8 +1,13 @@
 #pragma once
 
+#include <algorithm>
 #include <atomic>
+#include <cmath>
+#include <cstdint>
 #include <vector>
 
+#include "../../utility/memory_usage.hpp"
+
 namespace mailbox::render {
 
 struct GridFrame {
@@ -10,30 +15,85 @@ struct GridFrame {
     int cols = 1, rows = 1;
     float width = 0.f, height = 0.f;
 
-    std::vector<int> head;
-    std::vector<int> next;
+    // Cell ci holds particles indices[start[ci] .. start[ci] + count[ci])
+    std::vector<int> start;
     std::vector<int> count;
+    std::vector<int> indices;
 
     std::vector<float> sumVx;
     std::vector<float> sumVy;
 
+    // Force pairs read and pairs inside the radius, summed over the
+    // particles of each cell
+    std::vector<long long> examined;
+    std::vector<long long> accepted;
+
+    // start/count/indices mirror the simulation's CSR cells for this frame
+    bool indexed = false;
+
     void resize(int c, int r, int N) {
         cols = std::max(1, c);
         rows = std::max(1, r);
         const int C = cols * rows;
-        head.assign(C, -1);
+        start.assign(C, 0);
         count.assign(C, 0);
         sumVx.assign(C, 0.f);
         sumVy.assign(C, 0.f);
-        next.assign(N, -1);
+        examined.assign(C, 0);
+        accepted.assign(C, 0);
+        indices.assign(N, -1);
     }
 
     void clear_accum() {
-        std::fill(head.begin(), head.end(), -1);
+        indexed = false;
+        std::fill(start.begin(), start.end(), 0);
         std::fill(count.begin(), count.end(), 0);
         std::fill(sumVx.begin(), sumVx.end(), 0.f);
         std::fill(sumVy.begin(), sumVy.end(), 0.f);
-        std::fill(next.begin(), next.end(), -1);
+        std::fill(examined.begin(), examined.end(), 0);
+        std::fill(accepted.begin(), accepted.end(), 0);
+        std::fill(indices.begin(), indices.end(), -1);
+    }
+
+    particles::utility::MemoryUsage memory_usage() const noexcept {
+        particles::utility::MemoryUsage usage;
+        usage.add(start).add(count).add(indices).add(sumVx).add(sumVy);
+        usage.add(examined).add(accepted);
+        return usage;
+    }
+};
+
+// Positions as 16-bit fixed point relative to the bounds: a quarter of a
+// pixel at 16k wide worlds, half the bytes of the float stream
+struct PackedPositions {
+    static constexpr float STEPS = 65535.f;
+
+    std::vector<uint16_t> xy; // x0, y0, x1, y1, ...
+    float width = 1.f, height = 1.f;
+
+    void pack(const float *px, const float *py, int n, float w, float h) {
+        width = std::max(1.f, w);
+        height = std::max(1.f, h);
+        const float sx = STEPS / width;
+        const float sy = STEPS / height;
+        xy.resize(size_t(n) * 2);
+        for (int i = 0; i < n; ++i) {
+            // Non-finite positions land at 0, like they do in the grid
+            const float qx = std::isfinite(px[i]) ? px[i] * sx + 0.5f : 0.f;
+            const float qy = std::isfinite(py[i]) ? py[i] * sy + 0.5f : 0.f;
+            xy[size_t(i) * 2 + 0] = uint16_t(std::clamp(qx, 0.f, STEPS));
+            xy[size_t(i) * 2 + 1] = uint16_t(std::clamp(qy, 0.f, STEPS));
+        }
+    }
+
+    void unpack(std::vector<float> &out) const {
+        const float sx = width / STEPS;
+        const float sy = height / STEPS;
+        out.resize(xy.size());
+        for (size_t b = 0; b + 1 < xy.size(); b += 2) {
+            out[b + 0] = float(xy[b + 0]) * sx;
+            out[b + 1] = float(xy[b + 1]) * sy;
+        }
     }
 };
 
@@ -41,14 +101,19 @@ struct ReadView {
     const std::vector<float> *prev = nullptr;
     const std::vector<float> *curr = nullptr;
     const std::vector<float> *curr_vel = nullptr;
+    // Non-empty instead of prev/curr when positions were published packed
+    const PackedPositions *prev_packed = nullptr;
+    const PackedPositions *curr_packed = nullptr;
     const GridFrame *grid = nullptr;
     long long t0 = 0, t1 = 0;
-    uint8_t mask = 0;
+    // Slots pinned by DrawBuffer::begin_read (-1 for hand-made views)
+    int prev_slot = -1, curr_slot = -1;
 };
 
 struct Slot {
     std::vector<float> pos;
     std::vector<float> vel;
+    PackedPositions packed;
     GridFrame grid;
     std::atomic<long long> stamp_ns{0};
 };
@@ -0,0 +1,265 @@
+#include "metrics_server.hpp"
+
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "../utility/exceptions.hpp"
+#include "../utility/logger.hpp"
+
+namespace metrics {
+
+namespace {
+
+#ifdef MSG_NOSIGNAL
+constexpr int SEND_FLAGS = MSG_NOSIGNAL;
+#else
+constexpr int SEND_FLAGS = 0;
+#endif
+
+/** @brief Longest request accepted; scrapers send a few hundred bytes */
+constexpr size_t MAX_REQUEST_BYTES = 8192;
+
+std::string errno_message(const std::string &what) {
+    return what + ": " + std::strerror(errno);
+}
+
+/**
+ * @brief Parses a TCP port
+ * @throws ConfigError unless the text is a whole number in [0, 65535]
+ */
+int parse_port(const std::string &text) {
+    size_t used = 0;
+    int port = -1;
+    try {
+        port = std::stoi(text, &used);
+    } catch (const std::exception &) {
+        used = 0;
+    }
+    if (used != text.size() || port < 0 || port > 65535) {
+        throw particles::ConfigError("Invalid metrics address: " + text +
+                                     " (expected a port or unix:<path>)");
+    }
+    return port;
+}
+
+/**
+ * @brief Sends the whole buffer, giving up quietly if the client left
+ */
+void send_all(int fd, const std::string &data) {
+    const char *bytes = data.data();
+    size_t size = data.size();
+    while (size > 0) {
+        const ssize_t sent = ::send(fd, bytes, size, SEND_FLAGS);
+        if (sent < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return;
+        }
+        bytes += sent;
+        size -= (size_t)sent;
+    }
+}
+
+std::string response(const char *status, const char *content_type,
+                     const std::string &body, bool head) {
+    std::string out = std::string("HTTP/1.1 ") + status +
+                      "\r\nContent-Type: " + content_type +
+                      "\r\nContent-Length: " + std::to_string(body.size()) +
+                      "\r\nConnection: close\r\n\r\n";
+    if (!head) {
+        out += body;
+    }
+    return out;
+}
+
+} // namespace
+
+MetricsServer::MetricsServer(const std::string &address, Render render)
+    : m_render(std::move(render)) {
+    const bool unix_socket = address.rfind("unix:", 0) == 0;
+    const int port = unix_socket ? 0 : parse_port(address);
+    if (unix_socket) {
+        m_unix_path = address.substr(5);
+        sockaddr_un probe{};
+        if (m_unix_path.empty() ||
+            m_unix_path.size() >= sizeof(probe.sun_path)) {
+            throw particles::ConfigError("Invalid metrics socket path: " +
+                                         m_unix_path);
+        }
+    }
+
+    m_listen = ::socket(unix_socket ? AF_UNIX : AF_INET, SOCK_STREAM, 0);
+    if (m_listen < 0) {
+        throw particles::IOError(errno_message("Metrics socket"));
+    }
+    ::fcntl(m_listen, F_SETFD, FD_CLOEXEC);
+
+    int bound = -1;
+    if (unix_socket) {
+        // Replace a socket left behind by an earlier run, but nothing else
+        struct stat st {};
+        if (::stat(m_unix_path.c_str(), &st) == 0 && S_ISSOCK(st.st_mode)) {
+            ::unlink(m_unix_path.c_str());
+        }
+        sockaddr_un addr{};
+        addr.sun_family = AF_UNIX;
+        std::strncpy(addr.sun_path, m_unix_path.c_str(),
+                     sizeof(addr.sun_path) - 1);
+        bound = ::bind(m_listen, (const sockaddr *)&addr, sizeof(addr));
+    } else {
+        const int on = 1;
+        ::setsockopt(m_listen, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons((uint16_t)port);
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        bound = ::bind(m_listen, (const sockaddr *)&addr, sizeof(addr));
+    }
+    if (bound != 0 || ::listen(m_listen, 8) != 0) {
+        const std::string message = errno_message("Metrics bind " + address);
+        ::close(m_listen);
+        throw particles::IOError(message);
+    }
+    if (unix_socket) {
+        m_unix_path_bound = true;
+    } else {
+        sockaddr_in addr{};
+        socklen_t len = sizeof(addr);
+        ::getsockname(m_listen, (sockaddr *)&addr, &len);
+        m_port = ntohs(addr.sin_port);
+    }
+
+    if (::pipe(m_wake) != 0) {
+        const std::string message = errno_message("Metrics wake pipe");
+        ::close(m_listen);
+        if (m_unix_path_bound) {
+            ::unlink(m_unix_path.c_str());
+        }
+        throw particles::IOError(message);
+    }
+    m_thread = std::thread(&MetricsServer::serve, this);
+}
+
+MetricsServer::~MetricsServer() {
+    const char stop = 1;
+    while (::write(m_wake[1], &stop, 1) < 0 && errno == EINTR) {
+    }
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+    ::close(m_wake[0]);
+    ::close(m_wake[1]);
+    ::close(m_listen);
+    if (m_unix_path_bound) {
+        ::unlink(m_unix_path.c_str());
+    }
+}
+
+void MetricsServer::serve() {
+    for (;;) {
+        pollfd fds[2] = {{m_listen, POLLIN, 0}, {m_wake[0], POLLIN, 0}};
+        if (::poll(fds, 2, -1) < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            LOG_ERROR(errno_message("Metrics server poll"));
+            return;
+        }
+        if (fds[1].revents != 0) {
+            return;
+        }
+        if ((fds[0].revents & POLLIN) == 0) {
+            continue;
+        }
+
+        const int client = ::accept(m_listen, nullptr, nullptr);
+        if (client < 0) {
+            continue;
+        }
+#ifdef SO_NOSIGPIPE
+        const int on = 1;
+        ::setsockopt(client, SOL_SOCKET, SO_NOSIGPIPE, &on, sizeof(on));
+#endif
+        try {
+            handle(client);
+        } catch (const std::exception &e) {
+            LOG_WARN("Metrics request failed: " + std::string(e.what()));
+        }
+        ::close(client);
+    }
+}
+
+void MetricsServer::handle(int fd) {
+    using namespace std::chrono;
+    const auto deadline =
+        steady_clock::now() + milliseconds(CLIENT_TIMEOUT_MS);
+
+    // Only the request line matters; read until the end of the headers
+    std::string request;
+    char buffer[1024];
+    while (request.find("\r\n\r\n") == std::string::npos &&
+           request.size() < MAX_REQUEST_BYTES) {
+        const auto left =
+            duration_cast<milliseconds>(deadline - steady_clock::now());
+        if (left.count() <= 0) {
+            return;
+        }
+        pollfd pfd{fd, POLLIN, 0};
+        const int ready = ::poll(&pfd, 1, (int)left.count());
+        if (ready < 0 && errno == EINTR) {
+            continue;
+        }
+        if (ready <= 0) {
+            return;
+        }
+        const ssize_t got = ::recv(fd, buffer, sizeof(buffer), 0);
+        if (got < 0 && errno == EINTR) {
+            continue;
+        }
+        if (got <= 0) {
+            return;
+        }
+        request.append(buffer, (size_t)got);
+    }
+
+    const size_t method_end = request.find(' ');
+    const size_t path_end = method_end == std::string::npos
+                                ? std::string::npos
+                                : request.find(' ', method_end + 1);
+    if (path_end == std::string::npos) {
+        send_all(fd, response("400 Bad Request", "text/plain",
+                              "Bad request\n", false));
+        return;
+    }
+    const std::string method = request.substr(0, method_end);
+    std::string path =
+        request.substr(method_end + 1, path_end - method_end - 1);
+    path = path.substr(0, path.find('?'));
+
+    const bool head = method == "HEAD";
+    if (method != "GET" && !head) {
+        send_all(fd, response("405 Method Not Allowed", "text/plain",
+                              "Only GET is supported\n", false));
+    } else if (path != "/metrics") {
+        send_all(fd, response("404 Not Found", "text/plain",
+                              "Metrics are served at /metrics\n", head));
+    } else {
+        const std::string body = m_render(m_scrapes.fetch_add(1) + 1);
+        send_all(fd, response("200 OK",
+                              "text/plain; version=0.0.4; charset=utf-8",
+                              body, head));
+    }
+}
+
+} // namespace metrics
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <string>
+#include <thread>
+
+namespace metrics {
+
+/**
+ * @brief Serves a metrics document over HTTP from its own thread
+ *
+ * Listens on 127.0.0.1 or on a Unix socket and answers GET /metrics with
+ * whatever the render callback returns. The callback runs on the server
+ * thread, so it must only read lock-free snapshots (e.g.
+ * Simulation::get_stats) to leave the simulation's timing alone. Clients are
+ * served one at a time with short timeouts; a slow scraper only delays other
+ * scrapers.
+ */
+class MetricsServer {
+  public:
+    /**
+     * @brief Builds the response body; the argument is the scrape number
+     */
+    using Render = std::function<std::string(long long)>;
+
+    /** @brief Longest a client may take to send its request */
+    static constexpr int CLIENT_TIMEOUT_MS = 1000;
+
+    /**
+     * @brief Binds the address and starts the server thread
+     * @param address TCP port on 127.0.0.1 (e.g. "9464"; "0" picks a free
+     * one), or "unix:<path>" for a Unix socket
+     * @param render Callback producing the metrics document
+     * @throws ConfigError if the address cannot be parsed
+     * @throws IOError if the socket cannot be bound
+     */
+    MetricsServer(const std::string &address, Render render);
+    ~MetricsServer();
+    MetricsServer(const MetricsServer &) = delete;
+    MetricsServer &operator=(const MetricsServer &) = delete;
+    MetricsServer(MetricsServer &&) = delete;
+    MetricsServer &operator=(MetricsServer &&) = delete;
+
+    /**
+     * @brief Gets the bound TCP port (0 for a Unix socket)
+     */
+    int port() const noexcept { return m_port; }
+
+    /**
+     * @brief Gets the number of /metrics requests served
+     */
+    long long scrapes() const noexcept { return m_scrapes.load(); }
+
+  private:
+    /**
+     * @brief Accepts and serves clients until the destructor wakes it
+     */
+    void serve();
+
+    /**
+     * @brief Reads one request and writes the response
+     * @param fd Connected client socket
+     */
+    void handle(int fd);
+
+    Render m_render;
+    std::string m_unix_path;
+    bool m_unix_path_bound = false; // Unlinked again on destruction
+    int m_listen = -1;
+    int m_wake[2] = {-1, -1};
+    int m_port = 0;
+    std::atomic<long long> m_scrapes{0};
+    std::thread m_thread;
+};
+
+} // namespace metrics
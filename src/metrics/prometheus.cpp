@@ -0,0 +1,137 @@
+#include "prometheus.hpp"
+
+#include <cstdio>
+#include <utility>
+
+namespace metrics {
+
+namespace {
+
+/**
+ * @brief Appends metric families in the text exposition format
+ */
+class Writer {
+  public:
+    /**
+     * @brief Starts a family with its HELP and TYPE lines
+     */
+    Writer &family(const char *name, const char *type, const char *help) {
+        m_name = name;
+        m_out += "# HELP ";
+        m_out += name;
+        m_out += ' ';
+        m_out += help;
+        m_out += "\n# TYPE ";
+        m_out += name;
+        m_out += ' ';
+        m_out += type;
+        m_out += '\n';
+        return *this;
+    }
+
+    /**
+     * @brief Appends a sample of the current family
+     * @param labels Label set without braces (e.g. quantile="0.5"), or ""
+     */
+    Writer &sample(double value, const std::string &labels = "") {
+        char number[32];
+        std::snprintf(number, sizeof(number), "%.9g", value);
+        m_out += m_name;
+        if (!labels.empty()) {
+            m_out += '{';
+            m_out += labels;
+            m_out += '}';
+        }
+        m_out += ' ';
+        m_out += number;
+        m_out += '\n';
+        return *this;
+    }
+
+    /**
+     * @brief Appends the quantiles of a latency summary, in seconds
+     */
+    Writer &latency(const mailbox::LatencySummary &summary) {
+        const std::pair<const char *, long long> quantiles[] = {
+            {"0.5", summary.p50_ns},
+            {"0.95", summary.p95_ns},
+            {"0.99", summary.p99_ns},
+            {"1", summary.max_ns}};
+        for (const auto &[quantile, ns] : quantiles) {
+            sample(ns * 1e-9, std::string("quantile=\"") + quantile + "\"");
+        }
+        return *this;
+    }
+
+    std::string take() { return std::move(m_out); }
+
+  private:
+    std::string m_out;
+    const char *m_name = "";
+};
+
+} // namespace
+
+std::string prometheus_text(const mailbox::SimulationStatsSnapshot &stats,
+                            const mailbox::MemorySnapshot &memory,
+                            long long now_ns, long long scrapes) {
+    Writer w;
+    w.family("particles_tps", "gauge",
+             "Steps per second, averaged over the last second")
+        .sample(stats.effective_tps);
+    w.family("particles_steps_total", "counter",
+             "Steps since the world was last seeded or reset")
+        .sample((double)stats.num_steps);
+    w.family("particles_last_step_seconds", "gauge",
+             "Duration of the latest step")
+        .sample(stats.last_step_ns * 1e-9);
+    w.family("particles_step_seconds", "gauge",
+             "Step duration quantiles since the step counter was reset")
+        .latency(stats.step_latency);
+    w.family("particles_step_samples", "gauge",
+             "Steps behind the step duration quantiles")
+        .sample((double)stats.step_latency.samples);
+    w.family("particles_oversleep_seconds", "gauge",
+             "How far the frame limiter slept past its deadline")
+        .latency(stats.oversleep);
+    w.family("particles_missed_deadlines_total", "counter",
+             "Steps that overran 1 / target TPS")
+        .sample((double)stats.missed_deadlines);
+    w.family("particles_particles", "gauge", "Particles in the world")
+        .sample(stats.particles);
+    w.family("particles_groups", "gauge", "Particle groups in the world")
+        .sample(stats.groups);
+    w.family("particles_sim_threads", "gauge", "Simulation worker threads")
+        .sample(stats.sim_threads);
+    w.family("particles_stats_age_seconds", "gauge",
+             "Time since the simulation last published its stats")
+        .sample(stats.published_ns > 0 ? (now_ns - stats.published_ns) * 1e-9
+                                       : 0.0);
+
+    const std::pair<const char *, const mailbox::MemorySnapshot::Usage *>
+        parts[] = {{"world", &memory.world},
+                   {"grid_csr", &memory.grid_csr},
+                   {"stepper", &memory.stepper},
+                   {"draw_buffer", &memory.draw_buffer},
+                   {"snapshots", &memory.snapshots},
+                   {"commands", &memory.commands}};
+    w.family("particles_memory_used_bytes", "gauge",
+             "Bytes in use per subsystem");
+    for (const auto &[name, usage] : parts) {
+        w.sample((double)usage->used_bytes,
+                 std::string("subsystem=\"") + name + "\"");
+    }
+    w.family("particles_memory_reserved_bytes", "gauge",
+             "Bytes allocated per subsystem");
+    for (const auto &[name, usage] : parts) {
+        w.sample((double)usage->reserved_bytes,
+                 std::string("subsystem=\"") + name + "\"");
+    }
+
+    w.family("particles_metrics_scrapes_total", "counter",
+             "Metrics requests served")
+        .sample((double)scrapes);
+    return w.take();
+}
+
+} // namespace metrics
@@ -0,0 +1,21 @@
+#pragma once
+
+#include <string>
+
+#include "../mailbox/data_snapshot.hpp"
+
+namespace metrics {
+
+/**
+ * @brief Formats simulation snapshots in the Prometheus text format
+ * @param stats Latest stats snapshot
+ * @param memory Latest memory report
+ * @param now_ns Current steady-clock time, for the age of the stats
+ * @param scrapes Requests served so far, including this one
+ * @return One exposition document (version 0.0.4)
+ */
+std::string prometheus_text(const mailbox::SimulationStatsSnapshot &stats,
+                            const mailbox::MemorySnapshot &memory,
+                            long long now_ns, long long scrapes);
+
+} // namespace metrics
@@ -0,0 +1,58 @@
+#include "density_splat.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+void DensitySplat::build(const ParticleBatch &batch,
+                         const mailbox::WorldSnapshot &world_snapshot,
+                         int width, int height, float coverage) {
+    m_width = std::max(0, width);
+    m_height = std::max(0, height);
+    const size_t pixel_count = (size_t)m_width * m_height;
+    m_count.assign(pixel_count, 0);
+    m_sum.assign(pixel_count * 3, 0);
+    m_pixels.resize(pixel_count * 4);
+    update_alpha_lut(coverage);
+
+    const float *pos = batch.screen_positions().data();
+    for (const auto &span : batch.spans()) {
+        const Color c = world_snapshot.get_group_color(span.group);
+        for (int k = span.begin; k < span.end; ++k) {
+            const int x = (int)pos[(size_t)k * 2 + 0];
+            const int y = (int)pos[(size_t)k * 2 + 1];
+            if (x < 0 || y < 0 || x >= m_width || y >= m_height) {
+                continue;
+            }
+            const size_t p = (size_t)y * m_width + x;
+            m_count[p] += 1;
+            m_sum[p * 3 + 0] += c.r;
+            m_sum[p * 3 + 1] += c.g;
+            m_sum[p * 3 + 2] += c.b;
+        }
+    }
+
+    for (size_t p = 0; p < pixel_count; ++p) {
+        const uint32_t n = m_count[p];
+        uint8_t *out = m_pixels.data() + p * 4;
+        if (n == 0) {
+            out[0] = out[1] = out[2] = out[3] = 0;
+            continue;
+        }
+        out[0] = (uint8_t)(m_sum[p * 3 + 0] / n);
+        out[1] = (uint8_t)(m_sum[p * 3 + 1] / n);
+        out[2] = (uint8_t)(m_sum[p * 3 + 2] / n);
+        out[3] = m_alpha_lut[std::min<uint32_t>(n, ALPHA_LUT_SIZE - 1)];
+    }
+}
+
+void DensitySplat::update_alpha_lut(float coverage) {
+    coverage = std::clamp(coverage, 0.f, 1.f);
+    if (coverage == m_lut_coverage) {
+        return;
+    }
+    m_lut_coverage = coverage;
+    for (int n = 0; n < ALPHA_LUT_SIZE; ++n) {
+        const float covered = 1.f - std::pow(1.f - coverage, (float)n);
+        m_alpha_lut[n] = (uint8_t)std::lrint(255.f * covered);
+    }
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "../mailbox/data_snapshot.hpp"
+#include "particle_batch.hpp"
+
+/**
+ * @brief Level-of-detail image for views with many particles per pixel
+ *
+ * When zoomed far out, thousands of particles land on the same pixel and
+ * drawing a quad for each one is wasted fill rate. Instead each visible
+ * particle adds its group color to the pixel it lands on, and the result is
+ * resolved into an RGBA image (mean color, alpha from the particle count)
+ * that the renderer uploads and draws as a single texture.
+ */
+class DensitySplat {
+  public:
+    DensitySplat() = default;
+    ~DensitySplat() = default;
+    DensitySplat(const DensitySplat &) = delete;
+    DensitySplat(DensitySplat &&) = delete;
+    DensitySplat &operator=(const DensitySplat &) = delete;
+    DensitySplat &operator=(DensitySplat &&) = delete;
+
+    /**
+     * @brief Splats the batch's visible particles into the image
+     * @param batch Batch with screen positions and group spans for this frame
+     * @param world_snapshot World snapshot with group colors
+     * @param width Image width in pixels (matches the render target)
+     * @param height Image height in pixels
+     * @param coverage Fraction of a pixel covered by a single particle
+     * (clamped 0..1); n particles cover 1 - (1 - coverage)^n of the pixel
+     */
+    void build(const ParticleBatch &batch,
+               const mailbox::WorldSnapshot &world_snapshot, int width,
+               int height, float coverage);
+
+    /**
+     * @brief Gets the resolved RGBA8 pixels (row-major, top row first)
+     * @return Pixel data, width * height * 4 bytes
+     */
+    const std::vector<uint8_t> &pixels() const noexcept { return m_pixels; }
+
+    int width() const noexcept { return m_width; }
+    int height() const noexcept { return m_height; }
+
+  private:
+    /** @brief Maximum particle count with a distinct alpha; more saturates */
+    static constexpr int ALPHA_LUT_SIZE = 256;
+
+    /**
+     * @brief Rebuilds the count-to-alpha table when the coverage changes
+     * @param coverage Single particle pixel coverage (0..1)
+     */
+    void update_alpha_lut(float coverage);
+
+  private:
+    int m_width = 0;
+    int m_height = 0;
+    /** @brief Particles per pixel */
+    std::vector<uint32_t> m_count;
+    /** @brief Summed group RGB per pixel */
+    std::vector<uint32_t> m_sum;
+    /** @brief Resolved RGBA8 image */
+    std::vector<uint8_t> m_pixels;
+    /** @brief Alpha by particle count */
+    uint8_t m_alpha_lut[ALPHA_LUT_SIZE] = {};
+    float m_lut_coverage = -1.f;
+};
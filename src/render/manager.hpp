@@ -8,6 +8,7 @@
 
 #include "irenderer.hpp"
 #include "particles_renderer.hpp"
+#include "position_decoder.hpp"
 #include "types/context.hpp"
 #include "types/window.hpp"
 #include "ui/history_ui.hpp"
@@ -63,6 +64,7 @@ class RenderManager {
     bool draw_frame(Simulation &sim, Config &rcfg, SaveManager &save_manager,
                     UndoManager &undo_manager) {
         auto view = sim.begin_read_draw();
+        m_positions.decode(view);
         auto world_snapshot = sim.get_world_snapshot();
 
         bool can_interpolate = rcfg.interpolate && view.t0 > 0 && view.t1 > 0 &&
@@ -139,6 +141,7 @@ class RenderManager {
   private:
     WindowConfig m_wcfg;
     ParticlesRenderer m_particles;
+    PositionDecoder m_positions;
     InspectorUI m_inspector{};
     MenuBarUI m_menu_bar;
     ParticleEditorUI m_editor;
@@ -0,0 +1,285 @@
+#include "particle_batch.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#include "../utility/math.hpp"
+
+#if defined(USE_X86_SSE) && defined(ARCH_X64) &&                               \
+    (defined(PLATFORM_WINDOWS) || defined(PLATFORM_MACOS) ||                   \
+     defined(PLATFORM_LINUX))
+#define PARTICLE_BATCH_SSE
+#elif defined(__ARM_NEON) && defined(ARCH_ARM64) &&                            \
+    (defined(PLATFORM_MACOS) || defined(PLATFORM_LINUX))
+#define PARTICLE_BATCH_NEON
+#endif
+
+namespace {
+
+inline unsigned char tint_channel(unsigned char c, float k) {
+    long v = std::lrint(c * k);
+    return (unsigned char)(v < 0 ? 0 : (v > 255 ? 255 : v));
+}
+
+} // namespace
+
+void ParticleBatch::build_positions(
+    const mailbox::WorldSnapshot &world_snapshot,
+    const std::vector<float> *prev, const std::vector<float> &curr,
+    float alpha, const Transform &transform) {
+    const int particles = std::min(world_snapshot.get_particles_size(),
+                                   (int)(curr.size() / 2));
+    const float *p1 = curr.data();
+    const float *p0 = p1;
+    if (prev && prev->size() == curr.size()) {
+        p0 = prev->data();
+    } else {
+        alpha = 1.f;
+    }
+    alpha = std::clamp(alpha, 0.f, 1.f);
+
+    // Sized for the worst case and trimmed afterwards so appends are plain
+    // pointer writes
+    m_screen.resize((size_t)std::max(0, particles) * 2);
+    m_spans.clear();
+
+    int written = 0;
+    const int groups = world_snapshot.get_groups_size();
+    for (int g = 0; g < groups; ++g) {
+        if (!world_snapshot.is_group_enabled(g)) {
+            continue;
+        }
+        const int begin = std::max(0, world_snapshot.get_group_start(g));
+        const int end = std::min(particles, world_snapshot.get_group_end(g));
+        if (begin >= end) {
+            continue;
+        }
+        // append_range advances the span end as it writes positions
+        m_spans.push_back({g, written, written});
+        append_range(p0, p1, begin, end, alpha, transform);
+        written = m_spans.back().end;
+        if (m_spans.back().begin == written) {
+            m_spans.pop_back();
+        }
+    }
+
+    m_screen.resize((size_t)written * 2);
+}
+
+bool ParticleBatch::build_positions_culled(
+    const mailbox::WorldSnapshot &world_snapshot,
+    const std::vector<float> *prev, const std::vector<float> &curr,
+    float alpha, const Transform &transform,
+    const mailbox::render::GridFrame &grid, const ViewRect &view) {
+    const int particles = std::min(world_snapshot.get_particles_size(),
+                                   (int)(curr.size() / 2));
+    const int cells = grid.cols * grid.rows;
+    // The grid must describe exactly the particles being drawn
+    if (!grid.indexed || grid.cell <= 0.f || (int)grid.start.size() != cells ||
+        (int)grid.count.size() != cells ||
+        (int)grid.indices.size() != particles) {
+        build_positions(world_snapshot, prev, curr, alpha, transform);
+        return false;
+    }
+
+    m_screen.clear();
+    m_spans.clear();
+    if (view.x1 < 0.f || view.y1 < 0.f || view.x0 >= grid.width ||
+        view.y0 >= grid.height || view.x1 < view.x0 || view.y1 < view.y0) {
+        return true;
+    }
+
+    const float inv_cell = 1.f / grid.cell;
+    const int c0 = std::clamp((int)std::floor(view.x0 * inv_cell), 0,
+                              grid.cols - 1);
+    const int c1 = std::clamp((int)std::floor(view.x1 * inv_cell), 0,
+                              grid.cols - 1);
+    const int r0 = std::clamp((int)std::floor(view.y0 * inv_cell), 0,
+                              grid.rows - 1);
+    const int r1 = std::clamp((int)std::floor(view.y1 * inv_cell), 0,
+                              grid.rows - 1);
+
+    // Gathering cells is slower per particle than the linear SIMD pass,
+    // so it only pays off when a good part of the world is off screen
+    const long long visible_cells = (long long)(c1 - c0 + 1) * (r1 - r0 + 1);
+    if (visible_cells * 2 > (long long)cells) {
+        build_positions(world_snapshot, prev, curr, alpha, transform);
+        return false;
+    }
+
+    const float *p1 = curr.data();
+    const float *p0 = p1;
+    if (prev && prev->size() == curr.size()) {
+        p0 = prev->data();
+    } else {
+        alpha = 1.f;
+    }
+    alpha = std::clamp(alpha, 0.f, 1.f);
+
+    m_indices.clear();
+    for (int r = r0; r <= r1; ++r) {
+        for (int c = c0; c <= c1; ++c) {
+            const size_t ci = (size_t)r * grid.cols + c;
+            const auto first = grid.indices.begin() + grid.start[ci];
+            m_indices.insert(m_indices.end(), first, first + grid.count[ci]);
+        }
+    }
+    // Index order restores group order and keeps the position reads mostly
+    // sequential
+    std::sort(m_indices.begin(), m_indices.end());
+    m_screen.resize(m_indices.size() * 2);
+    const int *indices_begin = m_indices.data();
+    const int *indices_end = indices_begin + m_indices.size();
+
+    int written = 0;
+    const int groups = world_snapshot.get_groups_size();
+    for (int g = 0; g < groups; ++g) {
+        if (!world_snapshot.is_group_enabled(g)) {
+            continue;
+        }
+        const int begin = std::max(0, world_snapshot.get_group_start(g));
+        const int end = std::min(particles, world_snapshot.get_group_end(g));
+        if (begin >= end) {
+            continue;
+        }
+        const int *first = std::lower_bound(indices_begin, indices_end, begin);
+        const int *last = std::lower_bound(first, indices_end, end);
+        if (first == last) {
+            continue;
+        }
+        m_spans.push_back({g, written, written});
+        append_indices(p0, p1, first, last, alpha, transform);
+        written = m_spans.back().end;
+        if (m_spans.back().begin == written) {
+            m_spans.pop_back();
+        }
+    }
+
+    m_screen.resize((size_t)written * 2);
+    return true;
+}
+
+void ParticleBatch::append_range(const float *p0, const float *p1, int begin,
+                                 int end, float alpha,
+                                 const Transform &transform) {
+    GroupSpan &span = m_spans.back();
+    float *out = m_screen.data() + (size_t)span.end * 2;
+    const float max_x = transform.bounds_w - 1;
+    const float max_y = transform.bounds_h - 1;
+
+    int i = begin;
+#if defined(PARTICLE_BATCH_SSE)
+    // Two particles (x0, y0, x1, y1) per vector
+    const __m128 va = _mm_set1_ps(alpha);
+    const __m128 vzoom = _mm_set1_ps(transform.zoom);
+    const __m128 voff =
+        _mm_setr_ps(transform.ox, transform.oy, transform.ox, transform.oy);
+    const __m128 vmax = _mm_setr_ps(max_x, max_y, max_x, max_y);
+    const __m128 vzero = _mm_setzero_ps();
+    for (; i + 2 <= end; i += 2) {
+        const __m128 a = _mm_loadu_ps(p0 + (size_t)i * 2);
+        const __m128 b = _mm_loadu_ps(p1 + (size_t)i * 2);
+        const __m128 p = _mm_add_ps(a, _mm_mul_ps(_mm_sub_ps(b, a), va));
+        const __m128 inside =
+            _mm_and_ps(_mm_cmpge_ps(p, vzero), _mm_cmplt_ps(p, vmax));
+        const int mask = _mm_movemask_ps(inside);
+        const __m128 s = _mm_add_ps(_mm_mul_ps(p, vzoom), voff);
+        alignas(16) float tmp[4];
+        _mm_store_ps(tmp, s);
+        if ((mask & 0x3) == 0x3) {
+            *out++ = tmp[0];
+            *out++ = tmp[1];
+        }
+        if ((mask & 0xC) == 0xC) {
+            *out++ = tmp[2];
+            *out++ = tmp[3];
+        }
+    }
+#elif defined(PARTICLE_BATCH_NEON)
+    const float32x4_t vzoom = vdupq_n_f32(transform.zoom);
+    const float off_arr[4] = {transform.ox, transform.oy, transform.ox,
+                              transform.oy};
+    const float max_arr[4] = {max_x, max_y, max_x, max_y};
+    const float32x4_t voff = vld1q_f32(off_arr);
+    const float32x4_t vmax = vld1q_f32(max_arr);
+    const float32x4_t vzero = vdupq_n_f32(0.f);
+    for (; i + 2 <= end; i += 2) {
+        const float32x4_t a = vld1q_f32(p0 + (size_t)i * 2);
+        const float32x4_t b = vld1q_f32(p1 + (size_t)i * 2);
+        const float32x4_t p = vmlaq_n_f32(a, vsubq_f32(b, a), alpha);
+        const uint32x4_t inside =
+            vandq_u32(vcgeq_f32(p, vzero), vcltq_f32(p, vmax));
+        const float32x4_t s = vmlaq_f32(voff, p, vzoom);
+        float tmp[4];
+        vst1q_f32(tmp, s);
+        if (vgetq_lane_u32(inside, 0) && vgetq_lane_u32(inside, 1)) {
+            *out++ = tmp[0];
+            *out++ = tmp[1];
+        }
+        if (vgetq_lane_u32(inside, 2) && vgetq_lane_u32(inside, 3)) {
+            *out++ = tmp[2];
+            *out++ = tmp[3];
+        }
+    }
+#endif
+    for (; i < end; ++i) {
+        const float ax = p0[(size_t)i * 2 + 0], ay = p0[(size_t)i * 2 + 1];
+        const float x = ax + (p1[(size_t)i * 2 + 0] - ax) * alpha;
+        const float y = ay + (p1[(size_t)i * 2 + 1] - ay) * alpha;
+        if (x < 0 || y < 0 || x >= max_x || y >= max_y) {
+            continue;
+        }
+        *out++ = x * transform.zoom + transform.ox;
+        *out++ = y * transform.zoom + transform.oy;
+    }
+
+    span.end = (int)((out - m_screen.data()) / 2);
+}
+
+void ParticleBatch::append_indices(const float *p0, const float *p1,
+                                   const int *first, const int *last,
+                                   float alpha, const Transform &transform) {
+    GroupSpan &span = m_spans.back();
+    float *out = m_screen.data() + (size_t)span.end * 2;
+    const float max_x = transform.bounds_w - 1;
+    const float max_y = transform.bounds_h - 1;
+
+    for (; first != last; ++first) {
+        const size_t b = (size_t)*first * 2;
+        const float x = p0[b + 0] + (p1[b + 0] - p0[b + 0]) * alpha;
+        const float y = p0[b + 1] + (p1[b + 1] - p0[b + 1]) * alpha;
+        if (x < 0 || y < 0 || x >= max_x || y >= max_y) {
+            continue;
+        }
+        *out++ = x * transform.zoom + transform.ox;
+        *out++ = y * transform.zoom + transform.oy;
+    }
+
+    span.end = (int)((out - m_screen.data()) / 2);
+}
+
+void ParticleBatch::build_quads(const mailbox::WorldSnapshot &world_snapshot,
+                                float half_size, std::optional<float> rgb_gain,
+                                std::vector<ParticleVertex> &out) const {
+    out.resize((size_t)visible_count() * 4);
+    ParticleVertex *v = out.data();
+    const float *pos = m_screen.data();
+    const float s = half_size;
+
+    for (const auto &span : m_spans) {
+        Color c = world_snapshot.get_group_color(span.group);
+        if (rgb_gain.has_value()) {
+            c = {tint_channel(c.r, *rgb_gain), tint_channel(c.g, *rgb_gain),
+                 tint_channel(c.b, *rgb_gain), 255};
+        }
+        for (int k = span.begin; k < span.end; ++k) {
+            const float x = pos[(size_t)k * 2 + 0];
+            const float y = pos[(size_t)k * 2 + 1];
+            v[0] = {x - s, y - s, 0.f, 0.f, c.r, c.g, c.b, c.a};
+            v[1] = {x - s, y + s, 0.f, 1.f, c.r, c.g, c.b, c.a};
+            v[2] = {x + s, y + s, 1.f, 1.f, c.r, c.g, c.b, c.a};
+            v[3] = {x + s, y - s, 1.f, 0.f, c.r, c.g, c.b, c.a};
+            v += 4;
+        }
+    }
+}
@@ -5,6 +5,7 @@
 
 #include <raylib.h>
 #include <raymath.h>
+#include <rlgl.h>
 
 ParticlesRenderer::ParticlesRenderer(const WindowConfig &wcfg)
     : m_wcfg(wcfg),
@@ -15,6 +16,12 @@ ParticlesRenderer::~ParticlesRenderer() {
     if (m_glow_tex_initialized) {
         UnloadTexture(m_glow_tex);
     }
+    if (m_disc_tex_initialized) {
+        UnloadTexture(m_disc_tex);
+    }
+    if (m_lod_tex_initialized) {
+        UnloadTexture(m_lod_tex);
+    }
 }
 
 void ParticlesRenderer::resize(const WindowConfig &wcfg) {
@@ -72,71 +79,149 @@ void ParticlesRenderer::render_particles(
     const Context &ctx, const CameraTransform &transform) const {
     auto &rcfg = ctx.rcfg;
     auto &view = ctx.view;
-    const int group_size = ctx.world_snapshot.get_groups_size();
     const float core_size = rcfg.core_size;
 
-    Texture2D glow{};
-    float outer_glow_scale = 0.f, inner_glow_scale = 0.f;
+    if (!view.curr) {
+        return;
+    }
+
+    // Interpolate and transform every visible particle once; each pass below
+    // only expands the shared positions into quads
+    build_visible_positions(ctx, transform);
+    if (m_batch.visible_count() == 0) {
+        return;
+    }
+
+    if (use_density_lod(ctx, transform)) {
+        draw_density_lod(ctx);
+        return;
+    }
+
     if (rcfg.glow_enabled) {
-        glow = get_glow_tex();
-        outer_glow_scale = core_size * rcfg.outer_scale_mul;
-        inner_glow_scale = core_size * rcfg.inner_scale_mul;
+        Texture2D glow = get_glow_tex();
+        BeginBlendMode(BLEND_ALPHA);
+        m_batch.build_quads(ctx.world_snapshot,
+                            core_size * rcfg.outer_scale_mul,
+                            rcfg.outer_rgb_gain, m_vertices);
+        submit_quads(m_vertices, glow);
+        m_batch.build_quads(ctx.world_snapshot,
+                            core_size * rcfg.inner_scale_mul,
+                            rcfg.inner_rgb_gain, m_vertices);
+        submit_quads(m_vertices, glow);
+        EndBlendMode();
     }
 
-    if (ctx.can_interpolate) {
-        const auto &pos0 = *view.prev;
-        const auto &pos1 = *view.curr;
-        const float interpolation_alpha =
-            std::clamp(ctx.interp_alpha, 0.0f, 1.0f);
-        auto posAt = [&](int particle_index) -> Vector2 {
-            size_t position_base_index = (size_t)particle_index * 2;
-            if (position_base_index + 1 >= pos1.size()) {
-                return {0, 0};
-            }
-            float interpolated_x = pos0[position_base_index + 0] +
-                                   (pos1[position_base_index + 0] -
-                                    pos0[position_base_index + 0]) *
-                                       interpolation_alpha;
-            float interpolated_y = pos0[position_base_index + 1] +
-                                   (pos1[position_base_index + 1] -
-                                    pos0[position_base_index + 1]) *
-                                       interpolation_alpha;
-            return {interpolated_x, interpolated_y};
-        };
-        if (rcfg.glow_enabled) {
-            draw_particles_with_glow_camera(
-                ctx.world_snapshot, group_size, posAt, glow, core_size,
-                outer_glow_scale, rcfg.outer_rgb_gain, inner_glow_scale,
-                rcfg.inner_rgb_gain, transform.ox_cam, transform.oy_cam,
-                transform.bounds_w, transform.bounds_h, transform.zoom);
-        } else {
-            draw_particles_simple_camera(ctx.world_snapshot, group_size, posAt,
-                                         core_size, transform.ox_cam,
-                                         transform.oy_cam, transform.bounds_w,
-                                         transform.bounds_h, transform.zoom);
-        }
-    } else {
-        const auto &pos = *view.curr;
-        auto posAt = [&](int particle_index) -> Vector2 {
-            size_t position_base_index = (size_t)particle_index * 2;
-            if (position_base_index + 1 >= pos.size()) {
-                return {0, 0};
-            }
-            return {pos[position_base_index + 0], pos[position_base_index + 1]};
-        };
-        if (rcfg.glow_enabled) {
-            draw_particles_with_glow_camera(
-                ctx.world_snapshot, group_size, posAt, glow, core_size,
-                outer_glow_scale, rcfg.outer_rgb_gain, inner_glow_scale,
-                rcfg.inner_rgb_gain, transform.ox_cam, transform.oy_cam,
-                transform.bounds_w, transform.bounds_h, transform.zoom);
-        } else {
-            draw_particles_simple_camera(ctx.world_snapshot, group_size, posAt,
-                                         core_size, transform.ox_cam,
-                                         transform.oy_cam, transform.bounds_w,
-                                         transform.bounds_h, transform.zoom);
+    m_batch.build_quads(ctx.world_snapshot, core_size, std::nullopt,
+                        m_vertices);
+    submit_quads(m_vertices, get_disc_tex());
+}
+
+void ParticlesRenderer::build_visible_positions(
+    const Context &ctx, const CameraTransform &transform) const {
+    auto &rcfg = ctx.rcfg;
+    auto &view = ctx.view;
+    const float interpolation_alpha =
+        ctx.can_interpolate ? std::clamp(ctx.interp_alpha, 0.0f, 1.0f) : 1.0f;
+    const std::vector<float> *prev = ctx.can_interpolate ? view.prev : nullptr;
+    const ParticleBatch::Transform batch_transform{
+        transform.ox_cam, transform.oy_cam, transform.zoom, transform.bounds_w,
+        transform.bounds_h};
+
+    if (!rcfg.cull_cells || !view.grid || transform.zoom <= 0.f) {
+        m_batch.build_positions(ctx.world_snapshot, prev, *view.curr,
+                                interpolation_alpha, batch_transform);
+        return;
+    }
+
+    // Render target in world space, padded by the largest quad and one cell:
+    // the grid was built before the last integration step and interpolation
+    // may place a particle outside the cell it was binned into
+    float quad_half_size = rcfg.core_size;
+    if (rcfg.glow_enabled) {
+        quad_half_size *= std::max(
+            {1.0f, rcfg.outer_scale_mul, rcfg.inner_scale_mul});
+    }
+    const float inv_zoom = 1.0f / transform.zoom;
+    const float margin = quad_half_size * inv_zoom + view.grid->cell;
+    const ParticleBatch::ViewRect world_view{
+        (0.0f - transform.ox_cam) * inv_zoom - margin,
+        (0.0f - transform.oy_cam) * inv_zoom - margin,
+        ((float)m_rt.texture.width - transform.ox_cam) * inv_zoom + margin,
+        ((float)m_rt.texture.height - transform.oy_cam) * inv_zoom + margin};
+    m_batch.build_positions_culled(ctx.world_snapshot, prev, *view.curr,
+                                   interpolation_alpha, batch_transform,
+                                   *view.grid, world_view);
+}
+
+bool ParticlesRenderer::use_density_lod(
+    const Context &ctx, const CameraTransform &transform) const {
+    auto &rcfg = ctx.rcfg;
+    if (!rcfg.density_lod) {
+        return false;
+    }
+
+    // Screen area of the simulation bounds that is inside the render target
+    const float left = std::max(0.0f, transform.ox_cam);
+    const float top = std::max(0.0f, transform.oy_cam);
+    const float right =
+        std::min((float)m_rt.texture.width,
+                 transform.ox_cam + transform.bounds_w * transform.zoom);
+    const float bottom =
+        std::min((float)m_rt.texture.height,
+                 transform.oy_cam + transform.bounds_h * transform.zoom);
+    const float visible_area =
+        std::max(0.0f, right - left) * std::max(0.0f, bottom - top);
+
+    return visible_area <
+           rcfg.lod_px_per_particle * (float)m_batch.visible_count();
+}
+
+void ParticlesRenderer::draw_density_lod(const Context &ctx) const {
+    const int width = m_rt.texture.width;
+    const int height = m_rt.texture.height;
+    const float core_radius = ctx.rcfg.core_size;
+    m_splat.build(m_batch, ctx.world_snapshot, width, height,
+                  PI * core_radius * core_radius);
+
+    if (m_lod_tex_initialized &&
+        (m_lod_tex.width != width || m_lod_tex.height != height)) {
+        UnloadTexture(m_lod_tex);
+        m_lod_tex_initialized = false;
+    }
+    if (!m_lod_tex_initialized) {
+        Image lod_image = GenImageColor(width, height, BLANK);
+        m_lod_tex = LoadTextureFromImage(lod_image);
+        UnloadImage(lod_image);
+        m_lod_tex_initialized = true;
+    }
+    UpdateTexture(m_lod_tex, m_splat.pixels().data());
+
+    BeginBlendMode(BLEND_ALPHA);
+    DrawTexture(m_lod_tex, 0, 0, WHITE);
+    EndBlendMode();
+}
+
+void ParticlesRenderer::submit_quads(
+    const std::vector<ParticleVertex> &vertices, Texture2D texture) {
+    // Chunks stay well below rlgl's default batch size; each chunk checks
+    // the limit once (flushing if needed) instead of once per particle
+    constexpr size_t quads_per_chunk = 1024;
+    const size_t quads = vertices.size() / 4;
+    for (size_t first = 0; first < quads; first += quads_per_chunk) {
+        const size_t last = std::min(quads, first + quads_per_chunk);
+        rlCheckRenderBatchLimit((int)((last - first) * 4));
+        rlSetTexture(texture.id);
+        rlBegin(RL_QUADS);
+        const ParticleVertex *vertex = vertices.data() + first * 4;
+        const ParticleVertex *end = vertices.data() + last * 4;
+        for (; vertex != end; ++vertex) {
+            rlColor4ub(vertex->r, vertex->g, vertex->b, vertex->a);
+            rlTexCoord2f(vertex->u, vertex->v);
+            rlVertex2f(vertex->x, vertex->y);
         }
+        rlEnd();
     }
+    rlSetTexture(0);
 }
 
 void ParticlesRenderer::render_grid_overlays(
@@ -154,6 +239,11 @@ void ParticlesRenderer::render_grid_overlays(
                                  transform.oy_cam, transform.zoom);
     }
 
+    if (rcfg.show_cost_heat) {
+        draw_cost_heat_camera(*grid, rcfg.heat_alpha, transform.ox_cam,
+                              transform.oy_cam, transform.zoom);
+    }
+
     if (rcfg.show_velocity_field) {
         Color velocity_color = ColorWithA(WHITE, 200);
         draw_velocity_field_camera(*grid, rcfg.vel_scale, rcfg.vel_thickness,
@@ -201,7 +291,17 @@ void ParticlesRenderer::render_border(const Context &ctx,
                          rcfg.border_width, rcfg.border_color);
 }
 
+void ParticlesRenderer::request_cells(Context &ctx) {
+    mailbox::SimulationConfigSnapshot scfg = ctx.sim.get_config();
+    if (scfg.draw_report.cells != ctx.rcfg.cull_cells) {
+        scfg.draw_report.cells = ctx.rcfg.cull_cells;
+        ctx.sim.update_config(scfg);
+    }
+}
+
 void ParticlesRenderer::render(Context &ctx) {
+    request_cells(ctx);
+
     BeginTextureMode(m_rt);
     ClearBackground(ctx.rcfg.background_color);
 
@@ -251,6 +351,36 @@ Texture2D ParticlesRenderer::get_glow_tex() const {
     return m_glow_tex;
 }
 
+Texture2D ParticlesRenderer::get_disc_tex() const {
+    if (m_disc_tex_initialized)
+        return m_disc_tex;
+
+    const int texture_size = 64;
+    const float half_size = texture_size * 0.5f;
+    Image disc_image = GenImageColor(texture_size, texture_size, BLANK);
+    for (int pixel_y = 0; pixel_y < texture_size; ++pixel_y) {
+        for (int pixel_x = 0; pixel_x < texture_size; ++pixel_x) {
+            float offset_x = pixel_x + 0.5f - half_size;
+            float offset_y = pixel_y + 0.5f - half_size;
+            float distance_from_center =
+                sqrtf(offset_x * offset_x + offset_y * offset_y);
+            // Solid inside the radius with a one texel anti-aliased edge
+            float alpha_value =
+                std::clamp(half_size - distance_from_center, 0.0f, 1.0f);
+            unsigned char final_alpha =
+                (unsigned char)lrintf(alpha_value * 255.0f);
+            ImageDrawPixel(&disc_image, pixel_x, pixel_y,
+                           (Color){255, 255, 255, final_alpha});
+        }
+    }
+    m_disc_tex = LoadTextureFromImage(disc_image);
+    UnloadImage(disc_image);
+    SetTextureFilter(m_disc_tex, TEXTURE_FILTER_BILINEAR);
+    m_disc_tex_initialized = true;
+
+    return m_disc_tex;
+}
+
 void ParticlesRenderer::draw_density_heat_camera(
     const mailbox::render::GridFrame &g, float alpha, float ox, float oy,
     float zoom) const {
@@ -284,6 +414,44 @@ void ParticlesRenderer::draw_density_heat_camera(
     }
 }
 
+void ParticlesRenderer::draw_cost_heat_camera(
+    const mailbox::render::GridFrame &g, float alpha, float ox, float oy,
+    float zoom) const {
+    if (g.cols <= 0 || g.rows <= 0 || g.examined.empty())
+        return;
+    const int total_cells = g.cols * g.rows;
+    long long max_examined = 0;
+    for (int cell_index = 0; cell_index < total_cells; ++cell_index) {
+        max_examined = std::max(max_examined, g.examined[cell_index]);
+    }
+    if (max_examined <= 0) {
+        return;
+    }
+    const unsigned char heat_alpha =
+        (unsigned char)std::lrint(255.f * std::clamp(alpha, 0.f, 1.f));
+    for (int row_index = 0; row_index < g.rows; ++row_index) {
+        for (int column_index = 0; column_index < g.cols; ++column_index) {
+            int cell_index = row_index * g.cols + column_index;
+            const long long examined = g.examined[cell_index];
+            if (examined <= 0) {
+                continue;
+            }
+            float cost_ratio = (float)examined / (float)max_examined;
+            float acceptance = (float)g.accepted[cell_index] / (float)examined;
+            float hue_value = 270.0f - 270.0f * cost_ratio;
+            Color heat_color =
+                ColorFromHSV(hue_value, 0.25f + 0.75f * acceptance, 1.0f);
+            heat_color.a = heat_alpha;
+            float cell_x, cell_y, cell_width, cell_height;
+            cell_rect(g, column_index, row_index, cell_x, cell_y, cell_width,
+                      cell_height);
+            DrawRectangle((int)(cell_x * zoom + ox), (int)(cell_y * zoom + oy),
+                          (int)std::ceil(cell_width * zoom),
+                          (int)std::ceil(cell_height * zoom), heat_color);
+        }
+    }
+}
+
 void ParticlesRenderer::draw_velocity_field_camera(
     const mailbox::render::GridFrame &g, float scale, float thickness,
     Color col, float ox, float oy, float zoom) const {
@@ -2,24 +2,17 @@
 
 #include <algorithm>
 #include <cmath>
+#include <vector>
 
 #include <raylib.h>
 #include <raymath.h>
 
+#include "density_splat.hpp"
 #include "irenderer.hpp"
+#include "particle_batch.hpp"
 #include "types/config.hpp"
 #include "types/window.hpp"
 
-/**
- * @brief Concept for position functions used in particle rendering
- * @details A position function must accept an integer index and return a
- * Vector2 representing the particle's position
- */
-template <typename F>
-concept PosFn = requires(F f, int i) {
-    { f(i) } -> std::same_as<Vector2>;
-};
-
 /**
  * @brief Renders particle systems with support for glow effects, interpolation,
  * and camera transforms
@@ -78,21 +71,6 @@ class ParticlesRenderer : public IRenderer {
     };
 
   private:
-    /**
-     * @brief Tints a color by multiplying RGB components by a factor
-     * @param c Original color
-     * @param k Tint factor (1.0 = no change)
-     * @return Tinted color with alpha preserved
-     */
-    static inline Color TintRGB(Color c, float k) {
-        auto clamp = [](int v) {
-            return v < 0 ? 0 : (v > 255 ? 255 : v);
-        };
-        return Color{(unsigned char)clamp((int)std::lrint(c.r * k)),
-                     (unsigned char)clamp((int)std::lrint(c.g * k)),
-                     (unsigned char)clamp((int)std::lrint(c.b * k)), 255};
-    }
-
     /**
      * @brief Creates a color with modified alpha value
      * @param c Original color
@@ -129,6 +107,13 @@ class ParticlesRenderer : public IRenderer {
             h = std::max(0.f, maxH - y);
     }
 
+    /**
+     * @brief Asks the simulation for the CSR cell lists while cell culling
+     * is on (the cell overlays get them through grid_data)
+     * @param ctx Rendering context
+     */
+    static void request_cells(Context &ctx);
+
     /**
      * @brief Sets up camera transformation parameters
      * @param ctx Rendering context
@@ -151,7 +136,32 @@ class ParticlesRenderer : public IRenderer {
                           const CameraTransform &transform) const;
 
     /**
-     * @brief Renders grid overlays (density heat, velocity field, grid lines)
+     * @brief Fills the batch with the particles that can be on screen
+     * @param ctx Rendering context
+     * @param transform Camera transformation data
+     */
+    void build_visible_positions(const Context &ctx,
+                                 const CameraTransform &transform) const;
+
+    /**
+     * @brief Checks whether the batch is dense enough for the LOD image
+     * @param ctx Rendering context
+     * @param transform Camera transformation data
+     * @return True if visible screen pixels per particle fall below the
+     * configured threshold
+     */
+    bool use_density_lod(const Context &ctx,
+                         const CameraTransform &transform) const;
+
+    /**
+     * @brief Draws the batch as a single density-splat texture
+     * @param ctx Rendering context
+     */
+    void draw_density_lod(const Context &ctx) const;
+
+    /**
+     * @brief Renders grid overlays (density heat, force cost heat, velocity
+     * field, grid lines)
      * @param ctx Rendering context
      * @param transform Camera transformation data
      */
@@ -184,6 +194,21 @@ class ParticlesRenderer : public IRenderer {
                                   float alpha, float ox, float oy,
                                   float zoom) const;
 
+    /**
+     * @brief Draws force cost heat map overlay using camera-aware positioning
+     * @param g Grid frame containing per-cell pair counts
+     * @param alpha Heat map alpha transparency
+     * @param ox X camera offset
+     * @param oy Y camera offset
+     * @param zoom Camera zoom factor
+     *
+     * Hue follows the pairs examined in each cell; cells whose pairs are
+     * mostly out of range are drawn paler.
+     */
+    void draw_cost_heat_camera(const mailbox::render::GridFrame &g,
+                               float alpha, float ox, float oy,
+                               float zoom) const;
+
     /**
      * @brief Draws velocity field arrows using camera-aware positioning
      * @param g Grid frame containing velocity data
@@ -199,133 +224,32 @@ class ParticlesRenderer : public IRenderer {
                                     float ox, float oy, float zoom) const;
 
     /**
-     * @brief Draws particles with glow effects using camera-aware positioning
-     * @tparam PosFn Position function type
-     * @param world_snapshot World state snapshot
-     * @param groupsCount Number of particle groups
-     * @param posAt Position function for particles
-     * @param glow Glow texture
-     * @param coreSize Core particle size
-     * @param outerScale Outer glow scale
-     * @param outerRGBGain Outer glow RGB gain
-     * @param innerScale Inner glow scale
-     * @param innerRGBGain Inner glow RGB gain
-     * @param ox X camera offset
-     * @param oy Y camera offset
-     * @param bw Bounds width
-     * @param bh Bounds height
-     * @param zoom Camera zoom factor
+     * @brief Gets or creates the anti-aliased disc texture used for cores
+     * @return White disc texture with a one texel soft edge
      */
-    template <PosFn PosFn>
-    void draw_particles_with_glow_camera(
-        const mailbox::WorldSnapshot &world_snapshot, int groupsCount,
-        PosFn posAt, Texture2D glow, float coreSize, float outerScale,
-        float outerRGBGain, float innerScale, float innerRGBGain, float ox,
-        float oy, float bw, float bh, float zoom) const {
-        const Rectangle src = {0, 0, (float)glow.width, (float)glow.height};
-        const Vector2 org = {0, 0};
-        BeginBlendMode(BLEND_ALPHA);
-        for (int g = 0; g < groupsCount; ++g) {
-            // Skip disabled groups
-            if (!world_snapshot.is_group_enabled(g)) {
-                continue;
-            }
-            const int start = world_snapshot.get_group_start(g);
-            const int end = world_snapshot.get_group_end(g);
-            const Color tint =
-                TintRGB(world_snapshot.get_group_color(g), outerRGBGain);
-            for (int i = start; i < end; ++i) {
-                Vector2 p = posAt(i);
-                if (p.x < 0 || p.y < 0 || p.x >= bw - 1 || p.y >= bh - 1)
-                    continue;
-                Vector2 p_screen = {p.x * zoom + ox, p.y * zoom + oy};
-                Rectangle dest = {p_screen.x - outerScale,
-                                  p_screen.y - outerScale, outerScale * 2,
-                                  outerScale * 2};
-                DrawTexturePro(glow, src, dest, org, 0, tint);
-            }
-        }
-        EndBlendMode();
-        BeginBlendMode(BLEND_ALPHA);
-        for (int g = 0; g < groupsCount; ++g) {
-            // Skip disabled groups
-            if (!world_snapshot.is_group_enabled(g)) {
-                continue;
-            }
-            const int start = world_snapshot.get_group_start(g);
-            const int end = world_snapshot.get_group_end(g);
-            const Color tint =
-                TintRGB(world_snapshot.get_group_color(g), innerRGBGain);
-            for (int i = start; i < end; ++i) {
-                Vector2 p = posAt(i);
-                if (p.x < 0 || p.y < 0 || p.x >= bw - 1 || p.y >= bh - 1)
-                    continue;
-                Vector2 p_screen = {p.x * zoom + ox, p.y * zoom + oy};
-                Rectangle dest = {p_screen.x - innerScale,
-                                  p_screen.y - innerScale, innerScale * 2,
-                                  innerScale * 2};
-                DrawTexturePro(glow, src, dest, org, 0, tint);
-            }
-        }
-        EndBlendMode();
-        for (int g = 0; g < groupsCount; ++g) {
-            // Skip disabled groups
-            if (!world_snapshot.is_group_enabled(g)) {
-                continue;
-            }
-            const int start = world_snapshot.get_group_start(g);
-            const int end = world_snapshot.get_group_end(g);
-            const Color col = world_snapshot.get_group_color(g);
-            for (int i = start; i < end; ++i) {
-                Vector2 p = posAt(i);
-                if (p.x < 0 || p.y < 0 || p.x >= bw - 1 || p.y >= bh - 1)
-                    continue;
-                Vector2 p_screen = {p.x * zoom + ox, p.y * zoom + oy};
-                DrawCircleV(p_screen, coreSize, col);
-            }
-        }
-    }
+    Texture2D get_disc_tex() const;
 
     /**
-     * @brief Draws particles as simple circles using camera-aware positioning
-     * @tparam PosFn Position function type
-     * @param world_snapshot World state snapshot
-     * @param groupsCount Number of particle groups
-     * @param posAt Position function for particles
-     * @param coreSize Core particle size
-     * @param ox X camera offset
-     * @param oy Y camera offset
-     * @param bw Bounds width
-     * @param bh Bounds height
-     * @param zoom Camera zoom factor
+     * @brief Submits prebuilt particle quads through the rlgl batch
+     * @param vertices Quad vertices (four per particle)
+     * @param texture Texture sampled by every quad
      */
-    template <PosFn PosFn>
-    void
-    draw_particles_simple_camera(const mailbox::WorldSnapshot &world_snapshot,
-                                 int groupsCount, PosFn posAt, float coreSize,
-                                 float ox, float oy, float bw, float bh,
-                                 float zoom) const {
-        for (int g = 0; g < groupsCount; ++g) {
-            // Skip disabled groups
-            if (!world_snapshot.is_group_enabled(g)) {
-                continue;
-            }
-            const int start = world_snapshot.get_group_start(g);
-            const int end = world_snapshot.get_group_end(g);
-            const Color col = world_snapshot.get_group_color(g);
-            for (int i = start; i < end; ++i) {
-                Vector2 p = posAt(i);
-                if (p.x < 0 || p.y < 0 || p.x >= bw - 1 || p.y >= bh - 1)
-                    continue;
-                Vector2 p_screen = {p.x * zoom + ox, p.y * zoom + oy};
-                DrawCircleV(p_screen, coreSize, col);
-            }
-        }
-    }
+    static void submit_quads(const std::vector<ParticleVertex> &vertices,
+                             Texture2D texture);
 
   private:
     WindowConfig m_wcfg;
     RenderTexture2D m_rt{};
     mutable Texture2D m_glow_tex{};
     mutable bool m_glow_tex_initialized{false};
+    mutable Texture2D m_disc_tex{};
+    mutable bool m_disc_tex_initialized{false};
+    /** @brief Per-frame particle positions, reused across frames */
+    mutable ParticleBatch m_batch;
+    /** @brief Quad vertices for the pass being drawn, reused across passes */
+    mutable std::vector<ParticleVertex> m_vertices;
+    /** @brief CPU side of the level-of-detail image */
+    mutable DensitySplat m_splat;
+    mutable Texture2D m_lod_tex{};
+    mutable bool m_lod_tex_initialized{false};
 };
@@ -0,0 +1,29 @@
+#include "position_decoder.hpp"
+
+#include <utility>
+
+bool PositionDecoder::decode(mailbox::render::ReadView &view) {
+    if (!view.curr_packed || view.curr_packed->xy.empty()) {
+        return false;
+    }
+
+    if (view.t1 != m_curr_t) {
+        if (view.t0 == m_curr_t) {
+            std::swap(m_prev, m_curr);
+            m_prev_t = m_curr_t;
+        }
+        view.curr_packed->unpack(m_curr);
+        m_curr_t = view.t1;
+    }
+    view.curr = &m_curr;
+
+    // Right after switching to packed, prev still holds floats
+    if (view.prev_packed && !view.prev_packed->xy.empty()) {
+        if (view.t0 != m_prev_t) {
+            view.prev_packed->unpack(m_prev);
+            m_prev_t = view.t0;
+        }
+        view.prev = &m_prev;
+    }
+    return true;
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <vector>
+
+#include "../mailbox/render/types.hpp"
+
+/**
+ * @brief Render-side expansion of 16-bit packed draw positions
+ *
+ * When the simulation publishes PackedPositions instead of floats, the
+ * decoder unpacks them into buffers it owns and points the read view at
+ * those, so renderers and UI tools keep reading float positions. Each
+ * published frame is unpacked once: the previous current frame is reused as
+ * the next previous frame.
+ */
+class PositionDecoder {
+  public:
+    PositionDecoder() = default;
+    ~PositionDecoder() = default;
+    PositionDecoder(const PositionDecoder &) = delete;
+    PositionDecoder(PositionDecoder &&) = delete;
+    PositionDecoder &operator=(const PositionDecoder &) = delete;
+    PositionDecoder &operator=(PositionDecoder &&) = delete;
+
+    /**
+     * @brief Points the view's prev/curr at float positions
+     * @param view Draw buffer view; left alone if positions were published
+     * as floats
+     * @return True if the current frame was published packed
+     *
+     * The view stays valid until the next call.
+     */
+    bool decode(mailbox::render::ReadView &view);
+
+  private:
+    std::vector<float> m_prev;
+    std::vector<float> m_curr;
+    long long m_prev_t = -1;
+    long long m_curr_t = -1;
+};
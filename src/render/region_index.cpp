@@ -0,0 +1,54 @@
+#include "region_index.hpp"
+
+bool RegionIndex::update(const mailbox::render::ReadView &view, bool use_prev,
+                         float bounds_w, float bounds_h) {
+    if (!view.curr) {
+        m_count = 0;
+        return false;
+    }
+    const std::vector<float> &curr = *view.curr;
+    const int count = (int)(curr.size() / 2);
+    use_prev = use_prev && view.prev && view.prev->size() == curr.size();
+
+    if (count == m_count && view.t0 == m_built_t0 && view.t1 == m_built_t1 &&
+        bounds_w == m_built_w && bounds_h == m_built_h &&
+        use_prev == m_built_with_prev) {
+        return false;
+    }
+
+    if (count != m_count || bounds_w != m_built_w || bounds_h != m_built_h) {
+        m_grid.resize(bounds_w, bounds_h, m_cell_size, count);
+    }
+    m_grid.build(
+        count,
+        [&curr](int i) {
+            return curr[(size_t)i * 2 + 0];
+        },
+        [&curr](int i) {
+            return curr[(size_t)i * 2 + 1];
+        },
+        bounds_w, bounds_h);
+
+    float max_d2 = 0.f;
+    if (use_prev) {
+        const std::vector<float> &prev = *view.prev;
+        for (size_t b = 0; b < curr.size(); b += 2) {
+            const float dx = curr[b + 0] - prev[b + 0];
+            const float dy = curr[b + 1] - prev[b + 1];
+            const float d2 = dx * dx + dy * dy;
+            // Non-finite positions land in cell (0,0) and never match a query
+            if (std::isfinite(d2)) {
+                max_d2 = std::max(max_d2, d2);
+            }
+        }
+    }
+
+    m_margin = std::sqrt(max_d2);
+    m_count = count;
+    m_built_t0 = view.t0;
+    m_built_t1 = view.t1;
+    m_built_w = bounds_w;
+    m_built_h = bounds_h;
+    m_built_with_prev = use_prev;
+    return true;
+}
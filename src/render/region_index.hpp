@@ -0,0 +1,106 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "../mailbox/render/types.hpp"
+#include "../simulation/uniformgrid.hpp"
+
+/**
+ * @brief Render-side spatial index over the published particle positions
+ *
+ * Lets UI tools (region statistics, picking) visit only the particles near a
+ * world-space rectangle instead of scanning the whole world every frame. The
+ * grid is rebuilt from the current positions only when the simulation
+ * publishes a new frame, and queries are padded by the largest distance a
+ * particle moved between the previous and current frame so interpolated
+ * positions are never missed.
+ */
+class RegionIndex {
+  public:
+    /**
+     * @brief World-space rectangle (x0 <= x1, y0 <= y1)
+     */
+    struct Bounds {
+        float x0;
+        float y0;
+        float x1;
+        float y1;
+    };
+
+    /**
+     * @brief Creates an empty index
+     * @param cell_size Grid cell size in world units
+     */
+    explicit RegionIndex(float cell_size = 32.f) : m_cell_size(cell_size) {
+        // Queries walk the CSR view only
+        m_grid.set_linked_lists(false);
+    }
+    ~RegionIndex() = default;
+    RegionIndex(const RegionIndex &) = delete;
+    RegionIndex(RegionIndex &&) = delete;
+    RegionIndex &operator=(const RegionIndex &) = delete;
+    RegionIndex &operator=(RegionIndex &&) = delete;
+
+    /**
+     * @brief Rebuilds the index if the view holds a new frame
+     * @param view Draw buffer view (curr is indexed, prev sets the margin)
+     * @param use_prev Whether positions are interpolated from view.prev
+     * @param bounds_w Simulation bounds width
+     * @param bounds_h Simulation bounds height
+     * @return True if the grid was rebuilt
+     */
+    bool update(const mailbox::render::ReadView &view, bool use_prev,
+                float bounds_w, float bounds_h);
+
+    /**
+     * @brief Visits every particle that may lie inside the rectangle
+     * @param bounds World-space query rectangle
+     * @param fn Callable invoked as fn(int particle_index); candidates still
+     * need an exact position test
+     */
+    template <typename Fn>
+    void for_each_candidate(const Bounds &bounds, Fn &&fn) const {
+        if (m_count <= 0) {
+            return;
+        }
+        int c0, r0, c1, r1;
+        m_grid.cell_of(bounds.x0 - m_margin, bounds.y0 - m_margin, c0, r0);
+        m_grid.cell_of(bounds.x1 + m_margin, bounds.y1 + m_margin, c1, r1);
+        const auto &indices = m_grid.indices();
+        for (int r = r0; r <= r1; ++r) {
+            for (int c = c0; c <= c1; ++c) {
+                const int ci = m_grid.cell_index(c, r);
+                const int start = m_grid.cell_start_at(ci);
+                const int end = start + m_grid.cell_count_at(ci);
+                for (int k = start; k < end; ++k) {
+                    fn(indices[k]);
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief Gets the number of indexed particles
+     * @return Particle count of the last build
+     */
+    int size() const noexcept { return m_count; }
+
+    /**
+     * @brief Gets the query padding
+     * @return Largest per-particle displacement between prev and curr
+     */
+    float margin() const noexcept { return m_margin; }
+
+  private:
+    UniformGrid m_grid;
+    float m_cell_size;
+    float m_margin = 0.f;
+    int m_count = 0;
+    long long m_built_t0 = -1;
+    long long m_built_t1 = -1;
+    float m_built_w = -1.f;
+    float m_built_h = -1.f;
+    bool m_built_with_prev = false;
+};
@@ -0,0 +1,535 @@
+#include "software_renderer.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#include "../utility/exceptions.hpp"
+#include "../utility/image_writer.hpp"
+
+namespace {
+
+/** @brief Glow lookup table resolution (entries over squared distance 0..1) */
+constexpr int GLOW_LUT_SIZE = 1024;
+
+/** @brief Floats per group in the tinted color table */
+constexpr int GROUP_STRIDE = 12;
+
+/**
+ * @brief Tints a color channel the same way the GPU glow passes do
+ * @param c Channel value 0..255
+ * @param k Tint factor
+ * @return Tinted channel in 0..1
+ */
+inline float tint_channel(unsigned char c, float k) {
+    long v = std::lrint(c * k);
+    v = v < 0 ? 0 : (v > 255 ? 255 : v);
+    return (float)v / 255.f;
+}
+
+/**
+ * @brief Blends a color into an RGB float pixel (standard alpha blending)
+ */
+inline void blend(float *dst, const float *src, float a) {
+    dst[0] += (src[0] - dst[0]) * a;
+    dst[1] += (src[1] - dst[1]) * a;
+    dst[2] += (src[2] - dst[2]) * a;
+}
+
+} // namespace
+
+SoftwareRenderer::SoftwareRenderer(int width, int height) {
+    m_glow_lut.resize(GLOW_LUT_SIZE);
+    for (int i = 0; i < GLOW_LUT_SIZE; ++i) {
+        // Same falloff as ParticlesRenderer::get_glow_tex, indexed by d^2
+        float distance = std::sqrt((float)i / (float)(GLOW_LUT_SIZE - 1));
+        float alpha = std::max(0.f, 1.f - distance);
+        m_glow_lut[i] = alpha * alpha;
+    }
+    resize(width, height);
+}
+
+void SoftwareRenderer::resize(int width, int height) {
+    if (width <= 0 || height <= 0) {
+        throw particles::RenderError(
+            "Invalid software framebuffer size: " + std::to_string(width) +
+            "x" + std::to_string(height));
+    }
+
+    m_width = width;
+    m_height = height;
+    m_tiles_x = (width + TILE_SIZE - 1) / TILE_SIZE;
+    m_tiles_y = (height + TILE_SIZE - 1) / TILE_SIZE;
+    m_pixels.assign((size_t)width * (size_t)height * 4, 0);
+}
+
+void SoftwareRenderer::render(const mailbox::render::ReadView &view,
+                              const mailbox::WorldSnapshot &world_snapshot,
+                              const Config &rcfg, float bounds_w,
+                              float bounds_h, float interp_alpha,
+                              SimulationThreadPool &pool) {
+    FrameParams params{};
+    params.glow = rcfg.glow_enabled;
+    params.core_size = std::max(0.f, rcfg.core_size);
+    params.outer_scale = params.core_size * rcfg.outer_scale_mul;
+    params.inner_scale = params.core_size * rcfg.inner_scale_mul;
+    params.outer_gain = rcfg.outer_rgb_gain;
+    params.inner_gain = rcfg.inner_rgb_gain;
+
+    const int groups = world_snapshot.get_groups_size();
+    m_group_rgba.assign((size_t)std::max(0, groups) * GROUP_STRIDE, 0.f);
+    for (int g = 0; g < groups; ++g) {
+        const Color c = world_snapshot.get_group_color(g);
+        float *row = m_group_rgba.data() + (size_t)g * GROUP_STRIDE;
+        row[0] = c.r / 255.f;
+        row[1] = c.g / 255.f;
+        row[2] = c.b / 255.f;
+        row[3] = c.a / 255.f;
+        row[4] = tint_channel(c.r, params.outer_gain);
+        row[5] = tint_channel(c.g, params.outer_gain);
+        row[6] = tint_channel(c.b, params.outer_gain);
+        row[8] = tint_channel(c.r, params.inner_gain);
+        row[9] = tint_channel(c.g, params.inner_gain);
+        row[10] = tint_channel(c.b, params.inner_gain);
+    }
+
+    project(view, world_snapshot, rcfg, bounds_w, bounds_h, interp_alpha,
+            pool);
+
+    // Pick splatting or the density field per glow pass from the expected
+    // overdraw, then bin only for the passes that splat per particle
+    const long long visible =
+        std::count_if(m_group.begin(), m_group.end(), [](int g) {
+            return g >= 0;
+        });
+    const double framebuffer_pixels = (double)m_width * (double)m_height;
+    float bin_radius = params.core_size;
+    const float scales[2] = {params.outer_scale, params.inner_scale};
+    for (int pass = 0; pass < 2; ++pass) {
+        auto &field = m_glow_fields[pass];
+        field.active = false;
+        const float scale = scales[pass];
+        if (!params.glow || scale <= 0.f) {
+            continue;
+        }
+        const double overdraw = (double)visible * (2.0 * scale) *
+                                (2.0 * scale) / framebuffer_pixels;
+        if (m_glow_overdraw_limit > 0.f && overdraw > m_glow_overdraw_limit) {
+            build_glow_field(pass, scale, pool);
+        } else {
+            bin_radius = std::max(bin_radius, scale);
+        }
+    }
+    bin(bin_radius, pool);
+
+    const Color background = rcfg.background_color;
+    pool.parallel_for_n(
+        [&](int start, int end) {
+            for (int tile = start; tile < end; ++tile) {
+                raster_tile(tile, params, background);
+            }
+        },
+        m_tiles_x * m_tiles_y, 1);
+}
+
+void SoftwareRenderer::project(const mailbox::render::ReadView &view,
+                               const mailbox::WorldSnapshot &world_snapshot,
+                               const Config &rcfg, float bounds_w,
+                               float bounds_h, float interp_alpha,
+                               SimulationThreadPool &pool) {
+    int particles = 0;
+    if (view.curr) {
+        particles = std::min(world_snapshot.get_particles_size(),
+                             (int)(view.curr->size() / 2));
+    }
+    m_sx.resize(particles);
+    m_sy.resize(particles);
+    m_group.resize(particles);
+    if (particles == 0) {
+        return;
+    }
+
+    // Same camera transform as ParticlesRenderer::setup_camera_transform
+    const float bw = std::max(0.f, bounds_w);
+    const float bh = std::max(0.f, bounds_h);
+    const float offset_x = std::floor(((float)m_width - bw) * 0.5f);
+    const float offset_y = std::floor(((float)m_height - bh) * 0.5f);
+    const float zoom = rcfg.camera.zoom();
+    const float ox = offset_x + bw * 0.5f - bw * 0.5f * zoom -
+                     rcfg.camera.x * zoom;
+    const float oy = offset_y + bh * 0.5f - bh * 0.5f * zoom -
+                     rcfg.camera.y * zoom;
+
+    const float *pos1 = view.curr->data();
+    const float *pos0 = pos1;
+    float alpha = 1.f;
+    if (view.prev && view.prev->size() == view.curr->size()) {
+        pos0 = view.prev->data();
+        alpha = std::clamp(interp_alpha, 0.f, 1.f);
+    }
+
+    const int groups = world_snapshot.get_groups_size();
+    pool.parallel_for_n(
+        [&](int start, int end) {
+            std::fill(m_group.begin() + start, m_group.begin() + end, -1);
+            for (int g = 0; g < groups; ++g) {
+                if (!world_snapshot.is_group_enabled(g)) {
+                    continue;
+                }
+                const int gs =
+                    std::max(start, world_snapshot.get_group_start(g));
+                const int ge = std::min(end, world_snapshot.get_group_end(g));
+                for (int i = gs; i < ge; ++i) {
+                    const float x = pos0[i * 2 + 0] +
+                                    (pos1[i * 2 + 0] - pos0[i * 2 + 0]) * alpha;
+                    const float y = pos0[i * 2 + 1] +
+                                    (pos1[i * 2 + 1] - pos0[i * 2 + 1]) * alpha;
+                    if (x < 0 || y < 0 || x >= bw - 1 || y >= bh - 1) {
+                        continue;
+                    }
+                    m_sx[i] = x * zoom + ox;
+                    m_sy[i] = y * zoom + oy;
+                    m_group[i] = g;
+                }
+            }
+        },
+        particles);
+}
+
+inline bool SoftwareRenderer::tile_range(float sx, float sy, float radius,
+                                         int &tx0, int &ty0, int &tx1,
+                                         int &ty1) const noexcept {
+    const float x0 = sx - radius, x1 = sx + radius;
+    const float y0 = sy - radius, y1 = sy + radius;
+    if (x1 < 0.f || y1 < 0.f || x0 >= (float)m_width ||
+        y0 >= (float)m_height) {
+        return false;
+    }
+    tx0 = std::max(0, (int)std::floor(x0 / TILE_SIZE));
+    ty0 = std::max(0, (int)std::floor(y0 / TILE_SIZE));
+    tx1 = std::min(m_tiles_x - 1, (int)std::floor(x1 / TILE_SIZE));
+    ty1 = std::min(m_tiles_y - 1, (int)std::floor(y1 / TILE_SIZE));
+    return true;
+}
+
+void SoftwareRenderer::bin(float radius, SimulationThreadPool &pool) {
+    const int particles = (int)m_group.size();
+    const int tiles = m_tiles_x * m_tiles_y;
+    // A fixed chunk layout (independent of how the pool splits the work)
+    // keeps the tile lists in particle order.
+    const int chunks =
+        std::max(1, std::min(particles, std::max(1, pool.size()) * 4));
+    const int chunk_size = (particles + chunks - 1) / std::max(1, chunks);
+
+    m_chunk_counts.assign((size_t)chunks * tiles, 0);
+    m_tile_start.assign(tiles + 1, 0);
+    if (particles == 0) {
+        m_tile_items.clear();
+        return;
+    }
+
+    auto for_each_tile = [&](int i, auto &&fn) {
+        int tx0, ty0, tx1, ty1;
+        if (m_group[i] < 0 ||
+            !tile_range(m_sx[i], m_sy[i], radius, tx0, ty0, tx1, ty1)) {
+            return;
+        }
+        for (int ty = ty0; ty <= ty1; ++ty) {
+            for (int tx = tx0; tx <= tx1; ++tx) {
+                fn(ty * m_tiles_x + tx);
+            }
+        }
+    };
+
+    pool.parallel_for_n(
+        [&](int c0, int c1) {
+            for (int c = c0; c < c1; ++c) {
+                int *counts = m_chunk_counts.data() + (size_t)c * tiles;
+                const int end = std::min(particles, (c + 1) * chunk_size);
+                for (int i = c * chunk_size; i < end; ++i) {
+                    for_each_tile(i, [&](int t) {
+                        counts[t]++;
+                    });
+                }
+            }
+        },
+        chunks, 1);
+
+    // Turn counts into write cursors: tile-major, then chunk order
+    int running = 0;
+    for (int t = 0; t < tiles; ++t) {
+        m_tile_start[t] = running;
+        for (int c = 0; c < chunks; ++c) {
+            int &slot = m_chunk_counts[(size_t)c * tiles + t];
+            const int count = slot;
+            slot = running;
+            running += count;
+        }
+    }
+    m_tile_start[tiles] = running;
+    m_tile_items.resize(running);
+
+    pool.parallel_for_n(
+        [&](int c0, int c1) {
+            for (int c = c0; c < c1; ++c) {
+                int *cursor = m_chunk_counts.data() + (size_t)c * tiles;
+                const int end = std::min(particles, (c + 1) * chunk_size);
+                for (int i = c * chunk_size; i < end; ++i) {
+                    for_each_tile(i, [&](int t) {
+                        m_tile_items[cursor[t]++] = i;
+                    });
+                }
+            }
+        },
+        chunks, 1);
+}
+
+void SoftwareRenderer::build_glow_field(int pass, float scale,
+                                        SimulationThreadPool &pool) {
+    GlowField &f = m_glow_fields[pass];
+    f.active = true;
+    // Aim for a kernel of ~8 cells radius; the falloff is smooth enough that
+    // bilinear reconstruction from the coarse grid is not visible.
+    f.factor = std::clamp((int)std::lround(scale / 8.f), 1, 16);
+    f.radius = std::max(1, (int)std::ceil(scale / (float)f.factor));
+    f.pad = f.radius + 1;
+    f.cols = (m_width + f.factor - 1) / f.factor + 2 * f.pad;
+    f.rows = (m_height + f.factor - 1) / f.factor + 2 * f.pad;
+    const size_t plane = (size_t)f.cols * (size_t)f.rows;
+    f.deposit.assign(plane * 4, 0.f);
+    f.field.assign(plane * 5, 0.f);
+
+    const int taps = 2 * f.radius + 1;
+    f.kernel_a.resize((size_t)taps * taps);
+    f.kernel_log.resize((size_t)taps * taps);
+    const float cell2_over_scale2 =
+        (float)(f.factor * f.factor) / (scale * scale);
+    for (int ky = 0; ky < taps; ++ky) {
+        for (int kx = 0; kx < taps; ++kx) {
+            const float dx = (float)(kx - f.radius);
+            const float dy = (float)(ky - f.radius);
+            const float t = (dx * dx + dy * dy) * cell2_over_scale2;
+            const float a =
+                t < 1.f ? m_glow_lut[(int)(t * (GLOW_LUT_SIZE - 1))] : 0.f;
+            // Clamp so a particle sitting on a cell center leaves a sliver
+            // of transmittance instead of log(0)
+            f.kernel_a[(size_t)ky * taps + kx] = a;
+            f.kernel_log[(size_t)ky * taps + kx] =
+                std::log(1.f - std::min(a, 254.f / 255.f));
+        }
+    }
+
+    // Bilinear deposit of tinted weight. Serial on purpose: it is cheap next
+    // to the convolution and keeps float summation order fixed.
+    const float inv_factor = 1.f / (float)f.factor;
+    const int particles = (int)m_group.size();
+    float *dep_r = f.deposit.data();
+    float *dep_g = dep_r + plane;
+    float *dep_b = dep_g + plane;
+    float *dep_w = dep_b + plane;
+    for (int i = 0; i < particles; ++i) {
+        const int g = m_group[i];
+        if (g < 0) {
+            continue;
+        }
+        const float u = m_sx[i] * inv_factor - 0.5f + (float)f.pad;
+        const float v = m_sy[i] * inv_factor - 0.5f + (float)f.pad;
+        if (u < 0.f || v < 0.f || u >= (float)(f.cols - 1) ||
+            v >= (float)(f.rows - 1)) {
+            continue;
+        }
+        const int iu = (int)u;
+        const int iv = (int)v;
+        const float fu = u - (float)iu;
+        const float fv = v - (float)iv;
+        const float *tint =
+            m_group_rgba.data() + (size_t)g * GROUP_STRIDE + 4 * (pass + 1);
+        const size_t c00 = (size_t)iv * f.cols + iu;
+        const size_t cells[4] = {c00, c00 + 1, c00 + f.cols, c00 + f.cols + 1};
+        const float weights[4] = {(1.f - fu) * (1.f - fv), fu * (1.f - fv),
+                                  (1.f - fu) * fv, fu * fv};
+        for (int k = 0; k < 4; ++k) {
+            dep_r[cells[k]] += tint[0] * weights[k];
+            dep_g[cells[k]] += tint[1] * weights[k];
+            dep_b[cells[k]] += tint[2] * weights[k];
+            dep_w[cells[k]] += weights[k];
+        }
+    }
+
+    // Only cells the composite step can sample are convolved; the padding
+    // keeps every tap of those cells inside the grid, so no bounds checks.
+    const int first = f.pad - 1;
+    const int last_col = f.cols - f.pad + 1;
+    const int last_row = f.rows - f.pad + 1;
+    pool.parallel_for_n(
+        [&](int row_start, int row_end) {
+            for (int y = first + row_start; y < first + row_end; ++y) {
+                for (int x = first; x < last_col; ++x) {
+                    float sum[5] = {0.f, 0.f, 0.f, 0.f, 0.f};
+                    for (int ky = 0; ky < taps; ++ky) {
+                        const size_t src =
+                            (size_t)(y + ky - f.radius) * f.cols +
+                            (size_t)(x - f.radius);
+                        const float *ka = f.kernel_a.data() + (size_t)ky * taps;
+                        const float *kl =
+                            f.kernel_log.data() + (size_t)ky * taps;
+                        for (int kx = 0; kx < taps; ++kx) {
+                            const float w = dep_w[src + kx];
+                            sum[0] += ka[kx] * dep_r[src + kx];
+                            sum[1] += ka[kx] * dep_g[src + kx];
+                            sum[2] += ka[kx] * dep_b[src + kx];
+                            sum[3] += ka[kx] * w;
+                            sum[4] += kl[kx] * w;
+                        }
+                    }
+                    const size_t dst = (size_t)y * f.cols + x;
+                    for (int k = 0; k < 5; ++k) {
+                        f.field[plane * k + dst] = sum[k];
+                    }
+                }
+            }
+        },
+        last_row - first, 1);
+}
+
+void SoftwareRenderer::composite_glow_field(int pass, float *buf, int x0,
+                                            int y0, int w, int h) const {
+    const GlowField &f = m_glow_fields[pass];
+    const size_t plane = (size_t)f.cols * (size_t)f.rows;
+    const float inv_factor = 1.f / (float)f.factor;
+    for (int py = 0; py < h; ++py) {
+        const float v =
+            ((float)(y0 + py) + 0.5f) * inv_factor - 0.5f + (float)f.pad;
+        const int iv = (int)v;
+        const float fv = v - (float)iv;
+        for (int px = 0; px < w; ++px) {
+            const float u =
+                ((float)(x0 + px) + 0.5f) * inv_factor - 0.5f + (float)f.pad;
+            const int iu = (int)u;
+            const float fu = u - (float)iu;
+            const size_t c00 = (size_t)iv * f.cols + iu;
+            const float w00 = (1.f - fu) * (1.f - fv), w10 = fu * (1.f - fv);
+            const float w01 = (1.f - fu) * fv, w11 = fu * fv;
+            auto sample = [&](int k) {
+                const float *p = f.field.data() + plane * k + c00;
+                return p[0] * w00 + p[1] * w10 + p[f.cols] * w01 +
+                       p[f.cols + 1] * w11;
+            };
+            const float coverage = sample(3);
+            if (coverage <= 1e-6f) {
+                continue;
+            }
+            const float inv_coverage = 1.f / coverage;
+            const float color[3] = {sample(0) * inv_coverage,
+                                    sample(1) * inv_coverage,
+                                    sample(2) * inv_coverage};
+            // Sequential "over" of n layers with one color collapses to
+            // color + (dst - color) * prod(1 - a_i)
+            blend(buf + ((size_t)py * w + px) * 3, color,
+                  1.f - std::exp(sample(4)));
+        }
+    }
+}
+
+void SoftwareRenderer::raster_tile(int tile, const FrameParams &params,
+                                   Color background) {
+    const int x0 = (tile % m_tiles_x) * TILE_SIZE;
+    const int y0 = (tile / m_tiles_x) * TILE_SIZE;
+    const int w = std::min(TILE_SIZE, m_width - x0);
+    const int h = std::min(TILE_SIZE, m_height - y0);
+
+    float buf[TILE_SIZE * TILE_SIZE * 3];
+    const float bg[3] = {background.r / 255.f, background.g / 255.f,
+                         background.b / 255.f};
+    for (int p = 0; p < w * h; ++p) {
+        buf[p * 3 + 0] = bg[0];
+        buf[p * 3 + 1] = bg[1];
+        buf[p * 3 + 2] = bg[2];
+    }
+
+    const int *items = m_tile_items.data() + m_tile_start[tile];
+    const int n_items = m_tile_start[tile + 1] - m_tile_start[tile];
+    const float lut_scale = (float)(GLOW_LUT_SIZE - 1);
+
+    // Visits pixels (tile-local) whose centers lie within radius of (sx, sy)
+    auto splat = [&](float sx, float sy, float radius, auto &&shade) {
+        const float lx = sx - (float)x0;
+        const float ly = sy - (float)y0;
+        const int px0 = std::max(0, (int)std::floor(lx - radius));
+        const int py0 = std::max(0, (int)std::floor(ly - radius));
+        const int px1 = std::min(w - 1, (int)std::ceil(lx + radius));
+        const int py1 = std::min(h - 1, (int)std::ceil(ly + radius));
+        for (int py = py0; py <= py1; ++py) {
+            const float dy = (float)py + 0.5f - ly;
+            float *row = buf + (size_t)py * w * 3;
+            for (int px = px0; px <= px1; ++px) {
+                const float dx = (float)px + 0.5f - lx;
+                shade(row + px * 3, dx * dx + dy * dy);
+            }
+        }
+    };
+
+    // Glow passes: outer for every particle, then inner, matching the
+    // blend order of ParticlesRenderer::render_particles
+    if (params.glow) {
+        const float scales[2] = {params.outer_scale, params.inner_scale};
+        for (int pass = 0; pass < 2; ++pass) {
+            const float scale = scales[pass];
+            if (scale <= 0.f) {
+                continue;
+            }
+            if (m_glow_fields[pass].active) {
+                composite_glow_field(pass, buf, x0, y0, w, h);
+                continue;
+            }
+            const float inv_scale2 = 1.f / (scale * scale);
+            for (int k = 0; k < n_items; ++k) {
+                const int i = items[k];
+                const float *tint = m_group_rgba.data() +
+                                    (size_t)m_group[i] * GROUP_STRIDE +
+                                    4 * (pass + 1);
+                splat(m_sx[i], m_sy[i], scale, [&](float *dst, float d2) {
+                    const float t = d2 * inv_scale2;
+                    if (t >= 1.f) {
+                        return;
+                    }
+                    blend(dst, tint, m_glow_lut[(int)(t * lut_scale)]);
+                });
+            }
+        }
+    }
+
+    // Cores
+    const float core = params.core_size;
+    const float core2 = core * core;
+    for (int k = 0; k < n_items; ++k) {
+        const int i = items[k];
+        const float *color =
+            m_group_rgba.data() + (size_t)m_group[i] * GROUP_STRIDE;
+        splat(m_sx[i], m_sy[i], core, [&](float *dst, float d2) {
+            if (d2 <= core2) {
+                blend(dst, color, color[3]);
+            }
+        });
+    }
+
+    for (int py = 0; py < h; ++py) {
+        const float *src = buf + (size_t)py * w * 3;
+        uint8_t *dst = m_pixels.data() +
+                       ((size_t)(y0 + py) * m_width + (size_t)x0) * 4;
+        for (int px = 0; px < w; ++px) {
+            for (int ch = 0; ch < 3; ++ch) {
+                const float v = std::clamp(src[px * 3 + ch], 0.f, 1.f);
+                dst[px * 4 + ch] = (uint8_t)std::lrint(v * 255.f);
+            }
+            dst[px * 4 + 3] = 255;
+        }
+    }
+}
+
+void SoftwareRenderer::write_png(const std::string &path) const {
+    particles::utility::write_png(path, m_width, m_height, m_pixels);
+}
+
+void SoftwareRenderer::write_ppm(const std::string &path) const {
+    particles::utility::write_ppm(path, m_width, m_height, m_pixels);
+}
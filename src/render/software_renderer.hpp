@@ -0,0 +1,249 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "../mailbox/data_snapshot.hpp"
+#include "../mailbox/render/types.hpp"
+#include "../simulation/multicore.hpp"
+#include "types/config.hpp"
+
+/**
+ * @brief CPU-only particle renderer producing an RGBA8 framebuffer
+ *
+ * Mirrors what ParticlesRenderer draws (background, outer and inner glow
+ * passes using the same (1 - d)^2 falloff as the glow texture, then solid
+ * cores) without needing a GL context, so frames can be produced on headless
+ * machines. The framebuffer is split into square tiles; particles are binned
+ * into every tile their splat overlaps and each tile is then rasterized
+ * independently on the thread pool. Binning keeps particle order inside each
+ * tile, so blending order and therefore output is identical to a serial
+ * render regardless of the thread count.
+ *
+ * Large glow radii over many particles make per-particle splatting
+ * quadratic in the radius. When a glow pass would cover the framebuffer more
+ * than `glow_overdraw_limit` times, it is instead evaluated as a field: tinted
+ * particle weights are deposited on a coarse grid and convolved with the glow
+ * falloff (and with log(1 - falloff) for transmittance), then composited per
+ * pixel. For a single color this equals sequential alpha blending; with mixed
+ * colors the pass becomes order-independent (alpha-weighted average color).
+ */
+class SoftwareRenderer {
+  public:
+    /** @brief Tile edge length in pixels */
+    static constexpr int TILE_SIZE = 64;
+
+    /**
+     * @brief Constructs a renderer with a framebuffer of the given size
+     * @param width Framebuffer width in pixels
+     * @param height Framebuffer height in pixels
+     * @throws particles::RenderError if the size is not positive
+     */
+    SoftwareRenderer(int width, int height);
+    ~SoftwareRenderer() = default;
+    SoftwareRenderer(const SoftwareRenderer &) = delete;
+    SoftwareRenderer(SoftwareRenderer &&) = delete;
+    SoftwareRenderer &operator=(const SoftwareRenderer &) = delete;
+    SoftwareRenderer &operator=(SoftwareRenderer &&) = delete;
+
+    /**
+     * @brief Resizes the framebuffer
+     * @param width New width in pixels
+     * @param height New height in pixels
+     * @throws particles::RenderError if the size is not positive
+     */
+    void resize(int width, int height);
+
+    /**
+     * @brief Renders one frame into the framebuffer
+     * @param view Draw buffer read view (curr is required, prev is used for
+     * interpolation when present)
+     * @param world_snapshot World snapshot with group ranges and colors
+     * @param rcfg Render configuration (glow, core size, background, camera)
+     * @param bounds_w Simulation bounds width
+     * @param bounds_h Simulation bounds height
+     * @param interp_alpha Interpolation factor between prev and curr (1 =
+     * curr only)
+     * @param pool Thread pool used for binning and rasterization
+     */
+    void render(const mailbox::render::ReadView &view,
+                const mailbox::WorldSnapshot &world_snapshot,
+                const Config &rcfg, float bounds_w, float bounds_h,
+                float interp_alpha, SimulationThreadPool &pool);
+
+    /**
+     * @brief Gets the framebuffer contents
+     * @return RGBA8 pixels, row-major, top row first
+     */
+    const std::vector<uint8_t> &pixels() const noexcept { return m_pixels; }
+
+    /** @brief Framebuffer width in pixels */
+    int width() const noexcept { return m_width; }
+
+    /** @brief Framebuffer height in pixels */
+    int height() const noexcept { return m_height; }
+
+    /**
+     * @brief Writes the framebuffer as a PNG file
+     * @param path Output path
+     * @throws particles::IOError on failure
+     */
+    void write_png(const std::string &path) const;
+
+    /**
+     * @brief Writes the framebuffer as a binary PPM file
+     * @param path Output path
+     * @throws particles::IOError on failure
+     */
+    void write_ppm(const std::string &path) const;
+
+    /**
+     * @brief Sets the glow overdraw above which a glow pass uses the
+     * convolved density field instead of per-particle splats
+     * @param limit Average glow layers per framebuffer pixel (<= 0 forces
+     * exact per-particle glow)
+     */
+    void set_glow_overdraw_limit(float limit) noexcept {
+        m_glow_overdraw_limit = limit;
+    }
+
+    /**
+     * @brief Checks whether a glow pass used the density field last frame
+     * @param pass 0 for the outer glow, 1 for the inner glow
+     * @return True if the pass was convolved rather than splatted
+     */
+    bool glow_pass_convolved(int pass) const noexcept {
+        return pass >= 0 && pass < 2 && m_glow_fields[pass].active;
+    }
+
+  private:
+    /**
+     * @brief Per-frame splat parameters shared by all tiles
+     */
+    struct FrameParams {
+        float core_size;
+        float outer_scale;
+        float inner_scale;
+        float outer_gain;
+        float inner_gain;
+        bool glow;
+    };
+
+    /**
+     * @brief Coarse-grid glow field for dense glow passes
+     */
+    struct GlowField {
+        /** @brief Whether the pass is evaluated through this field */
+        bool active = false;
+        /** @brief Framebuffer pixels per grid cell */
+        int factor = 1;
+        /** @brief Grid cells of padding around the framebuffer */
+        int pad = 0;
+        /** @brief Grid dimensions including padding */
+        int cols = 0, rows = 0;
+        /** @brief Kernel radius in grid cells */
+        int radius = 0;
+        /** @brief Deposited planes: tint R, G, B and weight */
+        std::vector<float> deposit;
+        /** @brief Convolved planes: sum(a*R), sum(a*G), sum(a*B), sum(a),
+         * sum(log(1 - a)) */
+        std::vector<float> field;
+        /** @brief Kernel taps (falloff and log transmittance) */
+        std::vector<float> kernel_a;
+        std::vector<float> kernel_log;
+    };
+
+    /**
+     * @brief Projects particles to screen space and tags visible ones
+     * @param view Draw buffer read view
+     * @param world_snapshot World snapshot
+     * @param rcfg Render configuration
+     * @param bounds_w Simulation bounds width
+     * @param bounds_h Simulation bounds height
+     * @param interp_alpha Interpolation factor
+     * @param pool Thread pool
+     */
+    void project(const mailbox::render::ReadView &view,
+                 const mailbox::WorldSnapshot &world_snapshot,
+                 const Config &rcfg, float bounds_w, float bounds_h,
+                 float interp_alpha, SimulationThreadPool &pool);
+
+    /**
+     * @brief Bins visible particles into tiles, preserving particle order
+     * @param radius Splat radius in pixels
+     * @param pool Thread pool
+     */
+    void bin(float radius, SimulationThreadPool &pool);
+
+    /**
+     * @brief Deposits and convolves particles for a dense glow pass
+     * @param pass 0 for the outer glow, 1 for the inner glow
+     * @param scale Glow radius in pixels
+     * @param pool Thread pool
+     */
+    void build_glow_field(int pass, float scale, SimulationThreadPool &pool);
+
+    /**
+     * @brief Composites a glow field over a tile buffer
+     * @param pass Glow pass index
+     * @param buf Tile RGB buffer
+     * @param x0 Tile left edge in pixels
+     * @param y0 Tile top edge in pixels
+     * @param w Tile width
+     * @param h Tile height
+     */
+    void composite_glow_field(int pass, float *buf, int x0, int y0, int w,
+                              int h) const;
+
+    /**
+     * @brief Rasterizes one tile into the framebuffer
+     * @param tile Tile index
+     * @param params Frame splat parameters
+     * @param background Background color
+     */
+    void raster_tile(int tile, const FrameParams &params,
+                     Color background);
+
+    /**
+     * @brief Computes the inclusive tile range covered by a splat
+     * @return False if the splat is entirely off screen
+     */
+    inline bool tile_range(float sx, float sy, float radius, int &tx0, int &ty0,
+                           int &tx1, int &ty1) const noexcept;
+
+  private:
+    int m_width = 0;
+    int m_height = 0;
+    int m_tiles_x = 0;
+    int m_tiles_y = 0;
+
+    /** @brief RGBA8 framebuffer */
+    std::vector<uint8_t> m_pixels;
+
+    /** @brief Glow falloff (1 - d)^2 indexed by quantized squared distance */
+    std::vector<float> m_glow_lut;
+
+    /** @brief Overdraw above which glow passes use the density field */
+    float m_glow_overdraw_limit = 16.f;
+
+    /** @brief Density fields for the outer and inner glow passes */
+    GlowField m_glow_fields[2];
+
+    /** @brief Per-group tinted colors: core, outer glow, inner glow (RGBA,
+     * 0..1) */
+    std::vector<float> m_group_rgba;
+
+    /** @brief Screen-space particle positions */
+    std::vector<float> m_sx;
+    std::vector<float> m_sy;
+    /** @brief Group index per particle, -1 when culled */
+    std::vector<int> m_group;
+
+    /** @brief Per-chunk, per-tile particle counts used while binning */
+    std::vector<int> m_chunk_counts;
+    /** @brief Start offset of each tile's list in m_tile_items */
+    std::vector<int> m_tile_start;
+    /** @brief Particle indices grouped by tile */
+    std::vector<int> m_tile_items;
+};
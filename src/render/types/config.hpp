@@ -34,6 +34,12 @@ struct Config {
     float inner_rgb_gain = 0.18f;
     bool final_additive_blit = true;
 
+    // culling and level of detail
+    bool cull_cells = true;           // skip grid cells outside the view
+    bool density_lod = true;          // density image when zoomed far out
+    float lod_px_per_particle = 0.5f; // switch to the image below this
+    bool packed_positions = false;    // sim publishes 16-bit positions
+
     // background
     Color background_color = {0, 0, 0, 255}; // black background
 
@@ -45,6 +51,7 @@ struct Config {
     // overlays
     bool show_density_heat = false;
     float heat_alpha = 0.6f; // 0..1 overlay opacity
+    bool show_cost_heat = false; // force pairs examined per cell
     bool show_velocity_field = false;
     float vel_scale = 0.75f;      // px per (avg speed unit)
     float vel_thickness = 1.0f;   // line thickness
@@ -97,9 +97,15 @@ static inline Vector2 interpolate_position(const Context &ctx,
 }
 
 static inline Vector2 calculate_velocity(const Context &ctx, int particle_id) {
+    size_t b = (size_t)particle_id * 2;
+    // The velocity stream is exact; frame differences span whole publishes
+    if (ctx.view.curr_vel && b + 1 < ctx.view.curr_vel->size()) {
+        const auto &vel = *ctx.view.curr_vel;
+        return Vector2{vel[b], vel[b + 1]};
+    }
+
     const auto &pos0 = *ctx.view.prev;
     const auto &pos1 = *ctx.view.curr;
-    size_t b = (size_t)particle_id * 2;
 
     if (b + 1 >= pos1.size() || b + 1 >= pos0.size()) {
         return Vector2{0, 0};
@@ -117,6 +123,18 @@ static inline Vector2 world_to_screen(const Vector2 &world_pos,
                    world_pos.y * zoom + camera_offset.y};
 }
 
+static inline RegionIndex::Bounds
+screen_to_world_bounds(const Rectangle &screen_rect, const Context &ctx,
+                       const Vector2 &camera_offset) {
+    const float inv_zoom = 1.0f / ctx.rcfg.camera.zoom();
+
+    return RegionIndex::Bounds{
+        (screen_rect.x - camera_offset.x) * inv_zoom,
+        (screen_rect.y - camera_offset.y) * inv_zoom,
+        (screen_rect.x + screen_rect.width - camera_offset.x) * inv_zoom,
+        (screen_rect.y + screen_rect.height - camera_offset.y) * inv_zoom};
+}
+
 InspectorUI::InspectorUI() {
     m_render_texture = LoadRenderTexture(GetScreenWidth(), GetScreenHeight());
 }
@@ -133,6 +151,7 @@ RenderTexture2D &InspectorUI::texture() { return m_render_texture; }
 const RenderTexture2D &InspectorUI::texture() const { return m_render_texture; }
 
 void InspectorUI::render(Context &ctx) {
+    request_velocities(ctx);
     follow_tracked(ctx);
     BeginTextureMode(m_render_texture);
     ClearBackground({0, 0, 0, 0});
@@ -196,6 +215,7 @@ void InspectorUI::render_ui(Context &ctx, const RenderTexture2D &color_rt) {
     }
 
     Vector2 camera_offset = calculate_camera_offset(ctx);
+    update_region_index(ctx);
 
     ImGui::Begin("Region Inspector", &m_selection.show_window);
     ImGui::Text("x=%.0f  y=%.0f  w=%.0f  h=%.0f", logical.x, logical.y,
@@ -248,6 +268,22 @@ void InspectorUI::follow_tracked(Context &ctx) {
     }
 }
 
+void InspectorUI::request_velocities(Context &ctx) {
+    const bool want = m_selection.show_window && m_selection.track_enabled &&
+                      m_selection.tracked_id >= 0;
+    mailbox::SimulationConfigSnapshot scfg = ctx.sim.get_config();
+    if (scfg.draw_report.velocities != want) {
+        scfg.draw_report.velocities = want;
+        ctx.sim.update_config(scfg);
+    }
+}
+
+void InspectorUI::update_region_index(Context &ctx) {
+    mailbox::SimulationConfigSnapshot scfg = ctx.sim.get_config();
+    m_region_index.update(ctx.view, ctx.can_interpolate, scfg.bounds_width,
+                          scfg.bounds_height);
+}
+
 void InspectorUI::draw_selection_overlay() {
     auto &sel = m_selection;
     if (!sel.has || (!sel.dragging && !sel.show_window)) {
@@ -337,19 +373,23 @@ void InspectorUI::render_particle_statistics(Context &ctx,
 
     std::vector<int> per_group(G, 0);
     int in_count = 0;
-    for (int i = 0; i < total_particles; ++i) {
-        Vector2 p = interpolate_position(ctx, i);
-        Vector2 ps = world_to_screen(p, ctx, camera_offset);
-        if (ps.x >= logical.x && ps.x < logical.x + logical.width &&
-            ps.y >= logical.y && ps.y < logical.y + logical.height) {
-            int g = world.group_of(i);
-            // Skip disabled groups
-            if (g >= 0 && g < G && world.is_group_enabled(g)) {
-                ++in_count;
-                ++per_group[g];
+    m_region_index.for_each_candidate(
+        screen_to_world_bounds(logical, ctx, camera_offset), [&](int i) {
+            if (i >= total_particles) {
+                return;
             }
-        }
-    }
+            Vector2 p = interpolate_position(ctx, i);
+            Vector2 ps = world_to_screen(p, ctx, camera_offset);
+            if (ps.x >= logical.x && ps.x < logical.x + logical.width &&
+                ps.y >= logical.y && ps.y < logical.y + logical.height) {
+                int g = world.group_of(i);
+                // Skip disabled groups
+                if (g >= 0 && g < G && world.is_group_enabled(g)) {
+                    ++in_count;
+                    ++per_group[g];
+                }
+            }
+        });
 
     ImGui::Text("Particles in region: %d", in_count);
     if (G > 0) {
@@ -418,22 +458,30 @@ void InspectorUI::handle_particle_picking(Context &ctx,
     int best_id = -1;
     float best_d2 = 1e30f;
 
-    for (int i = 0; i < total_particles; ++i) {
-        Vector2 p = interpolate_position(ctx, i);
-        Vector2 ps = world_to_screen(p, ctx, camera_offset);
-        if (ps.x < logical.x || ps.x > logical.x + logical.width ||
-            ps.y < logical.y || ps.y > logical.y + logical.height) {
-            continue;
-        }
+    // Only particles within the pick radius of the click can win
+    const Rectangle pick_rect = {wx - pick_radius_px, wy - pick_radius_px,
+                                 pick_radius_px * 2.f, pick_radius_px * 2.f};
+    m_region_index.for_each_candidate(
+        screen_to_world_bounds(pick_rect, ctx, camera_offset), [&](int i) {
+            if (i >= total_particles) {
+                return;
+            }
+            Vector2 p = interpolate_position(ctx, i);
+            Vector2 ps = world_to_screen(p, ctx, camera_offset);
+            if (ps.x < logical.x || ps.x > logical.x + logical.width ||
+                ps.y < logical.y || ps.y > logical.y + logical.height) {
+                return;
+            }
 
-        float dx = ps.x - wx;
-        float dy = ps.y - wy;
-        float d2 = dx * dx + dy * dy;
-        if (d2 < best_d2) {
-            best_d2 = d2;
-            best_id = i;
-        }
-    }
+            float dx = ps.x - wx;
+            float dy = ps.y - wy;
+            float d2 = dx * dx + dy * dy;
+            // Lowest id wins ties so the result does not depend on cell order
+            if (d2 < best_d2 || (d2 == best_d2 && i < best_id)) {
+                best_d2 = d2;
+                best_id = i;
+            }
+        });
 
     if (best_id >= 0 && best_d2 <= pick_r2) {
         m_selection.tracked_id = best_id;
@@ -5,6 +5,7 @@
 #include <rlImGui.h>
 
 #include "../irenderer.hpp"
+#include "../region_index.hpp"
 
 /**
  * @brief UI component for inspecting particle regions and tracking individual
@@ -68,6 +69,19 @@ class InspectorUI : public IRenderer {
      */
     void follow_tracked(Context &ctx);
 
+    /**
+     * @brief Asks the simulation for the velocity stream while a particle is
+     * tracked, and stops it otherwise.
+     * @param ctx The rendering context.
+     */
+    void request_velocities(Context &ctx);
+
+    /**
+     * @brief Refreshes the region index if a new frame was published.
+     * @param ctx The rendering context.
+     */
+    void update_region_index(Context &ctx);
+
     /**
      * @brief Draws the selection overlay on the render texture.
      */
@@ -146,4 +160,7 @@ class InspectorUI : public IRenderer {
 
     /** @brief Render texture for drawing selection overlays. */
     RenderTexture2D m_render_texture{};
+
+    /** @brief Spatial index for region queries, rebuilt per sim frame. */
+    RegionIndex m_region_index;
 };
\ No newline at end of file
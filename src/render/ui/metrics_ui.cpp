@@ -1,5 +1,9 @@
 #include "metrics_ui.hpp"
 
+#include <algorithm>
+#include <cfloat>
+#include <utility>
+
 void MetricsUI::render(Context &ctx) {
     if (!ctx.rcfg.show_ui || !ctx.rcfg.show_metrics_ui) {
         return;
@@ -10,12 +14,14 @@ void MetricsUI::render(Context &ctx) {
 void MetricsUI::render_ui(Context &ctx) {
     static std::array<float, 240> fps_buf{};
     static std::array<float, 240> tps_buf{};
+    static std::array<float, 240> p99_buf{};
     static int head = 0;
 
     const int fps = GetFPS();
     const auto stats = ctx.sim.get_stats();
     fps_buf[head] = static_cast<float>(fps);
     tps_buf[head] = static_cast<float>(stats.effective_tps);
+    p99_buf[head] = static_cast<float>(stats.step_latency.p99_ns / 1e6);
     head = (head + 1) % static_cast<int>(fps_buf.size());
 
     ImGui::Begin("[1] metrics", &ctx.rcfg.show_metrics_ui);
@@ -27,8 +33,11 @@ void MetricsUI::render_ui(Context &ctx) {
         ImGuiCond_Appearing);
     ImGui::SetWindowSize(ImVec2{width, height}, ImGuiCond_Appearing);
 
-    render_performance_section(ctx, fps_buf, tps_buf, head, fps, stats);
+    render_performance_section(ctx, fps_buf, tps_buf, p99_buf, head, fps,
+                               stats);
     render_details_section(ctx, stats);
+    render_analytics_section(ctx);
+    render_memory_section(ctx);
     render_camera_section(ctx);
     render_debug_section();
 
@@ -37,7 +46,8 @@ void MetricsUI::render_ui(Context &ctx) {
 
 void MetricsUI::render_performance_section(
     Context &ctx, const std::array<float, 240> &fps_buf,
-    const std::array<float, 240> &tps_buf, int head, int fps,
+    const std::array<float, 240> &tps_buf,
+    const std::array<float, 240> &p99_buf, int head, int fps,
     const mailbox::SimulationStatsSnapshot &stats) {
     ImGui::SeparatorText("Performance");
 
@@ -66,18 +76,147 @@ void MetricsUI::render_performance_section(
     plot_circ(fps_buf, head, 240.0f, "##fps_plot");
     ImGui::Text("TPS: %d", stats.effective_tps);
     plot_circ(tps_buf, head, 240.0f, "##tps_plot");
+    ImGui::Text("Step p99: %.2f ms", stats.step_latency.p99_ns / 1e6);
+    plot_circ(p99_buf, head, FLT_MAX, "##p99_plot");
 }
 
 void MetricsUI::render_details_section(
     Context &ctx, const mailbox::SimulationStatsSnapshot &stats) {
     ImGui::SeparatorText("Details");
     ImGui::Text("Last step: %.3f ms", stats.last_step_ns / 1e6);
+    const auto &latency = stats.step_latency;
+    ImGui::Text("Step p50/p95/p99/max: %.2f / %.2f / %.2f / %.2f ms",
+                latency.p50_ns / 1e6, latency.p95_ns / 1e6,
+                latency.p99_ns / 1e6, latency.max_ns / 1e6);
     ImGui::Text("Num steps: %lld", stats.num_steps);
     ImGui::Text("Particles: %d  Groups: %d  Threads: %d", stats.particles,
                 stats.groups, stats.sim_threads);
     const auto scfg = ctx.sim.get_config();
     ImGui::Text("Sim Bounds: %.0f x %.0f", scfg.bounds_width,
                 scfg.bounds_height);
+    if (scfg.target_tps > 0) {
+        ImGui::Text("Missed deadlines: %lld  Oversleep p99: %.2f ms",
+                    stats.missed_deadlines, stats.oversleep.p99_ns / 1e6);
+    }
+}
+
+void MetricsUI::render_analytics_section(Context &ctx) {
+    ImGui::SeparatorText("Analytics");
+    const auto analytics = ctx.sim.get_analytics();
+    if (analytics.particles == 0) {
+        ImGui::TextDisabled("No particles stepped yet");
+        return;
+    }
+
+    const double inv_particles = 1.0 / analytics.particles;
+    ImGui::Text("Kinetic energy: %.1f (%.3f per particle)",
+                analytics.kinetic_energy,
+                analytics.kinetic_energy * inv_particles);
+    ImGui::Text("Momentum: %.1f, %.1f", analytics.momentum_x,
+                analytics.momentum_y);
+    ImGui::Text("Max speed: %.2f", analytics.max_speed);
+
+    std::array<float, mailbox::AnalyticsSnapshot::SPEED_BINS> speeds{};
+    for (int b = 0; b < (int)speeds.size(); ++b) {
+        speeds[b] = (float)analytics.speed_histogram[b];
+    }
+    ImGui::PlotHistogram("##speed_hist", speeds.data(), (int)speeds.size(), 0,
+                         "speed", 0.0f, FLT_MAX, ImVec2(-1, 44));
+
+    ImGui::Text("Cells: %d of %lld occupied, max %d", analytics.occupied_cells,
+                analytics.cells, analytics.max_cell_count);
+    ImGui::Text("Per occupied cell: %.1f +/- %.1f", analytics.mean_cell_count,
+                analytics.cell_count_stddev);
+    ImGui::Text("Stencil: %lld cells read, %lld pruned (%lld candidates)",
+                analytics.scanned_cells, analytics.pruned_cells,
+                analytics.pruned_candidates);
+    ImGui::Text("Pairs: %lld examined, %lld accepted (%.1f%%)",
+                analytics.examined_pairs, analytics.accepted_pairs,
+                analytics.pair_acceptance * 100.f);
+
+    if (ImGui::TreeNode("Group centroids")) {
+        for (int g = 0; g < (int)analytics.centroid_x.size(); ++g) {
+            ImGui::Text("Group %d: %.1f, %.1f", g, analytics.centroid_x[g],
+                        analytics.centroid_y[g]);
+        }
+        ImGui::TreePop();
+    }
+
+    render_clusters(ctx);
+}
+
+void MetricsUI::render_clusters(Context &ctx) {
+    const auto clusters = ctx.sim.get_clusters();
+    if (clusters.particles == 0) {
+        ImGui::TextDisabled("Clusters: enable in the sim config");
+        return;
+    }
+
+    ImGui::Text("Clusters: %d (>= %d particles, at step %lld)",
+                (int)clusters.sizes.size(), mailbox::ClusterSnapshot::MIN_SIZE,
+                clusters.num_steps);
+    ImGui::Text("Clustered: %.1f%%  Largest: %d",
+                100.0 * clusters.clustered / clusters.particles,
+                clusters.largest);
+
+    std::array<float, mailbox::ClusterSnapshot::SIZE_BINS> bins{};
+    for (int b = 0; b < (int)bins.size(); ++b) {
+        bins[b] = (float)clusters.size_histogram[b];
+    }
+    ImGui::PlotHistogram("##cluster_sizes", bins.data(), (int)bins.size(), 0,
+                         "log2 size", 0.0f, FLT_MAX, ImVec2(-1, 44));
+
+    if (ImGui::TreeNode("Largest clusters")) {
+        const int shown = std::min(16, (int)clusters.sizes.size());
+        for (int c = 0; c < shown; ++c) {
+            ImGui::Text("%d particles at %.1f, %.1f", clusters.sizes[c],
+                        clusters.centroid_x[c], clusters.centroid_y[c]);
+        }
+        ImGui::TreePop();
+    }
+}
+
+void MetricsUI::render_memory_section(Context &ctx) {
+    using Usage = particles::utility::MemoryUsage;
+    ImGui::SeparatorText("Memory");
+
+    const auto memory = ctx.sim.get_memory();
+    const Usage undo = ctx.undo.memory_usage();
+    Usage total = memory.total();
+    total.merge(undo);
+    auto mb = [](long long bytes) {
+        return (double)bytes / (1024.0 * 1024.0);
+    };
+    ImGui::Text("Total: %.1f MB used, %.1f MB reserved", mb(total.used_bytes),
+                mb(total.reserved_bytes));
+
+    const std::pair<const char *, const Usage *> parts[] = {
+        {"World", &memory.world},
+        {"Grid CSR", &memory.grid_csr},
+        {"Stepper", &memory.stepper},
+        {"Draw buffer", &memory.draw_buffer},
+        {"Snapshots", &memory.snapshots},
+        {"Commands", &memory.commands},
+        {"Undo history", &undo},
+    };
+    if (ImGui::BeginTable("##memory", 3)) {
+        for (const auto &[name, usage] : parts) {
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn();
+            ImGui::TextUnformatted(name);
+            ImGui::TableNextColumn();
+            ImGui::Text("%.2f / %.2f MB", mb(usage->used_bytes),
+                        mb(usage->reserved_bytes));
+            ImGui::TableNextColumn();
+            // Capacity left behind by shrinking, e.g. after remove_group
+            if (usage->wasteful()) {
+                ImGui::TextColored(ImVec4{1.f, 0.6f, 0.2f, 1.f},
+                                   "%.1f MB unused",
+                                   mb(usage->slack_bytes()));
+            }
+        }
+        ImGui::EndTable();
+    }
 }
 
 void MetricsUI::render_camera_section(Context &ctx) {
@@ -31,10 +31,14 @@ class MetricsUI : public IRenderer {
     void render_ui(Context &ctx);
     void render_performance_section(
         Context &ctx, const std::array<float, 240> &fps_buf,
-        const std::array<float, 240> &tps_buf, int head, int fps,
+        const std::array<float, 240> &tps_buf,
+        const std::array<float, 240> &p99_buf, int head, int fps,
         const mailbox::SimulationStatsSnapshot &stats);
     void render_details_section(Context &ctx,
                                 const mailbox::SimulationStatsSnapshot &stats);
+    void render_analytics_section(Context &ctx);
+    void render_clusters(Context &ctx);
+    void render_memory_section(Context &ctx);
     void render_camera_section(Context &ctx);
     void render_debug_section();
 };
@@ -454,6 +454,7 @@ mailbox::command::SeedSpec ParticleEditorUI::create_backup_state(Context &ctx) {
     backup_state.r2.resize(G);
     backup_state.enabled.resize(G);
     backup_state.rules.resize(G * G);
+    backup_state.rng_seed = world.rng_seed;
 
     for (int g = 0; g < G; ++g) {
         backup_state.sizes[g] =
@@ -23,11 +23,15 @@ void RenderConfigUI::render_ui(Context &ctx) {
     render_background_section(ctx);
     render_border_section(ctx);
     render_particle_rendering_section(ctx);
+    render_culling_section(ctx, mark);
     render_overlays_section(ctx, mark);
 
     scfg.draw_report.grid_data = rcfg.show_grid_lines ||
                                  rcfg.show_density_heat ||
+                                 rcfg.show_cost_heat ||
                                  rcfg.show_velocity_field;
+    scfg.draw_report.cell_costs = rcfg.show_cost_heat;
+    scfg.draw_report.packed_positions = rcfg.packed_positions;
 
     ImGui::End();
 
@@ -196,6 +200,53 @@ void RenderConfigUI::render_glow_settings(Context &ctx) {
     }
 }
 
+void RenderConfigUI::render_culling_section(Context &ctx,
+                                            std::function<void(bool)> mark) {
+    auto &rcfg = ctx.rcfg;
+
+    ImGui::SeparatorText("Culling & LOD");
+    {
+        bool before = rcfg.packed_positions;
+        if (ImGui::Checkbox("16-bit positions", &rcfg.packed_positions)) {
+            push_rcfg(ctx, "render.packed_positions", "16-bit positions",
+                      before, rcfg.packed_positions, [&](const bool &v) {
+                          rcfg.packed_positions = v;
+                      });
+            mark(true);
+        }
+    }
+    {
+        bool before = rcfg.cull_cells;
+        if (ImGui::Checkbox("Cull off-screen cells", &rcfg.cull_cells)) {
+            push_rcfg(ctx, "render.cull_cells", "Cull off-screen cells",
+                      before, rcfg.cull_cells, [&](const bool &v) {
+                          rcfg.cull_cells = v;
+                      });
+        }
+    }
+    {
+        bool before = rcfg.density_lod;
+        if (ImGui::Checkbox("Density LOD", &rcfg.density_lod)) {
+            push_rcfg(ctx, "render.density_lod", "Density LOD", before,
+                      rcfg.density_lod, [&](const bool &v) {
+                          rcfg.density_lod = v;
+                      });
+        }
+    }
+    if (rcfg.density_lod) {
+        float before = rcfg.lod_px_per_particle;
+        if (ImGui::SliderFloat("LOD below (px/particle)",
+                               &rcfg.lod_px_per_particle, 0.05f, 4.0f,
+                               "%.2f")) {
+            push_rcfg(ctx, "render.lod_px_per_particle",
+                      "LOD below (px/particle)", before,
+                      rcfg.lod_px_per_particle, [&](const float &v) {
+                          rcfg.lod_px_per_particle = v;
+                      });
+        }
+    }
+}
+
 void RenderConfigUI::render_overlays_section(Context &ctx,
                                              std::function<void(bool)> mark) {
     auto &rcfg = ctx.rcfg;
@@ -211,7 +262,17 @@ void RenderConfigUI::render_overlays_section(Context &ctx,
             mark(true);
         }
     }
-    if (rcfg.show_density_heat) {
+    {
+        bool before = rcfg.show_cost_heat;
+        if (ImGui::Checkbox("Force cost heatmap", &rcfg.show_cost_heat)) {
+            push_rcfg(ctx, "render.show_cost_heat", "Force cost heatmap",
+                      before, rcfg.show_cost_heat, [&](const bool &v) {
+                          rcfg.show_cost_heat = v;
+                      });
+            mark(true);
+        }
+    }
+    if (rcfg.show_density_heat || rcfg.show_cost_heat) {
         float before = rcfg.heat_alpha;
         if (ImGui::SliderFloat("Heat alpha", &rcfg.heat_alpha, 0.0f, 1.0f,
                                "%.2f")) {
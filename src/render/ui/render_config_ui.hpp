@@ -31,6 +31,7 @@ class RenderConfigUI : public IRenderer {
     void render_border_section(Context &ctx);
     void render_particle_rendering_section(Context &ctx);
     void render_glow_settings(Context &ctx);
+    void render_culling_section(Context &ctx, std::function<void(bool)> mark);
     void render_overlays_section(Context &ctx, std::function<void(bool)> mark);
     void render_velocity_field_settings(Context &ctx);
 
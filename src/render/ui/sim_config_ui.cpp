@@ -185,6 +185,55 @@ void SimConfigUI::render_simulation_params(
                          });
         scfg_updated = true;
     }
+
+    // Force lookup table
+    bool before_force_table = scfg.force_table;
+    if (ImGui::Checkbox("Force lookup table", &scfg.force_table)) {
+        push_scfg_action(ctx, "sim.force_table", "Force lookup table",
+                         before_force_table, scfg.force_table,
+                         [&](const bool &v) {
+                             auto cfg = sim.get_config();
+                             cfg.force_table = v;
+                             sim.update_config(cfg);
+                         });
+        scfg_updated = true;
+    }
+    if (ImGui::IsItemHovered()) {
+        ImGui::SetTooltip("Interpolate pair forces from a table per group "
+                          "pair instead of computing them");
+    }
+
+    // Cluster detection
+    int before_cluster_interval = scfg.cluster_interval;
+    if (ImGui::SliderInt("Cluster every N steps", &scfg.cluster_interval, 0,
+                         240, "%d", ImGuiSliderFlags_AlwaysClamp)) {
+        push_scfg_action(ctx, "sim.cluster_interval", "Cluster interval",
+                         before_cluster_interval, scfg.cluster_interval,
+                         [&](const int &v) {
+                             auto cfg = sim.get_config();
+                             cfg.cluster_interval = v;
+                             sim.update_config(cfg);
+                         });
+        scfg_updated = true;
+    }
+    if (ImGui::IsItemHovered()) {
+        ImGui::SetTooltip("Count connected clusters of particles every N "
+                          "steps (0 = off); results show in metrics");
+    }
+
+    float before_cluster_distance = scfg.cluster_distance;
+    if (ImGui::SliderFloat("Cluster distance (px)", &scfg.cluster_distance,
+                           1.0f, 100.0f, "%.1f",
+                           ImGuiSliderFlags_AlwaysClamp)) {
+        push_scfg_action(ctx, "sim.cluster_distance", "Cluster distance",
+                         before_cluster_distance, scfg.cluster_distance,
+                         [&](const float &v) {
+                             auto cfg = sim.get_config();
+                             cfg.cluster_distance = v;
+                             sim.update_config(cfg);
+                         });
+        scfg_updated = true;
+    }
 }
 
 void SimConfigUI::render_gravity_section(
@@ -160,6 +160,8 @@ std::optional<mailbox::command::SeedSpec> SaveManager::extract_current_seed(
         seed.enabled.push_back(world_snapshot.is_group_enabled(g));
     }
 
+    seed.rng_seed = world_snapshot.rng_seed;
+
     return seed;
 }
 
@@ -241,6 +243,8 @@ json SaveManager::seed_to_json(
         j["groups"].push_back(group);
     }
 
+    j["rng_seed"] = seed->rng_seed;
+
     return j;
 }
 
@@ -248,6 +252,10 @@ std::optional<mailbox::command::SeedSpec>
 SaveManager::json_to_seed(const json &j) {
     mailbox::command::SeedSpec seed;
 
+    if (j.contains("rng_seed")) {
+        seed.rng_seed = j["rng_seed"].get<uint64_t>();
+    }
+
     if (j.contains("groups")) {
         const auto &groups = j["groups"];
         seed.sizes.clear();
@@ -302,7 +310,14 @@ json SaveManager::sim_config_to_json(
                 {"gravity_y", config.gravity_y},
                 {"target_tps", config.target_tps},
                 {"sim_threads", config.sim_threads},
-                {"draw_report", {{"grid_data", config.draw_report.grid_data}}}};
+                {"force_table", config.force_table},
+                {"cluster_interval", config.cluster_interval},
+                {"cluster_distance", config.cluster_distance},
+                {"draw_report",
+                 {{"grid_data", config.draw_report.grid_data},
+                  {"cell_costs", config.draw_report.cell_costs},
+                  {"packed_positions",
+                   config.draw_report.packed_positions}}}};
 }
 
 mailbox::SimulationConfigSnapshot
@@ -339,9 +354,26 @@ SaveManager::json_to_sim_config(const json &j) {
     if (j.contains("sim_threads")) {
         config.sim_threads = j["sim_threads"];
     }
+    if (j.contains("force_table")) {
+        config.force_table = j["force_table"];
+    }
+    if (j.contains("cluster_interval")) {
+        config.cluster_interval = j["cluster_interval"];
+    }
+    if (j.contains("cluster_distance")) {
+        config.cluster_distance = j["cluster_distance"];
+    }
     if (j.contains("draw_report") && j["draw_report"].contains("grid_data")) {
         config.draw_report.grid_data = j["draw_report"]["grid_data"];
     }
+    if (j.contains("draw_report") && j["draw_report"].contains("cell_costs")) {
+        config.draw_report.cell_costs = j["draw_report"]["cell_costs"];
+    }
+    if (j.contains("draw_report") &&
+        j["draw_report"].contains("packed_positions")) {
+        config.draw_report.packed_positions =
+            j["draw_report"]["packed_positions"];
+    }
 
     return config;
 }
@@ -356,12 +388,17 @@ json SaveManager::render_config_to_json(const Config &config) {
                 {"inner_scale_mul", config.inner_scale_mul},
                 {"inner_rgb_gain", config.inner_rgb_gain},
                 {"final_additive_blit", config.final_additive_blit},
+                {"cull_cells", config.cull_cells},
+                {"density_lod", config.density_lod},
+                {"lod_px_per_particle", config.lod_px_per_particle},
+                {"packed_positions", config.packed_positions},
                 {"background_color", color_to_json(config.background_color)},
                 {"border_enabled", config.border_enabled},
                 {"border_color", color_to_json(config.border_color)},
                 {"border_width", config.border_width},
                 {"show_density_heat", config.show_density_heat},
                 {"heat_alpha", config.heat_alpha},
+                {"show_cost_heat", config.show_cost_heat},
                 {"show_velocity_field", config.show_velocity_field},
                 {"vel_scale", config.vel_scale},
                 {"vel_thickness", config.vel_thickness},
@@ -402,6 +439,18 @@ Config SaveManager::json_to_render_config(const json &j) {
     if (j.contains("final_additive_blit")) {
         config.final_additive_blit = j["final_additive_blit"];
     }
+    if (j.contains("cull_cells")) {
+        config.cull_cells = j["cull_cells"];
+    }
+    if (j.contains("density_lod")) {
+        config.density_lod = j["density_lod"];
+    }
+    if (j.contains("lod_px_per_particle")) {
+        config.lod_px_per_particle = j["lod_px_per_particle"];
+    }
+    if (j.contains("packed_positions")) {
+        config.packed_positions = j["packed_positions"];
+    }
     if (j.contains("background_color")) {
         config.background_color = json_to_color(j["background_color"]);
     }
@@ -420,6 +469,9 @@ Config SaveManager::json_to_render_config(const json &j) {
     if (j.contains("heat_alpha")) {
         config.heat_alpha = j["heat_alpha"];
     }
+    if (j.contains("show_cost_heat")) {
+        config.show_cost_heat = j["show_cost_heat"];
+    }
     if (j.contains("show_velocity_field")) {
         config.show_velocity_field = j["show_velocity_field"];
     }
@@ -0,0 +1,169 @@
+#include "rule_search.hpp"
+
+#include <algorithm>
+#include <string>
+
+#include "../utility/exceptions.hpp"
+
+RuleSearch::RuleSearch(const RuleSearchOptions &options,
+                       const mailbox::command::SeedSpec &base,
+                       const mailbox::SimulationConfigSnapshot &cfg)
+    : m_options(options), m_base(base), m_cfg(cfg),
+      m_groups(base.group_count()), m_rng(options.seed),
+      m_ensemble(options.threads) {
+    if (m_options.population < 2) {
+        throw particles::ConfigError("Search population must be >= 2, got " +
+                                     std::to_string(m_options.population));
+    }
+    if (m_options.steps < 2) {
+        throw particles::ConfigError("Search steps must be >= 2, got " +
+                                     std::to_string(m_options.steps));
+    }
+    if (m_options.elite < 0 || m_options.elite >= m_options.population) {
+        throw particles::ConfigError(
+            "Search elite must be in [0, population), got " +
+            std::to_string(m_options.elite));
+    }
+    if (m_options.tournament < 1) {
+        throw particles::ConfigError("Search tournament must be >= 1, got " +
+                                     std::to_string(m_options.tournament));
+    }
+    if (!(m_options.mutation_scale > 0.f) || !(m_options.rule_limit > 0.f)) {
+        throw particles::ConfigError(
+            "Search mutation scale and rule limit must be positive");
+    }
+    if (m_groups <= 0) {
+        throw particles::ConfigError("Search seed has no groups");
+    }
+
+    // Every candidate sees the same particle placement
+    m_base.rng_seed = m_options.seed;
+    m_base.ensure_defaults();
+
+    const int entries = m_groups * m_groups;
+    std::uniform_real_distribution<float> uniform(-m_options.rule_limit,
+                                                  m_options.rule_limit);
+    m_population.resize(m_options.population);
+    for (int c = 0; c < m_options.population; ++c) {
+        std::vector<float> &rules = m_population[c].rules;
+        if (c == 0 && (int)base.rules.size() == entries) {
+            rules = base.rules;
+            continue;
+        }
+        rules.resize(entries);
+        for (float &r : rules) {
+            r = uniform(m_rng);
+        }
+    }
+
+    // Fails fast on bad bounds instead of on the first evaluate()
+    m_ensemble.add(seed_of(m_population[0]), m_cfg);
+    m_ensemble.clear();
+}
+
+void RuleSearch::evaluate() {
+    std::vector<int> pending;
+    m_ensemble.clear();
+    for (int c = 0; c < (int)m_population.size(); ++c) {
+        if (!m_population[c].evaluated) {
+            m_ensemble.add(seed_of(m_population[c]), m_cfg);
+            pending.push_back(c);
+        }
+    }
+
+    if (!pending.empty()) {
+        const int half = m_options.steps / 2;
+        const int n = (int)pending.size();
+        std::vector<DensityHistogram> early(n);
+        m_ensemble.step(half);
+        for (int k = 0; k < n; ++k) {
+            early[k].sample(m_ensemble.world(k), m_cfg.bounds_width,
+                            m_cfg.bounds_height);
+        }
+        m_ensemble.step(m_options.steps - half);
+
+        DensityHistogram late;
+        for (int k = 0; k < n; ++k) {
+            const World &world = m_ensemble.world(k);
+            late.sample(world, m_cfg.bounds_width, m_cfg.bounds_height);
+
+            Candidate &candidate = m_population[pending[k]];
+            candidate.metrics.clustering = late.clustering();
+            candidate.metrics.persistence = late.similarity(early[k]);
+            candidate.metrics.kinetic_energy = mean_kinetic_energy(world);
+            candidate.score = score(candidate.metrics, m_options.weights);
+            candidate.evaluated = true;
+        }
+        m_evaluations += n;
+        m_ensemble.clear();
+    }
+
+    // Stable so equal scores keep their order and the search stays
+    // reproducible
+    std::stable_sort(m_population.begin(), m_population.end(),
+                     [](const Candidate &a, const Candidate &b) {
+                         return a.score > b.score;
+                     });
+}
+
+void RuleSearch::evolve() {
+    evaluate();
+
+    std::vector<Candidate> next;
+    next.reserve(m_population.size());
+    for (int e = 0; e < m_options.elite; ++e) {
+        next.push_back(m_population[e]);
+    }
+
+    std::uniform_real_distribution<float> unit(0.f, 1.f);
+    std::normal_distribution<float> perturb(0.f, m_options.mutation_scale);
+    while ((int)next.size() < m_options.population) {
+        const Candidate &a = select();
+        const Candidate &b = select();
+        Candidate child;
+        child.rules.resize(a.rules.size());
+        for (size_t k = 0; k < child.rules.size(); ++k) {
+            float r = unit(m_rng) < 0.5f ? a.rules[k] : b.rules[k];
+            if (unit(m_rng) < m_options.mutation_rate) {
+                r += perturb(m_rng);
+            }
+            child.rules[k] = limit(r);
+        }
+        next.push_back(std::move(child));
+    }
+
+    m_population = std::move(next);
+    ++m_generation;
+}
+
+mailbox::command::SeedSpec
+RuleSearch::seed_of(const Candidate &candidate) const {
+    mailbox::command::SeedSpec seed = m_base;
+    seed.rules = candidate.rules;
+    return seed;
+}
+
+float RuleSearch::score(const FitnessMetrics &metrics,
+                        const FitnessWeights &weights) noexcept {
+    const float energy = std::max(0.f, metrics.kinetic_energy);
+    const float activity =
+        weights.energy_scale > 0.f ? energy / (energy + weights.energy_scale)
+                                   : 0.f;
+    return weights.clustering * metrics.clustering +
+           weights.persistence * metrics.persistence +
+           weights.activity * activity;
+}
+
+const Candidate &RuleSearch::select() {
+    std::uniform_int_distribution<int> pick(0, (int)m_population.size() - 1);
+    // The population is sorted best first, so the lowest index wins
+    int best = pick(m_rng);
+    for (int t = 1; t < m_options.tournament; ++t) {
+        best = std::min(best, pick(m_rng));
+    }
+    return m_population[best];
+}
+
+float RuleSearch::limit(float rule) const noexcept {
+    return std::clamp(rule, -m_options.rule_limit, m_options.rule_limit);
+}
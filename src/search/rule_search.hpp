@@ -0,0 +1,151 @@
+#pragma once
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "../mailbox/command/cmd_seedspec.hpp"
+#include "../mailbox/data_snapshot.hpp"
+#include "../simulation/ensemble.hpp"
+#include "../simulation/fitness.hpp"
+
+/**
+ * @brief Weights of each metric in a candidate's score
+ */
+struct FitnessWeights {
+    float clustering = 1.f;
+    float persistence = 0.5f;
+    float activity = 0.5f;
+    /** @brief Kinetic energy at which activity reaches 0.5 (worlds at the
+     * app's default viscosity sit in the hundreds) */
+    float energy_scale = 200.f;
+};
+
+/**
+ * @brief Parameters of an evolutionary rule search
+ */
+struct RuleSearchOptions {
+    int population = 48;         // Candidates per generation
+    int steps = 300;             // Simulation steps per evaluation
+    int elite = 4;               // Best candidates copied unchanged
+    int tournament = 3;          // Candidates drawn per parent selection
+    float mutation_rate = 0.2f;  // Chance to perturb each rule entry
+    float mutation_scale = 0.3f; // Standard deviation of a perturbation
+    float rule_limit = 1.f;      // Rules are kept within [-limit, limit]
+    uint64_t seed = 1;           // Drives the search and particle placement
+    int threads = -1;            // Evaluation threads (-1 for automatic)
+    FitnessWeights weights;
+};
+
+/**
+ * @brief One rule matrix and its evaluation
+ */
+struct Candidate {
+    std::vector<float> rules; // Row-major G x G
+    FitnessMetrics metrics;
+    float score = 0.f;
+    bool evaluated = false;
+};
+
+/**
+ * @brief Evolves rule matrices toward worlds that form lasting structures
+ *
+ * Every candidate is a rule matrix applied to the same base seed (group
+ * sizes, colors, radii) and the same particle placement. A generation is
+ * evaluated as one Ensemble, stepping all unevaluated candidates in parallel
+ * for options.steps steps. The density histogram taken half way and at the
+ * end gives clustering and persistence; the final velocities give the kinetic
+ * energy. Evaluation is deterministic, so elites carried into the next
+ * generation keep their score without being simulated again.
+ *
+ * The next generation keeps the elite and fills the rest with uniform
+ * crossover of tournament-selected parents plus Gaussian mutation. The whole
+ * search is reproducible from options.seed.
+ */
+class RuleSearch {
+  public:
+    /**
+     * @brief Creates a random initial population
+     * @param options Search parameters
+     * @param base Groups every candidate is evaluated with (its rules are
+     * the first candidate)
+     * @param cfg Simulation config for the evaluation worlds
+     * @throws ConfigError if the options, seed or bounds are invalid
+     */
+    RuleSearch(const RuleSearchOptions &options,
+               const mailbox::command::SeedSpec &base,
+               const mailbox::SimulationConfigSnapshot &cfg);
+
+    /**
+     * @brief Scores every unevaluated candidate and sorts the population
+     * best first
+     */
+    void evaluate();
+
+    /**
+     * @brief Replaces the population with the next generation
+     *
+     * Evaluates the current population first if needed.
+     */
+    void evolve();
+
+    /**
+     * @brief Gets the population
+     * @return Candidates, best first after evaluate()
+     */
+    const std::vector<Candidate> &population() const noexcept {
+        return m_population;
+    }
+
+    /**
+     * @brief Gets the current generation number
+     * @return Number of evolve() calls so far
+     */
+    int generation() const noexcept { return m_generation; }
+
+    /**
+     * @brief Gets how many candidates have been simulated
+     * @return Evaluations since construction
+     */
+    long long evaluations() const noexcept { return m_evaluations; }
+
+    /**
+     * @brief Builds the seed that reproduces a candidate's world
+     * @param candidate Candidate from population()
+     * @return Base seed with the candidate's rules and the search's particle
+     * placement key
+     */
+    mailbox::command::SeedSpec seed_of(const Candidate &candidate) const;
+
+    /**
+     * @brief Combines metrics into a single score
+     * @param metrics Measured metrics
+     * @param weights Metric weights
+     * @return Weighted sum; activity is energy / (energy + energy_scale)
+     */
+    static float score(const FitnessMetrics &metrics,
+                       const FitnessWeights &weights) noexcept;
+
+  private:
+    /**
+     * @brief Picks the best of options.tournament random candidates
+     */
+    const Candidate &select();
+
+    /**
+     * @brief Clamps a rule to the allowed range
+     */
+    float limit(float rule) const noexcept;
+
+    RuleSearchOptions m_options;
+    mailbox::command::SeedSpec m_base;
+    mailbox::SimulationConfigSnapshot m_cfg;
+    int m_groups;
+
+    std::vector<Candidate> m_population;
+    int m_generation = 0;
+    long long m_evaluations = 0;
+
+    std::mt19937_64 m_rng;
+    Ensemble m_ensemble;
+};
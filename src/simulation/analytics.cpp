@@ -0,0 +1,78 @@
+#include "analytics.hpp"
+
+void AnalyticsPartial::merge(const AnalyticsPartial &other) noexcept {
+    kinetic_energy += other.kinetic_energy;
+    momentum_x += other.momentum_x;
+    momentum_y += other.momentum_y;
+    max_speed = std::max(max_speed, other.max_speed);
+    particles += other.particles;
+    for (int b = 0; b < SPEED_BINS; ++b) {
+        speed_histogram[b] += other.speed_histogram[b];
+    }
+    const size_t n = std::min(group_sums.size(), other.group_sums.size());
+    for (size_t k = 0; k < n; ++k) {
+        group_sums[k] += other.group_sums[k];
+    }
+}
+
+void CellPartial::merge(const CellPartial &other) noexcept {
+    occupied += other.occupied;
+    max_count = std::max(max_count, other.max_count);
+    sum += other.sum;
+    sum_squares += other.sum_squares;
+}
+
+void StencilPartial::merge(const StencilPartial &other) noexcept {
+    scanned_cells += other.scanned_cells;
+    pruned_cells += other.pruned_cells;
+    pruned_candidates += other.pruned_candidates;
+    examined_pairs += other.examined_pairs;
+    accepted_pairs += other.accepted_pairs;
+}
+
+void finish_analytics(const AnalyticsPartial &particles,
+                      const CellPartial &cells, const StencilPartial &stencil,
+                      long long total_cells, float speed_range,
+                      mailbox::AnalyticsSnapshot &out) {
+    out.particles = particles.particles;
+    out.kinetic_energy = particles.kinetic_energy;
+    out.momentum_x = particles.momentum_x;
+    out.momentum_y = particles.momentum_y;
+    out.max_speed = particles.max_speed;
+    out.speed_range = speed_range;
+    out.speed_histogram = particles.speed_histogram;
+
+    const int groups = (int)particles.group_sums.size() / 3;
+    out.centroid_x.assign(groups, 0.f);
+    out.centroid_y.assign(groups, 0.f);
+    for (int g = 0; g < groups; ++g) {
+        const double *const sums = particles.group_sums.data() + g * 3;
+        if (sums[2] > 0.0) {
+            out.centroid_x[g] = (float)(sums[0] / sums[2]);
+            out.centroid_y[g] = (float)(sums[1] / sums[2]);
+        }
+    }
+
+    out.cells = total_cells;
+    out.occupied_cells = cells.occupied;
+    out.max_cell_count = cells.max_count;
+    out.mean_cell_count = 0.f;
+    out.cell_count_stddev = 0.f;
+    if (cells.occupied > 0) {
+        const double mean = cells.sum / cells.occupied;
+        const double variance =
+            std::max(0.0, cells.sum_squares / cells.occupied - mean * mean);
+        out.mean_cell_count = (float)mean;
+        out.cell_count_stddev = (float)std::sqrt(variance);
+    }
+
+    out.scanned_cells = stencil.scanned_cells;
+    out.pruned_cells = stencil.pruned_cells;
+    out.pruned_candidates = stencil.pruned_candidates;
+    out.examined_pairs = stencil.examined_pairs;
+    out.accepted_pairs = stencil.accepted_pairs;
+    out.pair_acceptance =
+        stencil.examined_pairs > 0
+            ? (float)((double)stencil.accepted_pairs / stencil.examined_pairs)
+            : 0.f;
+}
@@ -0,0 +1,146 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <vector>
+
+#include "../mailbox/data_snapshot.hpp"
+
+/**
+ * @brief Per-particle analytics summed over a range of particles
+ *
+ * One partial is filled per reduction chunk by the fused position kernel and
+ * the partials are merged in chunk order (see reduce_chunks), so the totals
+ * do not depend on the thread count.
+ */
+struct AnalyticsPartial {
+    static constexpr int SPEED_BINS = mailbox::AnalyticsSnapshot::SPEED_BINS;
+
+    double kinetic_energy = 0.0; // Sum of 0.5 * |v|^2
+    double momentum_x = 0.0;     // Sum of vx
+    double momentum_y = 0.0;     // Sum of vy
+    float max_speed = 0.f;       // Fastest particle in the range
+    int particles = 0;           // Particles accumulated
+    std::array<int, SPEED_BINS> speed_histogram{};
+    std::vector<double> group_sums; // Sum of x, sum of y and count per group
+
+    AnalyticsPartial() = default;
+
+    /**
+     * @brief Creates an empty partial
+     * @param groups Number of groups in the world
+     */
+    explicit AnalyticsPartial(int groups) : group_sums(groups * 3, 0.0) {}
+
+    /**
+     * @brief Adds one particle
+     * @param group Group of the particle
+     * @param x Position x after the step
+     * @param y Position y after the step
+     * @param vx Velocity x after the step
+     * @param vy Velocity y after the step
+     * @param bins_per_speed SPEED_BINS / histogram range
+     */
+    inline void add(int group, float x, float y, float vx, float vy,
+                    float bins_per_speed) noexcept {
+        const float speed2 = vx * vx + vy * vy;
+        const float speed = std::sqrt(speed2);
+        kinetic_energy += 0.5 * speed2;
+        momentum_x += vx;
+        momentum_y += vy;
+        max_speed = std::max(max_speed, speed);
+        ++particles;
+
+        // Compared as float so huge or non-finite speeds land in the last bin
+        const float scaled = speed * bins_per_speed;
+        const int bin =
+            scaled < (float)(SPEED_BINS - 1) ? (int)scaled : SPEED_BINS - 1;
+        ++speed_histogram[bin];
+
+        double *const sums = group_sums.data() + group * 3;
+        sums[0] += x;
+        sums[1] += y;
+        sums[2] += 1.0;
+    }
+
+    /**
+     * @brief Folds another partial into this one
+     * @param other Partial of a later range
+     */
+    void merge(const AnalyticsPartial &other) noexcept;
+};
+
+/**
+ * @brief Particle counts summed over a range of neighbor grid cells
+ */
+struct CellPartial {
+    int occupied = 0;         // Cells holding at least one particle
+    int max_count = 0;        // Most particles in one cell
+    double sum = 0.0;         // Sum of the occupied cells' counts
+    double sum_squares = 0.0; // Sum of the squared counts
+
+    /**
+     * @brief Adds one cell
+     * @param count Particles in the cell
+     */
+    inline void add(int count) noexcept {
+        if (count <= 0) {
+            return;
+        }
+        ++occupied;
+        max_count = std::max(max_count, count);
+        sum += count;
+        sum_squares += (double)count * count;
+    }
+
+    /**
+     * @brief Folds another partial into this one
+     * @param other Partial of a later range
+     */
+    void merge(const CellPartial &other) noexcept;
+};
+
+/**
+ * @brief Neighbor stencil work of the force pass over a range of particles
+ */
+struct StencilPartial {
+    long long scanned_cells = 0;     // Neighbor cells whose particles were read
+    long long pruned_cells = 0;      // Cells skipped as out of the radius
+    long long pruned_candidates = 0; // Particles in the skipped cells
+    long long examined_pairs = 0;    // Candidates read in the scanned cells
+    long long accepted_pairs = 0;    // Candidates inside the radius
+
+    /**
+     * @brief Folds another partial into this one
+     * @param other Partial of a later range
+     */
+    void merge(const StencilPartial &other) noexcept;
+};
+
+/**
+ * @brief Gets the number of cell slots a grid stores counts for
+ * @param grid UniformGrid (every cell) or SparseGrid (occupied cells only)
+ * @return Valid range for grid.cell_count_at()
+ */
+template <typename Grid> inline int cell_slots(const Grid &grid) {
+    if constexpr (requires { grid.occupied_cells(); }) {
+        return grid.occupied_cells();
+    } else {
+        return grid.cols() * grid.rows();
+    }
+}
+
+/**
+ * @brief Turns reduced partials into a snapshot
+ * @param particles Reduced per-particle analytics
+ * @param cells Reduced cell counts
+ * @param stencil Reduced stencil work of the force pass
+ * @param total_cells Cells spanned by the grid, empty ones included
+ * @param speed_range Upper edge of the speed histogram used for particles
+ * @param out Snapshot to fill (num_steps is left untouched)
+ */
+void finish_analytics(const AnalyticsPartial &particles,
+                      const CellPartial &cells, const StencilPartial &stencil,
+                      long long total_cells, float speed_range,
+                      mailbox::AnalyticsSnapshot &out);
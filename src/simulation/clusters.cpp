@@ -0,0 +1,65 @@
+#include "clusters.hpp"
+
+void ClusterFinder::collect(const World &world,
+                            mailbox::ClusterSnapshot &out) {
+    using Snapshot = mailbox::ClusterSnapshot;
+
+    const int n = world.get_particles_size();
+    const float *const px = world.get_px_array();
+    const float *const py = world.get_py_array();
+    m_component.resize(n);
+    m_sums.clear();
+
+    // Roots are the lowest index of their component, so they are met before
+    // any other member and components are numbered in index order
+    int particles = 0;
+    for (int i = 0; i < n; ++i) {
+        if (!world.is_group_enabled(world.group_of(i))) {
+            continue;
+        }
+        ++particles;
+        const int r = m_parent[i];
+        if (r == i) {
+            m_component[i] = (int)m_sums.size() / 3;
+            m_sums.insert(m_sums.end(), {0.0, 0.0, 0.0});
+        }
+        double *const sums = m_sums.data() + m_component[r] * 3;
+        sums[0] += px[i];
+        sums[1] += py[i];
+        sums[2] += 1.0;
+    }
+
+    const int components = (int)m_sums.size() / 3;
+    out.particles = particles;
+    out.components = components;
+    out.clustered = 0;
+    out.largest = 0;
+    out.size_histogram.fill(0);
+    m_order.clear();
+    for (int c = 0; c < components; ++c) {
+        const int size = (int)m_sums[c * 3 + 2];
+        const int bin = std::min((int)std::log2((double)size),
+                                 Snapshot::SIZE_BINS - 1);
+        ++out.size_histogram[bin];
+        out.largest = std::max(out.largest, size);
+        if (size >= Snapshot::MIN_SIZE) {
+            out.clustered += size;
+            m_order.push_back(c);
+        }
+    }
+
+    // Largest first; ties keep index order so the list is reproducible
+    std::stable_sort(m_order.begin(), m_order.end(), [&](int a, int b) {
+        return m_sums[a * 3 + 2] > m_sums[b * 3 + 2];
+    });
+
+    out.sizes.resize(m_order.size());
+    out.centroid_x.resize(m_order.size());
+    out.centroid_y.resize(m_order.size());
+    for (size_t k = 0; k < m_order.size(); ++k) {
+        const double *const sums = m_sums.data() + m_order[k] * 3;
+        out.sizes[k] = (int)sums[2];
+        out.centroid_x[k] = (float)(sums[0] / sums[2]);
+        out.centroid_y[k] = (float)(sums[1] / sums[2]);
+    }
+}
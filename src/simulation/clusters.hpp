@@ -0,0 +1,172 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <vector>
+
+#include "../mailbox/data_snapshot.hpp"
+#include "world.hpp"
+
+/**
+ * @brief Finds clusters of particles as connected components
+ *
+ * Two particles of enabled groups are linked when they are closer than the
+ * link distance; a cluster is a connected component of those links. Links
+ * come from the neighbor grid the step already built: each particle scans
+ * only the forward half of its cell stencil, so every pair is tested once,
+ * and linked pairs are merged in a lock-free union-find shared by all
+ * threads.
+ *
+ * A root is always linked below the smaller index, so each component ends up
+ * rooted at its lowest particle index. The components, their order and their
+ * sums therefore do not depend on the thread count or on scheduling.
+ */
+class ClusterFinder {
+  public:
+    /**
+     * @brief Finds the clusters of a world
+     * @param world World whose positions the grid was built from
+     * @param grid Neighbor grid (UniformGrid or SparseGrid) of the positions
+     * @param distance Link distance
+     * @param for_n Called as for_n(kernel, n) to run kernel(start, end) over
+     * [0, n), serially or on a pool
+     * @param out Snapshot to fill (num_steps is left untouched)
+     */
+    template <typename Grid, typename ForN>
+    void find(const World &world, const Grid &grid, float distance,
+              ForN &&for_n, mailbox::ClusterSnapshot &out) {
+        const int n = world.get_particles_size();
+        m_parent.resize(n);
+        for (int i = 0; i < n; ++i) {
+            m_parent[i] = i;
+        }
+
+        const float distance2 = distance * distance;
+        const int reach =
+            std::max(1, (int)std::ceil(distance * grid.inv_cell()));
+        for_n(
+            [&](int s, int e) {
+                link(world, grid, s, e, reach, distance2);
+            },
+            n);
+        // Point every particle straight at its root before collecting
+        for_n(
+            [&](int s, int e) {
+                for (int i = s; i < e; ++i) {
+                    m_parent[i] = root(i);
+                }
+            },
+            n);
+
+        collect(world, out);
+        out.link_distance = distance;
+    }
+
+  private:
+    /**
+     * @brief Links particles [start, end) to their forward neighbors
+     */
+    template <typename Grid>
+    void link(const World &world, const Grid &grid, int start, int end,
+              int reach, float distance2) noexcept {
+        const float *const px = world.get_px_array();
+        const float *const py = world.get_py_array();
+        const auto &indices = grid.indices();
+
+        for (int i = start; i < end; ++i) {
+            if (!world.is_group_enabled(world.group_of(i))) {
+                continue;
+            }
+            const float x = px[i];
+            const float y = py[i];
+            int cx, cy;
+            grid.cell_of(x, y, cx, cy);
+
+            // Same row: this cell and the ones to the right; then every
+            // cell of the rows below
+            for (int dy = 0; dy <= reach; ++dy) {
+                for (int dx = dy == 0 ? 0 : -reach; dx <= reach; ++dx) {
+                    const int ci = grid.cell_index(cx + dx, cy + dy);
+                    if (ci < 0) {
+                        continue;
+                    }
+                    const bool own_cell = dx == 0 && dy == 0;
+                    const int cell_start = grid.cell_start_at(ci);
+                    const int cell_end = cell_start + grid.cell_count_at(ci);
+                    for (int pos = cell_start; pos < cell_end; ++pos) {
+                        const int j = indices[pos];
+                        if (own_cell && j <= i) {
+                            continue;
+                        }
+                        const float ddx = x - px[j];
+                        const float ddy = y - py[j];
+                        if (ddx * ddx + ddy * ddy < distance2 &&
+                            world.is_group_enabled(world.group_of(j))) {
+                            unite(i, j);
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief Finds a particle's root, halving the path on the way
+     */
+    int root(int x) noexcept {
+        while (true) {
+            int parent = std::atomic_ref<int>(m_parent[x]).load(
+                std::memory_order_relaxed);
+            if (parent == x) {
+                return x;
+            }
+            const int grandparent = std::atomic_ref<int>(m_parent[parent])
+                                        .load(std::memory_order_relaxed);
+            if (grandparent != parent) {
+                std::atomic_ref<int>(m_parent[x])
+                    .compare_exchange_weak(parent, grandparent,
+                                           std::memory_order_relaxed);
+            }
+            x = grandparent;
+        }
+    }
+
+    /**
+     * @brief Merges the components of two particles
+     */
+    void unite(int a, int b) noexcept {
+        while (true) {
+            a = root(a);
+            b = root(b);
+            if (a == b) {
+                return;
+            }
+            if (a < b) {
+                std::swap(a, b);
+            }
+            // Link the larger root below the smaller one; retry if another
+            // thread linked it first
+            int expected = a;
+            if (std::atomic_ref<int>(m_parent[a])
+                    .compare_exchange_strong(expected, b,
+                                             std::memory_order_acq_rel)) {
+                return;
+            }
+        }
+    }
+
+    /**
+     * @brief Sums the flattened components into the snapshot
+     */
+    void collect(const World &world, mailbox::ClusterSnapshot &out);
+
+    /** @brief Union-find parent per particle (root after find()) */
+    particles::utility::AlignedVector<int> m_parent;
+    /** @brief Component index per root particle */
+    std::vector<int> m_component;
+    /** @brief Sum of x, sum of y and count per component */
+    std::vector<double> m_sums;
+    /** @brief Components sorted for the snapshot */
+    std::vector<int> m_order;
+};
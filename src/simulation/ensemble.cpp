@@ -0,0 +1,82 @@
+#include "ensemble.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <string>
+
+#include "../utility/exceptions.hpp"
+#include "seed_world.hpp"
+
+Ensemble::Ensemble(int threads) : m_pool(threads) {}
+
+int Ensemble::add(const mailbox::command::SeedSpec &seed,
+                  const mailbox::SimulationConfigSnapshot &cfg) {
+    if (cfg.bounds_width <= 0.f || cfg.bounds_height <= 0.f) {
+        throw particles::ConfigError(
+            "Ensemble world bounds must be positive, got " +
+            std::to_string(cfg.bounds_width) + "x" +
+            std::to_string(cfg.bounds_height));
+    }
+    for (int size : seed.sizes) {
+        if (size < 0) {
+            throw particles::ConfigError(
+                "Ensemble group size must be >= 0, got " +
+                std::to_string(size));
+        }
+    }
+
+    auto member = std::make_unique<Member>();
+    member->cfg = cfg;
+
+    // Seeded serially: members are small, and add() runs on the caller
+    seed_world(member->world, seed, cfg.bounds_width, cfg.bounds_height,
+               [](auto &&kernel, int n) {
+                   kernel(0, n);
+               });
+
+    m_members.push_back(std::move(member));
+    return size() - 1;
+}
+
+void Ensemble::step(int ticks) {
+    if (ticks <= 0 || m_members.empty()) {
+        return;
+    }
+
+    // One job per thread; each claims the next unstepped world until none
+    // are left, so uneven worlds balance themselves
+    std::atomic<int> next{0};
+    const int lanes = std::min(threads(), size());
+    m_pool.parallel_for_n(
+        [&](int, int) {
+            for (int k = next.fetch_add(1); k < size();
+                 k = next.fetch_add(1)) {
+                advance(*m_members[k], ticks);
+            }
+        },
+        lanes, 1);
+}
+
+void Ensemble::advance(Member &member, int ticks) {
+    using namespace std::chrono;
+    const auto start = steady_clock::now();
+    for (int t = 0; t < ticks; ++t) {
+        member.stepper.step(member.world, member.cfg);
+    }
+    const long long ns =
+        duration_cast<nanoseconds>(steady_clock::now() - start).count();
+
+    EnsembleMetrics &m = member.metrics;
+    m.steps += ticks;
+    m.busy_ns += ns;
+    m.last_step_ns = ns / ticks;
+
+    const World &world = member.world;
+    const int n = world.get_particles_size();
+    double speed = 0.0;
+    for (int i = 0; i < n; ++i) {
+        speed += std::hypot(world.get_vx(i), world.get_vy(i));
+    }
+    m.mean_speed = n > 0 ? (float)(speed / n) : 0.f;
+}
@@ -0,0 +1,127 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "../mailbox/command/cmd_seedspec.hpp"
+#include "../mailbox/data_snapshot.hpp"
+#include "multicore.hpp"
+#include "stepper.hpp"
+#include "world.hpp"
+
+/**
+ * @brief Per-world statistics collected by an Ensemble
+ */
+struct EnsembleMetrics {
+    long long steps = 0;        // Steps taken since the world was added
+    long long busy_ns = 0;      // Total time spent stepping this world
+    long long last_step_ns = 0; // Mean step duration of the last step() call
+    float mean_speed = 0.f;     // Mean particle speed after the last step()
+};
+
+/**
+ * @brief Steps many small independent worlds on one shared thread pool
+ *
+ * Each member has its own World, Stepper, config and seed. Instead of
+ * splitting one world's particles across threads, which parallel_for_n skips
+ * for small worlds anyway, every pool thread claims whole worlds from a shared
+ * counter and steps them on its own thread. A slow world only delays the
+ * thread that claimed it, so throughput scales with cores even when each
+ * world is tiny.
+ *
+ * Members are stepped with Stepper's serial overload, which produces the same
+ * result as a Simulation stepping the same world: the ensemble is
+ * deterministic regardless of the thread count.
+ */
+class Ensemble {
+  public:
+    /**
+     * @brief Creates an empty ensemble
+     * @param threads Pool threads (-1 for automatic detection)
+     */
+    explicit Ensemble(int threads = -1);
+    ~Ensemble() = default;
+    Ensemble(const Ensemble &) = delete;
+    Ensemble &operator=(const Ensemble &) = delete;
+    Ensemble(Ensemble &&) = delete;
+    Ensemble &operator=(Ensemble &&) = delete;
+
+    /**
+     * @brief Adds a world built from a seed
+     * @param seed Groups, rules, radii and RNG key; particles are placed
+     * exactly as Simulation places them for the same seed and bounds
+     * @param cfg Simulation config for this world (sim_threads is ignored)
+     * @return Index of the new world
+     * @throws ConfigError if the bounds are not positive or a group size is
+     * negative
+     */
+    int add(const mailbox::command::SeedSpec &seed,
+            const mailbox::SimulationConfigSnapshot &cfg);
+
+    /**
+     * @brief Removes every world, keeping the thread pool
+     */
+    void clear() noexcept { m_members.clear(); }
+
+    /**
+     * @brief Advances every world and waits for all of them
+     * @param ticks Steps per world
+     */
+    void step(int ticks = 1);
+
+    /**
+     * @brief Gets the number of worlds
+     * @return World count
+     */
+    int size() const noexcept { return (int)m_members.size(); }
+
+    /**
+     * @brief Gets the number of pool threads
+     * @return Thread count
+     */
+    int threads() const noexcept { return m_pool.size(); }
+
+    /**
+     * @brief Gets a world
+     * @param index World index from add()
+     * @return World state as of the last step()
+     */
+    const World &world(int index) const { return m_members.at(index)->world; }
+
+    /**
+     * @brief Gets a world's config
+     * @param index World index from add()
+     * @return Config the world is stepped with
+     */
+    const mailbox::SimulationConfigSnapshot &config(int index) const {
+        return m_members.at(index)->cfg;
+    }
+
+    /**
+     * @brief Gets a world's statistics
+     * @param index World index from add()
+     * @return Metrics as of the last step()
+     */
+    const EnsembleMetrics &metrics(int index) const {
+        return m_members.at(index)->metrics;
+    }
+
+  private:
+    /**
+     * @brief One independent world with its own stepping state
+     */
+    struct Member {
+        World world;
+        Stepper stepper;
+        mailbox::SimulationConfigSnapshot cfg;
+        EnsembleMetrics metrics;
+    };
+
+    /**
+     * @brief Steps one member and updates its metrics
+     */
+    static void advance(Member &member, int ticks);
+
+    std::vector<std::unique_ptr<Member>> m_members;
+    SimulationThreadPool m_pool;
+};
@@ -0,0 +1,74 @@
+#include "fitness.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+void DensityHistogram::sample(const World &world, float width, float height) {
+    std::fill(m_counts.begin(), m_counts.end(), 0.f);
+    m_total = world.get_particles_size();
+
+    const float sx = width > 0.f ? BINS / width : 0.f;
+    const float sy = height > 0.f ? BINS / height : 0.f;
+    const float *const px = world.get_px_array();
+    const float *const py = world.get_py_array();
+    for (int i = 0; i < m_total; ++i) {
+        const int bx = std::clamp((int)(px[i] * sx), 0, BINS - 1);
+        const int by = std::clamp((int)(py[i] * sy), 0, BINS - 1);
+        m_counts[by * BINS + bx] += 1.f;
+    }
+}
+
+float DensityHistogram::clustering() const noexcept {
+    if (m_total <= 0) {
+        return 0.f;
+    }
+
+    const double inv_total = 1.0 / m_total;
+    double entropy = 0.0;
+    for (float c : m_counts) {
+        if (c > 0.f) {
+            const double p = c * inv_total;
+            entropy -= p * std::log(p);
+        }
+    }
+    const double max_entropy = std::log((double)BINS * BINS);
+    return (float)std::clamp(1.0 - entropy / max_entropy, 0.0, 1.0);
+}
+
+float DensityHistogram::similarity(
+    const DensityHistogram &other) const noexcept {
+    if (m_total <= 0 || other.m_total <= 0) {
+        return 0.f;
+    }
+
+    // Subtracting the uniform level keeps a featureless world from scoring 1
+    const double mean_a = (double)m_total / (BINS * BINS);
+    const double mean_b = (double)other.m_total / (BINS * BINS);
+    double dot = 0.0, norm_a = 0.0, norm_b = 0.0;
+    for (size_t k = 0; k < m_counts.size(); ++k) {
+        const double a = m_counts[k] - mean_a;
+        const double b = other.m_counts[k] - mean_b;
+        dot += a * b;
+        norm_a += a * a;
+        norm_b += b * b;
+    }
+    if (norm_a <= 0.0 || norm_b <= 0.0) {
+        return 0.f;
+    }
+    return (float)std::clamp(dot / std::sqrt(norm_a * norm_b), 0.0, 1.0);
+}
+
+float mean_kinetic_energy(const World &world) {
+    const int n = world.get_particles_size();
+    if (n <= 0) {
+        return 0.f;
+    }
+
+    const float *const vx = world.get_vx_array();
+    const float *const vy = world.get_vy_array();
+    double energy = 0.0;
+    for (int i = 0; i < n; ++i) {
+        energy += 0.5 * ((double)vx[i] * vx[i] + (double)vy[i] * vy[i]);
+    }
+    return (float)(energy / n);
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <vector>
+
+#include "world.hpp"
+
+/**
+ * @brief Cheap whole-world descriptors used to score rule sets
+ */
+struct FitnessMetrics {
+    float clustering = 0.f;     // 0 = uniform density, 1 = one dense spot
+    float kinetic_energy = 0.f; // Mean 0.5 * |v|^2 per particle
+    float persistence = 0.f;    // Density similarity between two samples
+};
+
+/**
+ * @brief Coarse particle density over the world bounds
+ *
+ * Counts particles on a fixed BINS x BINS grid. One pass over the positions,
+ * so it is cheap enough to sample every few hundred steps for each world of
+ * a search population.
+ */
+class DensityHistogram {
+  public:
+    /** @brief Bins per axis */
+    static constexpr int BINS = 32;
+
+    /**
+     * @brief Counts the world's particles
+     * @param world World to sample
+     * @param width Bounds width
+     * @param height Bounds height
+     */
+    void sample(const World &world, float width, float height);
+
+    /**
+     * @brief Measures how concentrated the density is
+     * @return 1 - normalized entropy of the bin counts: 0 when particles are
+     * spread evenly over every bin, 1 when they all share one bin
+     */
+    float clustering() const noexcept;
+
+    /**
+     * @brief Compares two samples of the same world
+     * @param other Histogram sampled at another time
+     * @return Cosine similarity of the bin counts minus the uniform level,
+     * clamped to [0, 1]; 1 when the same structures sit in the same place
+     */
+    float similarity(const DensityHistogram &other) const noexcept;
+
+    /**
+     * @brief Gets the number of particles counted
+     * @return Particle count of the last sample
+     */
+    int total() const noexcept { return m_total; }
+
+  private:
+    std::vector<float> m_counts = std::vector<float>(BINS * BINS, 0.f);
+    int m_total = 0;
+};
+
+/**
+ * @brief Computes the mean kinetic energy per particle
+ * @param world World to measure
+ * @return Mean 0.5 * |v|^2, 0 for an empty world
+ */
+float mean_kinetic_energy(const World &world);
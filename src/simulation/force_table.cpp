@@ -0,0 +1,49 @@
+#include "force_table.hpp"
+
+#include <cmath>
+
+bool ForceTable::update(const particles::WorldBase &world) {
+    const int groups = world.get_groups_size();
+    const std::vector<float> &rules = world.get_rules();
+    const std::vector<float> &radii2 = world.get_group_radii2();
+    if (groups == m_groups && rules == m_rules && radii2 == m_radii2) {
+        return false;
+    }
+
+    m_groups = groups;
+    m_rules = rules;
+    m_radii2 = radii2;
+    build();
+    return true;
+}
+
+float ForceTable::sample(float rule, float distance_squared) noexcept {
+    return rule / std::sqrt(distance_squared);
+}
+
+void ForceTable::build() {
+    const int G = m_groups;
+    m_inverse_step.assign(G, 0.f);
+    m_values.assign((size_t)G * G * (BINS + 1), 0.f);
+    if (m_rules.size() < (size_t)G * G || m_radii2.size() < (size_t)G) {
+        return;
+    }
+
+    for (int src = 0; src < G; ++src) {
+        const float r2 = m_radii2[src];
+        if (r2 <= 0.f) {
+            continue;
+        }
+        const float step = r2 / BINS;
+        m_inverse_step[src] = BINS / r2;
+        for (int dst = 0; dst < G; ++dst) {
+            const float rule = m_rules[(size_t)src * G + dst];
+            float *const samples =
+                &m_values[((size_t)src * G + dst) * (BINS + 1)];
+            samples[0] = sample(rule, 0.5f * step);
+            for (int k = 1; k <= BINS; ++k) {
+                samples[k] = sample(rule, (float)k * step);
+            }
+        }
+    }
+}
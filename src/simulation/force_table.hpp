@@ -0,0 +1,112 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+#include "../utility/memory_usage.hpp"
+#include "../world_base.hpp"
+
+/**
+ * @brief Precomputed force factors per (source, target) group pair
+ *
+ * The kernel's pair force is rule(src, dst) / d applied along (dx, dy). The
+ * table samples that factor at BINS + 1 evenly spaced squared distances over
+ * [0, r2(src)] for every target group, so the kernel replaces the rule lookup
+ * and reciprocal square root with one interpolated load keyed by d².
+ *
+ * Linear interpolation in d² is accurate to well under 1% once d is more
+ * than a few bins from zero; the first bin is clamped to its midpoint value
+ * instead of diverging, which caps the force between overlapping particles.
+ * Any other falloff law that is a function of d² can be tabulated the same
+ * way by changing sample().
+ */
+class ForceTable {
+  public:
+    /** @brief Intervals per table row (rows hold BINS + 1 samples) */
+    static constexpr int BINS = 1024;
+
+    /**
+     * @brief Row of samples for one source group
+     */
+    struct SourceRow {
+        /** @brief Samples for target group 0; target g starts at g * stride */
+        const float *values;
+        /** @brief BINS / r2(src), maps d² to a fractional bin */
+        float inverse_step;
+
+        /**
+         * @brief Interpolates the force factor for a pair
+         * @param target Target group index
+         * @param distance_squared Squared distance, in [0, r2(src))
+         * @return rule(src, target) / distance
+         */
+        inline float at(int target, float distance_squared) const noexcept {
+            const float t = distance_squared * inverse_step;
+            const int bin = std::min((int)t, BINS - 1);
+            const float *const samples = values + (size_t)target * (BINS + 1);
+            const float frac = t - (float)bin;
+            return samples[bin] + (samples[bin + 1] - samples[bin]) * frac;
+        }
+    };
+
+    /**
+     * @brief Rebuilds the table if the world's rules or radii changed
+     * @param world Source of rules and interaction radii
+     * @return True if the table was rebuilt
+     */
+    bool update(const particles::WorldBase &world);
+
+    /**
+     * @brief Gets the samples for one source group
+     * @param source Source group index (must be < groups())
+     * @return Row view for the kernel
+     */
+    inline SourceRow row(int source) const noexcept {
+        return {&m_values[(size_t)source * m_groups * (BINS + 1)],
+                m_inverse_step[source]};
+    }
+
+    /**
+     * @brief Gets the number of groups the table was built for
+     * @return Group count
+     */
+    int groups() const noexcept { return m_groups; }
+
+    /**
+     * @brief Gets the memory held by the samples
+     * @return Size in bytes
+     */
+    size_t bytes() const noexcept { return m_values.size() * sizeof(float); }
+
+    /**
+     * @brief Gets the memory held by the samples and the cached inputs
+     * @return Usage of every table
+     */
+    particles::utility::MemoryUsage memory_usage() const noexcept {
+        particles::utility::MemoryUsage usage;
+        usage.add(m_rules).add(m_radii2).add(m_inverse_step).add(m_values);
+        return usage;
+    }
+
+    /**
+     * @brief Evaluates the force law the table samples
+     * @param rule Interaction strength for the pair
+     * @param distance_squared Squared distance (> 0)
+     * @return Force factor applied to (dx, dy)
+     */
+    static float sample(float rule, float distance_squared) noexcept;
+
+  private:
+    /**
+     * @brief Fills every row from the cached rules and radii
+     */
+    void build();
+
+    int m_groups = 0;
+    /** @brief Rules and radii the table was built from (change detection) */
+    std::vector<float> m_rules;
+    std::vector<float> m_radii2;
+    std::vector<float> m_inverse_step;
+    std::vector<float> m_values;
+};
@@ -0,0 +1,25 @@
+#pragma once
+
+#include "world.hpp"
+
+/**
+ * @brief Receives every published frame on the simulation thread
+ *
+ * Lets a process export frames (e.g. to shared memory) without the
+ * simulation depending on the transport. write() runs inside the publish
+ * path, so it must not block; an exception thrown from it detaches the sink.
+ */
+class IFrameSink {
+  public:
+    virtual ~IFrameSink() = default;
+
+    /**
+     * @brief Takes the frame just published to the draw buffer
+     * @param world World after the step
+     * @param width Bounds width
+     * @param height Bounds height
+     * @param stamp_ns Publish timestamp of the frame
+     */
+    virtual void write(const World &world, float width, float height,
+                       long long stamp_ns) = 0;
+};
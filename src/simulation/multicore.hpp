@@ -25,6 +25,62 @@ concept Kernel = requires(F f, int a, int b) {
     { f(a, b) } -> std::same_as<void>;
 };
 
+/**
+ * @brief Concept for reduction kernels
+ * @details A reduction kernel accepts a start and end index and accumulates
+ * that range into the partial result passed by reference
+ */
+template <typename F, typename T>
+concept ReduceKernel = requires(F f, int a, int b, T &partial) {
+    { f(a, b, partial) } -> std::same_as<void>;
+};
+
+/** @brief Default number of items folded into one partial of a reduction */
+inline constexpr int REDUCE_GRAIN = 4096;
+
+/**
+ * @brief Reduces [0, n_items) in fixed-size chunks
+ * @details Every chunk of grain items is accumulated into its own copy of
+ * identity, then the partials are combined in chunk order. The chunking never
+ * depends on the thread count, so the result, floating point rounding
+ * included, is the same on one thread or many.
+ * @param identity Initial value of every partial
+ * @param fn Kernel called as fn(start, end, partial)
+ * @param combine Called as combine(into, from) to fold one partial into
+ * another
+ * @param n_items Total number of items to reduce
+ * @param grain Items per chunk
+ * @param run_chunks Called as run_chunks(kernel, chunks); must call
+ * kernel(first, last) over ranges covering [0, chunks) exactly once
+ * @return Combined result (identity when n_items <= 0)
+ */
+template <typename T, ReduceKernel<T> F, typename C, typename RunChunks>
+T reduce_chunks(const T &identity, F &fn, C &combine, int n_items, int grain,
+                RunChunks &&run_chunks) {
+    if (n_items <= 0) {
+        return identity;
+    }
+
+    grain = std::max(1, grain);
+    const int chunks = (n_items - 1) / grain + 1;
+    std::vector<T> partials(chunks, identity);
+    run_chunks(
+        [&](int first, int last) {
+            for (int c = first; c < last; ++c) {
+                const int start = c * grain;
+                const int end = start + std::min(grain, n_items - start);
+                fn(start, end, partials[c]);
+            }
+        },
+        chunks);
+
+    T result = std::move(partials[0]);
+    for (int c = 1; c < chunks; ++c) {
+        combine(result, partials[c]);
+    }
+    return result;
+}
+
 /**
  * @brief Computes the optimal number of simulation threads
  * @return Number of threads to use for simulation (leaves 1 core for render
@@ -68,20 +124,30 @@ class SimulationThreadPool {
      */
     void resize(int threads);
 
+    /**
+     * @brief Gets the number of worker threads in the pool
+     * @return Worker thread count
+     */
+    inline int size() const noexcept {
+        return static_cast<int>(m_workers.size());
+    }
+
     /**
      * @brief Executes a kernel function in parallel across multiple threads
      * @param fn Kernel function to execute (must accept start and end
      * parameters)
      * @param n_items Total number of items to process
+     * @param min_parallel_items Below this item count the kernel runs inline
+     * on the calling thread (use 1 for coarse work items such as tiles)
      */
     template <Kernel F>
-    void parallel_for_n(F fn, int n_items) {
+    void parallel_for_n(F fn, int n_items, int min_parallel_items = 1024) {
         if (n_items <= 0) {
             return;
         }
 
         int num_threads = std::max(1, static_cast<int>(m_workers.size()));
-        if (num_threads == 1 || n_items < 1024) {
+        if (num_threads == 1 || n_items < min_parallel_items) {
             fn(0, n_items);
             return;
         }
@@ -103,6 +169,25 @@ class SimulationThreadPool {
         job_latch.wait();
     }
 
+    /**
+     * @brief Reduces a range in parallel with a thread-count independent
+     * result
+     * @param identity Initial value of every partial
+     * @param fn Kernel called as fn(start, end, partial)
+     * @param combine Called as combine(into, from) to fold partials together
+     * @param n_items Total number of items to reduce
+     * @param grain Items per partial; chunks are spread over the workers
+     * @return Combined result, see reduce_chunks
+     */
+    template <typename T, ReduceKernel<T> F, typename C>
+    T parallel_reduce_n(const T &identity, F fn, C combine, int n_items,
+                        int grain = REDUCE_GRAIN) {
+        return reduce_chunks(identity, fn, combine, n_items, grain,
+                             [this](auto &&kernel, int chunks) {
+                                 parallel_for_n(kernel, chunks, 1);
+                             });
+    }
+
   private:
     /**
      * @brief Starts the thread pool with the specified number of threads
@@ -1,5 +1,9 @@
 #pragma once
 
+#include <cmath>
+#include <cstdint>
+
+#include "sparsegrid.hpp"
 #include "uniformgrid.hpp"
 #include "world.hpp"
 
@@ -8,11 +12,33 @@
  * @details Caches a UniformGrid to avoid expensive rebuilds when simulation
  * parameters haven't changed. Provides optimized spatial queries for particle
  * physics calculations.
+ *
+ * Two grid layouts back the same query API: the dense @ref UniformGrid and
+ * the occupied-cells-only @ref SparseGrid. The layout is chosen on every
+ * resize from the expected occupancy (items per cell), so huge mostly-empty
+ * bounds do not allocate, clear and scan tens of millions of empty cells each
+ * tick. Use @ref visit to run code against whichever grid is active.
  */
 struct NeighborIndex {
-    /** @brief The underlying spatial hash grid */
+    /**
+     * @brief Cells per item above which the sparse layout is used
+     * @details Below this the dense grid's O(cells) clear and scan is cheaper
+     * than a hash lookup per neighbor cell.
+     */
+    static constexpr int64_t SPARSE_CELLS_PER_ITEM = 16;
+
+    /** @brief Dense grids at or below this many cells are always kept */
+    static constexpr int64_t SPARSE_MIN_CELLS = 1 << 20;
+
+    /** @brief The dense spatial hash grid */
     UniformGrid grid;
 
+    /** @brief The sparse spatial hash grid */
+    SparseGrid sparse_grid;
+
+    /** @brief Whether sparse_grid is the active layout */
+    bool sparse = false;
+
     /** @brief Cached particle count from last build */
     int lastN = -1;
 
@@ -25,6 +51,32 @@ struct NeighborIndex {
     /** @brief Cached cell size from last build */
     float lastCell = -1.f;
 
+    /**
+     * @brief Creates an empty index whose dense grid builds the CSR view only
+     * @details The force kernel, clusters and the published draw frames all
+     * read cells as CSR ranges, so the head/next lists are never written.
+     */
+    NeighborIndex() { grid.set_linked_lists(false); }
+
+    /**
+     * @brief Invokes fn with the active grid (UniformGrid or SparseGrid)
+     * @param fn Generic callable taking the grid by reference
+     * @return Whatever fn returns
+     */
+    template <typename Fn> decltype(auto) visit(Fn &&fn) {
+        if (sparse) {
+            return fn(sparse_grid);
+        }
+        return fn(grid);
+    }
+
+    template <typename Fn> decltype(auto) visit(Fn &&fn) const {
+        if (sparse) {
+            return fn(sparse_grid);
+        }
+        return fn(grid);
+    }
+
     /**
      * @brief Ensures the spatial grid is up-to-date and returns inverse cell
      * size
@@ -35,28 +87,61 @@ struct NeighborIndex {
      * @return Inverse cell size (1.0f / cell) for efficient distance
      * calculations
      * @details Rebuilds the grid only if parameters have changed since last
-     * call
+     * call. Particles of disabled groups are left out of the grid, and every
+     * cell records the groups it holds (see UniformGrid::cell_mask_at).
      */
     inline float ensure(const World &w, float W, float H, float cell) {
         const int N = w.get_particles_size();
         const bool needResize =
             (N != lastN) || (W != lastW) || (H != lastH) || (cell != lastCell);
         if (needResize) {
-            grid.resize(W, H, cell, N);
+            sparse = use_sparse(W, H, cell, N);
+            if (sparse) {
+                grid.reset();
+                sparse_grid.resize(W, H, cell, N);
+            } else {
+                sparse_grid.reset();
+                grid.resize(W, H, cell, N);
+            }
             lastN = N;
             lastW = W;
             lastH = H;
             lastCell = cell;
         }
-        grid.build(
-            N,
-            [&w](int i) {
-                return w.get_px(i);
-            },
-            [&w](int i) {
-                return w.get_py(i);
-            },
-            W, H);
-        return grid.inv_cell();
+        return visit([&](auto &g) {
+            g.build(
+                N,
+                [&w](int i) {
+                    return w.get_px(i);
+                },
+                [&w](int i) {
+                    return w.get_py(i);
+                },
+                W, H,
+                [&w](int i) {
+                    const int group = w.group_of(i);
+                    return w.is_group_enabled(group) ? group : -1;
+                });
+            return g.inv_cell();
+        });
+    }
+
+    /**
+     * @brief Picks the grid layout for the given bounds and item count
+     * @param W World width
+     * @param H World height
+     * @param cell Cell size
+     * @param N Item count
+     * @return True if the sparse layout should be used
+     */
+    static bool use_sparse(float W, float H, float cell, int N) {
+        const float c = std::max(1.0f, cell);
+        const int64_t cols =
+            std::max<int64_t>(1, (int64_t)std::ceil(std::max(1.0f, W) / c));
+        const int64_t rows =
+            std::max<int64_t>(1, (int64_t)std::ceil(std::max(1.0f, H) / c));
+        const int64_t cells = cols * rows;
+        return cells > SPARSE_MIN_CELLS &&
+               cells > SPARSE_CELLS_PER_ITEM * std::max(1, N);
     }
 };
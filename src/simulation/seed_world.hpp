@@ -0,0 +1,116 @@
+#pragma once
+
+#include <cstdint>
+#include <numeric>
+
+#include <raylib.h>
+
+#include "../mailbox/command/cmd_seedspec.hpp"
+#include "../utility/counter_rng.hpp"
+#include "world.hpp"
+
+/**
+ * @brief Places a range of particles at random positions with zero velocity
+ * @param world World whose particles are placed
+ * @param begin First particle index
+ * @param end One past the last particle index
+ * @param key RNG key (the seed's rng_seed)
+ * @param stream RNG stream; every placement operation takes a new one
+ * @param width Bounds width
+ * @param height Bounds height
+ * @param for_n Called as for_n(kernel, n) to run kernel(start, end) over
+ * [0, n), serially or on a pool
+ * @details Positions come from the counter-based RNG indexed by particle, so
+ * the result does not depend on how for_n splits the range.
+ */
+template <typename ForN>
+void place_particles(World &world, int begin, int end, uint64_t key,
+                     uint32_t stream, float width, float height,
+                     ForN &&for_n) {
+    if (begin >= end) {
+        return;
+    }
+
+    using particles::utility::CounterRng;
+    const CounterRng rng(key, stream);
+    float *const px_array = world.get_px_array_mut();
+    float *const py_array = world.get_py_array_mut();
+    float *const vx_array = world.get_vx_array_mut();
+    float *const vy_array = world.get_vy_array_mut();
+
+    for_n(
+        [&](int start, int stop) {
+            for (int i = begin + start; i < begin + stop; ++i) {
+                const CounterRng::Block r = rng.at((uint64_t)i);
+                px_array[i] = CounterRng::to_unit_float(r[0]) * width;
+                py_array[i] = CounterRng::to_unit_float(r[1]) * height;
+                vx_array[i] = 0.f;
+                vy_array[i] = 0.f;
+            }
+        },
+        end - begin);
+}
+
+/**
+ * @brief Rebuilds the particle-to-group mapping of every particle
+ * @param world World to update
+ * @param for_n Range runner, see place_particles()
+ */
+template <typename ForN>
+void assign_particle_groups(World &world, ForN &&for_n) {
+    world.prepare_particle_groups();
+    for_n(
+        [&world](int start, int end) {
+            world.finalize_groups(start, end);
+        },
+        world.get_particles_size());
+}
+
+/**
+ * @brief Replaces a world's contents with the groups, rules and placement a
+ * seed describes
+ * @param world World to rebuild (cleared first; an empty seed leaves it so)
+ * @param seed Groups, rules and RNG key
+ * @param width Bounds width
+ * @param height Bounds height
+ * @param for_n Range runner, see place_particles()
+ * @details The particles take RNG stream 0, so later placements into the
+ * same world should start at stream 1. Simulation and Ensemble both seed
+ * through this, so a seed builds the same world bit for bit in either.
+ */
+template <typename ForN>
+void seed_world(World &world, const mailbox::command::SeedSpec &seed,
+                float width, float height, ForN &&for_n) {
+    world.reset(false);
+
+    const int G = seed.group_count();
+    if (G <= 0) {
+        return;
+    }
+
+    world.reserve(std::accumulate(seed.sizes.begin(), seed.sizes.end(), 0));
+    for (int g = 0; g < G; ++g) {
+        const Color col = g < (int)seed.colors.size() ? seed.colors[g] : WHITE;
+        world.add_group(seed.sizes[g], col);
+    }
+
+    place_particles(world, 0, world.get_particles_size(), seed.rng_seed, 0,
+                    width, height, for_n);
+    assign_particle_groups(world, for_n);
+    world.init_rule_tables(G);
+
+    for (int g = 0; g < G; ++g) {
+        world.set_r2(g, g < (int)seed.r2.size() ? seed.r2[g] : 80.f * 80.f);
+    }
+    if ((int)seed.rules.size() == G * G) {
+        for (int i = 0; i < G; ++i) {
+            for (int j = 0; j < G; ++j) {
+                world.set_rule(i, j, seed.rules[i * G + j]);
+            }
+        }
+    }
+    for (int g = 0; g < G; ++g) {
+        world.set_group_enabled(
+            g, g < (int)seed.enabled.size() ? seed.enabled[g] : true);
+    }
+}
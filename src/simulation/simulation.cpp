@@ -2,21 +2,18 @@
 
 using namespace std::chrono;
 
-constexpr float EPS = 1e-12f;
-
-constexpr int grid_offsets[9][2] = {{-1, -1}, {0, -1}, {1, -1}, {-1, 0}, {0, 0},
-                                    {1, 0},   {-1, 1}, {0, 1},  {1, 1}};
-
 inline long long now_ns() {
     return duration_cast<nanoseconds>(steady_clock::now().time_since_epoch())
         .count();
 }
 
 Simulation::Simulation(mailbox::SimulationConfigSnapshot cfg)
-    : m_world(), m_idx(), m_pool(std::make_unique<SimulationThreadPool>(1)),
+    : m_world(), m_stepper(), m_pool(std::make_unique<SimulationThreadPool>(1)),
       m_mail_cmd(), m_mail_draw(), m_mail_cfg(), m_mail_stats(),
-      m_mail_world() {
+      m_mail_world(), m_mail_analytics(), m_mail_clusters(),
+      m_rng_seed(particles::utility::random_seed()) {
     LOG_INFO("Initializing simulation");
+    m_stepper.set_analytics(true);
 
     mailbox::SimulationConfigSnapshot default_config = {};
     default_config.bounds_width = default_config.bounds_height = 0.f;
@@ -28,7 +25,7 @@ Simulation::Simulation(mailbox::SimulationConfigSnapshot cfg)
     default_config.gravity_y = 0.f;
     default_config.target_tps = 0;
     default_config.sim_threads = 1;
-    default_config.draw_report = {false};
+    default_config.draw_report = {false, false};
 
     m_mail_cfg.publish(default_config);
     m_mail_cfg.publish(default_config);
@@ -43,7 +40,9 @@ Simulation::Simulation(mailbox::SimulationConfigSnapshot cfg)
 Simulation::~Simulation() { end(); }
 
 void Simulation::begin() {
-    if (m_t_run_state != RunState::NotStarted) {
+    // The run state only changes once the thread runs, so a second call
+    // right after the first must be caught through the thread itself
+    if (m_t_run_state != RunState::NotStarted || has_started()) {
         return;
     }
 
@@ -91,12 +90,21 @@ void Simulation::update_config(mailbox::SimulationConfigSnapshot &cfg) {
                                      std::to_string(cfg.sim_threads));
     }
 
+    if (cfg.cluster_interval < 0 || !(cfg.cluster_distance > 0)) {
+        throw particles::ConfigError(
+            "Invalid cluster detection: every " +
+            std::to_string(cfg.cluster_interval) + " steps at distance " +
+            std::to_string(cfg.cluster_distance));
+    }
+
     LOG_DEBUG(
         "Updating simulation config: " + std::to_string(cfg.bounds_width) +
         "x" + std::to_string(cfg.bounds_height) +
         ", threads=" + std::to_string(cfg.sim_threads));
 
     m_mail_cfg.publish(cfg);
+    // An idle simulation thread republishes with the new config
+    m_mail_cmd.wake();
 }
 
 void Simulation::push_command(const mailbox::command::Command &cmd) {
@@ -123,6 +131,14 @@ mailbox::SimulationConfigSnapshot Simulation::get_config() const {
     return m_mail_cfg.acquire();
 }
 
+void Simulation::set_frame_sink(std::shared_ptr<IFrameSink> sink) {
+    if (m_thread.joinable()) {
+        throw particles::SimulationError(
+            "Frame sink must be set before the simulation starts");
+    }
+    m_frame_sink = std::move(sink);
+}
+
 void Simulation::force_stats_publish() {
     mailbox::SimulationStatsSnapshot st;
     st.effective_tps = m_t_last_published_tps;
@@ -132,62 +148,13 @@ void Simulation::force_stats_publish() {
     st.last_step_ns = 0; // Not applicable for forced update
     st.published_ns = now_ns();
     st.num_steps = m_total_steps; // Publish actual step count
+    fill_latency(st);
     m_mail_stats.publish(st);
 }
 
 void Simulation::step(mailbox::SimulationConfigSnapshot &cfg) {
-    const int particles_count = m_world.get_particles_size();
-    if (particles_count == 0) {
-        return;
-    }
-
-    if ((int)m_fx.size() != particles_count) {
-        m_fx.resize(particles_count);
-    }
-    if ((int)m_fy.size() != particles_count) {
-        m_fy.resize(particles_count);
-    }
-    std::fill_n(m_fx.data(), particles_count, 0.f);
-    std::fill_n(m_fy.data(), particles_count, 0.f);
-
-    KernelData data;
-    data.particles_count = particles_count;
-    data.k_time_scale = cfg.time_scale;
-    data.k_viscosity = cfg.viscosity;
-    data.k_inverse_viscosity = 1.f - cfg.viscosity;
-    data.k_wall_repel = cfg.wall_repel;
-    data.k_wall_strength = cfg.wall_strength;
-    data.k_gravity_x = cfg.gravity_x;
-    data.k_gravity_y = cfg.gravity_y;
-    data.width = cfg.bounds_width;
-    data.height = cfg.bounds_height;
-    data.fx = m_fx.data();
-    data.fy = m_fy.data();
-
-    float maxR = std::max(1.0f, m_world.max_interaction_radius());
-    data.inverse_cell =
-        m_idx.ensure(m_world, cfg.bounds_width, cfg.bounds_height, maxR);
-
-    // accumulate forces
-    m_pool->parallel_for_n(
-        [&](int s, int e) {
-            kernel_force(s, e, data);
-        },
-        particles_count);
-
-    // velocity update
-    m_pool->parallel_for_n(
-        [&](int s, int e) {
-            kernel_vel(s, e, data);
-        },
-        particles_count);
-
-    // position + bounce
-    m_pool->parallel_for_n(
-        [&](int s, int e) {
-            kernel_pos(s, e, data);
-        },
-        particles_count);
+    m_stepper.set_pair_counts(cfg.draw_report.cell_costs);
+    m_stepper.step(m_world, *m_pool, cfg);
 }
 
 int Simulation::ensure_pool(int t, mailbox::SimulationConfigSnapshot &cfg) {
@@ -202,8 +169,31 @@ int Simulation::ensure_pool(int t, mailbox::SimulationConfigSnapshot &cfg) {
 }
 
 inline bool Simulation::can_step() const noexcept {
-    return m_t_run_state == RunState::Running ||
-           m_t_run_state == RunState::OneStep;
+    // Stepping an empty world only counts steps; a OneStep is still taken
+    // so callers waiting on the step count see it
+    return m_t_run_state == RunState::OneStep ||
+           (m_t_run_state == RunState::Running &&
+            m_world.get_particles_size() > 0);
+}
+
+inline bool Simulation::is_idle() const noexcept {
+    // A pending OneStep arrives as a command, which ends the wait
+    return m_t_run_state != RunState::Running ||
+           m_world.get_particles_size() == 0;
+}
+
+void Simulation::wait_while_idle(int n_threads) {
+    // Leave stats that describe the idle state rather than the last window
+    m_t_last_published_tps = 0;
+    m_t_window_steps = 0;
+    publish_stats_immediately(n_threads, 0ns);
+    publish_memory();
+
+    m_mail_cmd.wait();
+
+    // Idle time is neither part of a TPS window nor a missed deadline
+    m_t_window_start = steady_clock::now();
+    m_t_last_step_time = m_t_window_start;
 }
 
 void Simulation::measure_tps(int n_threads, nanoseconds step_diff_ns) noexcept {
@@ -223,7 +213,9 @@ void Simulation::measure_tps(int n_threads, nanoseconds step_diff_ns) noexcept {
         st.published_ns = now_ns();
         // Always publish the step count, regardless of run state
         st.num_steps = m_total_steps;
+        fill_latency(st);
         m_mail_stats.publish(st);
+        publish_memory();
 
         m_t_window_steps = 0;
         m_t_window_start = now;
@@ -240,6 +232,7 @@ void Simulation::publish_stats_immediately(int n_threads,
     st.last_step_ns = step_diff_ns.count();
     st.published_ns = now_ns();
     st.num_steps = m_total_steps;
+    fill_latency(st);
     m_mail_stats.publish(st);
 }
 
@@ -253,12 +246,63 @@ void Simulation::wait_on_tps(int target_tps) noexcept {
     const auto elapsed = now - m_t_last_step_time;
 
     if (elapsed < target_frame_time) {
-        std::this_thread::sleep_for(target_frame_time - elapsed);
+        const auto wanted = target_frame_time - elapsed;
+        std::this_thread::sleep_for(wanted);
+        m_t_oversleep.record(
+            duration_cast<nanoseconds>(steady_clock::now() - now - wanted)
+                .count());
+    } else {
+        m_t_missed_deadlines.fetch_add(1, std::memory_order_relaxed);
     }
 
     m_t_last_step_time = steady_clock::now();
 }
 
+void Simulation::reset_step_counters() noexcept {
+    m_t_window_steps = 0;
+    m_t_window_start = steady_clock::now();
+    m_total_steps = 0;
+    m_t_step_latency.reset();
+    m_t_oversleep.reset();
+    m_t_missed_deadlines.store(0, std::memory_order_relaxed);
+}
+
+void Simulation::fill_latency(
+    mailbox::SimulationStatsSnapshot &st) const noexcept {
+    auto convert = [](const particles::utility::LatencyHistogram &h) {
+        const auto summary = h.summary();
+        mailbox::LatencySummary out;
+        out.samples = (long long)summary.count;
+        out.p50_ns = (long long)summary.p50;
+        out.p95_ns = (long long)summary.p95;
+        out.p99_ns = (long long)summary.p99;
+        out.max_ns = (long long)summary.max;
+        return out;
+    };
+    st.step_latency = convert(m_t_step_latency);
+    st.oversleep = convert(m_t_oversleep);
+    st.missed_deadlines = m_t_missed_deadlines.load(std::memory_order_relaxed);
+}
+
+void Simulation::publish_memory() {
+    const NeighborIndex &idx = m_stepper.index();
+    mailbox::MemorySnapshot memory;
+    memory.published_ns = now_ns();
+    memory.world = m_world.memory_usage();
+    memory.grid_csr = idx.grid.csr_memory();
+    memory.grid_csr.merge(idx.sparse_grid.memory_usage());
+    memory.stepper = m_stepper.memory_usage();
+    memory.draw_buffer = m_mail_draw.memory_usage();
+    memory.snapshots.merge(m_mail_cfg.memory_usage())
+        .merge(m_mail_stats.memory_usage())
+        .merge(m_mail_world.memory_usage())
+        .merge(m_mail_analytics.memory_usage())
+        .merge(m_mail_clusters.memory_usage())
+        .merge(m_mail_memory.memory_usage());
+    memory.commands = m_mail_cmd.memory_usage();
+    m_mail_memory.publish(memory);
+}
+
 void Simulation::loop_thread() {
     auto current_config = get_config();
     // no auto seeding; wait for a seed command or reset
@@ -271,45 +315,65 @@ void Simulation::loop_thread() {
     m_t_last_published_tps = 0;
     m_total_steps = 0;
     int current_thread_count = -9999;
+    // Whether anything but a step changed what the mailboxes show
+    bool dirty = true;
 
     while (m_t_run_state != RunState::Quit) {
         current_thread_count =
             ensure_pool(current_thread_count, current_config);
 
-        process_commands(current_config);
+        dirty |= process_commands(current_config);
 
         if (m_t_run_state == RunState::Quit) {
             break;
         }
 
         auto step_begin_time = steady_clock::now();
-        if (can_step()) {
+        const bool stepped = can_step();
+        if (stepped) {
             step(current_config);
             m_t_window_steps++;
             m_total_steps++;
+            publish_analytics();
         }
         auto step_end_time = steady_clock::now();
+        if (stepped) {
+            m_t_step_latency.record(
+                duration_cast<nanoseconds>(step_end_time - step_begin_time)
+                    .count());
+        }
 
-        publish_draw(current_config);
-        publish_world_snapshot();
+        // An idle pass has nothing new to copy out
+        if (stepped || dirty) {
+            publish_draw(current_config);
+            publish_world_snapshot();
+            // Publish stats more frequently for better responsiveness
+            publish_stats_immediately(current_thread_count,
+                                      (step_end_time - step_begin_time));
+        }
         measure_tps(current_thread_count, (step_end_time - step_begin_time));
 
-        // Publish stats more frequently for better responsiveness
-        publish_stats_immediately(current_thread_count,
-                                  (step_end_time - step_begin_time));
-
-        wait_on_tps(current_config.target_tps);
+        if (stepped) {
+            wait_on_tps(current_config.target_tps);
+        }
 
         if (m_t_run_state == RunState::OneStep) {
             m_t_run_state = RunState::Paused;
         }
+        dirty = false;
+
+        if (is_idle()) {
+            wait_while_idle(current_thread_count);
+            dirty = true;
+        }
 
         current_config = get_config();
     }
 }
 
-void Simulation::process_commands(mailbox::SimulationConfigSnapshot &cfg) {
-    for (const auto &cmd : m_mail_cmd.drain()) {
+bool Simulation::process_commands(mailbox::SimulationConfigSnapshot &cfg) {
+    const std::vector<mailbox::command::Command> cmds = m_mail_cmd.drain();
+    for (const auto &cmd : cmds) {
         std::visit(
             [&](auto &&c) {
                 using T = std::decay_t<decltype(c)>;
@@ -350,16 +414,47 @@ void Simulation::process_commands(mailbox::SimulationConfigSnapshot &cfg) {
             },
             cmd);
     }
+    return !cmds.empty();
 }
 
 void Simulation::publish_draw(mailbox::SimulationConfigSnapshot &cfg) {
     const int particles_count = m_world.get_particles_size();
-
-    auto &pos = m_mail_draw.begin_write_pos(size_t(particles_count) * 2);
-    auto &vel = m_mail_draw.begin_write_vel(size_t(particles_count) * 2);
-    auto &grid_frame = m_mail_draw.begin_write_grid(
-        m_idx.grid.cols(), m_idx.grid.rows(), particles_count,
-        m_idx.grid.cell_size(), m_idx.grid.width(), m_idx.grid.height());
+    const NeighborIndex &idx = m_stepper.index();
+
+    // Only the streams some consumer asked for are written: the float
+    // positions or their 16-bit packing, and velocities on request
+    const bool packed = cfg.draw_report.packed_positions;
+    const bool velocities = cfg.draw_report.velocities;
+    auto &pos =
+        m_mail_draw.begin_write_pos(packed ? 0 : size_t(particles_count) * 2);
+    auto &vel =
+        m_mail_draw.begin_write_vel(velocities ? size_t(particles_count) * 2
+                                               : 0);
+    auto &packed_pos = m_mail_draw.begin_write_packed();
+
+    // The CSR cells are written only when declared (or needed for the cell
+    // overlays). A sparse index has no dense cells to mirror, and a dense
+    // frame for its bounds is the allocation it exists to avoid. Either way
+    // one cell covering the world is published instead (the renderer then
+    // skips cell culling)
+    const bool cells = cfg.draw_report.cells || cfg.draw_report.grid_data ||
+                       cfg.draw_report.cell_costs;
+    auto &grid_frame = [&]() -> mailbox::render::GridFrame & {
+        if (!cells) {
+            return m_mail_draw.begin_write_grid(
+                1, 1, 0, std::max(cfg.bounds_width, cfg.bounds_height),
+                cfg.bounds_width, cfg.bounds_height);
+        }
+        if (idx.sparse) {
+            return m_mail_draw.begin_write_grid(
+                1, 1, particles_count,
+                std::max(idx.sparse_grid.width(), idx.sparse_grid.height()),
+                idx.sparse_grid.width(), idx.sparse_grid.height());
+        }
+        return m_mail_draw.begin_write_grid(
+            idx.grid.cols(), idx.grid.rows(), particles_count,
+            idx.grid.cell_size(), idx.grid.width(), idx.grid.height());
+    }();
 
     // Use SoA bulk operations for better performance
     const float *const px_array = m_world.get_px_array();
@@ -367,251 +462,122 @@ void Simulation::publish_draw(mailbox::SimulationConfigSnapshot &cfg) {
     const float *const vx_array = m_world.get_vx_array();
     const float *const vy_array = m_world.get_vy_array();
 
-    for (int i = 0; i < particles_count; ++i) {
-        const size_t b = size_t(i) * 2;
-        pos[b + 0] = px_array[i];
-        pos[b + 1] = py_array[i];
-        vel[b + 0] = vx_array[i];
-        vel[b + 1] = vy_array[i];
+    if (packed) {
+        packed_pos.pack(px_array, py_array, particles_count, cfg.bounds_width,
+                        cfg.bounds_height);
+    } else {
+        packed_pos.xy.clear();
+        for (int i = 0; i < particles_count; ++i) {
+            const size_t b = size_t(i) * 2;
+            pos[b + 0] = px_array[i];
+            pos[b + 1] = py_array[i];
+        }
+    }
+    if (velocities) {
+        for (int i = 0; i < particles_count; ++i) {
+            const size_t b = size_t(i) * 2;
+            vel[b + 0] = vx_array[i];
+            vel[b + 1] = vy_array[i];
+        }
     }
 
-    if (cfg.draw_report.grid_data) {
-        grid_frame.head = m_idx.grid.head();
-        grid_frame.next = m_idx.grid.next();
+    // The cells are only valid when the index was built for the current
+    // world, which a seed or group edit since the last step rules out
+    const int grid_cells = grid_frame.cols * grid_frame.rows;
+    if (cells && !idx.sparse && m_stepper.index_current() &&
+        (int)idx.grid.indices().size() == particles_count &&
+        (int)idx.grid.cell_start().size() == grid_cells) {
+        grid_frame.start.assign(idx.grid.cell_start().begin(),
+                                idx.grid.cell_start().end());
+        grid_frame.count.assign(idx.grid.cell_count().begin(),
+                                idx.grid.cell_count().end());
+        grid_frame.indices.assign(idx.grid.indices().begin(),
+                                  idx.grid.indices().end());
+        grid_frame.indexed = true;
+    }
 
-        const int grid_size = grid_frame.cols * grid_frame.rows;
-        for (int ci = 0; ci < grid_size; ++ci) {
-            int cell_count = 0;
+    if (cfg.draw_report.grid_data && grid_frame.indexed) {
+        for (int ci = 0; ci < grid_cells; ++ci) {
             float sx = 0.f, sy = 0.f;
-
-            for (int p = grid_frame.head[ci]; p != -1; p = grid_frame.next[p]) {
-                const size_t b = size_t(p) * 2;
-                sx += vel[b + 0];
-                sy += vel[b + 1];
-                ++cell_count;
+            const int begin = grid_frame.start[ci];
+            const int end = begin + grid_frame.count[ci];
+            for (int k = begin; k < end; ++k) {
+                const int p = grid_frame.indices[k];
+                sx += vx_array[p];
+                sy += vy_array[p];
             }
 
-            grid_frame.count[ci] = cell_count;
             grid_frame.sumVx[ci] = sx;
             grid_frame.sumVy[ci] = sy;
         }
     }
 
-    m_mail_draw.publish(now_ns());
-}
-
-void Simulation::clear_world() { m_world.reset(false); }
-
-void Simulation::apply_seed(const mailbox::command::SeedSpec &seed,
-                            mailbox::SimulationConfigSnapshot &cfg) {
-    m_world.reset(false);
-
-    const int G = (int)seed.sizes.size();
-    if (G <= 0) {
-        // empty seed leaves world cleared
-        return;
-    }
-
-    for (int g = 0; g < G; ++g) {
-        Color col = (g < (int)seed.colors.size()) ? seed.colors[g] : WHITE;
-        m_world.add_group(seed.sizes[g], col);
-    }
-
-    const int N = m_world.get_particles_size();
-    std::mt19937 rng{std::random_device{}()};
-    std::uniform_real_distribution<float> rx(0.f, cfg.bounds_width);
-    std::uniform_real_distribution<float> ry(0.f, cfg.bounds_height);
-    for (int i = 0; i < N; ++i) {
-        m_world.set_px(i, rx(rng));
-        m_world.set_py(i, ry(rng));
-        m_world.set_vx(i, 0.f);
-        m_world.set_vy(i, 0.f);
-    }
-
-    m_world.finalize_groups();
-    m_world.init_rule_tables(G);
-
-    // r2
-    for (int g = 0; g < G; ++g) {
-        float r2 = (g < (int)seed.r2.size()) ? seed.r2[g] : 80.f * 80.f;
-        m_world.set_r2(g, r2);
-    }
-
-    // rules
-    if ((int)seed.rules.size() == G * G) {
-        for (int i = 0; i < G; ++i) {
-            for (int j = 0; j < G; ++j) {
-                m_world.set_rule(i, j, seed.rules[i * G + j]);
+    // Pair counts belong to the step that built the published cells
+    const auto &examined = m_stepper.examined_pairs();
+    const auto &accepted = m_stepper.accepted_pairs();
+    if (cfg.draw_report.cell_costs && grid_frame.indexed &&
+        (int)examined.size() == particles_count) {
+        for (int ci = 0; ci < grid_cells; ++ci) {
+            long long cell_examined = 0, cell_accepted = 0;
+            const int begin = grid_frame.start[ci];
+            const int end = begin + grid_frame.count[ci];
+            for (int k = begin; k < end; ++k) {
+                const int p = grid_frame.indices[k];
+                cell_examined += examined[p];
+                cell_accepted += accepted[p];
             }
+            grid_frame.examined[ci] = cell_examined;
+            grid_frame.accepted[ci] = cell_accepted;
         }
     }
 
-    // enabled state
-    for (int g = 0; g < G; ++g) {
-        bool enabled = (g < (int)seed.enabled.size()) ? seed.enabled[g] : true;
-        m_world.set_group_enabled(g, enabled);
-    }
-}
+    const long long stamp = now_ns();
+    m_mail_draw.publish(stamp);
 
-inline void Simulation::kernel_force(int start, int end, KernelData &data) {
-    // Get SoA arrays for better cache locality and potential vectorization
-    const float *const px_array = m_world.get_px_array();
-    const float *const py_array = m_world.get_py_array();
-
-    for (int i = start; i < end; ++i) {
-        const float particle_x = px_array[i];
-        const float particle_y = py_array[i];
-        const int group_index = m_world.group_of(i);
-        const float interaction_radius_squared = m_world.r2_of(group_index);
-
-        // skip disabled groups
-        if (!m_world.is_group_enabled(group_index)) {
-            data.fx[i] = 0.f;
-            data.fy[i] = 0.f;
-            continue;
-        }
-
-        if (interaction_radius_squared <= 0.f) {
-            data.fx[i] = 0.f;
-            data.fy[i] = 0.f;
-            continue;
-        }
-
-        float force_x = 0.f, force_y = 0.f;
-        int cell_x = std::min(int(particle_x * data.inverse_cell),
-                              m_idx.grid.cols() - 1);
-        int cell_y = std::min(int(particle_y * data.inverse_cell),
-                              m_idx.grid.rows() - 1);
-
-        const auto interaction_rules = m_world.rules_of(group_index);
-
-        for (int k = 0; k < 9; ++k) {
-            const int neighbor_cell_index = m_idx.grid.cell_index(
-                cell_x + grid_offsets[k][0], cell_y + grid_offsets[k][1]);
-
-            if (neighbor_cell_index < 0) {
-                continue;
-            }
-
-            const int cell_start =
-                m_idx.grid.cell_start_at(neighbor_cell_index);
-            const int cell_count =
-                m_idx.grid.cell_count_at(neighbor_cell_index);
-            const auto &particle_indices = m_idx.grid.indices();
-            const int cell_end = cell_start + cell_count;
-            for (int pos = cell_start; pos < cell_end; ++pos) {
-                const int j = particle_indices[pos];
-                if (j == i) {
-                    continue;
-                }
-                const float other_particle_x = px_array[j];
-                const float other_particle_y = py_array[j];
-                const float dx = particle_x - other_particle_x;
-                const float dy = particle_y - other_particle_y;
-                const float distance_squared = dx * dx + dy * dy;
-                if (distance_squared > 0.f &&
-                    distance_squared < interaction_radius_squared) {
-                    const int other_group_index = m_world.group_of(j);
-                    // skip if target particle's group is disabled
-                    if (!m_world.is_group_enabled(other_group_index)) {
-                        continue;
-                    }
-                    const float interaction_strength =
-                        interaction_rules.get(other_group_index);
-                    const float inv_distance =
-                        rsqrt_fast(std::max(distance_squared, EPS));
-                    const float force_magnitude =
-                        interaction_strength * inv_distance;
-                    force_x += force_magnitude * dx;
-                    force_y += force_magnitude * dy;
-                }
-            }
+    if (m_frame_sink) {
+        try {
+            m_frame_sink->write(m_world, cfg.bounds_width, cfg.bounds_height,
+                                stamp);
+        } catch (const std::exception &e) {
+            LOG_ERROR("Frame sink failed, detaching it: " +
+                      std::string(e.what()));
+            m_frame_sink.reset();
         }
-
-        if (data.k_wall_repel > 0.f) {
-            const float wall_repel_distance = data.k_wall_repel;
-            const float wall_strength = data.k_wall_strength;
-
-            if (particle_x < wall_repel_distance) {
-                force_x += (wall_repel_distance - particle_x) * wall_strength;
-            }
-            if (particle_x > data.width - wall_repel_distance) {
-                force_x += (data.width - wall_repel_distance - particle_x) *
-                           wall_strength;
-            }
-            if (particle_y < wall_repel_distance) {
-                force_y += (wall_repel_distance - particle_y) * wall_strength;
-            }
-            if (particle_y > data.height - wall_repel_distance) {
-                force_y += (data.height - wall_repel_distance - particle_y) *
-                           wall_strength;
-            }
-        }
-
-        // apply gravity
-        force_x += data.k_gravity_x;
-        force_y += data.k_gravity_y;
-
-        data.fx[i] = force_x;
-        data.fy[i] = force_y;
     }
 }
 
-inline void Simulation::kernel_vel(int start, int end, KernelData &data) {
-    // Get SoA arrays for better cache locality and potential vectorization
-    float *const vx_array = m_world.get_vx_array_mut();
-    float *const vy_array = m_world.get_vy_array_mut();
-
-    for (int i = start; i < end; ++i) {
-        const float new_velocity_x = vx_array[i] * data.k_inverse_viscosity +
-                                     data.fx[i] * data.k_time_scale;
-        const float new_velocity_y = vy_array[i] * data.k_inverse_viscosity +
-                                     data.fy[i] * data.k_time_scale;
+void Simulation::clear_world() {
+    m_world.reset(false);
+    m_stepper.invalidate_index();
+}
 
-        vx_array[i] = new_velocity_x;
-        vy_array[i] = new_velocity_y;
+void Simulation::apply_seed(const mailbox::command::SeedSpec &seed,
+                            mailbox::SimulationConfigSnapshot &cfg) {
+    seed_world(m_world, seed, cfg.bounds_width, cfg.bounds_height,
+               [this](auto &&kernel, int n) {
+                   m_pool->parallel_for_n(kernel, n);
+               });
+    m_stepper.invalidate_index();
+    if (seed.group_count() > 0) {
+        m_rng_seed = seed.rng_seed;
+        // seed_world placed the particles with stream 0
+        m_rng_stream = 1;
     }
 }
 
-inline void Simulation::kernel_pos(int start, int end, KernelData &data) {
-    // Get SoA arrays for better cache locality and potential vectorization
-    const float *const px_array = m_world.get_px_array();
-    const float *const py_array = m_world.get_py_array();
-    const float *const vx_array = m_world.get_vx_array();
-    const float *const vy_array = m_world.get_vy_array();
-    float *const px_array_mut = m_world.get_px_array_mut();
-    float *const py_array_mut = m_world.get_py_array_mut();
-    float *const vx_array_mut = m_world.get_vx_array_mut();
-    float *const vy_array_mut = m_world.get_vy_array_mut();
-
-    for (int i = start; i < end; ++i) {
-        float new_x = px_array[i] + vx_array[i];
-        float new_y = py_array[i] + vy_array[i];
-        float new_velocity_x = vx_array[i];
-        float new_velocity_y = vy_array[i];
-
-        if (new_x < 0.f) {
-            new_x = -new_x;
-            new_velocity_x = -new_velocity_x;
-        }
-        if (new_x >= data.width) {
-            new_x = 2.f * data.width - new_x;
-            new_velocity_x = -new_velocity_x;
-        }
-        if (new_y < 0.f) {
-            new_y = -new_y;
-            new_velocity_y = -new_velocity_y;
-        }
-        if (new_y >= data.height) {
-            new_y = 2.f * data.height - new_y;
-            new_velocity_y = -new_velocity_y;
-        }
+void Simulation::init_particles(int begin, int end,
+                                const mailbox::SimulationConfigSnapshot &cfg) {
+    place_particles(m_world, begin, end, m_rng_seed, m_rng_stream++,
+                    cfg.bounds_width, cfg.bounds_height,
+                    [this](auto &&kernel, int n) {
+                        m_pool->parallel_for_n(kernel, n);
+                    });
+}
 
-        px_array_mut[i] = new_x;
-        py_array_mut[i] = new_y;
-        vx_array_mut[i] = new_velocity_x;
-        vy_array_mut[i] = new_velocity_y;
-    }
+void Simulation::finalize_groups() {
+    assign_particle_groups(m_world, [this](auto &&kernel, int n) {
+        m_pool->parallel_for_n(kernel, n, 1 << 16);
+    });
 }
 
 // Command handler implementations
@@ -621,9 +587,7 @@ void Simulation::handle_seed_world(const mailbox::command::SeedWorld &cmd,
         clear_world();
         m_initial_seed.reset();
         m_current_seed.reset();
-        m_t_window_steps = 0;
-        m_t_window_start = steady_clock::now();
-        m_total_steps = 0;
+        reset_step_counters();
 
         // Publish stats immediately after clearing to reflect the reset step
         // count
@@ -632,9 +596,7 @@ void Simulation::handle_seed_world(const mailbox::command::SeedWorld &cmd,
         m_initial_seed = cmd.seed;
         m_current_seed = cmd.seed;
         apply_seed(cmd.seed, cfg);
-        m_t_window_steps = 0;
-        m_t_window_start = steady_clock::now();
-        m_total_steps = 0;
+        reset_step_counters();
 
         // Publish stats immediately after seeding to reflect the reset step
         // count
@@ -654,9 +616,7 @@ void Simulation::handle_reset_world(mailbox::SimulationConfigSnapshot &cfg) {
     } else {
         clear_world();
     }
-    m_t_window_steps = 0;
-    m_t_window_start = steady_clock::now();
-    m_total_steps = 0;
+    reset_step_counters();
 
     // Publish stats immediately after reset to reflect the reset step count
     publish_stats_immediately(1, std::chrono::nanoseconds(0));
@@ -666,6 +626,8 @@ void Simulation::handle_apply_rules(const mailbox::command::ApplyRules &cmd,
                                     mailbox::SimulationConfigSnapshot &cfg) {
     const int groups_count = m_world.get_groups_size();
     const mailbox::command::RulePatch &p = cmd.patch;
+    // Enabled groups and radii decide which particles the index holds
+    m_stepper.invalidate_index();
 
     auto apply_colors_if_any = [&](int group_count) {
         if (!p.colors.empty() && (int)p.colors.size() == group_count) {
@@ -684,8 +646,11 @@ void Simulation::handle_apply_rules(const mailbox::command::ApplyRules &cmd,
     };
 
     if (p.groups == groups_count && p.hot) {
-        for (int g = 0; g < groups_count; ++g) {
-            m_world.set_r2(g, p.r2[g]);
+        // A patch without radii keeps the current ones
+        if ((int)p.r2.size() == groups_count) {
+            for (int g = 0; g < groups_count; ++g) {
+                m_world.set_r2(g, p.r2[g]);
+            }
         }
         for (int i = 0; i < groups_count; ++i) {
             const float *row = p.rules.data() + i * groups_count;
@@ -698,6 +663,8 @@ void Simulation::handle_apply_rules(const mailbox::command::ApplyRules &cmd,
     } else {
         const int Gnow = m_world.get_groups_size();
         mailbox::command::SeedSpec new_seed;
+        // Placing the groups anew keeps the project's placement key
+        new_seed.rng_seed = m_rng_seed;
         new_seed.sizes.resize(Gnow);
         new_seed.colors.resize(Gnow);
         new_seed.r2.resize(Gnow);
@@ -740,9 +707,7 @@ void Simulation::handle_apply_rules(const mailbox::command::ApplyRules &cmd,
         apply_colors_if_any(Gnow);
         apply_enabled_if_any(Gnow);
         apply_seed(m_current_seed.value(), cfg);
-        m_t_window_steps = 0;
-        m_t_window_start = steady_clock::now();
-        m_total_steps = 0;
+        reset_step_counters();
     }
 }
 
@@ -750,7 +715,8 @@ void Simulation::handle_add_group(const mailbox::command::AddGroup &cmd,
                                   mailbox::SimulationConfigSnapshot &cfg) {
     const int old_group_count = m_world.get_groups_size();
     m_world.add_group(cmd.size, cmd.color);
-    m_world.finalize_groups();
+    m_stepper.invalidate_index();
+    finalize_groups();
 
     // only initialize rule tables if this is the first group
     if (old_group_count == 0) {
@@ -763,17 +729,8 @@ void Simulation::handle_add_group(const mailbox::command::AddGroup &cmd,
     int new_group_index = m_world.get_groups_size() - 1;
     m_world.set_r2(new_group_index, cmd.r2);
 
-    std::mt19937 rng{std::random_device{}()};
-    std::uniform_real_distribution<float> rx(0.f, cfg.bounds_width);
-    std::uniform_real_distribution<float> ry(0.f, cfg.bounds_height);
-    const int start = m_world.get_group_start(new_group_index);
-    const int end = m_world.get_group_end(new_group_index);
-    for (int i = start; i < end; ++i) {
-        m_world.set_px(i, rx(rng));
-        m_world.set_py(i, ry(rng));
-        m_world.set_vx(i, 0.f);
-        m_world.set_vy(i, 0.f);
-    }
+    init_particles(m_world.get_group_start(new_group_index),
+                   m_world.get_group_end(new_group_index), cfg);
 }
 
 void Simulation::handle_remove_group(const mailbox::command::RemoveGroup &cmd) {
@@ -795,8 +752,9 @@ void Simulation::handle_remove_group(const mailbox::command::RemoveGroup &cmd) {
             }
         }
 
-        m_world.remove_group(group_index);
-        m_world.finalize_groups();
+        m_world.remove_group_unfinalized(group_index);
+        m_stepper.invalidate_index();
+        finalize_groups();
 
         // restore rules if we had multiple groups
         if (total_groups > 1) {
@@ -832,19 +790,16 @@ void Simulation::handle_remove_group(const mailbox::command::RemoveGroup &cmd) {
 
         // don't reseed - just clear the current seed since it's no longer valid
         m_current_seed = std::nullopt;
-        m_t_window_steps = 0;
-        m_t_window_start = steady_clock::now();
-        m_total_steps = 0;
+        reset_step_counters();
     }
 }
 
 void Simulation::handle_remove_all_groups() {
     m_world.reset(true);
+    m_stepper.invalidate_index();
     m_world.init_rule_tables(0);
     m_current_seed = std::nullopt;
-    m_t_window_steps = 0;
-    m_t_window_start = steady_clock::now();
-    m_total_steps = 0;
+    reset_step_counters();
 }
 
 void Simulation::handle_resize_group(const mailbox::command::ResizeGroup &cmd,
@@ -856,25 +811,16 @@ void Simulation::handle_resize_group(const mailbox::command::ResizeGroup &cmd,
         const int current_size = m_world.get_group_size(group_index);
         const int start = m_world.get_group_start(group_index);
 
-        m_world.resize_group(group_index, new_size);
+        m_world.resize_group_unfinalized(group_index, new_size);
+        m_stepper.invalidate_index();
+        finalize_groups();
 
         // initialize new particles if we added any
         if (new_size > current_size) {
-            std::mt19937 rng{std::random_device{}()};
-            std::uniform_real_distribution<float> rx(0.f, cfg.bounds_width);
-            std::uniform_real_distribution<float> ry(0.f, cfg.bounds_height);
-
-            for (int i = start + current_size; i < start + new_size; ++i) {
-                m_world.set_px(i, rx(rng));
-                m_world.set_py(i, ry(rng));
-                m_world.set_vx(i, 0.f);
-                m_world.set_vy(i, 0.f);
-            }
+            init_particles(start + current_size, start + new_size, cfg);
         }
 
-        m_t_window_steps = 0;
-        m_t_window_start = steady_clock::now();
-        m_total_steps = 0;
+        reset_step_counters();
     }
 }
 
@@ -884,6 +830,7 @@ void Simulation::publish_world_snapshot() {
     mailbox::WorldSnapshot snapshot;
     snapshot.group_count = m_world.get_groups_size();
     snapshot.particles_count = m_world.get_particles_size();
+    snapshot.rng_seed = m_rng_seed;
     snapshot.set_group_ranges(m_world.get_group_ranges());       // Copy data
     snapshot.set_group_colors(m_world.get_group_colors());       // Copy data
     snapshot.set_group_radii2(m_world.get_group_radii2());       // Copy data
@@ -896,3 +843,27 @@ void Simulation::publish_world_snapshot() {
 mailbox::WorldSnapshot Simulation::get_world_snapshot() const {
     return m_mail_world.acquire();
 }
+
+void Simulation::publish_analytics() {
+    mailbox::AnalyticsSnapshot snapshot = m_stepper.analytics();
+    snapshot.num_steps = m_total_steps;
+    m_mail_analytics.publish(snapshot);
+
+    if (m_stepper.clusters_updated()) {
+        mailbox::ClusterSnapshot clusters = m_stepper.clusters();
+        clusters.num_steps = m_total_steps;
+        m_mail_clusters.publish(clusters);
+    }
+}
+
+mailbox::AnalyticsSnapshot Simulation::get_analytics() const {
+    return m_mail_analytics.acquire();
+}
+
+mailbox::ClusterSnapshot Simulation::get_clusters() const {
+    return m_mail_clusters.acquire();
+}
+
+mailbox::MemorySnapshot Simulation::get_memory() const {
+    return m_mail_memory.acquire();
+}
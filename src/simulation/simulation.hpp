@@ -5,6 +5,7 @@
 #include <cmath>
 #include <memory>
 #include <mutex>
+#include <numeric>
 #include <optional>
 #include <random>
 #include <thread>
@@ -12,13 +13,16 @@
 
 #include "../mailbox/data_snapshot.hpp"
 #include "../mailbox/mailbox.hpp"
+#include "../utility/counter_rng.hpp"
 #include "../utility/exceptions.hpp"
+#include "../utility/latency_histogram.hpp"
 #include "../utility/logger.hpp"
 #include "../utility/math.hpp"
+#include "frame_sink.hpp"
 #include "multicore.hpp"
-#include "neighborindex.hpp"
 #include "render/types/window.hpp"
-#include "uniformgrid.hpp"
+#include "seed_world.hpp"
+#include "stepper.hpp"
 #include "world.hpp"
 
 /**
@@ -28,50 +32,6 @@
  * through mailbox system.
  */
 class Simulation {
-  private:
-    /**
-     * @brief Data structure containing kernel parameters for particle
-     * computation
-     */
-    struct KernelData {
-        KernelData() = default;
-        ~KernelData() = default;
-        KernelData(const KernelData &) = delete;
-        KernelData &operator=(const KernelData &) = delete;
-        KernelData(KernelData &&) = delete;
-        KernelData &operator=(KernelData &&) = delete;
-
-        /** @brief Number of particles in the simulation */
-        int particles_count = 0;
-        /** @brief Time scaling factor for simulation speed */
-        float k_time_scale = 0.f;
-        /** @brief Viscosity coefficient (0-1) */
-        float k_viscosity = 0.f;
-        /** @brief Inverse viscosity for velocity damping */
-        float k_inverse_viscosity = 1.f;
-        /** @brief Wall repulsion distance threshold */
-        float k_wall_repel = 0.f;
-        /** @brief Wall repulsion strength */
-        float k_wall_strength = 0.f;
-        /** @brief Gravity force in X direction */
-        float k_gravity_x = 0.f;
-        /** @brief Gravity force in Y direction */
-        float k_gravity_y = 0.f;
-        /** @brief Inverse cell size for spatial grid */
-        float inverse_cell = 1.f;
-        /** @brief Simulation bounds width */
-        float width = 0.f;
-        /** @brief Simulation bounds height */
-        float height = 0.f;
-
-        /** @brief Raw pointer to force buffer X components (owned by
-         * Simulation) */
-        float *fx = nullptr;
-        /** @brief Raw pointer to force buffer Y components (owned by
-         * Simulation) */
-        float *fy = nullptr;
-    };
-
   public:
     /**
      * @brief Simulation execution states
@@ -91,6 +51,12 @@ class Simulation {
      */
     void begin();
 
+    /**
+     * @brief Tells whether begin() started the simulation thread
+     * @return True from begin() until end() joined the thread
+     */
+    inline bool has_started() const noexcept { return m_thread.joinable(); }
+
     /**
      * @brief Stops the simulation thread and cleans up resources
      */
@@ -159,6 +125,34 @@ class Simulation {
      */
     mailbox::WorldSnapshot get_world_snapshot() const;
 
+    /**
+     * @brief Gets the analytics gathered during the latest step
+     * @return Energy, momentum, centroids, speed histogram and cell density
+     * of the world after that step
+     */
+    mailbox::AnalyticsSnapshot get_analytics() const;
+
+    /**
+     * @brief Gets the clusters found by the latest cluster detection pass
+     * @return Cluster count, sizes and centroids (empty until the first pass
+     * with cfg.cluster_interval > 0)
+     */
+    mailbox::ClusterSnapshot get_clusters() const;
+
+    /**
+     * @brief Gets the latest memory report of the simulation thread
+     * @return Bytes used and reserved per subsystem, refreshed about once
+     * per second (all zero before the first report)
+     */
+    mailbox::MemorySnapshot get_memory() const;
+
+    /**
+     * @brief Sets a sink that receives every published frame
+     * @param sink Sink called on the simulation thread, or nullptr for none
+     * @throws SimulationError if the simulation thread is already running
+     */
+    void set_frame_sink(std::shared_ptr<IFrameSink> sink);
+
     /**
      * @brief Gets current simulation run state
      * @return Current run state
@@ -184,6 +178,24 @@ class Simulation {
     void apply_seed(const mailbox::command::SeedSpec &seed,
                     mailbox::SimulationConfigSnapshot &cfg);
 
+    /**
+     * @brief Places a range of particles at random positions with zero
+     * velocity, in parallel on the pool
+     * @param begin First particle index
+     * @param end One past the last particle index
+     * @param cfg Current simulation configuration (bounds)
+     * @details Positions come from the counter-based RNG keyed by the current
+     * seed and indexed by particle, so the result does not depend on the
+     * number of threads. Each call uses a new RNG stream.
+     */
+    void init_particles(int begin, int end,
+                        const mailbox::SimulationConfigSnapshot &cfg);
+
+    /**
+     * @brief Rebuilds the particle-to-group mapping in parallel on the pool
+     */
+    void finalize_groups();
+
     /**
      * @brief Performs one simulation step (force calculation, velocity update,
      * position update)
@@ -199,8 +211,9 @@ class Simulation {
     /**
      * @brief Processes all pending commands from the command queue
      * @param cfg Current simulation configuration
+     * @return True if any command was processed
      */
-    void process_commands(mailbox::SimulationConfigSnapshot &cfg);
+    bool process_commands(mailbox::SimulationConfigSnapshot &cfg);
 
     /**
      * @brief Publishes current particle data to the draw buffer
@@ -213,6 +226,12 @@ class Simulation {
      */
     void publish_world_snapshot();
 
+    /**
+     * @brief Publishes the analytics and, if the step found them, the clusters
+     * of the step just taken
+     */
+    void publish_analytics();
+
     /**
      * @brief Ensures thread pool has correct number of threads
      * @param current_threads Current thread count
@@ -228,6 +247,19 @@ class Simulation {
      */
     bool can_step() const noexcept;
 
+    /**
+     * @brief Checks if the loop has nothing to do until a command arrives
+     * @return True if paused, or running with no particles
+     */
+    bool is_idle() const noexcept;
+
+    /**
+     * @brief Publishes idle stats and blocks on the command queue
+     * @param n_threads Number of threads used
+     * @details Returns when a command is queued or the config changes.
+     */
+    void wait_while_idle(int n_threads);
+
     /**
      * @brief Measures and updates TPS (ticks per second) statistics
      * @param n_threads Number of threads used
@@ -239,41 +271,36 @@ class Simulation {
     /**
      * @brief Waits to maintain target TPS if specified
      * @param target_tps Target ticks per second (0 = no limit)
+     * @details Records how far each sleep overshoots, and counts a missed
+     * deadline when the tick already took longer than 1 / target_tps.
      */
     void wait_on_tps(int target_tps) noexcept;
 
     /**
-     * @brief Publishes stats immediately for better responsiveness
-     * @param n_threads Number of threads used
-     * @param step_diff_ns Time taken for the step in nanoseconds
+     * @brief Restarts the step count, the TPS window and the latency
+     * histograms
      */
-    void
-    publish_stats_immediately(int n_threads,
-                              std::chrono::nanoseconds step_diff_ns) noexcept;
+    void reset_step_counters() noexcept;
 
     /**
-     * @brief Kernel function for force calculation between particles
-     * @param start Start particle index
-     * @param end End particle index (exclusive)
-     * @param data Kernel data containing simulation parameters
+     * @brief Copies the latency percentiles into a stats snapshot
+     * @param st Snapshot to fill
      */
-    void kernel_force(int start, int end, KernelData &data);
+    void fill_latency(mailbox::SimulationStatsSnapshot &st) const noexcept;
 
     /**
-     * @brief Kernel function for position update and boundary collision
-     * @param start Start particle index
-     * @param end End particle index (exclusive)
-     * @param data Kernel data containing simulation parameters
+     * @brief Measures the memory of every subsystem and publishes it
      */
-    void kernel_pos(int start, int end, KernelData &data);
+    void publish_memory();
 
     /**
-     * @brief Kernel function for velocity update with viscosity
-     * @param start Start particle index
-     * @param end End particle index (exclusive)
-     * @param data Kernel data containing simulation parameters
+     * @brief Publishes stats immediately for better responsiveness
+     * @param n_threads Number of threads used
+     * @param step_diff_ns Time taken for the step in nanoseconds
      */
-    void kernel_vel(int start, int end, KernelData &data);
+    void
+    publish_stats_immediately(int n_threads,
+                              std::chrono::nanoseconds step_diff_ns) noexcept;
 
     // Command processing functions
     /**
@@ -348,8 +375,8 @@ class Simulation {
   private:
     /** @brief Simulation world containing all particles and groups */
     World m_world;
-    /** @brief Spatial indexing structure for efficient neighbor finding */
-    NeighborIndex m_idx;
+    /** @brief Physics kernels and the neighbor index they build */
+    Stepper m_stepper;
     /** @brief Thread pool for parallel computation */
     std::unique_ptr<SimulationThreadPool> m_pool;
     /** @brief Command queue for thread-safe communication */
@@ -362,17 +389,24 @@ class Simulation {
     mailbox::DataSnapshot<mailbox::SimulationStatsSnapshot> m_mail_stats;
     /** @brief World data snapshot for thread-safe access */
     mailbox::DataSnapshot<mailbox::WorldSnapshot> m_mail_world;
+    /** @brief Step analytics snapshot for thread-safe access */
+    mailbox::DataSnapshot<mailbox::AnalyticsSnapshot> m_mail_analytics;
+    /** @brief Cluster snapshot for thread-safe access */
+    mailbox::DataSnapshot<mailbox::ClusterSnapshot> m_mail_clusters;
+    /** @brief Memory report snapshot for thread-safe access */
+    mailbox::DataSnapshot<mailbox::MemorySnapshot> m_mail_memory;
+    /** @brief Optional receiver of published frames (sim thread only) */
+    std::shared_ptr<IFrameSink> m_frame_sink;
     /** @brief Main simulation thread */
     std::thread m_thread;
     /** @brief Initial seed used to create the simulation */
     std::optional<mailbox::command::SeedSpec> m_initial_seed;
     /** @brief Current seed specification */
     std::optional<mailbox::command::SeedSpec> m_current_seed;
-
-    /** @brief Force buffer X components (reused every step) */
-    std::vector<float> m_fx;
-    /** @brief Force buffer Y components (reused every step) */
-    std::vector<float> m_fy;
+    /** @brief Key for particle placement, taken from the last applied seed */
+    uint64_t m_rng_seed;
+    /** @brief Next RNG stream; advanced by every placement since the seed */
+    uint32_t m_rng_stream{0};
 
   private:
     /** @brief Current simulation execution state */
@@ -387,4 +421,10 @@ class Simulation {
     std::chrono::steady_clock::time_point m_t_window_start;
     /** @brief Time of last simulation step */
     std::chrono::steady_clock::time_point m_t_last_step_time;
+    /** @brief Durations of the steps taken since the last counter reset */
+    particles::utility::LatencyHistogram m_t_step_latency;
+    /** @brief How far wait_on_tps slept past each deadline */
+    particles::utility::LatencyHistogram m_t_oversleep;
+    /** @brief Ticks that overran 1 / target_tps */
+    std::atomic<long long> m_t_missed_deadlines{0};
 };
\ No newline at end of file
@@ -0,0 +1,303 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include "uniformgrid.hpp"
+
+/**
+ * @brief Fixed-cell-size 2D spatial hash that only stores occupied cells.
+ *
+ * @details
+ * Same partitioning and CSR query API as @ref UniformGrid, but memory and
+ * build time scale with the item count instead of rows*cols. Occupied cells
+ * are kept in an open-addressing hash table keyed by the flat cell key
+ * (cy*cols + cx, 64-bit so huge bounds cannot overflow) that maps to a dense
+ * slot id. @ref cell_index returns that slot id, or -1 for an empty or
+ * out-of-range cell, so existing neighbor loops work unchanged:
+ *
+ * @code
+ * const int ci = grid.cell_index(cx + dx, cy + dy);
+ * if (ci < 0) continue; // outside grid or empty
+ * const int start = grid.cell_start_at(ci);
+ * const int end = start + grid.cell_count_at(ci);
+ * for (int k = start; k < end; ++k) { int j = grid.indices()[k]; ... }
+ * @endcode
+ *
+ * Items inside a cell are stored in ascending index order, exactly like the
+ * dense grid, so neighbor traversal visits the same items in the same order.
+ *
+ * Complexity:
+ * - build: O(N) expected time, O(N) memory
+ * - cell_index: O(1) expected (one hash probe sequence)
+ *
+ * The linked-list head/next view of @ref UniformGrid is not provided: a
+ * per-cell head array is exactly the dense allocation this grid avoids.
+ */
+class SparseGrid {
+  public:
+    /** @brief Cache-line aligned index storage */
+    using Buffer = particles::utility::AlignedVector<int>;
+
+    SparseGrid() = default;
+    ~SparseGrid() = default;
+    SparseGrid(const SparseGrid &) = delete;
+    SparseGrid(SparseGrid &&) = delete;
+    SparseGrid &operator=(const SparseGrid &) = delete;
+    SparseGrid &operator=(SparseGrid &&) = delete;
+
+    /**
+     * @brief Reset to a minimal 1×1 grid and release all storage.
+     */
+    void reset() {
+        m_cell = 64.f;
+        m_width = 64.f;
+        m_height = 64.f;
+        m_cols = 1;
+        m_rows = 1;
+        m_occupied = 0;
+        m_table_keys.clear();
+        m_table_slots.clear();
+        m_cellStart.clear();
+        m_cellCount.clear();
+        m_cellMask.clear();
+        m_indices.clear();
+        m_item_cell.clear();
+        m_cursor.clear();
+    }
+
+    inline float width() const { return m_width; }
+    inline float height() const { return m_height; }
+    inline float cell_size() const { return m_cell; }
+    inline int cols() const { return m_cols; }
+    inline int rows() const { return m_rows; }
+    inline float inv_cell() const { return 1.0f / m_cell; }
+
+    /**
+     * @brief Number of non-empty cells after the last build.
+     */
+    inline int occupied_cells() const { return m_occupied; }
+
+    /**
+     * @brief Map a point (x,y) to clamped cell coordinates.
+     */
+    inline void cell_of(float x, float y, int &cx, int &cy) const {
+        const float invc = 1.0f / m_cell;
+        int ix = (int)std::floor(x * invc);
+        int iy = (int)std::floor(y * invc);
+        cx = std::clamp(ix, 0, m_cols - 1);
+        cy = std::clamp(iy, 0, m_rows - 1);
+    }
+
+    // CSR-style contiguous storage accessors, indexed by slot id
+    inline int cell_start_at(int ci) const { return m_cellStart[ci]; }
+    inline int cell_count_at(int ci) const { return m_cellCount[ci]; }
+    inline const Buffer &indices() const { return m_indices; }
+
+    /**
+     * @brief Groups present in slot @c ci (see UniformGrid::cell_mask_at).
+     */
+    inline uint64_t cell_mask_at(int ci) const { return m_cellMask[ci]; }
+
+    /**
+     * @brief Bytes held by the hash table, the CSR storage, the cell masks
+     * and the build scratch buffers.
+     */
+    particles::utility::MemoryUsage memory_usage() const noexcept {
+        particles::utility::MemoryUsage usage;
+        usage.add(m_table_keys)
+            .add(m_table_slots)
+            .add(m_cellStart)
+            .add(m_cellCount)
+            .add(m_indices)
+            .add(m_cellMask)
+            .add(m_item_cell)
+            .add(m_cursor);
+        return usage;
+    }
+
+    /**
+     * @brief Look up the slot id of cell (cx,cy), or -1 if the cell is out of
+     * range or holds no items.
+     */
+    inline int cell_index(int cx, int cy) const {
+        if (cx < 0 || cy < 0 || cx >= m_cols || cy >= m_rows ||
+            m_occupied == 0) {
+            return -1;
+        }
+        const int64_t key = (int64_t)cy * m_cols + cx;
+        for (size_t h = hash(key);; h = (h + 1) & m_mask) {
+            const int64_t k = m_table_keys[h];
+            if (k == key) {
+                return m_table_slots[h];
+            }
+            if (k == EMPTY_KEY) {
+                return -1;
+            }
+        }
+    }
+
+    /**
+     * @brief Resize/reinitialize the grid for new bounds and item count.
+     *
+     * @param width     World width (>= 1)
+     * @param height    World height (>= 1)
+     * @param cell_size Size of one cell (>= 1)
+     * @param count     Number of items (N)
+     *
+     * @details Only item-sized storage is allocated; the hash table holds at
+     * least twice as many buckets as items so probe sequences stay short.
+     */
+    inline void resize(float width, float height, float cell_size, int count) {
+        m_cell = std::max(1.0f, cell_size);
+        m_width = std::max(1.0f, width);
+        m_height = std::max(1.0f, height);
+        m_cols = std::max(1, (int)std::ceil(m_width / m_cell));
+        m_rows = std::max(1, (int)std::ceil(m_height / m_cell));
+
+        size_t buckets = 16;
+        while (buckets < (size_t)std::max(0, count) * 2) {
+            buckets <<= 1;
+        }
+        m_mask = buckets - 1;
+        m_shift = 64;
+        for (size_t b = buckets; b > 1; b >>= 1) {
+            --m_shift;
+        }
+        m_table_keys.assign(buckets, EMPTY_KEY);
+        m_table_slots.assign(buckets, -1);
+
+        m_occupied = 0;
+        m_cellStart.assign(count, 0);
+        m_cellCount.assign(count, 0);
+        m_cellMask.assign(count, 0);
+        m_indices.assign(count, -1);
+    }
+
+    /**
+     * @brief Populate the occupied cells from item positions.
+     *
+     * @param count Number of items (N). Must match the size passed to @ref
+     * resize.
+     * @param get_x X accessor
+     * @param get_y Y accessor
+     * @param group_of Group of item i; a negative group leaves the item out
+     *
+     * @details Positions are mapped exactly like @ref UniformGrid::build
+     * (non-finite → (0,0), then clamped). Slot ids are assigned in order of
+     * first appearance.
+     */
+    template <FloatGetter GetX, FloatGetter GetY,
+              GroupGetter GroupOf = SingleGroup>
+    void build(int count, GetX get_x, GetY get_y, float /*width*/,
+               float /*height*/, GroupOf group_of = {}) {
+#ifndef NDEBUG
+        assert((int)m_indices.size() == count);
+        assert(m_table_keys.size() >= (size_t)count * 2);
+#endif
+        std::fill(m_table_keys.begin(), m_table_keys.end(), EMPTY_KEY);
+        if ((int)m_item_cell.size() != count) {
+            m_item_cell.assign(count, 0);
+        }
+
+        const int max_cx = m_cols - 1;
+        const int max_cy = m_rows - 1;
+        const float inv_cell = 1.0f / m_cell;
+
+        // First pass: find or insert each item's cell and count per slot
+        int occupied = 0;
+        for (int i = 0; i < count; ++i) {
+            const int group = group_of(i);
+            if (group < 0) {
+                m_item_cell[i] = -1;
+                continue;
+            }
+            float x = get_x(i);
+            float y = get_y(i);
+
+            if (!std::isfinite(x) || !std::isfinite(y)) {
+                x = 0.0f;
+                y = 0.0f;
+            }
+
+            const int cx = std::clamp((int)std::floor(x * inv_cell), 0, max_cx);
+            const int cy = std::clamp((int)std::floor(y * inv_cell), 0, max_cy);
+            const int64_t key = (int64_t)cy * m_cols + cx;
+
+            size_t h = hash(key);
+            while (m_table_keys[h] != key && m_table_keys[h] != EMPTY_KEY) {
+                h = (h + 1) & m_mask;
+            }
+            if (m_table_keys[h] == EMPTY_KEY) {
+                m_table_keys[h] = key;
+                m_table_slots[h] = occupied;
+                m_cellCount[occupied] = 0;
+                m_cellMask[occupied] = 0;
+                ++occupied;
+            }
+            const int slot = m_table_slots[h];
+            m_item_cell[i] = slot;
+            m_cellCount[slot] += 1;
+            m_cellMask[slot] |= group_mask_bit(group);
+        }
+        m_occupied = occupied;
+
+        // Exclusive scan over occupied slots only
+        int running = 0;
+        for (int s = 0; s < occupied; ++s) {
+            m_cellStart[s] = running;
+            running += m_cellCount[s];
+        }
+
+        if ((int)m_cursor.size() != count) {
+            m_cursor.assign(count, 0);
+        }
+        std::copy_n(m_cellStart.begin(), occupied, m_cursor.begin());
+        for (int i = 0; i < count; ++i) {
+            const int slot = m_item_cell[i];
+            if (slot < 0) {
+                continue;
+            }
+            m_indices[m_cursor[slot]++] = i;
+        }
+        std::fill(m_indices.begin() + running, m_indices.end(), -1);
+    }
+
+  private:
+    static constexpr int64_t EMPTY_KEY = -1;
+
+    inline size_t hash(int64_t key) const {
+        // Fibonacci hashing: the top bits of the product are well mixed
+        return (size_t)(((uint64_t)key * 0x9E3779B97F4A7C15ull) >> m_shift) &
+               m_mask;
+    }
+
+    // Grid configuration
+    float m_cell = 64.f;
+    float m_width = 64.f;
+    float m_height = 64.f;
+    int m_cols = 1;
+    int m_rows = 1;
+
+    // Open-addressing table: cell key -> slot id (linear probing)
+    std::vector<int64_t> m_table_keys;
+    std::vector<int> m_table_slots;
+    size_t m_mask = 0;
+    int m_shift = 64;
+    int m_occupied = 0;
+
+    // CSR-style contiguous storage per occupied slot
+    Buffer m_cellStart; // size N (first m_occupied used)
+    Buffer m_cellCount; // size N (first m_occupied used)
+    Buffer m_indices;   // size N, contiguous ranges per slot
+
+    // group_mask_bit() of every group present, per slot (size N)
+    particles::utility::AlignedVector<uint64_t> m_cellMask;
+
+    // transient buffers reused across builds
+    Buffer m_item_cell; // size N
+    Buffer m_cursor;    // size N
+};
@@ -0,0 +1,450 @@
+#include "stepper.hpp"
+
+#include <algorithm>
+
+constexpr float EPS = 1e-12f;
+
+constexpr int grid_offsets[9][2] = {{-1, -1}, {0, -1}, {1, -1}, {-1, 0}, {0, 0},
+                                    {1, 0},   {-1, 1}, {0, 1},  {1, 1}};
+
+void Stepper::step(World &world, SimulationThreadPool &pool,
+                   const mailbox::SimulationConfigSnapshot &cfg) {
+    run(
+        world, cfg,
+        [&pool](auto &&kernel, int n) {
+            pool.parallel_for_n(kernel, n);
+        },
+        [&pool](const auto &identity, auto &&fn, auto &&combine, int n) {
+            return pool.parallel_reduce_n(identity, fn, combine, n);
+        });
+}
+
+void Stepper::step(World &world,
+                   const mailbox::SimulationConfigSnapshot &cfg) {
+    run(
+        world, cfg,
+        [](auto &&kernel, int n) {
+            kernel(0, n);
+        },
+        [](const auto &identity, auto &&fn, auto &&combine, int n) {
+            return reduce_chunks(identity, fn, combine, n, REDUCE_GRAIN,
+                                 [](auto &&kernel, int chunks) {
+                                     kernel(0, chunks);
+                                 });
+        });
+}
+
+template <typename ForN, typename ReduceN>
+void Stepper::run(World &world, const mailbox::SimulationConfigSnapshot &cfg,
+                  ForN &&for_n, ReduceN &&reduce_n) {
+    m_clusters_updated = false;
+    const int particles_count = world.get_particles_size();
+    if (particles_count == 0) {
+        if (m_analytics_enabled) {
+            m_analytics = mailbox::AnalyticsSnapshot{};
+        }
+        return;
+    }
+
+    if ((int)m_fx.size() != particles_count) {
+        m_fx.resize(particles_count);
+    }
+    if ((int)m_fy.size() != particles_count) {
+        m_fy.resize(particles_count);
+    }
+    std::fill_n(m_fx.data(), particles_count, 0.f);
+    std::fill_n(m_fy.data(), particles_count, 0.f);
+    if (m_pair_counts_enabled) {
+        // every particle's counts are overwritten by the force pass
+        m_examined.resize(particles_count);
+        m_accepted.resize(particles_count);
+    } else {
+        m_examined.clear();
+        m_accepted.clear();
+    }
+
+    KernelData data;
+    data.particles_count = particles_count;
+    data.k_time_scale = cfg.time_scale;
+    data.k_viscosity = cfg.viscosity;
+    data.k_inverse_viscosity = 1.f - cfg.viscosity;
+    data.k_wall_repel = cfg.wall_repel;
+    data.k_wall_strength = cfg.wall_strength;
+    data.k_gravity_x = cfg.gravity_x;
+    data.k_gravity_y = cfg.gravity_y;
+    data.width = cfg.bounds_width;
+    data.height = cfg.bounds_height;
+    data.fx = m_fx.data();
+    data.fy = m_fy.data();
+    if (m_pair_counts_enabled) {
+        data.examined = m_examined.data();
+        data.accepted = m_accepted.data();
+    }
+
+    update_group_masks(world);
+    data.group_masks = m_group_masks.data();
+
+    float maxR = std::max(1.0f, world.max_interaction_radius());
+    data.inverse_cell =
+        m_idx.ensure(world, cfg.bounds_width, cfg.bounds_height, maxR);
+    m_index_generation = m_world_generation;
+    data.cell_size = 1.f / data.inverse_cell;
+    data.prune_below_r2 = 2.f * data.cell_size * data.cell_size;
+
+    // accumulate forces
+    StencilPartial stencil;
+    if (cfg.force_table) {
+        m_table.update(world);
+        data.table = &m_table;
+        stencil = force_pass<true>(world, data, for_n, reduce_n);
+    } else {
+        stencil = force_pass<false>(world, data, for_n, reduce_n);
+    }
+
+    // clusters, while the grid still matches the positions
+    if (m_analytics_enabled) {
+        if (cfg.cluster_interval > 0 &&
+            m_analytics_steps % cfg.cluster_interval == 0) {
+            m_idx.visit([&](const auto &grid) {
+                m_cluster_finder.find(world, grid, cfg.cluster_distance, for_n,
+                                      m_clusters);
+            });
+            m_clusters_updated = true;
+        }
+        ++m_analytics_steps;
+    }
+
+    // velocity update
+    for_n(
+        [&](int s, int e) {
+            kernel_vel(world, s, e, data);
+        },
+        particles_count);
+
+    // position + bounce
+    if (!m_analytics_enabled) {
+        for_n(
+            [&](int s, int e) {
+                kernel_pos<false>(world, s, e, data, nullptr);
+            },
+            particles_count);
+        return;
+    }
+
+    // Bin speeds against the previous step's maximum (with headroom) so the
+    // histogram needs no extra pass to find its range
+    const float speed_range =
+        m_analytics.max_speed > 0.f ? m_analytics.max_speed * 1.25f : 1.f;
+    data.bins_per_speed = AnalyticsPartial::SPEED_BINS / speed_range;
+    const AnalyticsPartial particles = reduce_n(
+        AnalyticsPartial(world.get_groups_size()),
+        [&](int s, int e, AnalyticsPartial &partial) {
+            kernel_pos<true>(world, s, e, data, &partial);
+        },
+        [](AnalyticsPartial &into, const AnalyticsPartial &from) {
+            into.merge(from);
+        },
+        particles_count);
+    finish_analytics_step(reduce_n, particles, stencil, speed_range);
+}
+
+template <bool UseTable, typename ForN, typename ReduceN>
+StencilPartial Stepper::force_pass(const World &world, KernelData &data,
+                                   ForN &&for_n, ReduceN &&reduce_n) {
+    const int particles_count = data.particles_count;
+    return m_idx.visit([&](const auto &grid) {
+        if (!m_analytics_enabled && !m_pair_counts_enabled) {
+            for_n(
+                [&](int s, int e) {
+                    kernel_force<UseTable, false>(world, grid, s, e, data,
+                                                  nullptr);
+                },
+                particles_count);
+            return StencilPartial{};
+        }
+        return reduce_n(
+            StencilPartial{},
+            [&](int s, int e, StencilPartial &partial) {
+                kernel_force<UseTable, true>(world, grid, s, e, data,
+                                             &partial);
+            },
+            [](StencilPartial &into, const StencilPartial &from) {
+                into.merge(from);
+            },
+            particles_count);
+    });
+}
+
+void Stepper::update_group_masks(const World &world) {
+    const int groups = world.get_groups_size();
+    m_group_masks.assign(groups, 0);
+    for (int g = 0; g < groups; ++g) {
+        const auto rules = world.rules_of(g);
+        for (int other = 0; other < groups; ++other) {
+            if (rules.get(other) != 0.f && world.is_group_enabled(other)) {
+                m_group_masks[g] |= group_mask_bit(other);
+            }
+        }
+    }
+}
+
+template <typename ReduceN>
+void Stepper::finish_analytics_step(ReduceN &&reduce_n,
+                                    const AnalyticsPartial &particles,
+                                    const StencilPartial &stencil,
+                                    float speed_range) {
+    // Cell counts describe the grid built at the start of the step
+    m_idx.visit([&](const auto &grid) {
+        const CellPartial cells = reduce_n(
+            CellPartial{},
+            [&](int s, int e, CellPartial &partial) {
+                for (int ci = s; ci < e; ++ci) {
+                    partial.add(grid.cell_count_at(ci));
+                }
+            },
+            [](CellPartial &into, const CellPartial &from) {
+                into.merge(from);
+            },
+            cell_slots(grid));
+        const long long total_cells = (long long)grid.cols() * grid.rows();
+        finish_analytics(particles, cells, stencil, total_cells, speed_range,
+                         m_analytics);
+    });
+}
+
+template <bool UseTable, bool Counted, typename Grid>
+void Stepper::kernel_force(const World &world, const Grid &grid, int start,
+                           int end, KernelData &data,
+                           StencilPartial *partial) {
+    // Get SoA arrays for better cache locality and potential vectorization
+    const float *const px_array = world.get_px_array();
+    const float *const py_array = world.get_py_array();
+
+    for (int i = start; i < end; ++i) {
+        const float particle_x = px_array[i];
+        const float particle_y = py_array[i];
+        const int group_index = world.group_of(i);
+        const float interaction_radius_squared = world.r2_of(group_index);
+
+        // skip disabled groups and groups that reach nothing
+        if (!world.is_group_enabled(group_index) ||
+            interaction_radius_squared <= 0.f) {
+            data.fx[i] = 0.f;
+            data.fy[i] = 0.f;
+            if constexpr (Counted) {
+                if (data.examined) {
+                    data.examined[i] = 0;
+                    data.accepted[i] = 0;
+                }
+            }
+            continue;
+        }
+
+        float force_x = 0.f, force_y = 0.f;
+        [[maybe_unused]] int examined = 0, accepted = 0;
+        int cell_x =
+            std::min(int(particle_x * data.inverse_cell), grid.cols() - 1);
+        int cell_y =
+            std::min(int(particle_y * data.inverse_cell), grid.rows() - 1);
+
+        const auto interaction_rules = world.rules_of(group_index);
+        const uint64_t wanted_groups = data.group_masks[group_index];
+
+        // Squared gap from the particle to the neighbor cells on each side
+        // (left/top, own, right/bottom). A neighbor cell is out of reach when
+        // the gap to its rectangle is at least the radius, which only happens
+        // for radii below a corner cell's farthest gap.
+        const bool prune = interaction_radius_squared < data.prune_below_r2;
+        const float inside_x = std::clamp(
+            particle_x - (float)cell_x * data.cell_size, 0.f, data.cell_size);
+        const float inside_y = std::clamp(
+            particle_y - (float)cell_y * data.cell_size, 0.f, data.cell_size);
+        const float gap_x2[3] = {inside_x * inside_x, 0.f,
+                                 (data.cell_size - inside_x) *
+                                     (data.cell_size - inside_x)};
+        const float gap_y2[3] = {inside_y * inside_y, 0.f,
+                                 (data.cell_size - inside_y) *
+                                     (data.cell_size - inside_y)};
+
+        ForceTable::SourceRow table_row{};
+        if constexpr (UseTable) {
+            table_row = data.table->row(group_index);
+        }
+
+        // A group without rules towards enabled groups feels no pair forces
+        for (int k = 0; wanted_groups != 0 && k < 9; ++k) {
+            const int offset_x = grid_offsets[k][0];
+            const int offset_y = grid_offsets[k][1];
+            const bool out_of_reach =
+                prune && gap_x2[offset_x + 1] + gap_y2[offset_y + 1] >=
+                             interaction_radius_squared;
+            if (out_of_reach && !Counted) {
+                continue;
+            }
+
+            const int neighbor_cell_index =
+                grid.cell_index(cell_x + offset_x, cell_y + offset_y);
+            if constexpr (Counted) {
+                if (out_of_reach) {
+                    if (neighbor_cell_index >= 0) {
+                        ++partial->pruned_cells;
+                        partial->pruned_candidates +=
+                            grid.cell_count_at(neighbor_cell_index);
+                    }
+                    continue;
+                }
+            }
+
+            // skip cells holding none of the groups this one reacts to
+            if (neighbor_cell_index < 0 ||
+                (grid.cell_mask_at(neighbor_cell_index) & wanted_groups) ==
+                    0) {
+                continue;
+            }
+            if constexpr (Counted) {
+                ++partial->scanned_cells;
+            }
+
+            const int cell_start = grid.cell_start_at(neighbor_cell_index);
+            const int cell_count = grid.cell_count_at(neighbor_cell_index);
+            const auto &particle_indices = grid.indices();
+            const int cell_end = cell_start + cell_count;
+            for (int pos = cell_start; pos < cell_end; ++pos) {
+                const int j = particle_indices[pos];
+                if (j == i) {
+                    continue;
+                }
+                if constexpr (Counted) {
+                    ++examined;
+                }
+                const float other_particle_x = px_array[j];
+                const float other_particle_y = py_array[j];
+                const float dx = particle_x - other_particle_x;
+                const float dy = particle_y - other_particle_y;
+                const float distance_squared = dx * dx + dy * dy;
+                if (distance_squared > 0.f &&
+                    distance_squared < interaction_radius_squared) {
+                    // disabled groups are not in the grid
+                    const int other_group_index = world.group_of(j);
+                    float force_magnitude;
+                    if constexpr (UseTable) {
+                        force_magnitude =
+                            table_row.at(other_group_index, distance_squared);
+                    } else {
+                        const float interaction_strength =
+                            interaction_rules.get(other_group_index);
+                        const float inv_distance =
+                            rsqrt_fast(std::max(distance_squared, EPS));
+                        force_magnitude = interaction_strength * inv_distance;
+                    }
+                    force_x += force_magnitude * dx;
+                    force_y += force_magnitude * dy;
+                    if constexpr (Counted) {
+                        ++accepted;
+                    }
+                }
+            }
+        }
+
+        if constexpr (Counted) {
+            partial->examined_pairs += examined;
+            partial->accepted_pairs += accepted;
+            if (data.examined) {
+                data.examined[i] = examined;
+                data.accepted[i] = accepted;
+            }
+        }
+
+        if (data.k_wall_repel > 0.f) {
+            const float wall_repel_distance = data.k_wall_repel;
+            const float wall_strength = data.k_wall_strength;
+
+            if (particle_x < wall_repel_distance) {
+                force_x += (wall_repel_distance - particle_x) * wall_strength;
+            }
+            if (particle_x > data.width - wall_repel_distance) {
+                force_x += (data.width - wall_repel_distance - particle_x) *
+                           wall_strength;
+            }
+            if (particle_y < wall_repel_distance) {
+                force_y += (wall_repel_distance - particle_y) * wall_strength;
+            }
+            if (particle_y > data.height - wall_repel_distance) {
+                force_y += (data.height - wall_repel_distance - particle_y) *
+                           wall_strength;
+            }
+        }
+
+        // apply gravity
+        force_x += data.k_gravity_x;
+        force_y += data.k_gravity_y;
+
+        data.fx[i] = force_x;
+        data.fy[i] = force_y;
+    }
+}
+
+void Stepper::kernel_vel(World &world, int start, int end,
+                         KernelData &data) {
+    // Get SoA arrays for better cache locality and potential vectorization
+    float *const vx_array = world.get_vx_array_mut();
+    float *const vy_array = world.get_vy_array_mut();
+
+    for (int i = start; i < end; ++i) {
+        const float new_velocity_x = vx_array[i] * data.k_inverse_viscosity +
+                                     data.fx[i] * data.k_time_scale;
+        const float new_velocity_y = vy_array[i] * data.k_inverse_viscosity +
+                                     data.fy[i] * data.k_time_scale;
+
+        vx_array[i] = new_velocity_x;
+        vy_array[i] = new_velocity_y;
+    }
+}
+
+template <bool Analytics>
+void Stepper::kernel_pos(World &world, int start, int end, KernelData &data,
+                         AnalyticsPartial *partial) {
+    // Get SoA arrays for better cache locality and potential vectorization
+    const float *const px_array = world.get_px_array();
+    const float *const py_array = world.get_py_array();
+    const float *const vx_array = world.get_vx_array();
+    const float *const vy_array = world.get_vy_array();
+    float *const px_array_mut = world.get_px_array_mut();
+    float *const py_array_mut = world.get_py_array_mut();
+    float *const vx_array_mut = world.get_vx_array_mut();
+    float *const vy_array_mut = world.get_vy_array_mut();
+
+    for (int i = start; i < end; ++i) {
+        float new_x = px_array[i] + vx_array[i];
+        float new_y = py_array[i] + vy_array[i];
+        float new_velocity_x = vx_array[i];
+        float new_velocity_y = vy_array[i];
+
+        if (new_x < 0.f) {
+            new_x = -new_x;
+            new_velocity_x = -new_velocity_x;
+        }
+        if (new_x >= data.width) {
+            new_x = 2.f * data.width - new_x;
+            new_velocity_x = -new_velocity_x;
+        }
+        if (new_y < 0.f) {
+            new_y = -new_y;
+            new_velocity_y = -new_velocity_y;
+        }
+        if (new_y >= data.height) {
+            new_y = 2.f * data.height - new_y;
+            new_velocity_y = -new_velocity_y;
+        }
+
+        px_array_mut[i] = new_x;
+        py_array_mut[i] = new_y;
+        vx_array_mut[i] = new_velocity_x;
+        vy_array_mut[i] = new_velocity_y;
+
+        if constexpr (Analytics) {
+            partial->add(world.group_of(i), new_x, new_y, new_velocity_x,
+                         new_velocity_y, data.bins_per_speed);
+        }
+    }
+}
@@ -0,0 +1,350 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "../mailbox/data_snapshot.hpp"
+#include "../utility/math.hpp"
+#include "analytics.hpp"
+#include "clusters.hpp"
+#include "force_table.hpp"
+#include "multicore.hpp"
+#include "neighborindex.hpp"
+#include "world.hpp"
+
+/**
+ * @brief Advances a World by one physics step
+ *
+ * Owns the neighbor index and force buffers the kernels need, so any owner of
+ * a World (the simulation thread, a slab worker) steps it with exactly the
+ * same math. Results depend only on the world contents and config: particle
+ * order inside each cell follows particle index, so a world holding the same
+ * particles in the same relative order produces bit-identical forces.
+ *
+ * With cfg.force_table set, pair forces come from a ForceTable that is
+ * rebuilt only when the world's rules or radii change.
+ *
+ * With analytics enabled, the position kernel also sums energy, momentum,
+ * group centroids and a speed histogram through a chunked reduction, and the
+ * neighbor grid's cell counts are reduced the same way. The extra work rides
+ * on data the kernel already has in registers, so no second pass over the
+ * particles is needed. Every cfg.cluster_interval steps it also finds
+ * clusters with a ClusterFinder, before the positions move away from the
+ * grid.
+ */
+class Stepper {
+  public:
+    Stepper() = default;
+    ~Stepper() = default;
+    Stepper(const Stepper &) = delete;
+    Stepper &operator=(const Stepper &) = delete;
+    Stepper(Stepper &&) = delete;
+    Stepper &operator=(Stepper &&) = delete;
+
+    /**
+     * @brief Performs one simulation step (force calculation, velocity update,
+     * position update)
+     * @param world World to advance in place
+     * @param pool Thread pool the kernels run on
+     * @param cfg Current simulation configuration
+     */
+    void step(World &world, SimulationThreadPool &pool,
+              const mailbox::SimulationConfigSnapshot &cfg);
+
+    /**
+     * @brief Performs one simulation step on the calling thread
+     * @param world World to advance in place
+     * @param cfg Current simulation configuration
+     *
+     * Produces the same result as the pooled overload; meant for callers that
+     * already parallelize across worlds (Ensemble).
+     */
+    void step(World &world, const mailbox::SimulationConfigSnapshot &cfg);
+
+    /**
+     * @brief Gets the neighbor index built by the last step
+     * @return Neighbor index (dense or sparse grid)
+     */
+    const NeighborIndex &index() const noexcept { return m_idx; }
+
+    /**
+     * @brief Marks the neighbor index as built for an older world
+     * @details Call after editing the world outside a step (seeding, group
+     * edits, enabling groups); only the next step rebuilds the index.
+     */
+    void invalidate_index() noexcept { ++m_world_generation; }
+
+    /**
+     * @brief Tells whether the index matches the world as last stepped
+     * @return False from invalidate_index() until the next step builds it
+     */
+    bool index_current() const noexcept {
+        return m_index_generation == m_world_generation;
+    }
+
+    /**
+     * @brief Gets the force lookup table
+     * @return Table as of the last step that used it
+     */
+    const ForceTable &force_table() const noexcept { return m_table; }
+
+    /**
+     * @brief Gets the bytes held by the step buffers
+     * @return Usage of the force buffers, force table, group masks and pair
+     * counts (the neighbor index is reported by its grids)
+     */
+    particles::utility::MemoryUsage memory_usage() const noexcept {
+        particles::utility::MemoryUsage usage = m_table.memory_usage();
+        usage.add(m_fx).add(m_fy).add(m_group_masks);
+        usage.add(m_examined).add(m_accepted);
+        return usage;
+    }
+
+    /**
+     * @brief Turns analytics gathering on or off (off by default)
+     * @param enabled Whether following steps fill analytics()
+     */
+    void set_analytics(bool enabled) noexcept { m_analytics_enabled = enabled; }
+
+    /**
+     * @brief Gets the analytics of the last step that gathered them
+     * @return Analytics; num_steps is left for the owner to fill in
+     */
+    const mailbox::AnalyticsSnapshot &analytics() const noexcept {
+        return m_analytics;
+    }
+
+    /**
+     * @brief Turns per-particle force pair counts on or off (off by default)
+     * @param enabled Whether following steps fill examined_pairs() and
+     * accepted_pairs()
+     */
+    void set_pair_counts(bool enabled) noexcept {
+        m_pair_counts_enabled = enabled;
+    }
+
+    /**
+     * @brief Gets the candidate pairs each particle read in the last step
+     * @return One count per particle; empty unless pair counts are enabled
+     *
+     * Summed over the particles of a neighbor cell, this is the force work
+     * spent on that cell.
+     */
+    const particles::utility::AlignedVector<int> &
+    examined_pairs() const noexcept {
+        return m_examined;
+    }
+
+    /**
+     * @brief Gets the examined pairs of each particle that were inside its
+     * radius in the last step
+     * @return One count per particle; empty unless pair counts are enabled
+     */
+    const particles::utility::AlignedVector<int> &
+    accepted_pairs() const noexcept {
+        return m_accepted;
+    }
+
+    /**
+     * @brief Tells whether the last step found clusters
+     * @return True if clusters() was refreshed by the last step
+     */
+    bool clusters_updated() const noexcept { return m_clusters_updated; }
+
+    /**
+     * @brief Gets the clusters of the last step that looked for them
+     * @return Clusters; num_steps is left for the owner to fill in
+     */
+    const mailbox::ClusterSnapshot &clusters() const noexcept {
+        return m_clusters;
+    }
+
+  private:
+    /**
+     * @brief Runs the three kernels of a step
+     * @param world World to advance in place
+     * @param cfg Current simulation configuration
+     * @param for_n Called as for_n(kernel, n) to run kernel(start, end) over
+     * [0, n), serially or on a pool
+     * @param reduce_n Called as reduce_n(identity, fn, combine, n) to reduce
+     * [0, n) with reduce_chunks semantics, serially or on a pool
+     */
+    template <typename ForN, typename ReduceN>
+    void run(World &world, const mailbox::SimulationConfigSnapshot &cfg,
+             ForN &&for_n, ReduceN &&reduce_n);
+
+    /**
+     * @brief Reduces the neighbor grid's cell counts into m_analytics
+     * @param reduce_n Reduction runner, see run()
+     * @param particles Reduced per-particle analytics of the step
+     * @param stencil Reduced stencil work of the force pass
+     * @param speed_range Histogram range the particles were binned with
+     */
+    template <typename ReduceN>
+    void finish_analytics_step(ReduceN &&reduce_n,
+                               const AnalyticsPartial &particles,
+                               const StencilPartial &stencil,
+                               float speed_range);
+
+    /**
+     * @brief Rebuilds m_group_masks from the world's rules
+     * @param world World about to be stepped
+     */
+    void update_group_masks(const World &world);
+
+    /**
+     * @brief Data structure containing kernel parameters for particle
+     * computation
+     */
+    struct KernelData {
+        KernelData() = default;
+        ~KernelData() = default;
+        KernelData(const KernelData &) = delete;
+        KernelData &operator=(const KernelData &) = delete;
+        KernelData(KernelData &&) = delete;
+        KernelData &operator=(KernelData &&) = delete;
+
+        /** @brief Number of particles in the simulation */
+        int particles_count = 0;
+        /** @brief Time scaling factor for simulation speed */
+        float k_time_scale = 0.f;
+        /** @brief Viscosity coefficient (0-1) */
+        float k_viscosity = 0.f;
+        /** @brief Inverse viscosity for velocity damping */
+        float k_inverse_viscosity = 1.f;
+        /** @brief Wall repulsion distance threshold */
+        float k_wall_repel = 0.f;
+        /** @brief Wall repulsion strength */
+        float k_wall_strength = 0.f;
+        /** @brief Gravity force in X direction */
+        float k_gravity_x = 0.f;
+        /** @brief Gravity force in Y direction */
+        float k_gravity_y = 0.f;
+        /** @brief Inverse cell size for spatial grid */
+        float inverse_cell = 1.f;
+        /** @brief Cell size for spatial grid */
+        float cell_size = 1.f;
+        /** @brief Groups with a smaller squared radius can have neighbor
+         * cells out of reach (2 * cell_size^2, the farthest a corner cell
+         * can be) */
+        float prune_below_r2 = 0.f;
+        /** @brief Simulation bounds width */
+        float width = 0.f;
+        /** @brief Simulation bounds height */
+        float height = 0.f;
+        /** @brief Speed histogram bins per unit of speed (analytics only) */
+        float bins_per_speed = 0.f;
+
+        /** @brief Force lookup table, used when the kernel is instantiated
+         * with UseTable */
+        const ForceTable *table = nullptr;
+
+        /** @brief Per source group, group_mask_bit() of every enabled group
+         * it has a non-zero rule with */
+        const uint64_t *group_masks = nullptr;
+
+        /** @brief Per-particle examined pairs, written by the Counted kernel
+         * when set (owned by Stepper) */
+        int *examined = nullptr;
+        /** @brief Per-particle accepted pairs, written by the Counted kernel
+         * when set (owned by Stepper) */
+        int *accepted = nullptr;
+
+        /** @brief Raw pointer to force buffer X components (owned by
+         * Stepper) */
+        float *fx = nullptr;
+        /** @brief Raw pointer to force buffer Y components (owned by
+         * Stepper) */
+        float *fy = nullptr;
+    };
+
+    /**
+     * @brief Accumulates the forces of every particle into data.fx/fy
+     * @param world World being stepped
+     * @param data Kernel data of the step
+     * @param for_n Parallel runner, see run()
+     * @param reduce_n Reduction runner, see run()
+     * @return Stencil work of the pass (empty unless analytics or pair
+     * counts are enabled)
+     * @tparam UseTable Read pair forces from data.table
+     */
+    template <bool UseTable, typename ForN, typename ReduceN>
+    StencilPartial force_pass(const World &world, KernelData &data,
+                              ForN &&for_n, ReduceN &&reduce_n);
+
+    /**
+     * @brief Kernel function for force calculation between particles
+     * @param world World being stepped
+     * @param grid Active neighbor grid (UniformGrid or SparseGrid)
+     * @param start Start particle index
+     * @param end End particle index (exclusive)
+     * @param data Kernel data containing simulation parameters
+     * @param partial Receives the range's stencil work when instantiated
+     * with Counted; each particle's pair counts also go to data.examined and
+     * data.accepted when those are set
+     * @tparam UseTable Read pair forces from data.table instead of computing
+     * them
+     * @tparam Counted Count scanned and pruned neighbor cells and pairs
+     */
+    template <bool UseTable, bool Counted, typename Grid>
+    static void kernel_force(const World &world, const Grid &grid, int start,
+                             int end, KernelData &data,
+                             StencilPartial *partial);
+
+    /**
+     * @brief Kernel function for velocity update with viscosity
+     * @param world World being stepped
+     * @param start Start particle index
+     * @param end End particle index (exclusive)
+     * @param data Kernel data containing simulation parameters
+     */
+    static void kernel_vel(World &world, int start, int end,
+                           KernelData &data);
+
+    /**
+     * @brief Kernel function for position update and boundary collision
+     * @param world World being stepped
+     * @param start Start particle index
+     * @param end End particle index (exclusive)
+     * @param data Kernel data containing simulation parameters
+     * @param partial Receives the range's analytics when instantiated with
+     * Analytics
+     * @tparam Analytics Accumulate analytics of the updated particles
+     */
+    template <bool Analytics>
+    static void kernel_pos(World &world, int start, int end, KernelData &data,
+                           AnalyticsPartial *partial);
+
+    /** @brief Spatial indexing structure for efficient neighbor finding */
+    NeighborIndex m_idx;
+    /** @brief Pair force lookup table (built on first use) */
+    ForceTable m_table;
+    /** @brief Groups each group reacts to (see KernelData::group_masks) */
+    std::vector<uint64_t> m_group_masks;
+    /** @brief Force buffer X components (reused every step) */
+    particles::utility::AlignedVector<float> m_fx;
+    /** @brief Force buffer Y components (reused every step) */
+    particles::utility::AlignedVector<float> m_fy;
+    /** @brief Examined pairs per particle (see examined_pairs()) */
+    particles::utility::AlignedVector<int> m_examined;
+    /** @brief Accepted pairs per particle (see accepted_pairs()) */
+    particles::utility::AlignedVector<int> m_accepted;
+    /** @brief Whether steps gather analytics */
+    bool m_analytics_enabled = false;
+    /** @brief Whether steps fill m_examined and m_accepted */
+    bool m_pair_counts_enabled = false;
+    /** @brief Analytics of the last step that gathered them */
+    mailbox::AnalyticsSnapshot m_analytics;
+    /** @brief Connected components pass (buffers reused between runs) */
+    ClusterFinder m_cluster_finder;
+    /** @brief Clusters of the last step that looked for them */
+    mailbox::ClusterSnapshot m_clusters;
+    /** @brief Whether the last step refreshed m_clusters */
+    bool m_clusters_updated = false;
+    /** @brief Steps taken with analytics enabled, paces cluster detection */
+    long long m_analytics_steps = 0;
+    /** @brief Bumped by invalidate_index() */
+    uint64_t m_world_generation = 1;
+    /** @brief m_world_generation when m_idx was last built */
+    uint64_t m_index_generation = 0;
+};
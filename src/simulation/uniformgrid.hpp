@@ -4,8 +4,12 @@
 #include <cassert>
 #include <cmath>
 #include <concepts>
+#include <cstdint>
 #include <vector>
 
+#include "../utility/aligned_allocator.hpp"
+#include "../utility/memory_usage.hpp"
+
 /**
  * @brief Concept for a callable that returns an item's coordinate as float.
  * @details Must be invocable as f(int index) -> float.
@@ -15,6 +19,32 @@ concept FloatGetter = requires(F f, int i) {
     { f(i) } -> std::convertible_to<float>;
 };
 
+/**
+ * @brief Concept for a callable that returns an item's group.
+ * @details Must be invocable as f(int index) -> int. A negative group leaves
+ * the item out of the grid.
+ */
+template <typename F>
+concept GroupGetter = requires(F f, int i) {
+    { f(i) } -> std::convertible_to<int>;
+};
+
+/**
+ * @brief Group getter that puts every item in group 0.
+ */
+struct SingleGroup {
+    inline int operator()(int) const noexcept { return 0; }
+};
+
+/**
+ * @brief Bit of a group in a per-cell group mask.
+ * @details Groups 63 and above share the top bit, so a mask test can report
+ * a false match for them but never a false miss.
+ */
+inline constexpr uint64_t group_mask_bit(int group) noexcept {
+    return uint64_t(1) << (group < 63 ? group : 63);
+}
+
 /**
  * @brief Fixed-cell-size 2D spatial hash for N items.
  *
@@ -35,6 +65,12 @@ concept FloatGetter = requires(F f, int i) {
  * This “struct-of-arrays linked list” is cache-friendly and avoids per-node
  * allocations.
  *
+ * Every build also lays the same cells out contiguously (CSR): the items of
+ * cell @c ci are @c indices()[cell_start_at(ci) .. +cell_count_at(ci)), in
+ * ascending item order. Callers that only read the CSR view can turn the
+ * lists off with @ref set_linked_lists, which skips their writes and frees
+ * one of the two per-item arrays.
+ *
  * Typical usage pattern:
  * @code
  * grid.resize(worldW, worldH, cellSize, N);
@@ -80,6 +116,9 @@ concept FloatGetter = requires(F f, int i) {
  */
 class UniformGrid {
   public:
+    /** @brief Cache-line aligned index storage */
+    using Buffer = particles::utility::AlignedVector<int>;
+
     UniformGrid() = default;
     ~UniformGrid() = default;
     UniformGrid(const UniformGrid &) = delete;
@@ -98,8 +137,35 @@ class UniformGrid {
         m_rows = 1;
         m_head.clear();
         m_next.clear();
+        m_cellMask.clear();
+    }
+
+    /**
+     * @brief Turns the head/next linked lists on or off.
+     * @param enabled False to build the CSR view only
+     *
+     * @details With the lists off, @ref head and @ref next are empty and
+     * their storage is released. Takes effect from the next @ref build.
+     */
+    void set_linked_lists(bool enabled) {
+        if (enabled == m_lists) {
+            return;
+        }
+        m_lists = enabled;
+        if (m_lists) {
+            m_head.assign(m_cellStart.size(), -1);
+            m_next.assign(m_indices.size(), -1);
+        } else {
+            Buffer().swap(m_head);
+            Buffer().swap(m_next);
+        }
     }
 
+    /**
+     * @brief Whether @ref build maintains the head/next linked lists.
+     */
+    inline bool linked_lists() const { return m_lists; }
+
     inline float width() const { return m_width; }
     inline float height() const { return m_height; }
     inline float cell_size() const { return m_cell; }
@@ -125,25 +191,57 @@ class UniformGrid {
     /**
      * @brief Read-only view of the per-cell head array.
      * @details Size is rows*cols. @c head()[ci] is the first item in cell @c
-     * ci, or -1.
+     * ci, or -1. Empty when the linked lists are off.
      */
-    inline const std::vector<int> &head() const { return m_head; }
+    inline const Buffer &head() const { return m_head; }
     inline int head_at(int ci) const { return m_head[ci]; }
 
     /**
      * @brief Read-only view of the per-item next array.
      * @details Size is N (count passed to @ref resize/@ref build). @c next()[i]
-     * is the next item index in the same cell as @c i, or -1.
+     * is the next item index in the same cell as @c i, or -1. Empty when the
+     * linked lists are off.
      */
-    inline const std::vector<int> &next() const { return m_next; }
+    inline const Buffer &next() const { return m_next; }
     inline int next_at(int i) const { return m_next[i]; }
 
     // CSR-style contiguous storage accessors
-    inline const std::vector<int> &cell_start() const { return m_cellStart; }
-    inline const std::vector<int> &cell_count() const { return m_cellCount; }
+    inline const Buffer &cell_start() const { return m_cellStart; }
+    inline const Buffer &cell_count() const { return m_cellCount; }
     inline int cell_start_at(int ci) const { return m_cellStart[ci]; }
     inline int cell_count_at(int ci) const { return m_cellCount[ci]; }
-    inline const std::vector<int> &indices() const { return m_indices; }
+    inline const Buffer &indices() const { return m_indices; }
+
+    /**
+     * @brief Groups present in a cell.
+     * @details One @ref group_mask_bit per group with an item in cell @c ci,
+     * as reported by the group getter passed to @ref build.
+     */
+    inline uint64_t cell_mask_at(int ci) const { return m_cellMask[ci]; }
+
+    /**
+     * @brief Bytes held by the linked-list view (head/next).
+     */
+    particles::utility::MemoryUsage list_memory() const noexcept {
+        particles::utility::MemoryUsage usage;
+        usage.add(m_head).add(m_next);
+        return usage;
+    }
+
+    /**
+     * @brief Bytes held by the CSR copy, the cell masks and the build
+     * scratch buffers.
+     */
+    particles::utility::MemoryUsage csr_memory() const noexcept {
+        particles::utility::MemoryUsage usage;
+        usage.add(m_cellStart)
+            .add(m_cellCount)
+            .add(m_indices)
+            .add(m_cellMask)
+            .add(m_item_cell)
+            .add(m_cursor);
+        return usage;
+    }
 
     /**
      * @brief Convert (cx,cy) cell coordinates to a flat cell index, or -1 if
@@ -169,8 +267,8 @@ class UniformGrid {
      * @details
      * Computes @ref m_cols and @ref m_rows as ceil(width/cell_size) and
      * ceil(height/cell_size), allocates @ref m_head with rows*cols initialized
-     * to -1 and @ref m_next with N initialized to -1. Must be called before
-     * @ref build whenever N or bounds change.
+     * to -1 and @ref m_next with N initialized to -1 (unless the linked lists
+     * are off). Must be called before @ref build whenever N or bounds change.
      */
     inline void resize(float width, float height, float cell_size, int count) {
         m_cell = std::max(1.0f, cell_size);
@@ -182,11 +280,14 @@ class UniformGrid {
         m_rows = std::max(1, (int)std::ceil(m_height / m_cell));
 
         const int c = m_cols * m_rows;
-        m_head.assign(c, -1);
-        m_next.assign(count, -1);
+        if (m_lists) {
+            m_head.assign(c, -1);
+            m_next.assign(count, -1);
+        }
         // CSR buffers
         m_cellStart.assign(c, 0);
         m_cellCount.assign(c, 0);
+        m_cellMask.assign(c, 0);
         m_indices.assign(count, -1);
     }
 
@@ -202,35 +303,43 @@ class UniformGrid {
      * @param width  Unused here (kept for API symmetry; bounds come from @ref
      * resize).
      * @param height Unused here.
+     * @param group_of Group of item i; items with a negative group are left
+     * out of every cell list. Defaults to group 0 for all items.
      *
      * @details
      * For each item i:
      *  1) x = get_x(i), y = get_y(i); if non-finite → set to (0,0)
      *  2) Map to cell coords: cx=floor(x/cell), cy=floor(y/cell), then clamp to
      * the grid 3) Push-front into the cell’s list: m_next[i] = m_head[ci];
-     *       m_head[ci] = i;
+     *       m_head[ci] = i; (skipped when the linked lists are off)
      *
      * After this, every cell’s items can be traversed by following @ref m_next
-     * starting at @ref m_head.
+     * starting at @ref m_head, and @ref cell_mask_at tells which groups a
+     * cell holds.
      */
-    template <FloatGetter GetX, FloatGetter GetY>
+    template <FloatGetter GetX, FloatGetter GetY,
+              GroupGetter GroupOf = SingleGroup>
     void build(int count, GetX get_x, GetY get_y, float /*width*/,
-               float /*height*/) {
+               float /*height*/, GroupOf group_of = {}) {
         // Clear/resize structures
-        std::fill(m_head.begin(), m_head.end(), -1);
-        if ((int)m_next.size() != count) {
-            m_next.assign(count, -1);
+        const bool lists = m_lists;
+        if (lists) {
+            std::fill(m_head.begin(), m_head.end(), -1);
+            if ((int)m_next.size() != count) {
+                m_next.assign(count, -1);
+            }
         }
         if ((int)m_indices.size() != count) {
             m_indices.assign(count, -1);
         }
         std::fill(m_cellCount.begin(), m_cellCount.end(), 0);
+        std::fill(m_cellMask.begin(), m_cellMask.end(), 0);
 
 #ifndef NDEBUG
         // Catch mismatched resize/build quickly in debug builds
         assert(m_cols > 0 && m_rows > 0);
-        assert((int)m_head.size() == m_cols * m_rows);
-        assert((int)m_next.size() == count);
+        assert(!lists || (int)m_head.size() == m_cols * m_rows);
+        assert(!lists || (int)m_next.size() == count);
 #endif
 
         const int max_cx = m_cols - 1;
@@ -238,11 +347,19 @@ class UniformGrid {
         const float inv_cell = 1.0f / m_cell;
 
         // First pass: compute per-item cell, count items per cell, and build
-        // head/next lists
+        // head/next lists if enabled
         if ((int)m_item_cell.size() != count) {
             m_item_cell.assign(count, 0);
         }
         for (int i = 0; i < count; ++i) {
+            const int group = group_of(i);
+            if (group < 0) {
+                m_item_cell[i] = -1;
+                if (lists) {
+                    m_next[i] = -1;
+                }
+                continue;
+            }
             float x = get_x(i);
             float y = get_y(i);
 
@@ -257,11 +374,13 @@ class UniformGrid {
             cy = std::clamp(cy, 0, max_cy);
             const int ci = cy * m_cols + cx;
             m_item_cell[i] = ci;
-            // linked list
-            m_next[i] = m_head[ci];
-            m_head[ci] = i;
+            if (lists) {
+                m_next[i] = m_head[ci];
+                m_head[ci] = i;
+            }
             // CSR counts
             m_cellCount[ci] += 1;
+            m_cellMask[ci] |= group_mask_bit(group);
         }
 
         // Exclusive scan over counts to produce starts
@@ -282,9 +401,14 @@ class UniformGrid {
         }
         for (int i = 0; i < count; ++i) {
             const int ci = m_item_cell[i];
+            if (ci < 0) {
+                continue;
+            }
             const int pos = m_cursor[ci]++;
             m_indices[pos] = i;
         }
+        // Left-out items leave the tail unused
+        std::fill(m_indices.begin() + running, m_indices.end(), -1);
     }
 
   private:
@@ -294,27 +418,31 @@ class UniformGrid {
     float m_height = 64.f; // World height (world units)
     int m_cols = 1;        // Number of columns (ceil(width/cell))
     int m_rows = 1;        // Number of rows    (ceil(height/cell))
+    bool m_lists = true;   // Maintain m_head/m_next alongside the CSR view
 
     /**
      * @brief Per-cell list heads (size rows*cols).
      * @details For cell ci, @c m_head[ci] is the index of the first item in
      * that cell, or -1.
      */
-    std::vector<int> m_head;
+    Buffer m_head;
 
     /**
      * @brief Per-item next pointers (size N).
      * @details For item i, @c m_next[i] is the next item index in the same
      * cell, or -1.
      */
-    std::vector<int> m_next;
+    Buffer m_next;
 
     // CSR-style contiguous storage per cell
-    std::vector<int> m_cellStart; // size rows*cols
-    std::vector<int> m_cellCount; // size rows*cols
-    std::vector<int> m_indices;   // size N, contiguous ranges per cell
+    Buffer m_cellStart; // size rows*cols
+    Buffer m_cellCount; // size rows*cols
+    Buffer m_indices;   // size N, contiguous ranges per cell
+
+    // group_mask_bit() of every group present, per cell (size rows*cols)
+    particles::utility::AlignedVector<uint64_t> m_cellMask;
 
     // transient buffers reused across builds
-    std::vector<int> m_item_cell; // size N
-    std::vector<int> m_cursor;    // size rows*cols
+    Buffer m_item_cell; // size N
+    Buffer m_cursor;    // size rows*cols
 };
@@ -4,13 +4,32 @@
 #include "world.hpp"
 
 void World::finalize_groups() {
+    prepare_particle_groups();
+    finalize_groups(0, get_particles_size());
+}
+
+void World::prepare_particle_groups() {
+    m_particle_groups.resize(get_particles_size());
+}
+
+void World::finalize_groups(int begin, int end) {
     const int group_count = get_groups_size();
-    m_particle_groups.assign(get_particles_size(), 0);
-    for (int group_index = 0; group_index < group_count; ++group_index) {
-        for (int particle_index = get_group_start(group_index);
-             particle_index < get_group_end(group_index); ++particle_index) {
-            m_particle_groups[particle_index] = group_index;
-        }
+    begin = std::max(0, begin);
+    end = std::min(end, (int)m_particle_groups.size());
+
+    // Groups are contiguous and ordered, so the range is a few runs
+    int group_index = 0;
+    while (group_index < group_count && get_group_end(group_index) <= begin) {
+        ++group_index;
+    }
+    for (int particle_index = begin; particle_index < end; ++group_index) {
+        const int run_end = (group_index < group_count)
+                                ? std::min(end, get_group_end(group_index))
+                                : end;
+        std::fill(m_particle_groups.begin() + particle_index,
+                  m_particle_groups.begin() + run_end,
+                  (group_index < group_count) ? group_index : 0);
+        particle_index = run_end;
     }
 }
 
@@ -58,6 +77,46 @@ int World::add_group(int particle_count, Color color) {
     return m_group_colors.size() - 1;
 }
 
+void World::reserve(int particle_count) {
+    if (particle_count < 0) {
+        throw particles::SimulationError("Invalid particle count: " +
+                                         std::to_string(particle_count));
+    }
+
+    m_px.reserve(particle_count);
+    m_py.reserve(particle_count);
+    m_vx.reserve(particle_count);
+    m_vy.reserve(particle_count);
+    m_particle_groups.reserve(particle_count);
+}
+
+void World::set_group_sizes(const std::vector<int> &sizes) {
+    if ((int)sizes.size() != (int)m_group_colors.size()) {
+        throw particles::SimulationError(
+            "Group size count " + std::to_string(sizes.size()) +
+            " does not match group count " +
+            std::to_string(m_group_colors.size()));
+    }
+
+    m_group_ranges.clear();
+    int total = 0;
+    for (int size : sizes) {
+        if (size < 0) {
+            throw particles::SimulationError("Invalid particle count: " +
+                                             std::to_string(size));
+        }
+        m_group_ranges.push_back(total);
+        total += size;
+        m_group_ranges.push_back(total);
+    }
+
+    m_px.resize(total);
+    m_py.resize(total);
+    m_vx.resize(total);
+    m_vy.resize(total);
+    finalize_groups();
+}
+
 void World::reset(bool shrink) {
     m_px.clear();
     m_py.clear();
@@ -71,10 +130,10 @@ void World::reset(bool shrink) {
     m_group_enabled.clear();
 
     if (shrink) {
-        std::vector<float>().swap(m_px);
-        std::vector<float>().swap(m_py);
-        std::vector<float>().swap(m_vx);
-        std::vector<float>().swap(m_vy);
+        decltype(m_px)().swap(m_px);
+        decltype(m_py)().swap(m_py);
+        decltype(m_vx)().swap(m_vx);
+        decltype(m_vy)().swap(m_vy);
         std::vector<int>().swap(m_group_ranges);
         std::vector<Color>().swap(m_group_colors);
         std::vector<int>().swap(m_particle_groups);
@@ -85,6 +144,11 @@ void World::reset(bool shrink) {
 }
 
 void World::remove_group(int group_index) {
+    remove_group_unfinalized(group_index);
+    finalize_groups();
+}
+
+void World::remove_group_unfinalized(int group_index) {
     const int group_count = get_groups_size();
     if (group_index < 0 || group_index >= group_count)
         return;
@@ -116,10 +180,7 @@ void World::remove_group(int group_index) {
     m_group_ranges.erase(m_group_ranges.begin() + group_index * 2,
                          m_group_ranges.begin() + group_index * 2 + 2);
 
-    // 4) rebuild p_group for new layout
-    finalize_groups();
-
-    // 5) prune rule matrix row/col group_index and radii2[group_index]
+    // 4) prune rule matrix row/col group_index and radii2[group_index]
     // rules is size group_count*group_count; radii2 size group_count
     if (!m_rules.empty()) {
         const int old_group_count = group_count;
@@ -145,6 +206,11 @@ void World::remove_group(int group_index) {
 }
 
 void World::resize_group(int group_index, int new_size) {
+    resize_group_unfinalized(group_index, new_size);
+    finalize_groups();
+}
+
+void World::resize_group_unfinalized(int group_index, int new_size) {
     const int group_count = get_groups_size();
     if (group_index < 0 || group_index >= group_count || new_size < 0)
         return;
@@ -153,8 +219,6 @@ void World::resize_group(int group_index, int new_size) {
     const int start_index = get_group_start(group_index);
 
     if (new_size == current_size) {
-        // Still need to finalize groups to ensure consistency
-        finalize_groups();
         return;
     }
 
@@ -195,8 +259,6 @@ void World::resize_group(int group_index, int new_size) {
         }
         m_group_ranges[group_index * 2 + 1] -= remove_count;
     }
-
-    finalize_groups();
 }
 
 void World::preserve_rules_on_add_group() {
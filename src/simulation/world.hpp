@@ -6,6 +6,7 @@
 
 #include <raylib.h>
 
+#include "../utility/aligned_allocator.hpp"
 #include "../utility/exceptions.hpp"
 #include "../utility/logger.hpp"
 #include "../world_base.hpp"
@@ -36,6 +37,22 @@ class World : public particles::WorldBase {
      */
     void finalize_groups();
 
+    /**
+     * @brief Sizes the particle-to-group mapping for the current particle
+     * count without filling it.
+     *
+     * Follow with finalize_groups(begin, end) over every particle; the ranges
+     * are independent and may be filled from several threads.
+     */
+    void prepare_particle_groups();
+
+    /**
+     * @brief Fills the particle-to-group mapping for a range of particles.
+     * @param begin First particle index
+     * @param end One past the last particle index
+     */
+    void finalize_groups(int begin, int end);
+
     /**
      * @brief Initializes rule tables and group properties for the specified
      * number of groups.
@@ -60,6 +77,28 @@ class World : public particles::WorldBase {
      */
     int add_group(int count, Color color);
 
+    /**
+     * @brief Reserves particle storage ahead of add_group() calls.
+     *
+     * Seeding adds groups one by one; reserving the total first allocates
+     * each column once instead of regrowing (and copying) it per group.
+     * @param particle_count Total particles the world will hold
+     * @throws SimulationError if particle_count is negative
+     */
+    void reserve(int particle_count);
+
+    /**
+     * @brief Replaces the particle layout with new per-group sizes.
+     *
+     * Rules, radii, colors and enabled flags are kept and groups may be
+     * empty. Particle state is resized (not preserved per group) and the
+     * particle-to-group mapping is rebuilt.
+     * @param sizes Particle count for every existing group
+     * @throws SimulationError if sizes does not match the group count or a
+     * size is negative
+     */
+    void set_group_sizes(const std::vector<int> &sizes);
+
     /**
      * @brief Resets the world to empty state.
      * @param shrink Whether to shrink vectors to free memory
@@ -72,6 +111,14 @@ class World : public particles::WorldBase {
      */
     void remove_group(int group_index);
 
+    /**
+     * @brief Like remove_group(), but leaves the particle-to-group mapping
+     * stale for the caller to rebuild, e.g. with the ranged
+     * finalize_groups() on a thread pool.
+     * @param group_index Index of the group to remove
+     */
+    void remove_group_unfinalized(int group_index);
+
     /**
      * @brief Resizes a group by adding or removing particles.
      * @param group_index Index of the group to resize
@@ -79,6 +126,14 @@ class World : public particles::WorldBase {
      */
     void resize_group(int group_index, int new_size);
 
+    /**
+     * @brief Like resize_group(), but leaves the particle-to-group mapping
+     * stale for the caller to rebuild.
+     * @param group_index Index of the group to resize
+     * @param new_size New size for the group
+     */
+    void resize_group_unfinalized(int group_index, int new_size);
+
     /**
      * @brief Preserves existing rules when a new group is added.
      *
@@ -269,9 +324,20 @@ class World : public particles::WorldBase {
             m_group_enabled[group_index] = enabled;
     }
 
+    /**
+     * @brief Gets the bytes held by the particle columns and group tables
+     * @return Usage; reserved_bytes stays high after remove_group() or a
+     * smaller resize until reset(true)
+     */
+    particles::utility::MemoryUsage memory_usage() const noexcept {
+        particles::utility::MemoryUsage usage = WorldBase::memory_usage();
+        usage.add(m_px).add(m_py).add(m_vx).add(m_vy);
+        return usage;
+    }
+
   private:
-    std::vector<float> m_px; // Particle X positions
-    std::vector<float> m_py; // Particle Y positions
-    std::vector<float> m_vx; // Particle X velocities
-    std::vector<float> m_vy; // Particle Y velocities
+    particles::utility::AlignedVector<float> m_px; // Particle X positions
+    particles::utility::AlignedVector<float> m_py; // Particle Y positions
+    particles::utility::AlignedVector<float> m_vx; // Particle X velocities
+    particles::utility::AlignedVector<float> m_vy; // Particle Y velocities
 };
@@ -31,6 +31,9 @@ class ClearAllGroupsAction : public IAction {
     void unapply() override;
     bool canCoalesce(const IAction &other) const override { return false; }
     bool coalesce(const IAction &other) override { return false; }
+    particles::utility::MemoryUsage memory_usage() const override {
+        return m_backup_state.memory_usage();
+    }
 
     /**
      * @brief Set the function to call when applying this action.
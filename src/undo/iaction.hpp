@@ -1,5 +1,7 @@
 #pragma once
 
+#include "utility/memory_usage.hpp"
+
 /**
  * @brief Base interface for all undo/redo actions.
  *
@@ -52,4 +54,12 @@ struct IAction {
         (void)other;
         return false;
     }
+
+    /**
+     * @brief Get the heap memory this action keeps for undo/redo.
+     * @return Usage of the action's containers (not the object itself).
+     */
+    virtual particles::utility::MemoryUsage memory_usage() const {
+        return {};
+    }
 };
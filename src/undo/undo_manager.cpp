@@ -82,3 +82,16 @@ bool UndoManager::is_at_saved_state(unsigned long long saved_version) const {
     // For now, we'll return false for any other case
     return false;
 }
+
+particles::utility::MemoryUsage UndoManager::memory_usage() const {
+    particles::utility::MemoryUsage usage;
+    usage.add(m_past).add(m_future);
+    for (const auto *stack : {&m_past, &m_future}) {
+        for (const Entry &entry : *stack) {
+            if (entry.act) {
+                usage.merge(entry.act->memory_usage());
+            }
+        }
+    }
+    return usage;
+}
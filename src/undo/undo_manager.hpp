@@ -119,6 +119,13 @@ class UndoManager {
      */
     const std::vector<Entry> &get_future_entries() const { return m_future; }
 
+    /**
+     * @brief Get the memory held by the undo and redo history.
+     * @return Usage of both stacks and of what their actions keep (group
+     * backups)
+     */
+    particles::utility::MemoryUsage memory_usage() const;
+
   private:
     /**
      * @brief Trim the history to the maximum size.
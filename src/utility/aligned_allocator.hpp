@@ -0,0 +1,209 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <vector>
+
+#ifdef PLATFORM_WINDOWS
+#include <malloc.h>
+#else
+#include <sys/mman.h>
+#endif
+
+namespace particles::utility {
+
+/** @brief Alignment of simulation arrays: one cache line, the widest SIMD
+ * load */
+inline constexpr std::size_t SIMD_ALIGNMENT = 64;
+
+/** @brief Huge page size on x86-64 and most ARM64 Linux systems */
+inline constexpr std::size_t HUGE_PAGE_SIZE = std::size_t(2) << 20;
+
+/**
+ * @brief How large simulation arrays are backed
+ */
+enum class HugePages {
+    Off,         // Plain 64-byte aligned heap blocks
+    Transparent, // Large blocks are 2 MB aligned and advised as huge pages
+    Explicit,    // Large blocks use reserved huge pages when there are any
+};
+
+/**
+ * @brief Gets the process-wide huge page policy
+ * @return Policy from PARTICLES_HUGE_PAGES ("off", "transparent" or
+ * "explicit"); Transparent on Linux and Off elsewhere when unset
+ *
+ * Read once, so every block is freed the same way it was allocated.
+ */
+inline HugePages huge_pages() noexcept {
+    static const HugePages mode = [] {
+        const char *env = std::getenv("PARTICLES_HUGE_PAGES");
+        if (env && std::strcmp(env, "off") == 0) {
+            return HugePages::Off;
+        }
+        if (env && std::strcmp(env, "explicit") == 0) {
+            return HugePages::Explicit;
+        }
+#if defined(PLATFORM_LINUX) || defined(__linux__)
+        return HugePages::Transparent;
+#else
+        return env && std::strcmp(env, "transparent") == 0
+                   ? HugePages::Transparent
+                   : HugePages::Off;
+#endif
+    }();
+    return mode;
+}
+
+/**
+ * @brief Rounds a size up to a multiple of a power of two
+ */
+inline std::size_t round_up_pow2(std::size_t size, std::size_t to) noexcept {
+    return (size + to - 1) & ~(to - 1);
+}
+
+/**
+ * @brief Tells whether a block of this size is mapped in huge pages
+ * @param bytes Requested size
+ * @return True if allocate_aligned() maps it instead of using the heap
+ */
+inline bool uses_huge_pages(std::size_t bytes) noexcept {
+#ifdef PLATFORM_WINDOWS
+    (void)bytes;
+    return false;
+#else
+    return huge_pages() != HugePages::Off && bytes >= HUGE_PAGE_SIZE;
+#endif
+}
+
+#ifndef PLATFORM_WINDOWS
+/**
+ * @brief Maps a huge-page aligned block
+ * @param size Multiple of HUGE_PAGE_SIZE
+ * @return Block start, or nullptr if the mapping failed
+ */
+inline void *map_huge_block(std::size_t size) noexcept {
+#ifdef MAP_HUGETLB
+    if (huge_pages() == HugePages::Explicit) {
+        void *p = mmap(nullptr, size, PROT_READ | PROT_WRITE,
+                       MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (p != MAP_FAILED) {
+            return p;
+        }
+    }
+#endif
+
+    // Over-map by one huge page and trim both ends so the block starts on a
+    // huge page boundary; the kernel can only back aligned 2 MB ranges
+    const std::size_t mapped = size + HUGE_PAGE_SIZE;
+    void *raw = mmap(nullptr, mapped, PROT_READ | PROT_WRITE,
+                     MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (raw == MAP_FAILED) {
+        return nullptr;
+    }
+    char *const base = static_cast<char *>(raw);
+    char *const start = reinterpret_cast<char *>(
+        round_up_pow2(reinterpret_cast<std::size_t>(base), HUGE_PAGE_SIZE));
+    const std::size_t head = (std::size_t)(start - base);
+    if (head > 0) {
+        munmap(base, head);
+    }
+    if (mapped - head > size) {
+        munmap(start + size, mapped - head - size);
+    }
+#ifdef MADV_HUGEPAGE
+    madvise(start, size, MADV_HUGEPAGE);
+#endif
+    return start;
+}
+#endif
+
+/**
+ * @brief Allocates a SIMD_ALIGNMENT aligned block
+ * @param bytes Block size
+ * @return Block start
+ * @throws std::bad_alloc if the memory is not available
+ *
+ * Blocks of HUGE_PAGE_SIZE or more are mapped in huge pages unless
+ * huge_pages() is Off, and are returned to the system when freed.
+ */
+inline void *allocate_aligned(std::size_t bytes) {
+    bytes = std::max<std::size_t>(bytes, 1);
+    void *p = nullptr;
+#ifdef PLATFORM_WINDOWS
+    p = _aligned_malloc(round_up_pow2(bytes, SIMD_ALIGNMENT), SIMD_ALIGNMENT);
+#else
+    if (uses_huge_pages(bytes)) {
+        p = map_huge_block(round_up_pow2(bytes, HUGE_PAGE_SIZE));
+    } else {
+        p = std::aligned_alloc(SIMD_ALIGNMENT,
+                               round_up_pow2(bytes, SIMD_ALIGNMENT));
+    }
+#endif
+    if (!p) {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+/**
+ * @brief Frees a block from allocate_aligned()
+ * @param p Block start
+ * @param bytes Size the block was allocated with
+ */
+inline void free_aligned(void *p, std::size_t bytes) noexcept {
+#ifdef PLATFORM_WINDOWS
+    (void)bytes;
+    _aligned_free(p);
+#else
+    bytes = std::max<std::size_t>(bytes, 1);
+    if (uses_huge_pages(bytes)) {
+        munmap(p, round_up_pow2(bytes, HUGE_PAGE_SIZE));
+    } else {
+        std::free(p);
+    }
+#endif
+}
+
+/**
+ * @brief Standard allocator over allocate_aligned()
+ *
+ * Gives std::vector storage that SIMD kernels can load with aligned
+ * instructions and that large worlds get in huge pages, cutting TLB misses
+ * when the kernels stream millions of particles.
+ */
+template <typename T> class AlignedAllocator {
+  public:
+    using value_type = T;
+
+    static_assert(alignof(T) <= SIMD_ALIGNMENT,
+                  "AlignedAllocator cannot over-align this type");
+
+    AlignedAllocator() noexcept = default;
+    template <typename U>
+    AlignedAllocator(const AlignedAllocator<U> &) noexcept {}
+
+    T *allocate(std::size_t n) {
+        if (n > std::size_t(-1) / sizeof(T)) {
+            throw std::bad_array_new_length();
+        }
+        return static_cast<T *>(allocate_aligned(n * sizeof(T)));
+    }
+
+    void deallocate(T *p, std::size_t n) noexcept {
+        free_aligned(p, n * sizeof(T));
+    }
+
+    template <typename U>
+    bool operator==(const AlignedAllocator<U> &) const noexcept {
+        return true;
+    }
+};
+
+/** @brief Vector whose storage comes from allocate_aligned() */
+template <typename T> using AlignedVector = std::vector<T, AlignedAllocator<T>>;
+
+} // namespace particles::utility
@@ -7,6 +7,7 @@
 
 #include <raylib.h>
 
+#include "../utility/counter_rng.hpp"
 #include "../utility/exceptions.hpp"
 #include "../utility/logger.hpp"
 #include "mailbox/command/cmd_seedspec.hpp"
@@ -22,6 +23,7 @@ inline mailbox::command::SeedSpec create_default_seed() {
     const int groups = 5;
 
     seed.resize_groups(groups);
+    seed.rng_seed = random_seed();
 
     seed.set_group(0, 1500, (Color){0, 228, 114, 255}, 80.f * 80.f, true);
     seed.set_group(1, 1500, (Color){238, 70, 82, 255}, 80.f * 80.f, true);
@@ -0,0 +1,196 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "exceptions.hpp"
+
+namespace particles::utility {
+
+namespace detail {
+
+/**
+ * @brief Builds the CRC-32 lookup table used by PNG chunks
+ * @return 256-entry CRC table (polynomial 0xEDB88320)
+ */
+inline const std::array<uint32_t, 256> &crc32_table() {
+    static const std::array<uint32_t, 256> table = [] {
+        std::array<uint32_t, 256> t{};
+        for (uint32_t n = 0; n < 256; ++n) {
+            uint32_t c = n;
+            for (int k = 0; k < 8; ++k) {
+                c = (c & 1u) ? 0xEDB88320u ^ (c >> 1) : (c >> 1);
+            }
+            t[n] = c;
+        }
+        return t;
+    }();
+    return table;
+}
+
+/**
+ * @brief Continues a CRC-32 over a byte range
+ * @param crc Running CRC (start with 0)
+ * @param data Bytes to hash
+ * @param size Number of bytes
+ * @return Updated CRC
+ */
+inline uint32_t crc32_update(uint32_t crc, const uint8_t *data, size_t size) {
+    const auto &table = crc32_table();
+    uint32_t c = crc ^ 0xFFFFFFFFu;
+    for (size_t i = 0; i < size; ++i) {
+        c = table[(c ^ data[i]) & 0xFFu] ^ (c >> 8);
+    }
+    return c ^ 0xFFFFFFFFu;
+}
+
+inline void put_u32_be(std::vector<uint8_t> &out, uint32_t v) {
+    out.push_back((uint8_t)(v >> 24));
+    out.push_back((uint8_t)(v >> 16));
+    out.push_back((uint8_t)(v >> 8));
+    out.push_back((uint8_t)(v));
+}
+
+/**
+ * @brief Appends a PNG chunk (length, type, payload, CRC) to the output
+ * @param out Output byte stream
+ * @param type Four character chunk type
+ * @param payload Chunk payload
+ */
+inline void put_png_chunk(std::vector<uint8_t> &out, const char *type,
+                          const std::vector<uint8_t> &payload) {
+    put_u32_be(out, (uint32_t)payload.size());
+    const size_t type_at = out.size();
+    out.insert(out.end(), type, type + 4);
+    out.insert(out.end(), payload.begin(), payload.end());
+    put_u32_be(out, crc32_update(0, out.data() + type_at, payload.size() + 4));
+}
+
+inline void write_bytes(const std::string &path, const uint8_t *data,
+                        size_t size) {
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        throw particles::IOError("Failed to open image for writing: " + path);
+    }
+    file.write(reinterpret_cast<const char *>(data), (std::streamsize)size);
+    if (!file) {
+        throw particles::IOError("Failed to write image: " + path);
+    }
+}
+
+} // namespace detail
+
+/**
+ * @brief Writes an RGBA8 framebuffer as a binary PPM (P6), dropping alpha
+ * @param path Output file path
+ * @param width Image width in pixels
+ * @param height Image height in pixels
+ * @param rgba Pixel data, width * height * 4 bytes, row-major, top row first
+ * @throws particles::IOError if the file can't be written
+ */
+inline void write_ppm(const std::string &path, int width, int height,
+                      const std::vector<uint8_t> &rgba) {
+    if (width <= 0 || height <= 0 ||
+        rgba.size() < (size_t)width * (size_t)height * 4) {
+        throw particles::IOError("Invalid framebuffer for PPM: " + path);
+    }
+
+    const std::string header = "P6\n" + std::to_string(width) + " " +
+                               std::to_string(height) + "\n255\n";
+    std::vector<uint8_t> out;
+    out.reserve(header.size() + (size_t)width * height * 3);
+    out.insert(out.end(), header.begin(), header.end());
+    const size_t pixels = (size_t)width * (size_t)height;
+    for (size_t i = 0; i < pixels; ++i) {
+        out.push_back(rgba[i * 4 + 0]);
+        out.push_back(rgba[i * 4 + 1]);
+        out.push_back(rgba[i * 4 + 2]);
+    }
+    detail::write_bytes(path, out.data(), out.size());
+}
+
+/**
+ * @brief Writes an RGBA8 framebuffer as a PNG file
+ *
+ * The image data is wrapped in stored (uncompressed) deflate blocks, so no
+ * zlib dependency is needed. Files are larger than a compressed encoder
+ * would produce but encoding is a straight memory copy, which keeps frame
+ * export cheap.
+ *
+ * @param path Output file path
+ * @param width Image width in pixels
+ * @param height Image height in pixels
+ * @param rgba Pixel data, width * height * 4 bytes, row-major, top row first
+ * @throws particles::IOError if the file can't be written
+ */
+inline void write_png(const std::string &path, int width, int height,
+                      const std::vector<uint8_t> &rgba) {
+    if (width <= 0 || height <= 0 ||
+        rgba.size() < (size_t)width * (size_t)height * 4) {
+        throw particles::IOError("Invalid framebuffer for PNG: " + path);
+    }
+
+    // Raw scanlines, each prefixed with filter type 0 (None)
+    const size_t row_bytes = (size_t)width * 4;
+    std::vector<uint8_t> raw;
+    raw.reserve((row_bytes + 1) * (size_t)height);
+    for (int y = 0; y < height; ++y) {
+        raw.push_back(0);
+        const uint8_t *row = rgba.data() + (size_t)y * row_bytes;
+        raw.insert(raw.end(), row, row + row_bytes);
+    }
+
+    // zlib stream: header, stored blocks of at most 65535 bytes, adler32
+    std::vector<uint8_t> idat;
+    idat.reserve(raw.size() + raw.size() / 65535 * 5 + 16);
+    idat.push_back(0x78);
+    idat.push_back(0x01);
+    size_t offset = 0;
+    do {
+        const size_t len = std::min<size_t>(65535, raw.size() - offset);
+        const bool last = offset + len == raw.size();
+        idat.push_back(last ? 1 : 0);
+        idat.push_back((uint8_t)(len & 0xFF));
+        idat.push_back((uint8_t)(len >> 8));
+        idat.push_back((uint8_t)(~len & 0xFF));
+        idat.push_back((uint8_t)((~len >> 8) & 0xFF));
+        idat.insert(idat.end(), raw.begin() + offset,
+                    raw.begin() + offset + len);
+        offset += len;
+    } while (offset < raw.size());
+
+    // Adler-32, reducing only every 5552 bytes (largest run without overflow)
+    uint32_t a = 1, b = 0;
+    for (size_t i = 0; i < raw.size();) {
+        const size_t run = std::min<size_t>(5552, raw.size() - i);
+        for (size_t k = 0; k < run; ++k, ++i) {
+            a += raw[i];
+            b += a;
+        }
+        a %= 65521u;
+        b %= 65521u;
+    }
+    detail::put_u32_be(idat, (b << 16) | a);
+
+    std::vector<uint8_t> ihdr;
+    detail::put_u32_be(ihdr, (uint32_t)width);
+    detail::put_u32_be(ihdr, (uint32_t)height);
+    ihdr.push_back(8); // bit depth
+    ihdr.push_back(6); // color type RGBA
+    ihdr.push_back(0); // compression
+    ihdr.push_back(0); // filter
+    ihdr.push_back(0); // interlace
+
+    std::vector<uint8_t> out = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+    out.reserve(out.size() + idat.size() + 64);
+    detail::put_png_chunk(out, "IHDR", ihdr);
+    detail::put_png_chunk(out, "IDAT", idat);
+    detail::put_png_chunk(out, "IEND", {});
+    detail::write_bytes(path, out.data(), out.size());
+}
+
+} // namespace particles::utility
@@ -0,0 +1,134 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+
+namespace particles::utility {
+
+/**
+ * @brief Lock-free log-linear histogram of durations (HDR-style)
+ *
+ * Values are bucketed by power of two and split into SUB_BUCKETS linear
+ * sub-buckets, so every recorded value is kept to within 1/SUB_BUCKETS
+ * (about 6%) from 1 ns up to 2^MAX_EXPONENT ns (about 18 minutes) in a fixed
+ * 5 KB table. Recording is a relaxed atomic increment; any thread may read
+ * percentiles while one thread records.
+ */
+class LatencyHistogram {
+  public:
+    static constexpr int SUB_BITS = 4;
+    static constexpr int SUB_BUCKETS = 1 << SUB_BITS;
+    static constexpr int MAX_EXPONENT = 40;
+    static constexpr int BUCKETS = (MAX_EXPONENT - SUB_BITS + 1) * SUB_BUCKETS;
+
+    /**
+     * @brief Percentiles of the recorded values
+     *
+     * Each percentile is the upper edge of the bucket it falls in, capped at
+     * the largest recorded value.
+     */
+    struct Summary {
+        uint64_t count = 0;
+        uint64_t p50 = 0;
+        uint64_t p95 = 0;
+        uint64_t p99 = 0;
+        uint64_t max = 0;
+    };
+
+    LatencyHistogram() noexcept { reset(); }
+    LatencyHistogram(const LatencyHistogram &) = delete;
+    LatencyHistogram &operator=(const LatencyHistogram &) = delete;
+
+    /**
+     * @brief Records one value
+     * @param value Duration in nanoseconds (negative values count as 0)
+     */
+    void record(int64_t value) noexcept {
+        const uint64_t v = value > 0 ? (uint64_t)value : 0;
+        m_counts[bucket_of(v)].fetch_add(1, std::memory_order_relaxed);
+        uint64_t seen = m_max.load(std::memory_order_relaxed);
+        while (v > seen && !m_max.compare_exchange_weak(
+                               seen, v, std::memory_order_relaxed)) {
+        }
+    }
+
+    /**
+     * @brief Forgets every recorded value
+     * @details Not atomic as a whole; call it from the recording thread.
+     */
+    void reset() noexcept {
+        for (auto &count : m_counts) {
+            count.store(0, std::memory_order_relaxed);
+        }
+        m_max.store(0, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Computes p50, p95, p99 and the maximum in one pass
+     * @return Summary (all zero when nothing was recorded)
+     */
+    Summary summary() const noexcept {
+        std::array<uint64_t, BUCKETS> counts;
+        Summary out;
+        for (int b = 0; b < BUCKETS; ++b) {
+            counts[b] = m_counts[b].load(std::memory_order_relaxed);
+            out.count += counts[b];
+        }
+        if (out.count == 0) {
+            return out;
+        }
+        out.max = m_max.load(std::memory_order_relaxed);
+
+        const double quantiles[3] = {0.50, 0.95, 0.99};
+        uint64_t *const targets[3] = {&out.p50, &out.p95, &out.p99};
+        uint64_t seen = 0;
+        int q = 0;
+        for (int b = 0; b < BUCKETS && q < 3; ++b) {
+            seen += counts[b];
+            while (q < 3 && (double)seen >= std::ceil(quantiles[q] *
+                                                      (double)out.count)) {
+                *targets[q] = std::min(bucket_upper(b), out.max);
+                ++q;
+            }
+        }
+        return out;
+    }
+
+    /**
+     * @brief Gets the bucket a value is counted in
+     */
+    static constexpr int bucket_of(uint64_t value) noexcept {
+        if (value < (uint64_t)SUB_BUCKETS) {
+            return (int)value;
+        }
+        const int exponent = (int)std::bit_width(value) - 1;
+        if (exponent >= MAX_EXPONENT) {
+            return BUCKETS - 1;
+        }
+        const int shift = exponent - SUB_BITS;
+        const int sub = (int)(value >> shift) - SUB_BUCKETS;
+        return (shift + 1) * SUB_BUCKETS + sub;
+    }
+
+    /**
+     * @brief Gets the largest value counted in a bucket
+     */
+    static constexpr uint64_t bucket_upper(int bucket) noexcept {
+        if (bucket < SUB_BUCKETS) {
+            return (uint64_t)bucket;
+        }
+        const int shift = bucket / SUB_BUCKETS - 1;
+        const uint64_t sub = (uint64_t)(bucket % SUB_BUCKETS + SUB_BUCKETS);
+        return ((sub + 1) << shift) - 1;
+    }
+
+  private:
+    std::array<std::atomic<uint64_t>, BUCKETS> m_counts;
+    std::atomic<uint64_t> m_max{0};
+};
+
+} // namespace particles::utility
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <type_traits>
+
+namespace particles::utility {
+
+/**
+ * @brief Bytes a subsystem keeps in its containers
+ *
+ * used_bytes counts the elements in use and reserved_bytes the storage
+ * actually allocated for them, so the difference is memory that containers
+ * keep after shrinking (a removed group, a smaller world) until they are
+ * shrunk or freed.
+ */
+struct MemoryUsage {
+    /** @brief Least slack worth reporting as waste */
+    static constexpr long long WASTE_MIN_BYTES = 1ll << 20;
+
+    long long used_bytes = 0;     // Elements in use (size)
+    long long reserved_bytes = 0; // Allocated storage (capacity)
+
+    /**
+     * @brief Counts a vector's elements and its storage
+     * @param v Any std::vector (std::vector<bool> counts bits)
+     * @return This usage
+     */
+    template <typename Vector> MemoryUsage &add(const Vector &v) noexcept {
+        using T = typename Vector::value_type;
+        if constexpr (std::is_same_v<T, bool>) {
+            used_bytes += (long long)(v.size() + 7) / 8;
+            reserved_bytes += (long long)(v.capacity() + 7) / 8;
+        } else {
+            used_bytes += (long long)(v.size() * sizeof(T));
+            reserved_bytes += (long long)(v.capacity() * sizeof(T));
+        }
+        return *this;
+    }
+
+    /**
+     * @brief Counts storage that is used in full
+     * @param bytes Size of an object or fixed array
+     * @return This usage
+     */
+    MemoryUsage &add_bytes(long long bytes) noexcept {
+        used_bytes += bytes;
+        reserved_bytes += bytes;
+        return *this;
+    }
+
+    /**
+     * @brief Folds another usage into this one
+     * @return This usage
+     */
+    MemoryUsage &merge(const MemoryUsage &other) noexcept {
+        used_bytes += other.used_bytes;
+        reserved_bytes += other.reserved_bytes;
+        return *this;
+    }
+
+    /**
+     * @brief Gets the storage allocated beyond what is in use
+     */
+    long long slack_bytes() const noexcept {
+        return reserved_bytes - used_bytes;
+    }
+
+    /**
+     * @brief Tells whether the slack is worth reclaiming
+     * @return True if at least WASTE_MIN_BYTES and more than is in use are
+     * allocated but unused
+     */
+    bool wasteful() const noexcept {
+        return slack_bytes() >= WASTE_MIN_BYTES && slack_bytes() > used_bytes;
+    }
+};
+
+} // namespace particles::utility
@@ -4,6 +4,8 @@
 
 #include <raylib.h>
 
+#include "utility/memory_usage.hpp"
+
 namespace particles {
 
 /**
@@ -262,6 +264,21 @@ class WorldBase {
         m_particle_groups = groups;
     }
 
+    /**
+     * @brief Gets the bytes held by the group tables and particle groups
+     * @return Usage of every per-group and per-particle table of this class
+     */
+    utility::MemoryUsage memory_usage() const noexcept {
+        utility::MemoryUsage usage;
+        usage.add(m_group_ranges)
+            .add(m_group_colors)
+            .add(m_group_radii2)
+            .add(m_group_enabled)
+            .add(m_rules)
+            .add(m_particle_groups);
+        return usage;
+    }
+
   protected:
     std::vector<int>
         m_group_ranges; // Group ranges: each group has 2 items (start, end)
@@ -0,0 +1,114 @@
+#pragma once
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "mailbox/data_snapshot.hpp"
+#include "simulation/world.hpp"
+
+/**
+ * @brief Fixtures shared by the unit tests
+ */
+namespace test_helpers {
+
+/**
+ * @brief Config the stepping tests share: unit time scale, soft walls and
+ * one simulation thread
+ * @param width Bounds width
+ * @param height Bounds height
+ * @param viscosity Velocity damping
+ */
+inline mailbox::SimulationConfigSnapshot
+stepping_config(float width, float height, float viscosity) {
+    mailbox::SimulationConfigSnapshot cfg = {};
+    cfg.bounds_width = width;
+    cfg.bounds_height = height;
+    cfg.time_scale = 1.0f;
+    cfg.viscosity = viscosity;
+    cfg.wall_repel = 20.0f;
+    cfg.wall_strength = 0.1f;
+    cfg.sim_threads = 1;
+    return cfg;
+}
+
+/**
+ * @brief Fills an empty world with red, green and blue groups under a fixed
+ * asymmetric rule matrix and radii of 40, 60 and 30
+ * @param w World to fill
+ * @param red Particles in the red group
+ * @param green Particles in the green group
+ * @param blue Particles in the blue group
+ * @param cfg Config whose bounds the particles are spread over
+ * @param rng_seed Seed of the positions and velocities
+ * @param max_speed Velocity components are drawn from
+ * [-max_speed, max_speed]
+ */
+inline void seed_three_groups(World &w, int red, int green, int blue,
+                              const mailbox::SimulationConfigSnapshot &cfg,
+                              uint32_t rng_seed, float max_speed) {
+    w.add_group(red, RED);
+    w.add_group(green, GREEN);
+    w.add_group(blue, BLUE);
+    w.init_rule_tables(3);
+    const float rules[3][3] = {
+        {0.3f, -0.2f, 0.1f}, {-0.4f, 0.2f, 0.3f}, {0.25f, -0.3f, -0.1f}};
+    for (int i = 0; i < 3; ++i) {
+        for (int j = 0; j < 3; ++j) {
+            w.set_rule(i, j, rules[i][j]);
+        }
+    }
+    w.set_r2(0, 40.f * 40.f);
+    w.set_r2(1, 60.f * 60.f);
+    w.set_r2(2, 30.f * 30.f);
+    w.finalize_groups();
+
+    std::mt19937 rng(rng_seed);
+    std::uniform_real_distribution<float> ux(0.f, cfg.bounds_width);
+    std::uniform_real_distribution<float> uy(0.f, cfg.bounds_height);
+    std::uniform_real_distribution<float> uv(-max_speed, max_speed);
+    for (int i = 0; i < w.get_particles_size(); ++i) {
+        w.set_px(i, ux(rng));
+        w.set_py(i, uy(rng));
+        w.set_vx(i, uv(rng));
+        w.set_vy(i, uv(rng));
+    }
+}
+
+/**
+ * @brief Builds a world snapshot with one group per color
+ * @param sizes Particles per group
+ * @param colors Color of every group
+ * @param enabled Enabled flag of every group (empty enables them all)
+ * @details Radii are 80 and rules zero; renderers only read the layout,
+ * colors and enabled flags.
+ */
+inline mailbox::WorldSnapshot
+make_world(const std::vector<int> &sizes, const std::vector<Color> &colors,
+           const std::vector<bool> &enabled = {}) {
+    mailbox::WorldSnapshot world;
+    std::vector<int> ranges;
+    std::vector<int> particle_groups;
+    int start = 0;
+    for (size_t g = 0; g < sizes.size(); ++g) {
+        ranges.push_back(start);
+        ranges.push_back(start + sizes[g]);
+        for (int i = 0; i < sizes[g]; ++i) {
+            particle_groups.push_back((int)g);
+        }
+        start += sizes[g];
+    }
+    world.group_count = (int)sizes.size();
+    world.particles_count = start;
+    world.set_group_ranges(ranges);
+    world.set_group_colors(colors);
+    world.set_group_radii2(std::vector<float>(sizes.size(), 80.f * 80.f));
+    world.set_group_enabled(enabled.empty()
+                                ? std::vector<bool>(sizes.size(), true)
+                                : enabled);
+    world.set_rules(std::vector<float>(sizes.size() * sizes.size(), 0.f));
+    world.set_particle_groups(particle_groups);
+    return world;
+}
+
+} // namespace test_helpers
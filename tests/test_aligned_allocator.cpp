@@ -0,0 +1,76 @@
+#include <catch_amalgamated.hpp>
+
+#include <cstdint>
+
+#include "simulation/world.hpp"
+#include "utility/aligned_allocator.hpp"
+
+using particles::utility::AlignedVector;
+using particles::utility::HUGE_PAGE_SIZE;
+using particles::utility::SIMD_ALIGNMENT;
+
+namespace {
+
+bool is_aligned(const void *p, std::size_t alignment) {
+    return reinterpret_cast<std::uintptr_t>(p) % alignment == 0;
+}
+
+} // namespace
+
+TEST_CASE("AlignedVector storage is SIMD aligned at any size",
+          "[aligned_allocator]") {
+    // Below and above the huge page threshold
+    for (std::size_t n : {1u, 3u, 1000u, 600'000u, 1'500'000u}) {
+        AlignedVector<float> v(n, 1.f);
+        REQUIRE(is_aligned(v.data(), SIMD_ALIGNMENT));
+        if (particles::utility::uses_huge_pages(n * sizeof(float))) {
+            REQUIRE(is_aligned(v.data(), HUGE_PAGE_SIZE));
+        }
+        REQUIRE(v.front() == 1.f);
+        v.back() = 2.f; // the whole block is writable
+        REQUIRE(v.back() == 2.f);
+    }
+}
+
+TEST_CASE("AlignedVector keeps its contents across growth",
+          "[aligned_allocator]") {
+    AlignedVector<int> v;
+    for (int i = 0; i < 1'000'000; ++i) {
+        v.push_back(i);
+    }
+    REQUIRE(is_aligned(v.data(), SIMD_ALIGNMENT));
+    bool intact = true;
+    for (int i = 0; i < (int)v.size(); ++i) {
+        intact = intact && v[i] == i;
+    }
+    REQUIRE(intact);
+
+    AlignedVector<int> copy = v;
+    REQUIRE(copy == v);
+    v.clear();
+    v.shrink_to_fit();
+    REQUIRE(copy.size() == 1'000'000u);
+}
+
+TEST_CASE("World particle columns are aligned and reserve keeps them stable",
+          "[aligned_allocator]") {
+    World w;
+    w.reserve(700'000);
+    w.add_group(100'000, RED);
+    const float *const px = w.get_px_array();
+    const float *const vy = w.get_vy_array();
+    w.add_group(300'000, BLUE);
+    w.add_group(300'000, GREEN);
+
+    REQUIRE(w.get_particles_size() == 700'000);
+    REQUIRE(w.get_px_array() == px);
+    REQUIRE(w.get_vy_array() == vy);
+    for (const float *column : {w.get_px_array(), w.get_py_array(),
+                                w.get_vx_array(), w.get_vy_array()}) {
+        REQUIRE(is_aligned(column, SIMD_ALIGNMENT));
+    }
+
+    REQUIRE_THROWS_AS(w.reserve(-1), particles::SimulationError);
+    w.reset(true);
+    REQUIRE(w.get_particles_size() == 0);
+}
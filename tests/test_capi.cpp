@@ -0,0 +1,164 @@
+#include <catch_amalgamated.hpp>
+
+#include <chrono>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "capi/particles.h"
+
+namespace {
+
+particles_sim *make_sim(int publish_velocities) {
+    particles_config cfg = particles_default_config(400.f, 300.f);
+    cfg.sim_threads = 1;
+    cfg.publish_velocities = publish_velocities;
+    particles_sim *sim = nullptr;
+    REQUIRE(particles_create(&cfg, &sim) == PARTICLES_OK);
+    REQUIRE(sim != nullptr);
+    return sim;
+}
+
+void seed_two_groups(particles_sim *sim) {
+    const particles_group groups[2] = {{200, 255, 0, 0, 255, 40.f, 1},
+                                       {100, 0, 0, 255, 255, 40.f, 1}};
+    const float rules[4] = {0.2f, -0.3f, 0.4f, -0.1f};
+    REQUIRE(particles_seed(sim, groups, 2, rules, 7) == PARTICLES_OK);
+}
+
+particles_stats wait_for_particles(particles_sim *sim, int particles) {
+    particles_stats stats = {};
+    for (int attempt = 0; attempt < 300; ++attempt) {
+        REQUIRE(particles_get_stats(sim, &stats) == PARTICLES_OK);
+        if (stats.particles == particles && stats.num_steps > 0) {
+            break;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    return stats;
+}
+
+} // namespace
+
+TEST_CASE("C API seeds, steps and lends out frames", "[capi]") {
+    particles_sim *sim = make_sim(1);
+    seed_two_groups(sim);
+    REQUIRE(particles_start(sim) == PARTICLES_OK);
+
+    const particles_stats stats = wait_for_particles(sim, 300);
+    REQUIRE(stats.particles == 300);
+    REQUIRE(stats.groups == 2);
+    REQUIRE(stats.sim_threads == 1);
+
+    // Wait for a frame published after the seed
+    particles_frame frame = {};
+    for (int attempt = 0; attempt < 300; ++attempt) {
+        REQUIRE(particles_begin_read(sim, &frame) == PARTICLES_OK);
+        if (frame.count == 300) {
+            break;
+        }
+        REQUIRE(particles_end_read(sim, &frame) == PARTICLES_OK);
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    REQUIRE(frame.count == 300);
+    REQUIRE(frame.positions != nullptr);
+    REQUIRE(frame.velocities != nullptr);
+    REQUIRE(frame.stamp_ns > 0);
+    for (int i = 0; i < frame.count; ++i) {
+        REQUIRE(frame.positions[i * 2 + 0] >= 0.f);
+        REQUIRE(frame.positions[i * 2 + 0] <= 400.f);
+        REQUIRE(frame.positions[i * 2 + 1] >= 0.f);
+        REQUIRE(frame.positions[i * 2 + 1] <= 300.f);
+    }
+
+    // The simulation keeps stepping around the borrowed frame
+    const std::vector<float> held(frame.positions,
+                                  frame.positions + frame.count * 2);
+    const long long steps = stats.num_steps;
+    particles_stats later = stats;
+    for (int attempt = 0; attempt < 300 && later.num_steps < steps + 5;
+         ++attempt) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        REQUIRE(particles_get_stats(sim, &later) == PARTICLES_OK);
+    }
+    REQUIRE(later.num_steps >= steps + 5);
+    REQUIRE(std::memcmp(held.data(), frame.positions,
+                        held.size() * sizeof(float)) == 0);
+    REQUIRE(particles_end_read(sim, &frame) == PARTICLES_OK);
+    REQUIRE(frame.positions == nullptr);
+
+    // Commands are applied by the simulation thread
+    const particles_group extra = {50, 0, 255, 0, 255, 30.f, 1};
+    REQUIRE(particles_add_group(sim, &extra) == PARTICLES_OK);
+    REQUIRE(wait_for_particles(sim, 350).groups == 3);
+    REQUIRE(particles_remove_group(sim, 0) == PARTICLES_OK);
+    REQUIRE(wait_for_particles(sim, 150).groups == 2);
+
+    particles_destroy(sim);
+}
+
+TEST_CASE("C API steps one tick at a time while paused", "[capi]") {
+    particles_sim *sim = make_sim(0);
+    seed_two_groups(sim);
+    REQUIRE(particles_start(sim) == PARTICLES_OK);
+    REQUIRE(particles_pause(sim) == PARTICLES_OK);
+    wait_for_particles(sim, 300);
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+    particles_stats before = {};
+    REQUIRE(particles_get_stats(sim, &before) == PARTICLES_OK);
+    REQUIRE(particles_step(sim) == PARTICLES_OK);
+    particles_stats after = before;
+    for (int attempt = 0; attempt < 300 && after.num_steps == before.num_steps;
+         ++attempt) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        REQUIRE(particles_get_stats(sim, &after) == PARTICLES_OK);
+    }
+    REQUIRE(after.num_steps == before.num_steps + 1);
+
+    // Velocities were not requested
+    particles_frame frame = {};
+    REQUIRE(particles_begin_read(sim, &frame) == PARTICLES_OK);
+    REQUIRE(frame.count == 300);
+    REQUIRE(frame.velocities == nullptr);
+    REQUIRE(particles_end_read(sim, &frame) == PARTICLES_OK);
+
+    const float rules[4] = {0.f, 0.f, 0.f, 0.f};
+    REQUIRE(particles_set_rules(sim, 2, rules, nullptr) == PARTICLES_OK);
+    particles_config cfg = particles_default_config(500.f, 300.f);
+    cfg.sim_threads = 1;
+    REQUIRE(particles_set_config(sim, &cfg) == PARTICLES_OK);
+    REQUIRE(particles_resume(sim) == PARTICLES_OK);
+    particles_destroy(sim);
+}
+
+TEST_CASE("C API reports errors through statuses", "[capi]") {
+    particles_config cfg = particles_default_config(0.f, 300.f);
+    particles_sim *sim = nullptr;
+    REQUIRE(particles_create(&cfg, &sim) == PARTICLES_ERROR_ARGUMENT);
+    REQUIRE(sim == nullptr);
+    REQUIRE(std::strlen(particles_last_error()) > 0);
+
+    REQUIRE(particles_start(nullptr) == PARTICLES_ERROR_ARGUMENT);
+    REQUIRE(std::string(particles_last_error()) == "Null simulation handle");
+
+    sim = make_sim(0);
+    REQUIRE(particles_seed(sim, nullptr, 2, nullptr, 0) ==
+            PARTICLES_ERROR_ARGUMENT);
+    REQUIRE(particles_remove_group(sim, -1) == PARTICLES_ERROR_ARGUMENT);
+    cfg.viscosity = 2.f;
+    cfg.bounds_width = 100.f;
+    REQUIRE(particles_set_config(sim, &cfg) == PARTICLES_ERROR_ARGUMENT);
+
+    REQUIRE(particles_start(sim) == PARTICLES_OK);
+    REQUIRE(particles_start(sim) == PARTICLES_ERROR_STATE);
+
+    particles_frame frame = {};
+    REQUIRE(particles_begin_read(sim, &frame) == PARTICLES_OK);
+    REQUIRE(particles_end_read(sim, &frame) == PARTICLES_OK);
+    REQUIRE(particles_end_read(sim, &frame) == PARTICLES_ERROR_ARGUMENT);
+
+    particles_destroy(sim);
+    particles_destroy(nullptr);
+}
@@ -0,0 +1,258 @@
+#include <catch_amalgamated.hpp>
+
+#include <numeric>
+#include <random>
+#include <vector>
+
+#include "simulation/clusters.hpp"
+#include "simulation/multicore.hpp"
+#include "simulation/neighborindex.hpp"
+#include "simulation/stepper.hpp"
+#include "simulation/world.hpp"
+
+namespace {
+
+/**
+ * @brief Builds a one-group world from explicit positions
+ */
+void fill_world(World &w, const std::vector<float> &xy) {
+    w.add_group((int)xy.size() / 2, RED);
+    w.init_rule_tables(1);
+    w.set_r2(0, 40.f * 40.f);
+    w.finalize_groups();
+    for (size_t i = 0; i < xy.size() / 2; ++i) {
+        w.set_px((int)i, xy[i * 2 + 0]);
+        w.set_py((int)i, xy[i * 2 + 1]);
+    }
+}
+
+/**
+ * @brief Scatters particles of two groups over the bounds
+ */
+void scatter_world(World &w, int per_group, float width, float height) {
+    w.add_group(per_group, RED);
+    w.add_group(per_group, BLUE);
+    w.init_rule_tables(2);
+    w.set_r2(0, 40.f * 40.f);
+    w.set_r2(1, 40.f * 40.f);
+    w.set_rule(0, 0, 0.2f);
+    w.set_rule(1, 0, -0.3f);
+    w.finalize_groups();
+
+    std::mt19937 rng(11);
+    std::uniform_real_distribution<float> ux(0.f, width);
+    std::uniform_real_distribution<float> uy(0.f, height);
+    for (int i = 0; i < w.get_particles_size(); ++i) {
+        w.set_px(i, ux(rng));
+        w.set_py(i, uy(rng));
+    }
+}
+
+/**
+ * @brief Runs the cluster pass over a freshly built grid
+ */
+mailbox::ClusterSnapshot find_clusters(const World &w, float width,
+                                       float height, float cell,
+                                       float distance,
+                                       SimulationThreadPool *pool = nullptr) {
+    NeighborIndex index;
+    index.ensure(w, width, height, cell);
+    ClusterFinder finder;
+    mailbox::ClusterSnapshot out;
+    index.visit([&](const auto &grid) {
+        if (pool) {
+            finder.find(
+                w, grid, distance,
+                [pool](auto &&kernel, int n) {
+                    pool->parallel_for_n(kernel, n);
+                },
+                out);
+        } else {
+            finder.find(
+                w, grid, distance,
+                [](auto &&kernel, int n) {
+                    kernel(0, n);
+                },
+                out);
+        }
+    });
+    return out;
+}
+
+/**
+ * @brief Counts components and the largest one by testing every pair
+ */
+std::pair<int, int> brute_force_components(const World &w, float distance) {
+    const int n = w.get_particles_size();
+    std::vector<int> parent(n);
+    std::iota(parent.begin(), parent.end(), 0);
+    auto root = [&](int x) {
+        while (parent[x] != x) {
+            x = parent[x];
+        }
+        return x;
+    };
+    for (int i = 0; i < n; ++i) {
+        for (int j = i + 1; j < n; ++j) {
+            const float dx = w.get_px(i) - w.get_px(j);
+            const float dy = w.get_py(i) - w.get_py(j);
+            if (dx * dx + dy * dy < distance * distance) {
+                parent[std::max(root(i), root(j))] = std::min(root(i), root(j));
+            }
+        }
+    }
+
+    std::vector<int> sizes(n, 0);
+    int components = 0;
+    for (int i = 0; i < n; ++i) {
+        const int r = root(i);
+        components += r == i ? 1 : 0;
+        ++sizes[r];
+    }
+    return {components, *std::max_element(sizes.begin(), sizes.end())};
+}
+
+} // namespace
+
+TEST_CASE("ClusterFinder separates linked groups", "[clusters]") {
+    std::vector<float> xy;
+    // A chain of 10 crossing a cell border, 5 px apart
+    for (int k = 0; k < 10; ++k) {
+        xy.insert(xy.end(), {30.f + 5.f * k, 100.f});
+    }
+    // A tight blob of 5 far away
+    for (int k = 0; k < 5; ++k) {
+        xy.insert(xy.end(), {500.f + 2.f * k, 300.f});
+    }
+    // A pair and two loners
+    xy.insert(xy.end(), {300.f, 50.f, 303.f, 50.f, 700.f, 500.f, 10.f, 550.f});
+
+    World w;
+    fill_world(w, xy);
+    const auto c = find_clusters(w, 800.f, 600.f, 40.f, 6.f);
+
+    REQUIRE(c.particles == 19);
+    REQUIRE(c.components == 5);
+    REQUIRE(c.largest == 10);
+    REQUIRE(c.clustered == 15);
+    REQUIRE(c.link_distance == 6.f);
+    REQUIRE(c.sizes == std::vector<int>{10, 5});
+    REQUIRE(c.centroid_x[0] == Catch::Approx(52.5f));
+    REQUIRE(c.centroid_y[0] == Catch::Approx(100.f));
+    REQUIRE(c.centroid_x[1] == Catch::Approx(504.f));
+    REQUIRE(c.size_histogram[0] == 2); // loners
+    REQUIRE(c.size_histogram[1] == 1); // the pair
+    REQUIRE(c.size_histogram[2] == 1); // 5
+    REQUIRE(c.size_histogram[3] == 1); // 10
+
+    // Just below the spacing nothing links
+    const auto apart = find_clusters(w, 800.f, 600.f, 40.f, 1.5f);
+    REQUIRE(apart.components == 19);
+    REQUIRE(apart.sizes.empty());
+}
+
+TEST_CASE("ClusterFinder matches a brute-force pass for any thread count",
+          "[clusters]") {
+    World w;
+    scatter_world(w, 1500, 800.f, 600.f);
+
+    // Link distances below, at and above the cell size
+    for (float distance : {6.f, 10.f, 25.f}) {
+        const auto expected = brute_force_components(w, distance);
+        const auto serial = find_clusters(w, 800.f, 600.f, 12.f, distance);
+        REQUIRE(serial.components == expected.first);
+        REQUIRE(serial.largest == expected.second);
+
+        for (int threads : {2, 4}) {
+            SimulationThreadPool pool(threads);
+            const auto pooled =
+                find_clusters(w, 800.f, 600.f, 12.f, distance, &pool);
+            REQUIRE(pooled.components == serial.components);
+            REQUIRE(pooled.sizes == serial.sizes);
+            REQUIRE(pooled.centroid_x == serial.centroid_x);
+            REQUIRE(pooled.centroid_y == serial.centroid_y);
+            REQUIRE(pooled.size_histogram == serial.size_histogram);
+        }
+    }
+}
+
+TEST_CASE("ClusterFinder ignores disabled groups", "[clusters]") {
+    World w;
+    scatter_world(w, 500, 200.f, 200.f);
+    const auto all = find_clusters(w, 200.f, 200.f, 40.f, 8.f);
+    w.set_group_enabled(1, false);
+    const auto red = find_clusters(w, 200.f, 200.f, 40.f, 8.f);
+
+    REQUIRE(all.particles == 1000);
+    REQUIRE(red.particles == 500);
+    REQUIRE(red.largest <= all.largest);
+    int counted = 0;
+    for (int b = 0; b < mailbox::ClusterSnapshot::SIZE_BINS; ++b) {
+        counted += red.size_histogram[b];
+    }
+    REQUIRE(counted == red.components);
+}
+
+TEST_CASE("Stepper finds clusters every cluster_interval steps",
+          "[clusters]") {
+    mailbox::SimulationConfigSnapshot cfg = {};
+    cfg.bounds_width = 400.0f;
+    cfg.bounds_height = 300.0f;
+    cfg.time_scale = 1.0f;
+    cfg.viscosity = 0.2f;
+    cfg.cluster_interval = 3;
+    cfg.cluster_distance = 10.f;
+
+    World w;
+    scatter_world(w, 800, 400.f, 300.f);
+    Stepper stepper;
+    stepper.step(w, cfg);
+    REQUIRE_FALSE(stepper.clusters_updated()); // analytics are off
+
+    stepper.set_analytics(true);
+    std::vector<bool> updated;
+    for (int s = 0; s < 7; ++s) {
+        stepper.step(w, cfg);
+        updated.push_back(stepper.clusters_updated());
+    }
+    REQUIRE(updated ==
+            std::vector<bool>{true, false, false, true, false, false, true});
+    REQUIRE(stepper.clusters().particles == 1600);
+    REQUIRE(stepper.clusters().link_distance == 10.f);
+}
+
+TEST_CASE("Cluster pass vs force step at 200k particles", "[!benchmark]") {
+    mailbox::SimulationConfigSnapshot cfg = {};
+    cfg.bounds_width = 4000.0f;
+    cfg.bounds_height = 3000.0f;
+    cfg.time_scale = 1.0f;
+    cfg.viscosity = 0.2f;
+    cfg.cluster_distance = 8.f;
+
+    World w;
+    scatter_world(w, 100'000, cfg.bounds_width, cfg.bounds_height);
+    SimulationThreadPool pool(-1);
+    Stepper stepper;
+    BENCHMARK("step") {
+        stepper.step(w, pool, cfg);
+    };
+
+    // The step reuses its own grid; build one that matches the final
+    // positions so only the cluster pass itself is timed
+    NeighborIndex index;
+    index.ensure(w, cfg.bounds_width, cfg.bounds_height,
+                 w.max_interaction_radius());
+    ClusterFinder finder;
+    mailbox::ClusterSnapshot out;
+    BENCHMARK("cluster pass") {
+        index.visit([&](const auto &grid) {
+            finder.find(
+                w, grid, cfg.cluster_distance,
+                [&pool](auto &&kernel, int n) {
+                    pool.parallel_for_n(kernel, n);
+                },
+                out);
+        });
+        return out.components;
+    };
+}
@@ -0,0 +1,56 @@
+#include <catch_amalgamated.hpp>
+
+#include <set>
+
+#include "utility/counter_rng.hpp"
+
+using particles::utility::CounterRng;
+
+TEST_CASE("CounterRng matches Philox4x32-10 reference vectors",
+          "[counter_rng]") {
+    REQUIRE(CounterRng::philox({0, 0, 0, 0}, {0, 0}) ==
+            CounterRng::Block{0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8});
+    REQUIRE(CounterRng::philox({0xffffffff, 0xffffffff, 0xffffffff,
+                                0xffffffff},
+                               {0xffffffff, 0xffffffff}) ==
+            CounterRng::Block{0x408f276d, 0x41c83b0e, 0xa20bc7c6, 0x6d5451fd});
+    REQUIRE(CounterRng::philox({0x243f6a88, 0x85a308d3, 0x13198a2e,
+                                0x03707344},
+                               {0xa4093822, 0x299f31d0}) ==
+            CounterRng::Block{0xd16cfe09, 0x94fdcceb, 0x5001e420, 0x24126ea1});
+}
+
+TEST_CASE("CounterRng is a pure function of seed, stream and index",
+          "[counter_rng]") {
+    const CounterRng a(42, 0);
+    const CounterRng b(42, 0);
+    const CounterRng other_stream(42, 1);
+    const CounterRng other_seed(43, 0);
+
+    std::set<uint32_t> words;
+    for (uint64_t i = 0; i < 1000; ++i) {
+        REQUIRE(a.at(i) == b.at(i));
+        REQUIRE(a.at(i) != other_stream.at(i));
+        REQUIRE(a.at(i) != other_seed.at(i));
+        words.insert(a.at(i)[0]);
+    }
+    // Reading indices out of order gives the same values
+    REQUIRE(a.at(999) == b.at(999));
+    REQUIRE(words.size() == 1000);
+}
+
+TEST_CASE("CounterRng unit floats stay in [0, 1)", "[counter_rng]") {
+    REQUIRE(CounterRng::to_unit_float(0) == 0.f);
+    REQUIRE(CounterRng::to_unit_float(0xffffffffu) < 1.f);
+
+    const CounterRng rng(7);
+    double sum = 0.0;
+    const int n = 100'000;
+    for (int i = 0; i < n; ++i) {
+        const float u = CounterRng::to_unit_float(rng.at(i)[1]);
+        REQUIRE(u >= 0.f);
+        REQUIRE(u < 1.f);
+        sum += u;
+    }
+    REQUIRE(sum / n == Catch::Approx(0.5).margin(0.01));
+}
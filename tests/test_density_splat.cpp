@@ -0,0 +1,66 @@
+#include <catch_amalgamated.hpp>
+
+#include "render/density_splat.hpp"
+
+#include "helpers.hpp"
+
+using test_helpers::make_world;
+
+namespace {
+
+const uint8_t *pixel_at(const DensitySplat &splat, int x, int y) {
+    return splat.pixels().data() + ((size_t)y * splat.width() + x) * 4;
+}
+
+} // namespace
+
+TEST_CASE("DensitySplat averages colors and accumulates coverage",
+          "[density_splat]") {
+    // Two red and two blue particles share pixel (3, 2); one red at (0, 0)
+    auto world = make_world({3, 2}, {{200, 0, 0, 255}, {0, 0, 100, 255}});
+    std::vector<float> pos = {3.5f, 2.5f, 3.1f, 2.9f, 0.f,
+                              0.f,  3.2f, 2.2f, 3.9f, 2.0f};
+    ParticleBatch batch;
+    batch.build_positions(world, nullptr, pos, 1.f,
+                          {0.f, 0.f, 1.f, 10.f, 10.f});
+
+    DensitySplat splat;
+    splat.build(batch, world, 8, 4, 0.5f);
+    REQUIRE(splat.width() == 8);
+    REQUIRE(splat.height() == 4);
+    REQUIRE(splat.pixels().size() == 8u * 4u * 4u);
+
+    const uint8_t *shared = pixel_at(splat, 3, 2);
+    REQUIRE(shared[0] == 100);
+    REQUIRE(shared[1] == 0);
+    REQUIRE(shared[2] == 50);
+    // 1 - 0.5^4
+    REQUIRE(shared[3] == 239);
+
+    const uint8_t *single = pixel_at(splat, 0, 0);
+    REQUIRE(single[0] == 200);
+    REQUIRE(single[3] == 128);
+
+    const uint8_t *empty = pixel_at(splat, 7, 3);
+    REQUIRE(empty[3] == 0);
+}
+
+TEST_CASE("DensitySplat ignores positions outside the image",
+          "[density_splat]") {
+    auto world = make_world({2}, {{255, 255, 255, 255}});
+    // Inside the sim bounds but outside the (smaller) image
+    std::vector<float> pos = {20.f, 1.f, 1.f, 1.f};
+    ParticleBatch batch;
+    batch.build_positions(world, nullptr, pos, 1.f,
+                          {0.f, 0.f, 1.f, 50.f, 50.f});
+
+    DensitySplat splat;
+    splat.build(batch, world, 4, 4, 2.f);
+    size_t covered = 0;
+    for (size_t p = 0; p < 16; ++p) {
+        covered += splat.pixels()[p * 4 + 3] != 0;
+    }
+    REQUIRE(covered == 1);
+    // Coverage is clamped, so one particle saturates its pixel
+    REQUIRE(pixel_at(splat, 1, 1)[3] == 255);
+}
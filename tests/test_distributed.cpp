@@ -0,0 +1,319 @@
+#include <catch_amalgamated.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <unistd.h>
+
+#include "distributed/channel.hpp"
+#include "distributed/frame_export.hpp"
+#include "distributed/frame_ring.hpp"
+#include "distributed/slab_coordinator.hpp"
+#include "distributed/slab_layout.hpp"
+#include "simulation/multicore.hpp"
+#include "simulation/stepper.hpp"
+#include "simulation/world.hpp"
+#include "utility/exceptions.hpp"
+
+#include "helpers.hpp"
+
+using namespace distributed;
+
+namespace {
+
+void world_state(const World &w, std::vector<float> &pos,
+                 std::vector<float> &vel) {
+    const int n = w.get_particles_size();
+    pos.resize((size_t)n * 2);
+    vel.resize((size_t)n * 2);
+    for (int i = 0; i < n; ++i) {
+        pos[(size_t)i * 2 + 0] = w.get_px(i);
+        pos[(size_t)i * 2 + 1] = w.get_py(i);
+        vel[(size_t)i * 2 + 0] = w.get_vx(i);
+        vel[(size_t)i * 2 + 1] = w.get_vy(i);
+    }
+}
+
+} // namespace
+
+TEST_CASE("SlabLayout owner_of agrees with slab edges", "[distributed]") {
+    SlabLayout layout{1000.f, 7};
+    REQUIRE(layout.owner_of(-5.f) == 0);
+    REQUIRE(layout.owner_of(0.f) == 0);
+    REQUIRE(layout.owner_of(999.9f) == 6);
+    REQUIRE(layout.owner_of(5000.f) == 6);
+    for (int s = 0; s < layout.slabs; ++s) {
+        REQUIRE(layout.owner_of(layout.x0(s)) == s);
+        const float inside = std::nextafter(layout.x1(s), 0.f);
+        REQUIRE(layout.owner_of(inside) == s);
+    }
+}
+
+TEST_CASE("Channel exchange does not deadlock on large payloads",
+          "[distributed]") {
+    auto [a, b] = Channel::pair();
+    std::vector<ParticleRecord> to_b(200000), to_a(150000);
+    for (int i = 0; i < (int)to_b.size(); ++i) {
+        to_b[i] = {i, 1, (float)i, 0.f, 0.f, 0.f};
+    }
+    for (int i = 0; i < (int)to_a.size(); ++i) {
+        to_a[i] = {-i, 2, 0.f, (float)i, 0.f, 0.f};
+    }
+
+    std::vector<ParticleRecord> at_a, at_b;
+    std::thread peer([&, &b = b] {
+        std::vector<Exchange> ex{{&b, MessageTag::Halo, &to_a, &at_b}};
+        exchange(ex);
+    });
+    std::vector<Exchange> ex{{&a, MessageTag::Halo, &to_b, &at_a}};
+    exchange(ex);
+    peer.join();
+
+    REQUIRE(at_a.size() == to_a.size());
+    REQUIRE(at_b.size() == to_b.size());
+    REQUIRE(at_a.back().py == to_a.back().py);
+    REQUIRE(at_b.back().px == to_b.back().px);
+
+    // Empty payloads and tag checks
+    std::vector<ParticleRecord> none;
+    a.send(MessageTag::Done, 42);
+    const auto header = b.expect(MessageTag::Done, at_b);
+    REQUIRE(header.value == 42);
+    REQUIRE(at_b.empty());
+    a.send(MessageTag::Gather, 0);
+    REQUIRE_THROWS_AS(b.expect(MessageTag::Done, at_b),
+                      particles::SimulationError);
+    a.close();
+    REQUIRE_THROWS_AS(b.receive(at_b), particles::IOError);
+}
+
+TEST_CASE("Slab processes match a single-process run bit for bit",
+          "[distributed]") {
+    const auto cfg = test_helpers::stepping_config(900.0f, 500.0f, 0.2f);
+
+    World reference;
+    test_helpers::seed_three_groups(reference, 700, 500, 300, cfg, 99, 3.f);
+    std::vector<float> pos, vel;
+    world_state(reference, pos, vel);
+
+    SlabCoordinator coordinator(reference, pos, vel, cfg, 3, 2);
+    REQUIRE(coordinator.slabs() == 3);
+    const std::vector<int> initial_sizes = coordinator.slab_sizes();
+
+    Stepper stepper;
+    SimulationThreadPool pool(2);
+    const int steps = 40;
+    for (int s = 0; s < steps; ++s) {
+        stepper.step(reference, pool, cfg);
+    }
+    coordinator.step(steps / 2);
+    coordinator.step(steps / 2);
+
+    std::vector<float> expected_pos, expected_vel;
+    world_state(reference, expected_pos, expected_vel);
+    std::vector<float> got_pos, got_vel;
+    coordinator.gather(got_pos, got_vel);
+
+    REQUIRE(got_pos == expected_pos);
+    REQUIRE(got_vel == expected_vel);
+
+    // Particles crossed slab boundaries along the way
+    int total = 0;
+    for (int n : coordinator.slab_sizes()) {
+        total += n;
+    }
+    REQUIRE(total == reference.get_particles_size());
+    REQUIRE(coordinator.slab_sizes() != initial_sizes);
+}
+
+TEST_CASE("Slab coordinator validates its configuration", "[distributed]") {
+    const auto cfg = test_helpers::stepping_config(900.0f, 500.0f, 0.2f);
+    World w;
+    test_helpers::seed_three_groups(w, 700, 500, 300, cfg, 99, 3.f);
+    std::vector<float> pos, vel;
+    world_state(w, pos, vel);
+
+    // 900 / 20 = 45 units per slab, narrower than the 60 unit radius
+    REQUIRE_THROWS_AS(SlabCoordinator(w, pos, vel, cfg, 20),
+                      particles::ConfigError);
+    REQUIRE_THROWS_AS(SlabCoordinator(w, pos, vel, cfg, 0),
+                      particles::ConfigError);
+    pos.pop_back();
+    REQUIRE_THROWS_AS(SlabCoordinator(w, pos, vel, cfg, 2),
+                      particles::ConfigError);
+}
+
+namespace {
+
+/** @brief Ring name unique to this process, so parallel runs do not clash */
+std::string ring_name(const char *what) {
+    return "/particles_test_" + std::string(what) + "_" +
+           std::to_string((long long)getpid());
+}
+
+} // namespace
+
+TEST_CASE("Frame ring hands readers the latest frame without copies",
+          "[distributed]") {
+    World w;
+    w.add_group(30, RED);
+    w.add_group(20, BLUE);
+    w.init_rule_tables(2);
+    w.set_group_enabled(1, false);
+    for (int i = 0; i < w.get_particles_size(); ++i) {
+        w.set_px(i, float(i));
+        w.set_py(i, float(i) * 2.f);
+    }
+
+    FrameExport exporter(ring_name("latest"));
+    FrameRingReader reader(exporter.ring().name());
+    FrameView frame;
+    REQUIRE_FALSE(reader.latest(frame));
+
+    exporter.write(w, 400.f, 300.f, 1234);
+    REQUIRE(reader.latest(frame));
+    REQUIRE(frame.number == 1);
+    REQUIRE(frame.stamp_ns == 1234);
+    REQUIRE(frame.particles == 50);
+    REQUIRE(frame.groups == 2);
+    REQUIRE(frame.width == 400.f);
+    REQUIRE(frame.height == 300.f);
+    REQUIRE(frame.group[0].begin == 0);
+    REQUIRE(frame.group[0].end == 30);
+    REQUIRE(frame.group[0].enabled == 1);
+    REQUIRE(frame.group[1].begin == 30);
+    REQUIRE(frame.group[1].end == 50);
+    REQUIRE(frame.group[1].enabled == 0);
+    REQUIRE(frame.group[1].b == BLUE.b);
+    for (uint32_t i = 0; i < frame.particles; ++i) {
+        REQUIRE(frame.xy[i * 2 + 0] == float(i));
+        REQUIRE(frame.xy[i * 2 + 1] == float(i) * 2.f);
+    }
+    REQUIRE(reader.still_valid(frame));
+
+    // The writer laps the held slot instead of waiting for the reader
+    for (int i = 0; i < FrameRingWriter::DEFAULT_SLOTS; ++i) {
+        exporter.write(w, 400.f, 300.f, 2000 + i);
+    }
+    REQUIRE_FALSE(reader.still_valid(frame));
+    REQUIRE(reader.latest(frame));
+    REQUIRE(frame.number == 1 + FrameRingWriter::DEFAULT_SLOTS);
+    REQUIRE(frame.stamp_ns == 2000 + FrameRingWriter::DEFAULT_SLOTS - 1);
+}
+
+TEST_CASE("Frame ring grows into a new ring that readers reopen",
+          "[distributed]") {
+    const std::string name = ring_name("grow");
+    FrameRingWriter writer(name, 3, 8, 1);
+    FrameRingReader reader(name);
+
+    std::vector<float> px(100), py(100);
+    for (int i = 0; i < 100; ++i) {
+        px[i] = float(i);
+        py[i] = -float(i);
+    }
+    const FrameGroup group{0, 8, 255, 0, 0, 255, 1};
+    writer.write(1, 10.f, 10.f, px.data(), py.data(), 8, &group, 1);
+    FrameView frame;
+    REQUIRE(reader.latest(frame));
+    REQUIRE(frame.particles == 8);
+    REQUIRE_FALSE(reader.stale());
+
+    const FrameGroup all{0, 100, 255, 0, 0, 255, 1};
+    writer.write(2, 10.f, 10.f, px.data(), py.data(), 100, &all, 1);
+    REQUIRE(reader.stale());
+    REQUIRE_FALSE(reader.closed());
+    REQUIRE_FALSE(reader.latest(frame));
+
+    reader.reopen();
+    REQUIRE_FALSE(reader.stale());
+    REQUIRE(reader.latest(frame));
+    REQUIRE(frame.number == 2);
+    REQUIRE(frame.particles == 100);
+    REQUIRE(frame.stamp_ns == 2);
+    REQUIRE(frame.xy[99 * 2 + 0] == 99.f);
+    REQUIRE(frame.xy[99 * 2 + 1] == -99.f);
+    REQUIRE(writer.frames_written() == 2);
+}
+
+TEST_CASE("Frame ring readers see the writer go away", "[distributed]") {
+    const std::string name = ring_name("close");
+    REQUIRE_THROWS_AS(FrameRingReader(name), particles::IOError);
+
+    auto writer = std::make_unique<FrameRingWriter>(name);
+    FrameRingReader reader(name);
+    writer.reset();
+    REQUIRE(reader.stale());
+    REQUIRE(reader.closed());
+    REQUIRE_THROWS_AS(reader.reopen(), particles::IOError);
+
+    // A failed reopen keeps the old mapping
+    FrameView frame;
+    REQUIRE(reader.closed());
+    REQUIRE_FALSE(reader.latest(frame));
+}
+
+TEST_CASE("Frame ring readers follow a ring that grows while they poll",
+          "[distributed]") {
+    const std::string name = ring_name("poll");
+    constexpr int FRAMES = 3000;
+    FrameRingWriter writer(name, 2, 1, 1);
+    FrameRingReader reader(name);
+
+    uint64_t newest = 0;
+    int reopens = 0;
+    int torn = 0;
+    bool closed = false;
+    std::thread poller([&] {
+        const auto deadline =
+            std::chrono::steady_clock::now() + std::chrono::seconds(20);
+        while (newest < FRAMES &&
+               std::chrono::steady_clock::now() < deadline) {
+            if (reader.closed()) {
+                closed = true;
+                return;
+            }
+            if (reader.stale()) {
+                // The writer may have grown the ring again meanwhile
+                try {
+                    reader.reopen();
+                    ++reopens;
+                } catch (const particles::IOError &) {
+                }
+                continue;
+            }
+            FrameView frame;
+            if (!reader.latest(frame)) {
+                continue;
+            }
+            // Every coordinate of frame n is n
+            const uint32_t n = frame.particles;
+            const bool whole = n > 0 && frame.stamp_ns == (int64_t)n &&
+                               frame.groups == 1 && frame.group[0].end == n &&
+                               frame.xy[0] == float(n) &&
+                               frame.xy[(size_t)n * 2 - 1] == float(n);
+            if (!reader.still_valid(frame)) {
+                continue;
+            }
+            torn += whole ? 0 : 1;
+            newest = std::max(newest, frame.number);
+        }
+    });
+
+    std::vector<float> xy(FRAMES);
+    for (int n = 1; n <= FRAMES; ++n) {
+        std::fill(xy.begin(), xy.begin() + n, float(n));
+        const FrameGroup group{0, (uint32_t)n, 255, 0, 0, 255, 1};
+        writer.write(n, 10.f, 10.f, xy.data(), xy.data(), n, &group, 1);
+    }
+    poller.join();
+
+    REQUIRE_FALSE(closed);
+    REQUIRE(torn == 0);
+    REQUIRE(reopens > 0);
+    REQUIRE(newest == FRAMES);
+}
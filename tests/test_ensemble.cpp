@@ -0,0 +1,126 @@
+#include <catch_amalgamated.hpp>
+
+#include <vector>
+
+#include "simulation/ensemble.hpp"
+#include "utility/exceptions.hpp"
+
+#include "helpers.hpp"
+
+namespace {
+
+mailbox::SimulationConfigSnapshot member_config(int variant) {
+    return test_helpers::stepping_config(500.0f + 40.0f * variant, 400.0f,
+                                         0.1f + 0.05f * (variant % 4));
+}
+
+mailbox::command::SeedSpec member_seed(int variant, int per_group) {
+    mailbox::command::SeedSpec seed;
+    seed.add_group(per_group, RED, 50.f * 50.f, true);
+    seed.add_group(per_group / 2 + variant * 37, GREEN, 70.f * 70.f, true);
+    seed.add_group(per_group / 3, BLUE, 40.f * 40.f, true);
+    seed.rules = {0.3f,  -0.2f, 0.1f * variant, -0.4f, 0.2f,
+                  0.3f,  0.25f, -0.3f,          -0.1f};
+    seed.rng_seed = 1000 + variant;
+    return seed;
+}
+
+/**
+ * @brief Positions and velocities of every world, concatenated
+ */
+std::vector<float> ensemble_state(const Ensemble &ensemble) {
+    std::vector<float> state;
+    for (int k = 0; k < ensemble.size(); ++k) {
+        const World &w = ensemble.world(k);
+        for (int i = 0; i < w.get_particles_size(); ++i) {
+            state.push_back(w.get_px(i));
+            state.push_back(w.get_py(i));
+            state.push_back(w.get_vx(i));
+            state.push_back(w.get_vy(i));
+        }
+    }
+    return state;
+}
+
+} // namespace
+
+TEST_CASE("Ensemble results do not depend on the thread count",
+          "[ensemble]") {
+    Ensemble serial(1);
+    Ensemble parallel(4);
+    for (int k = 0; k < 9; ++k) {
+        REQUIRE(serial.add(member_seed(k, 600), member_config(k)) == k);
+        REQUIRE(parallel.add(member_seed(k, 600), member_config(k)) == k);
+    }
+    REQUIRE(parallel.size() == 9);
+    REQUIRE(parallel.threads() == 4);
+
+    serial.step(3);
+    parallel.step(3);
+    parallel.step(2);
+    serial.step(2);
+    REQUIRE(ensemble_state(serial) == ensemble_state(parallel));
+
+    for (int k = 0; k < parallel.size(); ++k) {
+        const EnsembleMetrics &m = parallel.metrics(k);
+        REQUIRE(m.steps == 5);
+        REQUIRE(m.busy_ns > 0);
+        REQUIRE(m.last_step_ns > 0);
+        REQUIRE(m.mean_speed > 0.f);
+    }
+}
+
+TEST_CASE("Ensemble worlds are independent", "[ensemble]") {
+    Ensemble ensemble(2);
+    ensemble.add(member_seed(1, 400), member_config(1));
+    ensemble.add(member_seed(1, 400), member_config(1));
+    ensemble.add(member_seed(2, 400), member_config(1));
+    ensemble.step(4);
+
+    const World &a = ensemble.world(0);
+    const World &b = ensemble.world(1);
+    const World &c = ensemble.world(2);
+    REQUIRE(a.get_particles_size() == b.get_particles_size());
+    bool same = true;
+    for (int i = 0; i < a.get_particles_size(); ++i) {
+        same = same && a.get_px(i) == b.get_px(i) &&
+               a.get_py(i) == b.get_py(i);
+    }
+    REQUIRE(same);
+    REQUIRE(c.get_particles_size() != a.get_particles_size());
+    REQUIRE(ensemble.config(2).bounds_width == member_config(1).bounds_width);
+}
+
+TEST_CASE("Ensemble rejects invalid worlds", "[ensemble]") {
+    Ensemble ensemble(1);
+    mailbox::SimulationConfigSnapshot cfg = member_config(0);
+    cfg.bounds_width = 0.f;
+    REQUIRE_THROWS_AS(ensemble.add(member_seed(0, 100), cfg),
+                      particles::ConfigError);
+
+    mailbox::command::SeedSpec seed = member_seed(0, 100);
+    seed.sizes[1] = -1;
+    REQUIRE_THROWS_AS(ensemble.add(seed, member_config(0)),
+                      particles::ConfigError);
+    REQUIRE(ensemble.size() == 0);
+
+    // Stepping an empty ensemble is a no-op
+    ensemble.step(3);
+}
+
+TEST_CASE("Ensemble throughput: 1 thread vs all threads", "[!benchmark]") {
+    Ensemble serial(1);
+    Ensemble parallel(-1);
+    for (int k = 0; k < 32; ++k) {
+        serial.add(member_seed(k, 2500), member_config(k));
+        parallel.add(member_seed(k, 2500), member_config(k));
+    }
+    WARN("Ensemble threads: " << parallel.threads());
+
+    BENCHMARK("32 worlds, 1 thread") {
+        serial.step(1);
+    };
+    BENCHMARK("32 worlds, all threads") {
+        parallel.step(1);
+    };
+}
@@ -0,0 +1,126 @@
+#include <catch_amalgamated.hpp>
+
+#include <cmath>
+#include <vector>
+
+#include "simulation/force_table.hpp"
+#include "simulation/multicore.hpp"
+#include "simulation/stepper.hpp"
+#include "simulation/world.hpp"
+
+#include "helpers.hpp"
+
+namespace {
+
+/**
+ * @brief Largest position difference between two worlds after one step each
+ */
+float one_step_drift(World &direct, World &table,
+                     const mailbox::SimulationConfigSnapshot &cfg) {
+    SimulationThreadPool pool(1);
+    Stepper direct_stepper;
+    Stepper table_stepper;
+    mailbox::SimulationConfigSnapshot table_cfg = cfg;
+    table_cfg.force_table = true;
+    direct_stepper.step(direct, pool, cfg);
+    table_stepper.step(table, pool, table_cfg);
+
+    float drift = 0.f;
+    for (int i = 0; i < direct.get_particles_size(); ++i) {
+        drift = std::max(drift, std::abs(direct.get_px(i) - table.get_px(i)));
+        drift = std::max(drift, std::abs(direct.get_py(i) - table.get_py(i)));
+    }
+    return drift;
+}
+
+} // namespace
+
+TEST_CASE("ForceTable matches the direct force law", "[force_table]") {
+    World w;
+    mailbox::SimulationConfigSnapshot cfg =
+        test_helpers::stepping_config(400.f, 300.f, 0.2f);
+    test_helpers::seed_three_groups(w, 1, 1, 1, cfg, 7, 1.f);
+
+    ForceTable table;
+    REQUIRE(table.update(w));
+    REQUIRE(table.groups() == 3);
+    REQUIRE(table.bytes() == 9 * (ForceTable::BINS + 1) * sizeof(float));
+
+    for (int src = 0; src < 3; ++src) {
+        const float r = std::sqrt(w.r2_of(src));
+        const ForceTable::SourceRow row = table.row(src);
+        for (int dst = 0; dst < 3; ++dst) {
+            const float rule = w.rules_of(src).get(dst);
+            // Beyond a few bins from zero the interpolation error is tiny
+            for (float d = r / 8.f; d < r; d += r / 97.f) {
+                const float expected = ForceTable::sample(rule, d * d);
+                const float got = row.at(dst, d * d);
+                REQUIRE(std::abs(got - expected) <=
+                        std::abs(expected) * 1e-3f);
+            }
+            // Near zero the factor is capped instead of diverging
+            REQUIRE(std::isfinite(row.at(dst, 0.f)));
+        }
+    }
+}
+
+TEST_CASE("ForceTable rebuilds only when rules or radii change",
+          "[force_table]") {
+    World w;
+    mailbox::SimulationConfigSnapshot cfg =
+        test_helpers::stepping_config(400.f, 300.f, 0.2f);
+    test_helpers::seed_three_groups(w, 1, 1, 1, cfg, 7, 1.f);
+
+    ForceTable table;
+    REQUIRE(table.update(w));
+    REQUIRE_FALSE(table.update(w));
+
+    w.set_rule(1, 2, -0.5f);
+    REQUIRE(table.update(w));
+    REQUIRE(table.row(1).at(2, 100.f) < 0.f);
+    REQUIRE_FALSE(table.update(w));
+
+    w.set_r2(2, 50.f * 50.f);
+    REQUIRE(table.update(w));
+    REQUIRE_FALSE(table.update(w));
+}
+
+TEST_CASE("Stepper with force table stays close to the direct kernel",
+          "[force_table]") {
+    mailbox::SimulationConfigSnapshot cfg =
+        test_helpers::stepping_config(600.f, 400.f, 0.2f);
+    World direct;
+    World table;
+    test_helpers::seed_three_groups(direct, 400, 400, 400, cfg, 7, 1.f);
+    test_helpers::seed_three_groups(table, 400, 400, 400, cfg, 7, 1.f);
+
+    // Forces scale with 1/d, so a pair inside the first bin can differ a lot;
+    // one step on a loose world keeps that rare enough to bound the drift
+    REQUIRE(one_step_drift(direct, table, cfg) < 0.5f);
+}
+
+TEST_CASE("Force kernel: direct vs lookup table", "[!benchmark]") {
+    mailbox::SimulationConfigSnapshot cfg =
+        test_helpers::stepping_config(2000.f, 1500.f, 0.2f);
+    mailbox::SimulationConfigSnapshot table_cfg = cfg;
+    table_cfg.force_table = true;
+
+    World reference;
+    World tabled;
+    test_helpers::seed_three_groups(reference, 7000, 7000, 7000, cfg, 7, 1.f);
+    test_helpers::seed_three_groups(tabled, 7000, 7000, 7000, cfg, 7, 1.f);
+    WARN("Max position drift after one step: "
+         << one_step_drift(reference, tabled, cfg));
+
+    World w;
+    test_helpers::seed_three_groups(w, 7000, 7000, 7000, cfg, 7, 1.f);
+    SimulationThreadPool pool(1);
+    Stepper stepper;
+
+    BENCHMARK("direct rsqrt") {
+        stepper.step(w, pool, cfg);
+    };
+    BENCHMARK("lookup table") {
+        stepper.step(w, pool, table_cfg);
+    };
+}
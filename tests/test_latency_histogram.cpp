@@ -0,0 +1,78 @@
+#include <catch_amalgamated.hpp>
+
+#include <thread>
+#include <vector>
+
+#include "utility/latency_histogram.hpp"
+
+using particles::utility::LatencyHistogram;
+
+TEST_CASE("LatencyHistogram buckets keep values within 1/16", "[latency]") {
+    for (int b = 0; b < LatencyHistogram::SUB_BUCKETS; ++b) {
+        REQUIRE(LatencyHistogram::bucket_of((uint64_t)b) == b);
+        REQUIRE(LatencyHistogram::bucket_upper(b) == (uint64_t)b);
+    }
+
+    int last_bucket = 0;
+    for (uint64_t v = 1; v < (uint64_t(1) << 39); v = v * 5 / 4 + 1) {
+        const int bucket = LatencyHistogram::bucket_of(v);
+        const uint64_t upper = LatencyHistogram::bucket_upper(bucket);
+        REQUIRE(bucket >= last_bucket);
+        REQUIRE(bucket < LatencyHistogram::BUCKETS);
+        REQUIRE(upper >= v);
+        REQUIRE((double)(upper - v) <= (double)v / 16.0);
+        // The value just past a bucket starts the next one
+        REQUIRE(LatencyHistogram::bucket_of(upper + 1) == bucket + 1);
+        last_bucket = bucket;
+    }
+    REQUIRE(LatencyHistogram::bucket_of(~uint64_t(0)) ==
+            LatencyHistogram::BUCKETS - 1);
+}
+
+TEST_CASE("LatencyHistogram reports percentiles and the maximum",
+          "[latency]") {
+    LatencyHistogram h;
+    REQUIRE(h.summary().count == 0);
+    REQUIRE(h.summary().p99 == 0);
+
+    // 1..10000 us, shuffled by a stride coprime with the count
+    for (int k = 0; k < 10000; ++k) {
+        h.record((int64_t)((k * 7919) % 10000 + 1) * 1000);
+    }
+    h.record(-5); // counts as 0
+
+    const auto s = h.summary();
+    REQUIRE(s.count == 10001);
+    REQUIRE(s.max == 10'000'000);
+    REQUIRE(s.p50 == Catch::Approx(5'000'000).epsilon(1.0 / 16));
+    REQUIRE(s.p95 == Catch::Approx(9'500'000).epsilon(1.0 / 16));
+    REQUIRE(s.p99 == Catch::Approx(9'900'000).epsilon(1.0 / 16));
+    REQUIRE(s.p50 <= s.p95);
+    REQUIRE(s.p95 <= s.p99);
+    REQUIRE(s.p99 <= s.max);
+
+    h.reset();
+    REQUIRE(h.summary().count == 0);
+    REQUIRE(h.summary().max == 0);
+}
+
+TEST_CASE("LatencyHistogram counts every value recorded concurrently",
+          "[latency]") {
+    LatencyHistogram h;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&h, t] {
+            for (int k = 0; k < 20000; ++k) {
+                h.record(1000 * (t + 1));
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+
+    const auto s = h.summary();
+    REQUIRE(s.count == 80000);
+    REQUIRE(s.max == 4000);
+    REQUIRE(s.p50 == Catch::Approx(2000).epsilon(1.0 / 16));
+}
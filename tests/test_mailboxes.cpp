@@ -1,5 +1,11 @@
 #include <catch_amalgamated.hpp>
 
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <thread>
+#include <vector>
+
 #include "mailbox/mailbox.hpp"
 
 using namespace mailbox;
@@ -55,8 +61,9 @@ TEST_CASE("DrawBuffer basic write/read", "[mailboxes]") {
     vel[1] = 0.2f;
     vel[2] = 0.3f;
     vel[3] = 0.4f;
-    g.head[0] = 0;
-    g.next[0] = 1;
+    g.count[0] = 2;
+    g.indices[0] = 0;
+    g.indices[1] = 1;
     db.publish(123);
 
     auto v = db.begin_read();
@@ -67,6 +74,196 @@ TEST_CASE("DrawBuffer basic write/read", "[mailboxes]") {
     db.end_read(v);
 }
 
+namespace {
+
+/**
+ * @brief Publishes a frame whose every position float is its stamp
+ */
+void publish_frame(mailbox::render::DrawBuffer &db, size_t floats,
+                   long long stamp) {
+    auto &pos = db.begin_write_pos(floats);
+    std::fill(pos.begin(), pos.end(), (float)stamp);
+    db.publish(stamp);
+}
+
+/**
+ * @brief Reads views until stop is set and checks each one is whole
+ * @return Views read, or -1 if a view was torn, recycled or went back in time
+ */
+long long read_frames(const mailbox::render::DrawBuffer &db,
+                      const std::atomic<bool> &stop) {
+    long long reads = 0;
+    long long last_t1 = 0;
+    while (!stop.load(std::memory_order_relaxed)) {
+        auto v = db.begin_read();
+        bool ok = v.t0 <= v.t1 && v.t1 >= last_t1;
+        for (const float p : *v.curr) {
+            ok = ok && p == (float)v.t1;
+        }
+        for (const float p : *v.prev) {
+            ok = ok && p == (float)v.t0;
+        }
+        // A slot the writer recycled would now hold a newer frame
+        ok = ok && v.curr->front() == (float)v.t1;
+        last_t1 = v.t1;
+        db.end_read(v);
+        if (!ok) {
+            return -1;
+        }
+        ++reads;
+    }
+    return reads;
+}
+
+} // namespace
+
+TEST_CASE("DrawBuffer readers never wait for each other", "[mailboxes]") {
+    mailbox::render::DrawBuffer db;
+    REQUIRE(db.slot_count() == mailbox::render::DrawBuffer::DEFAULT_SLOTS);
+    publish_frame(db, 4, 1);
+
+    // A reader holding a view does not block a second reader or the writer
+    auto held = db.begin_read();
+    auto other = db.begin_read();
+    REQUIRE(other.t1 == 1);
+    db.end_read(other);
+    for (long long t = 2; t < 50; ++t) {
+        publish_frame(db, 4, t);
+    }
+    REQUIRE(db.dropped_frames() == 0);
+    REQUIRE(held.t1 == 1);
+    REQUIRE((*held.curr)[0] == 1.f);
+    db.end_read(held);
+
+    auto latest = db.begin_read();
+    REQUIRE(latest.t0 == 48);
+    REQUIRE(latest.t1 == 49);
+    db.end_read(latest);
+
+    SECTION("Too few slots drop frames instead of recycling pinned ones") {
+        mailbox::render::DrawBuffer small(3);
+        publish_frame(small, 4, 1);
+        publish_frame(small, 4, 2);
+        auto pinned = small.begin_read();
+        publish_frame(small, 4, 3);
+        publish_frame(small, 4, 4);
+        REQUIRE(small.dropped_frames() == 1);
+        REQUIRE((*pinned.prev)[0] == 1.f);
+        REQUIRE((*pinned.curr)[0] == 2.f);
+        small.end_read(pinned);
+        publish_frame(small, 4, 5);
+        auto v = small.begin_read();
+        REQUIRE(v.t0 == 3);
+        REQUIRE(v.t1 == 5);
+        small.end_read(v);
+    }
+}
+
+TEST_CASE("DrawBuffer stress: many readers against one writer",
+          "[mailboxes]") {
+    const int readers = 8;
+    mailbox::render::DrawBuffer db(
+        mailbox::render::DrawBuffer::slots_for_readers(readers));
+    publish_frame(db, 256, 1);
+
+    std::atomic<bool> stop{false};
+    std::vector<long long> reads(readers, 0);
+    std::vector<std::thread> threads;
+    for (int r = 0; r < readers; ++r) {
+        threads.emplace_back([&, r]() {
+            reads[r] = read_frames(db, stop);
+        });
+    }
+    for (long long t = 2; t < 20'000; ++t) {
+        publish_frame(db, 256, t);
+    }
+    stop.store(true);
+    for (auto &thread : threads) {
+        thread.join();
+    }
+
+    REQUIRE(db.dropped_frames() == 0);
+    for (int r = 0; r < readers; ++r) {
+        REQUIRE(reads[r] >= 0);
+    }
+}
+
+TEST_CASE("DrawBuffer throughput with concurrent readers", "[!benchmark]") {
+    struct Case {
+        int readers;
+        const char *publish;
+        const char *read;
+    };
+    const Case cases[] = {
+        {0, "publish 1k particles, 0 readers", "begin/end read, alone"},
+        {1, "publish 1k particles, 1 reader", "begin/end read, 1 other"},
+        {4, "publish 1k particles, 4 readers", "begin/end read, 4 others"},
+        {8, "publish 1k particles, 8 readers", "begin/end read, 8 others"},
+    };
+    for (const Case &c : cases) {
+        const int readers = c.readers;
+        mailbox::render::DrawBuffer db(
+            mailbox::render::DrawBuffer::slots_for_readers(readers));
+        publish_frame(db, 2048, 1);
+        std::atomic<bool> stop{false};
+        std::vector<std::thread> threads;
+        for (int r = 0; r < readers; ++r) {
+            threads.emplace_back([&]() {
+                read_frames(db, stop);
+            });
+        }
+
+        long long stamp = 1;
+        BENCHMARK(c.publish) {
+            publish_frame(db, 2048, ++stamp);
+        };
+        BENCHMARK(c.read) {
+            auto v = db.begin_read();
+            db.end_read(v);
+            return v.t1;
+        };
+
+        stop.store(true);
+        for (auto &thread : threads) {
+            thread.join();
+        }
+        REQUIRE(db.dropped_frames() == 0);
+    }
+}
+
+TEST_CASE("PackedPositions round-trip within one step", "[mailboxes]") {
+    const float xs[] = {0.f, 123.4f, 800.f, -5.f, 900.f, NAN};
+    const float ys[] = {0.f, 456.7f, 600.f, 10.f, -1.f, 3.f};
+    mailbox::render::PackedPositions packed;
+    packed.pack(xs, ys, 6, 800.f, 600.f);
+    REQUIRE(packed.xy.size() == 12);
+
+    std::vector<float> out;
+    packed.unpack(out);
+    REQUIRE(out.size() == 12);
+    const float step_x = 800.f / mailbox::render::PackedPositions::STEPS;
+    const float step_y = 600.f / mailbox::render::PackedPositions::STEPS;
+    for (int i = 0; i < 3; ++i) {
+        REQUIRE(out[i * 2] == Catch::Approx(xs[i]).margin(step_x));
+        REQUIRE(out[i * 2 + 1] == Catch::Approx(ys[i]).margin(step_y));
+    }
+    // Out of bounds clamps to the edges, non-finite lands at 0
+    REQUIRE(out[6] == 0.f);
+    REQUIRE(out[8] == Catch::Approx(800.f));
+    REQUIRE(out[9] == 0.f);
+    REQUIRE(out[10] == 0.f);
+
+    mailbox::render::DrawBuffer db;
+    db.begin_write_pos(0);
+    db.begin_write_packed() = packed;
+    db.publish(5);
+    auto v = db.begin_read();
+    REQUIRE(v.curr->empty());
+    REQUIRE(v.curr_packed != nullptr);
+    REQUIRE(v.curr_packed->xy == packed.xy);
+    db.end_read(v);
+}
+
 TEST_CASE("Command queue push/drain", "[mailboxes]") {
     mailbox::command::Queue q;
     q.push(mailbox::command::Pause{});
@@ -77,6 +274,40 @@ TEST_CASE("Command queue push/drain", "[mailboxes]") {
     REQUIRE(std::holds_alternative<mailbox::command::Resume>(cmds[1]));
 }
 
+TEST_CASE("Mailboxes report the memory they hold", "[mailboxes]") {
+    mailbox::DataSnapshot<mailbox::ClusterSnapshot> clusters;
+    const auto empty = clusters.memory_usage();
+    REQUIRE(empty.used_bytes ==
+            2 * (long long)sizeof(mailbox::ClusterSnapshot));
+
+    mailbox::ClusterSnapshot snapshot;
+    snapshot.sizes.assign(1000, 3);
+    snapshot.centroid_x.assign(1000, 0.f);
+    snapshot.centroid_y.assign(1000, 0.f);
+    clusters.publish(snapshot);
+    REQUIRE(clusters.memory_usage().used_bytes ==
+            empty.used_bytes + 1000 * 3 * 4);
+
+    mailbox::render::DrawBuffer db;
+    const auto before = db.memory_usage();
+    db.begin_write_pos(2000);
+    db.begin_write_vel(2000);
+    db.begin_write_grid(10, 10, 1000, 4.f, 40.f, 40.f);
+    db.publish(1);
+    const auto after = db.memory_usage();
+    // positions, velocities, indices, and 6 per-cell arrays of 4 or 8 bytes
+    REQUIRE(after.used_bytes - before.used_bytes >=
+            2000 * 4 * 2 + 1000 * 4 + 100 * 4 * 4 + 100 * 8 * 2);
+
+    mailbox::command::Queue q;
+    REQUIRE(q.memory_usage().used_bytes == 0);
+    q.push(mailbox::command::Pause{});
+    REQUIRE(q.memory_usage().used_bytes ==
+            (long long)sizeof(mailbox::command::Command));
+    q.drain();
+    REQUIRE(q.memory_usage().reserved_bytes == 0);
+}
+
 // Test case to verify compile-time type constraints
 // This test demonstrates that DataSnapshot only accepts valid snapshot types
 TEST_CASE("DataSnapshot type constraints", "[mailboxes]") {
@@ -0,0 +1,162 @@
+#include <catch_amalgamated.hpp>
+
+#include <cstring>
+#include <string>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "metrics/metrics_server.hpp"
+#include "metrics/prometheus.hpp"
+#include "utility/exceptions.hpp"
+
+using namespace metrics;
+
+namespace {
+
+/**
+ * @brief Sends a raw request and returns the whole response
+ */
+std::string request(int fd, const std::string &text) {
+    REQUIRE(::send(fd, text.data(), text.size(), 0) ==
+            (ssize_t)text.size());
+    std::string out;
+    char buffer[4096];
+    ssize_t got = 0;
+    while ((got = ::recv(fd, buffer, sizeof(buffer), 0)) > 0) {
+        out.append(buffer, (size_t)got);
+    }
+    ::close(fd);
+    return out;
+}
+
+int connect_tcp(int port) {
+    const int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons((uint16_t)port);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    REQUIRE(::connect(fd, (const sockaddr *)&addr, sizeof(addr)) == 0);
+    return fd;
+}
+
+int connect_unix(const std::string &path) {
+    const int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    std::strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path) - 1);
+    REQUIRE(::connect(fd, (const sockaddr *)&addr, sizeof(addr)) == 0);
+    return fd;
+}
+
+bool contains(const std::string &text, const std::string &part) {
+    return text.find(part) != std::string::npos;
+}
+
+} // namespace
+
+TEST_CASE("Prometheus text covers stats and memory", "[metrics]") {
+    mailbox::SimulationStatsSnapshot stats = {};
+    stats.effective_tps = 240;
+    stats.particles = 5000;
+    stats.groups = 4;
+    stats.sim_threads = 8;
+    stats.num_steps = 1234;
+    stats.last_step_ns = 2'000'000;
+    stats.published_ns = 10'000'000'000;
+    stats.step_latency = {1234, 3'000'000, 4'500'000, 5'000'000, 9'000'000};
+    stats.missed_deadlines = 3;
+    mailbox::MemorySnapshot memory;
+    memory.world = {1000, 4096};
+    memory.draw_buffer = {2048, 2048};
+
+    const std::string text =
+        prometheus_text(stats, memory, 10'500'000'000, 7);
+    REQUIRE(contains(text, "# TYPE particles_tps gauge\nparticles_tps 240\n"));
+    REQUIRE(contains(text, "# TYPE particles_steps_total counter\n"
+                           "particles_steps_total 1234\n"));
+    REQUIRE(contains(text, "particles_particles 5000\n"));
+    REQUIRE(contains(text, "particles_groups 4\n"));
+    REQUIRE(contains(text, "particles_sim_threads 8\n"));
+    REQUIRE(contains(text, "particles_last_step_seconds 0.002\n"));
+    REQUIRE(contains(text, "particles_step_seconds{quantile=\"0.5\"} 0.003\n"));
+    REQUIRE(
+        contains(text, "particles_step_seconds{quantile=\"0.99\"} 0.005\n"));
+    REQUIRE(contains(text, "particles_step_seconds{quantile=\"1\"} 0.009\n"));
+    REQUIRE(contains(text, "particles_missed_deadlines_total 3\n"));
+    REQUIRE(contains(text, "particles_stats_age_seconds 0.5\n"));
+    REQUIRE(contains(
+        text, "particles_memory_used_bytes{subsystem=\"world\"} 1000\n"));
+    REQUIRE(contains(
+        text, "particles_memory_reserved_bytes{subsystem=\"world\"} 4096\n"));
+    REQUIRE(contains(text, "particles_metrics_scrapes_total 7\n"));
+    REQUIRE(text.back() == '\n');
+}
+
+TEST_CASE("Metrics server answers scrapes on localhost", "[metrics]") {
+    MetricsServer server("0", [](long long scrapes) {
+        return "scrape " + std::to_string(scrapes) + "\n";
+    });
+    REQUIRE(server.port() > 0);
+
+    const std::string ok = request(connect_tcp(server.port()),
+                                   "GET /metrics HTTP/1.1\r\n"
+                                   "Host: localhost\r\n\r\n");
+    REQUIRE(ok.rfind("HTTP/1.1 200 OK\r\n", 0) == 0);
+    REQUIRE(contains(ok, "Content-Type: text/plain; version=0.0.4"));
+    REQUIRE(contains(ok, "Content-Length: 9\r\n"));
+    REQUIRE(contains(ok, "\r\n\r\nscrape 1\n"));
+
+    const std::string again = request(connect_tcp(server.port()),
+                                      "GET /metrics?x=1 HTTP/1.0\r\n\r\n");
+    REQUIRE(contains(again, "scrape 2\n"));
+    REQUIRE(server.scrapes() == 2);
+
+    const std::string missing =
+        request(connect_tcp(server.port()), "GET / HTTP/1.1\r\n\r\n");
+    REQUIRE(missing.rfind("HTTP/1.1 404", 0) == 0);
+    const std::string post =
+        request(connect_tcp(server.port()), "POST /metrics HTTP/1.1\r\n\r\n");
+    REQUIRE(post.rfind("HTTP/1.1 405", 0) == 0);
+    const std::string head =
+        request(connect_tcp(server.port()), "HEAD /metrics HTTP/1.1\r\n\r\n");
+    REQUIRE(head.rfind("HTTP/1.1 200 OK", 0) == 0);
+    REQUIRE(head.size() == head.find("\r\n\r\n") + 4);
+    REQUIRE(server.scrapes() == 3);
+}
+
+TEST_CASE("Metrics server listens on a Unix socket", "[metrics]") {
+    const std::string path =
+        "/tmp/particles_metrics_" + std::to_string((long long)getpid());
+    {
+        MetricsServer server("unix:" + path,
+                             [](long long) { return std::string("up 1\n"); });
+        REQUIRE(server.port() == 0);
+        REQUIRE(access(path.c_str(), F_OK) == 0);
+        const std::string ok =
+            request(connect_unix(path), "GET /metrics HTTP/1.1\r\n\r\n");
+        REQUIRE(contains(ok, "\r\n\r\nup 1\n"));
+
+        // A client that never finishes its request is dropped after the
+        // client timeout instead of stalling the server
+        const int idle = connect_unix(path);
+        const std::string next =
+            request(connect_unix(path), "GET /metrics HTTP/1.1\r\n\r\n");
+        REQUIRE(contains(next, "up 1\n"));
+        ::close(idle);
+    }
+    REQUIRE(access(path.c_str(), F_OK) != 0);
+}
+
+TEST_CASE("Metrics server rejects bad addresses", "[metrics]") {
+    auto render = [](long long) { return std::string(); };
+    REQUIRE_THROWS_AS(MetricsServer("abc", render), particles::ConfigError);
+    REQUIRE_THROWS_AS(MetricsServer("70000", render), particles::ConfigError);
+    REQUIRE_THROWS_AS(MetricsServer("unix:", render), particles::ConfigError);
+    REQUIRE_THROWS_AS(MetricsServer("unix:/nonexistent/dir/metrics.sock",
+                                    render),
+                      particles::IOError);
+}
@@ -3,6 +3,7 @@
 #include "simulation/multicore.hpp"
 #include "utility/exceptions.hpp"
 #include <atomic>
+#include <cmath>
 
 TEST_CASE("SimulationThreadPool parallel_for_n sums correctly", "[multicore]") {
     SimulationThreadPool pool(std::max(1, compute_sim_threads()));
@@ -22,6 +23,45 @@ TEST_CASE("SimulationThreadPool parallel_for_n sums correctly", "[multicore]") {
     REQUIRE(sum.load() == expected);
 }
 
+TEST_CASE("SimulationThreadPool parallel_reduce_n ignores the thread count",
+          "[multicore]") {
+    // Float sums round differently when regrouped, so equality across thread
+    // counts shows the partials are always combined the same way
+    const int N = 50'000;
+    auto fn = [](int start, int end, float &partial) {
+        for (int i = start; i < end; ++i) {
+            partial += 1.f / (float)(i + 1);
+        }
+    };
+    auto combine = [](float &into, const float &from) {
+        into += from;
+    };
+
+    const float serial = reduce_chunks(0.f, fn, combine, N, 1000,
+                                       [](auto &&kernel, int chunks) {
+                                           kernel(0, chunks);
+                                       });
+    for (int threads : {1, 2, 3, 4}) {
+        SimulationThreadPool pool(threads);
+        REQUIRE(pool.parallel_reduce_n(0.f, fn, combine, N, 1000) == serial);
+    }
+    REQUIRE(serial == Catch::Approx(std::log((double)N) + 0.5772).margin(1e-3));
+
+    SimulationThreadPool pool(2);
+    REQUIRE(pool.parallel_reduce_n(7.f, fn, combine, 0) == 7.f);
+    // A partial chunk at the end still covers every item
+    long long items = pool.parallel_reduce_n(
+        0LL,
+        [](int start, int end, long long &partial) {
+            partial += end - start;
+        },
+        [](long long &into, const long long &from) {
+            into += from;
+        },
+        10'001, 100);
+    REQUIRE(items == 10'001);
+}
+
 TEST_CASE("SimulationThreadPool thread count variations", "[multicore]") {
     // Test with different thread counts
     for (int threads : {1, 2, 4}) {
@@ -0,0 +1,259 @@
+#include <catch_amalgamated.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+#include "render/particle_batch.hpp"
+
+#include "helpers.hpp"
+
+using test_helpers::make_world;
+
+TEST_CASE("ParticleBatch transforms and culls positions", "[particle_batch]") {
+    auto world = make_world({5}, {{10, 20, 30, 255}}, {true});
+    // Last two fall outside the bounds (x >= w - 1, y < 0)
+    std::vector<float> pos = {10.f, 10.f, 0.f,  0.f,  50.f,
+                              98.f, 99.f, 10.f, 10.f, -1.f};
+    ParticleBatch batch;
+    batch.build_positions(world, nullptr, pos, 1.f,
+                          {5.f, 7.f, 2.f, 100.f, 100.f});
+
+    REQUIRE(batch.visible_count() == 3);
+    const auto &screen = batch.screen_positions();
+    REQUIRE(screen[0] == Catch::Approx(25.f));
+    REQUIRE(screen[1] == Catch::Approx(27.f));
+    REQUIRE(screen[2] == Catch::Approx(5.f));
+    REQUIRE(screen[3] == Catch::Approx(7.f));
+    REQUIRE(screen[4] == Catch::Approx(105.f));
+    REQUIRE(screen[5] == Catch::Approx(203.f));
+    REQUIRE(batch.spans().size() == 1);
+    REQUIRE(batch.spans()[0].begin == 0);
+    REQUIRE(batch.spans()[0].end == 3);
+}
+
+TEST_CASE("ParticleBatch interpolates once per particle", "[particle_batch]") {
+    auto world = make_world({3}, {{255, 255, 255, 255}}, {true});
+    std::vector<float> prev = {0.f, 0.f, 10.f, 10.f, 20.f, 40.f};
+    std::vector<float> curr = {10.f, 20.f, 30.f, 10.f, 20.f, 0.f};
+    ParticleBatch batch;
+
+    SECTION("Halfway between frames") {
+        batch.build_positions(world, &prev, curr, 0.5f,
+                              {0.f, 0.f, 1.f, 100.f, 100.f});
+        const auto &screen = batch.screen_positions();
+        REQUIRE(batch.visible_count() == 3);
+        REQUIRE(screen[0] == Catch::Approx(5.f));
+        REQUIRE(screen[1] == Catch::Approx(10.f));
+        REQUIRE(screen[2] == Catch::Approx(20.f));
+        REQUIRE(screen[3] == Catch::Approx(10.f));
+        REQUIRE(screen[4] == Catch::Approx(20.f));
+        REQUIRE(screen[5] == Catch::Approx(20.f));
+    }
+
+    SECTION("Mismatched previous frame falls back to current") {
+        std::vector<float> short_prev = {0.f, 0.f};
+        batch.build_positions(world, &short_prev, curr, 0.5f,
+                              {0.f, 0.f, 1.f, 100.f, 100.f});
+        REQUIRE(batch.screen_positions()[0] == Catch::Approx(10.f));
+        REQUIRE(batch.screen_positions()[1] == Catch::Approx(20.f));
+    }
+}
+
+TEST_CASE("ParticleBatch skips disabled groups and keeps group order",
+          "[particle_batch]") {
+    auto world = make_world(
+        {2, 3, 1}, {{255, 0, 0, 255}, {0, 255, 0, 255}, {0, 0, 255, 255}},
+        {true, false, true});
+    std::vector<float> pos(12, 5.f);
+    ParticleBatch batch;
+    batch.build_positions(world, nullptr, pos, 1.f,
+                          {0.f, 0.f, 1.f, 100.f, 100.f});
+
+    REQUIRE(batch.visible_count() == 3);
+    REQUIRE(batch.spans().size() == 2);
+    REQUIRE(batch.spans()[0].group == 0);
+    REQUIRE(batch.spans()[0].end - batch.spans()[0].begin == 2);
+    REQUIRE(batch.spans()[1].group == 2);
+    REQUIRE(batch.spans()[1].end - batch.spans()[1].begin == 1);
+}
+
+TEST_CASE("ParticleBatch builds interleaved quads", "[particle_batch]") {
+    auto world = make_world({1, 1}, {{100, 200, 250, 128}, {10, 20, 30, 255}},
+                            {true, true});
+    std::vector<float> pos = {10.f, 20.f, 40.f, 50.f};
+    ParticleBatch batch;
+    batch.build_positions(world, nullptr, pos, 1.f,
+                          {0.f, 0.f, 1.f, 100.f, 100.f});
+    std::vector<ParticleVertex> vertices;
+
+    SECTION("Core quads keep the group color") {
+        batch.build_quads(world, 2.f, std::nullopt, vertices);
+        REQUIRE(vertices.size() == 8);
+        // top-left, bottom-left, bottom-right, top-right
+        REQUIRE(vertices[0].x == 8.f);
+        REQUIRE(vertices[0].y == 18.f);
+        REQUIRE(vertices[0].u == 0.f);
+        REQUIRE(vertices[0].v == 0.f);
+        REQUIRE(vertices[1].x == 8.f);
+        REQUIRE(vertices[1].y == 22.f);
+        REQUIRE(vertices[1].v == 1.f);
+        REQUIRE(vertices[2].x == 12.f);
+        REQUIRE(vertices[2].y == 22.f);
+        REQUIRE(vertices[2].u == 1.f);
+        REQUIRE(vertices[3].x == 12.f);
+        REQUIRE(vertices[3].y == 18.f);
+        REQUIRE(vertices[0].r == 100);
+        REQUIRE(vertices[0].a == 128);
+        REQUIRE(vertices[4].r == 10);
+        REQUIRE(vertices[4].x == 38.f);
+    }
+
+    SECTION("Glow quads are tinted and opaque") {
+        batch.build_quads(world, 10.f, 2.f, vertices);
+        REQUIRE(vertices.size() == 8);
+        REQUIRE(vertices[0].r == 200);
+        REQUIRE(vertices[0].g == 255);
+        REQUIRE(vertices[0].b == 255);
+        REQUIRE(vertices[0].a == 255);
+        REQUIRE(vertices[0].x == 0.f);
+        REQUIRE(vertices[2].y == 30.f);
+    }
+}
+
+TEST_CASE("ParticleBatch SIMD path matches scalar reference",
+          "[particle_batch]") {
+    // Odd count exercises the scalar tail after the vector loop
+    const int N = 1001;
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<float> dist(-20.f, 220.f);
+    std::vector<float> prev(N * 2), curr(N * 2);
+    for (int i = 0; i < N * 2; ++i) {
+        prev[i] = dist(rng);
+        curr[i] = dist(rng);
+    }
+    auto world = make_world({N}, {{255, 255, 255, 255}}, {true});
+    const ParticleBatch::Transform transform{3.f, -4.f, 1.5f, 200.f, 200.f};
+    const float alpha = 0.3f;
+
+    ParticleBatch batch;
+    batch.build_positions(world, &prev, curr, alpha, transform);
+
+    std::vector<float> expected;
+    for (int i = 0; i < N; ++i) {
+        float x = prev[i * 2] + (curr[i * 2] - prev[i * 2]) * alpha;
+        float y = prev[i * 2 + 1] + (curr[i * 2 + 1] - prev[i * 2 + 1]) * alpha;
+        if (x < 0 || y < 0 || x >= 199.f || y >= 199.f)
+            continue;
+        expected.push_back(x * 1.5f + 3.f);
+        expected.push_back(y * 1.5f - 4.f);
+    }
+
+    const auto &screen = batch.screen_positions();
+    REQUIRE(screen.size() == expected.size());
+    for (size_t i = 0; i < expected.size(); ++i) {
+        REQUIRE(screen[i] == Catch::Approx(expected[i]).margin(1e-3));
+    }
+}
+
+namespace {
+
+/**
+ * @brief Builds a grid frame with CSR cells for the given positions
+ */
+mailbox::render::GridFrame make_grid(const std::vector<float> &pos,
+                                     float cell, float width, float height) {
+    mailbox::render::GridFrame grid;
+    const int N = (int)(pos.size() / 2);
+    grid.cell = cell;
+    grid.width = width;
+    grid.height = height;
+    grid.resize((int)std::ceil(width / cell), (int)std::ceil(height / cell),
+                N);
+    std::vector<int> cell_of(N);
+    for (int i = 0; i < N; ++i) {
+        const int cx =
+            std::clamp((int)std::floor(pos[i * 2] / cell), 0, grid.cols - 1);
+        const int cy = std::clamp((int)std::floor(pos[i * 2 + 1] / cell), 0,
+                                  grid.rows - 1);
+        cell_of[i] = cy * grid.cols + cx;
+        ++grid.count[cell_of[i]];
+    }
+    int running = 0;
+    for (size_t ci = 0; ci < grid.start.size(); ++ci) {
+        grid.start[ci] = running;
+        running += grid.count[ci];
+    }
+    std::vector<int> cursor = grid.start;
+    for (int i = 0; i < N; ++i) {
+        grid.indices[cursor[cell_of[i]]++] = i;
+    }
+    grid.indexed = true;
+    return grid;
+}
+
+} // namespace
+
+TEST_CASE("ParticleBatch culls by grid cell", "[particle_batch]") {
+    const int N = 4000;
+    std::mt19937 rng(11);
+    std::uniform_real_distribution<float> dist(0.f, 999.f);
+    std::vector<float> pos(N * 2);
+    for (float &p : pos) {
+        p = dist(rng);
+    }
+    auto world = make_world({N / 2, N / 2},
+                            {{255, 0, 0, 255}, {0, 0, 255, 255}},
+                            {true, true});
+    auto grid = make_grid(pos, 50.f, 1000.f, 1000.f);
+    const ParticleBatch::Transform transform{0.f, 0.f, 1.f, 1000.f, 1000.f};
+    const ParticleBatch::ViewRect view{120.f, 300.f, 380.f, 520.f};
+
+    ParticleBatch culled;
+    REQUIRE(culled.build_positions_culled(world, nullptr, pos, 1.f, transform,
+                                          grid, view));
+
+    // Everything inside the view is kept, nothing outside the touched cells
+    int inside = 0;
+    for (int i = 0; i < N; ++i) {
+        const float x = pos[i * 2], y = pos[i * 2 + 1];
+        if (x >= view.x0 && x <= view.x1 && y >= view.y0 && y <= view.y1) {
+            ++inside;
+        }
+    }
+    REQUIRE(culled.visible_count() >= inside);
+    const auto &screen = culled.screen_positions();
+    for (int k = 0; k < culled.visible_count(); ++k) {
+        REQUIRE(screen[k * 2] >= 100.f);
+        REQUIRE(screen[k * 2] < 400.f);
+        REQUIRE(screen[k * 2 + 1] >= 300.f);
+        REQUIRE(screen[k * 2 + 1] < 550.f);
+    }
+    REQUIRE(culled.spans().size() == 2);
+    REQUIRE(culled.spans()[0].group == 0);
+    REQUIRE(culled.spans()[1].group == 1);
+
+    SECTION("Mostly visible views use the linear pass") {
+        ParticleBatch full;
+        REQUIRE_FALSE(full.build_positions_culled(
+            world, nullptr, pos, 1.f, transform, grid,
+            {0.f, 0.f, 1000.f, 1000.f}));
+        REQUIRE(full.visible_count() == N);
+    }
+
+    SECTION("Stale grids fall back to the linear pass") {
+        grid.indices.pop_back();
+        ParticleBatch fallback;
+        REQUIRE_FALSE(fallback.build_positions_culled(
+            world, nullptr, pos, 1.f, transform, grid, view));
+        REQUIRE(fallback.visible_count() == N);
+    }
+
+    SECTION("Views outside the world draw nothing") {
+        ParticleBatch empty;
+        REQUIRE(empty.build_positions_culled(world, nullptr, pos, 1.f,
+                                             transform, grid,
+                                             {-500.f, -500.f, -10.f, -10.f}));
+        REQUIRE(empty.visible_count() == 0);
+    }
+}
@@ -0,0 +1,81 @@
+#include <catch_amalgamated.hpp>
+
+#include <vector>
+
+#include "render/position_decoder.hpp"
+
+namespace {
+
+mailbox::render::PackedPositions pack(const std::vector<float> &xs,
+                                      const std::vector<float> &ys) {
+    mailbox::render::PackedPositions packed;
+    packed.pack(xs.data(), ys.data(), (int)xs.size(), 400.f, 300.f);
+    return packed;
+}
+
+} // namespace
+
+TEST_CASE("PositionDecoder leaves float views alone", "[position_decoder]") {
+    std::vector<float> pos = {1.f, 2.f, 3.f, 4.f};
+    mailbox::render::PackedPositions empty;
+    mailbox::render::ReadView view;
+    view.prev = &pos;
+    view.curr = &pos;
+    view.prev_packed = &empty;
+    view.curr_packed = &empty;
+
+    PositionDecoder decoder;
+    REQUIRE_FALSE(decoder.decode(view));
+    REQUIRE(view.curr == &pos);
+    REQUIRE(view.prev == &pos);
+}
+
+TEST_CASE("PositionDecoder unpacks packed frames once",
+          "[position_decoder]") {
+    const float step_x = 400.f / mailbox::render::PackedPositions::STEPS;
+    const float step_y = 300.f / mailbox::render::PackedPositions::STEPS;
+    auto frame0 = pack({10.f, 399.f}, {20.f, 0.f});
+    auto frame1 = pack({11.f, 398.f}, {21.f, 1.f});
+    auto frame2 = pack({12.f, 397.f}, {22.f, 2.f});
+    std::vector<float> floats = {9.f, 19.f, 400.f, 0.f};
+
+    PositionDecoder decoder;
+
+    // Right after packing is turned on, prev still holds floats
+    mailbox::render::PackedPositions none;
+    mailbox::render::ReadView view;
+    view.prev = &floats;
+    view.curr = &floats;
+    view.prev_packed = &none;
+    view.curr_packed = &frame0;
+    view.t0 = 1;
+    view.t1 = 2;
+    REQUIRE(decoder.decode(view));
+    REQUIRE(view.prev == &floats);
+    REQUIRE(view.curr->size() == 4);
+    REQUIRE((*view.curr)[0] == Catch::Approx(10.f).margin(step_x));
+    REQUIRE((*view.curr)[1] == Catch::Approx(20.f).margin(step_y));
+    REQUIRE((*view.curr)[2] == Catch::Approx(399.f).margin(step_x));
+
+    // The next frame reuses the decoded current frame as prev
+    view.prev = &floats;
+    view.prev_packed = &frame0;
+    view.curr_packed = &frame1;
+    view.t0 = 2;
+    view.t1 = 3;
+    REQUIRE(decoder.decode(view));
+    REQUIRE(view.prev != &floats);
+    REQUIRE((*view.prev)[0] == Catch::Approx(10.f).margin(step_x));
+    REQUIRE((*view.curr)[0] == Catch::Approx(11.f).margin(step_x));
+    REQUIRE((*view.curr)[3] == Catch::Approx(1.f).margin(step_y));
+
+    // A skipped frame decodes both sides
+    view.prev = &floats;
+    view.prev_packed = &frame2;
+    view.curr_packed = &frame2;
+    view.t0 = 5;
+    view.t1 = 5;
+    REQUIRE(decoder.decode(view));
+    REQUIRE((*view.prev)[0] == Catch::Approx(12.f).margin(step_x));
+    REQUIRE((*view.curr)[0] == Catch::Approx(12.f).margin(step_x));
+}
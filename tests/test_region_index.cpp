@@ -0,0 +1,94 @@
+#include <catch_amalgamated.hpp>
+
+#include <algorithm>
+#include <random>
+
+#include "render/region_index.hpp"
+
+namespace {
+
+std::vector<int> query(const RegionIndex &index,
+                       const RegionIndex::Bounds &bounds) {
+    std::vector<int> out;
+    index.for_each_candidate(bounds, [&](int i) {
+        out.push_back(i);
+    });
+    std::sort(out.begin(), out.end());
+    return out;
+}
+
+} // namespace
+
+TEST_CASE("RegionIndex returns every particle inside a region",
+          "[region_index]") {
+    const int N = 5000;
+    std::mt19937 rng(3);
+    std::uniform_real_distribution<float> dist(0.f, 500.f);
+    std::vector<float> pos(N * 2);
+    for (float &p : pos) {
+        p = dist(rng);
+    }
+    mailbox::render::ReadView view;
+    view.curr = &pos;
+    view.t1 = 1;
+
+    RegionIndex index(25.f);
+    REQUIRE(index.update(view, false, 500.f, 500.f));
+    REQUIRE(index.size() == N);
+    REQUIRE(index.margin() == 0.f);
+
+    const RegionIndex::Bounds bounds{110.f, 40.f, 180.f, 95.f};
+    const auto candidates = query(index, bounds);
+    // Candidates come from the touched cells only, so far fewer than N
+    REQUIRE(candidates.size() < (size_t)N / 10);
+    for (int i = 0; i < N; ++i) {
+        const float x = pos[i * 2], y = pos[i * 2 + 1];
+        if (x >= bounds.x0 && x < bounds.x1 && y >= bounds.y0 &&
+            y < bounds.y1) {
+            REQUIRE(std::binary_search(candidates.begin(), candidates.end(),
+                                       i));
+        }
+    }
+}
+
+TEST_CASE("RegionIndex rebuilds only for new frames", "[region_index]") {
+    std::vector<float> pos = {10.f, 10.f, 90.f, 90.f};
+    mailbox::render::ReadView view;
+    view.curr = &pos;
+    view.t1 = 5;
+
+    RegionIndex index(10.f);
+    REQUIRE(index.update(view, false, 100.f, 100.f));
+    REQUIRE_FALSE(index.update(view, false, 100.f, 100.f));
+
+    pos[0] = 50.f;
+    view.t1 = 6;
+    REQUIRE(index.update(view, false, 100.f, 100.f));
+    REQUIRE(query(index, {45.f, 5.f, 55.f, 15.f}) == std::vector<int>{0});
+    REQUIRE(query(index, {5.f, 5.f, 15.f, 15.f}).empty());
+}
+
+TEST_CASE("RegionIndex pads queries by the interpolation distance",
+          "[region_index]") {
+    // Particle 0 moves 40 units between frames; halfway it sits at x=30
+    std::vector<float> prev = {10.f, 50.f, 80.f, 80.f};
+    std::vector<float> curr = {50.f, 50.f, 80.f, 81.f};
+    mailbox::render::ReadView view;
+    view.prev = &prev;
+    view.curr = &curr;
+    view.t0 = 1;
+    view.t1 = 2;
+
+    RegionIndex index(10.f);
+    index.update(view, true, 100.f, 100.f);
+    REQUIRE(index.margin() == Catch::Approx(40.f));
+    const auto candidates = query(index, {25.f, 45.f, 35.f, 55.f});
+    REQUIRE(std::find(candidates.begin(), candidates.end(), 0) !=
+            candidates.end());
+
+    SECTION("Without interpolation there is no padding") {
+        REQUIRE(index.update(view, false, 100.f, 100.f));
+        REQUIRE(index.margin() == 0.f);
+        REQUIRE(query(index, {25.f, 45.f, 35.f, 55.f}).empty());
+    }
+}
@@ -0,0 +1,177 @@
+#include <catch_amalgamated.hpp>
+
+#include <vector>
+
+#include "search/rule_search.hpp"
+#include "simulation/fitness.hpp"
+#include "utility/exceptions.hpp"
+
+#include "helpers.hpp"
+
+namespace {
+
+mailbox::SimulationConfigSnapshot search_config() {
+    return test_helpers::stepping_config(320.0f, 240.0f, 0.3f);
+}
+
+mailbox::command::SeedSpec search_seed() {
+    mailbox::command::SeedSpec seed;
+    seed.add_group(150, RED, 40.f * 40.f, true);
+    seed.add_group(150, GREEN, 40.f * 40.f, true);
+    seed.add_group(100, BLUE, 30.f * 30.f, true);
+    return seed;
+}
+
+RuleSearchOptions small_options() {
+    RuleSearchOptions options;
+    options.population = 8;
+    options.steps = 24;
+    options.elite = 2;
+    options.seed = 42;
+    options.threads = 2;
+    return options;
+}
+
+void fill_world(World &w, const std::vector<float> &xy) {
+    w.add_group((int)xy.size() / 2, RED);
+    w.finalize_groups();
+    for (size_t i = 0; i < xy.size() / 2; ++i) {
+        w.set_px((int)i, xy[i * 2 + 0]);
+        w.set_py((int)i, xy[i * 2 + 1]);
+    }
+}
+
+} // namespace
+
+TEST_CASE("DensityHistogram measures clustering and persistence",
+          "[rule_search]") {
+    const int bins = DensityHistogram::BINS;
+    std::vector<float> spread;
+    for (int y = 0; y < bins; ++y) {
+        for (int x = 0; x < bins; ++x) {
+            spread.push_back(x * 10.f + 5.f);
+            spread.push_back(y * 10.f + 5.f);
+        }
+    }
+    std::vector<float> clumped(spread.size());
+    for (size_t i = 0; i < clumped.size(); i += 2) {
+        clumped[i] = 52.f;
+        clumped[i + 1] = 77.f;
+    }
+    std::vector<float> moved(spread.size());
+    for (size_t i = 0; i < moved.size(); i += 2) {
+        moved[i] = 252.f;
+        moved[i + 1] = 177.f;
+    }
+
+    World spread_world, clumped_world, moved_world;
+    fill_world(spread_world, spread);
+    fill_world(clumped_world, clumped);
+    fill_world(moved_world, moved);
+
+    const float side = bins * 10.f;
+    DensityHistogram uniform, clump, shifted;
+    uniform.sample(spread_world, side, side);
+    clump.sample(clumped_world, side, side);
+    shifted.sample(moved_world, side, side);
+
+    REQUIRE(uniform.total() == bins * bins);
+    REQUIRE(uniform.clustering() == Catch::Approx(0.f).margin(1e-6));
+    REQUIRE(clump.clustering() == Catch::Approx(1.f));
+    REQUIRE(clump.similarity(clump) == Catch::Approx(1.f));
+    REQUIRE(clump.similarity(shifted) == Catch::Approx(0.f).margin(1e-6));
+    // A featureless world has no structure to persist
+    REQUIRE(uniform.similarity(uniform) == 0.f);
+}
+
+TEST_CASE("mean_kinetic_energy averages 0.5 |v|^2", "[rule_search]") {
+    World w;
+    REQUIRE(mean_kinetic_energy(w) == 0.f);
+    fill_world(w, {1.f, 1.f, 2.f, 2.f});
+    w.set_vx(0, 3.f);
+    w.set_vy(0, 4.f);
+    REQUIRE(mean_kinetic_energy(w) == Catch::Approx(0.5f * 25.f / 2.f));
+}
+
+TEST_CASE("RuleSearch evolves reproducibly", "[rule_search]") {
+    const RuleSearchOptions options = small_options();
+    RuleSearch a(options, search_seed(), search_config());
+    RuleSearch b(options, search_seed(), search_config());
+
+    for (int g = 0; g < 3; ++g) {
+        a.evolve();
+        b.evolve();
+    }
+    a.evaluate();
+    b.evaluate();
+    REQUIRE(a.generation() == 3);
+
+    // Elites keep their score and are not simulated again
+    const int fresh = options.population - options.elite;
+    REQUIRE(a.evaluations() == options.population + 3 * fresh);
+
+    const auto &pa = a.population();
+    const auto &pb = b.population();
+    REQUIRE(pa.size() == (size_t)options.population);
+    for (size_t c = 0; c < pa.size(); ++c) {
+        REQUIRE(pa[c].evaluated);
+        REQUIRE(pa[c].rules == pb[c].rules);
+        REQUIRE(pa[c].score == pb[c].score);
+        REQUIRE(pa[c].rules.size() == 9);
+        for (float r : pa[c].rules) {
+            REQUIRE(r >= -options.rule_limit);
+            REQUIRE(r <= options.rule_limit);
+        }
+        if (c > 0) {
+            REQUIRE(pa[c - 1].score >= pa[c].score);
+        }
+    }
+
+    const mailbox::command::SeedSpec best = a.seed_of(pa[0]);
+    REQUIRE(best.rules == pa[0].rules);
+    REQUIRE(best.rng_seed == options.seed);
+    REQUIRE(best.sizes == search_seed().sizes);
+}
+
+TEST_CASE("RuleSearch keeps the base rules as a candidate",
+          "[rule_search]") {
+    mailbox::command::SeedSpec seed = search_seed();
+    seed.rules = {0.1f, 0.2f, 0.3f, 0.4f, 0.5f, 0.6f, 0.7f, 0.8f, 0.9f};
+    RuleSearch search(small_options(), seed, search_config());
+    REQUIRE(search.population()[0].rules == seed.rules);
+    REQUIRE_FALSE(search.population()[0].evaluated);
+}
+
+TEST_CASE("RuleSearch rejects invalid options", "[rule_search]") {
+    RuleSearchOptions options = small_options();
+    options.population = 1;
+    REQUIRE_THROWS_AS(RuleSearch(options, search_seed(), search_config()),
+                      particles::ConfigError);
+
+    options = small_options();
+    options.elite = options.population;
+    REQUIRE_THROWS_AS(RuleSearch(options, search_seed(), search_config()),
+                      particles::ConfigError);
+
+    REQUIRE_THROWS_AS(RuleSearch(small_options(), mailbox::command::SeedSpec{},
+                                 search_config()),
+                      particles::ConfigError);
+
+    mailbox::SimulationConfigSnapshot cfg = search_config();
+    cfg.bounds_height = 0.f;
+    REQUIRE_THROWS_AS(RuleSearch(small_options(), search_seed(), cfg),
+                      particles::ConfigError);
+}
+
+TEST_CASE("RuleSearch score favors clustered, persistent, moving worlds",
+          "[rule_search]") {
+    const FitnessWeights weights;
+    FitnessMetrics still;
+    FitnessMetrics lively;
+    lively.clustering = 0.4f;
+    lively.persistence = 0.8f;
+    lively.kinetic_energy = weights.energy_scale;
+    REQUIRE(RuleSearch::score(still, weights) == 0.f);
+    REQUIRE(RuleSearch::score(lively, weights) ==
+            Catch::Approx(0.4f + 0.5f * 0.8f + 0.5f * 0.5f));
+}
@@ -26,6 +26,8 @@ TEST_CASE("SaveManager - Basic functionality", "[json_manager]") {
         REQUIRE(data.sim_config.wall_repel == 86.0f);
         REQUIRE(data.sim_config.wall_strength == 0.129f);
         REQUIRE(data.sim_config.sim_threads == -1);
+        REQUIRE_FALSE(data.sim_config.force_table);
+        REQUIRE(data.sim_config.cluster_interval == 0);
 
         // Check render config defaults
         REQUIRE(data.render_config.interpolate == true);
@@ -54,9 +56,15 @@ TEST_CASE("SaveManager - Basic functionality", "[json_manager]") {
         // Modify some values to make them unique
         original_data.sim_config.viscosity = 0.5f;
         original_data.sim_config.wall_repel = 100.0f;
+        original_data.sim_config.force_table = true;
+        original_data.sim_config.cluster_interval = 30;
+        original_data.sim_config.cluster_distance = 12.5f;
         original_data.render_config.core_size = 2.0f;
         original_data.render_config.background_color = {255, 0, 0,
                                                         255}; // Red background
+        original_data.seed->rng_seed = 0xfeedface12345678ULL;
+        original_data.render_config.cull_cells = false;
+        original_data.render_config.lod_px_per_particle = 1.25f;
 
         // Save project
         REQUIRE_NOTHROW(manager.save_project(test_file, original_data));
@@ -68,14 +76,20 @@ TEST_CASE("SaveManager - Basic functionality", "[json_manager]") {
         // Verify loaded data matches original
         REQUIRE(loaded_data.sim_config.viscosity == 0.5f);
         REQUIRE(loaded_data.sim_config.wall_repel == 100.0f);
+        REQUIRE(loaded_data.sim_config.force_table);
+        REQUIRE(loaded_data.sim_config.cluster_interval == 30);
+        REQUIRE(loaded_data.sim_config.cluster_distance == 12.5f);
         REQUIRE(loaded_data.render_config.core_size == 2.0f);
         REQUIRE(loaded_data.render_config.background_color.r == 255);
         REQUIRE(loaded_data.render_config.background_color.g == 0);
         REQUIRE(loaded_data.render_config.background_color.b == 0);
         REQUIRE(loaded_data.render_config.background_color.a == 255);
+        REQUIRE(loaded_data.render_config.cull_cells == false);
+        REQUIRE(loaded_data.render_config.lod_px_per_particle == 1.25f);
 
         // Verify seed data
         REQUIRE(loaded_data.seed.has_value());
+        REQUIRE(loaded_data.seed->rng_seed == 0xfeedface12345678ULL);
         REQUIRE(loaded_data.seed->sizes.size() ==
                 original_data.seed->sizes.size());
         REQUIRE(loaded_data.seed->colors.size() ==
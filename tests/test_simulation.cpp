@@ -1,8 +1,13 @@
 #include <catch_amalgamated.hpp>
 
+#include "simulation/ensemble.hpp"
 #include "simulation/simulation.hpp"
 #include "utility/exceptions.hpp"
+#include <algorithm>
+#include <atomic>
 #include <chrono>
+#include <memory>
+#include <stdexcept>
 #include <thread>
 
 TEST_CASE("Simulation initialization", "[simulation]") {
@@ -756,11 +761,139 @@ TEST_CASE("Simulation draw report configuration", "[simulation]") {
     // Test draw data with grid enabled
     auto read_view = sim.begin_read_draw();
     REQUIRE(read_view.grid != nullptr);
+    // The published cells cover every particle exactly once
+    const auto &grid = *read_view.grid;
+    REQUIRE(grid.indexed);
+    REQUIRE(grid.indices.size() == 50);
+    std::vector<int> seen(50, 0);
+    int listed = 0;
+    for (size_t ci = 0; ci < grid.start.size(); ++ci) {
+        for (int k = grid.start[ci]; k < grid.start[ci] + grid.count[ci];
+             ++k) {
+            ++seen[grid.indices[k]];
+            ++listed;
+        }
+    }
+    REQUIRE(listed == 50);
+    REQUIRE(std::count(seen.begin(), seen.end(), 1) == 50);
     sim.end_read_draw(read_view);
 
     sim.end();
 }
 
+TEST_CASE("Simulation publishes cells only for the world they index",
+          "[simulation]") {
+    mailbox::SimulationConfigSnapshot cfg = {};
+    cfg.bounds_width = 1000.0f;
+    cfg.bounds_height = 800.0f;
+    cfg.time_scale = 1.0f;
+    cfg.viscosity = 0.1f;
+    cfg.sim_threads = 1;
+    cfg.draw_report.cells = true;
+
+    mailbox::command::SeedSpec seed;
+    seed.add_group(2000, RED, 40.f * 40.f, true);
+    seed.rng_seed = 1;
+
+    Simulation sim(cfg);
+    sim.begin();
+    sim.pause();
+
+    // Waits for the published frame to show num_steps and rng_seed
+    auto indexed_after = [&](long long num_steps, uint64_t rng_seed) {
+        for (int attempt = 0; attempt < 300; ++attempt) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            if (sim.get_stats().num_steps == num_steps &&
+                sim.get_world_snapshot().rng_seed == rng_seed) {
+                break;
+            }
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        auto view = sim.begin_read_draw();
+        const bool indexed = view.grid && view.grid->indexed;
+        sim.end_read_draw(view);
+        return indexed;
+    };
+
+    sim.push_command(mailbox::command::SeedWorld{seed});
+    REQUIRE_FALSE(indexed_after(0, 1));
+    sim.push_command(mailbox::command::OneStep{});
+    REQUIRE(indexed_after(1, 1));
+
+    // Same particle count, different positions: the old cells are stale
+    seed.rng_seed = 2;
+    sim.push_command(mailbox::command::SeedWorld{seed});
+    REQUIRE_FALSE(indexed_after(0, 2));
+    sim.push_command(mailbox::command::OneStep{});
+    REQUIRE(indexed_after(1, 2));
+
+    // So are they after a group edit
+    sim.push_command(mailbox::command::ResizeGroup{0, 2000});
+    REQUIRE_FALSE(indexed_after(0, 2));
+    sim.end();
+}
+
+TEST_CASE("Simulation publishes only the requested draw streams",
+          "[simulation]") {
+    mailbox::SimulationConfigSnapshot cfg;
+    cfg.bounds_width = 1000.0f;
+    cfg.bounds_height = 800.0f;
+    cfg.target_tps = 0;
+    cfg.time_scale = 1.0f;
+    cfg.viscosity = 0.1f;
+    cfg.sim_threads = 1;
+    cfg.draw_report = {false, false};
+
+    Simulation sim(cfg);
+    sim.begin();
+    mailbox::command::AddGroup add_cmd;
+    add_cmd.size = 50;
+    add_cmd.color = RED;
+    sim.push_command(add_cmd);
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+    // Positions as floats, no velocities or cells by default
+    auto view = sim.begin_read_draw();
+    REQUIRE(view.curr->size() == 100);
+    REQUIRE(view.curr_vel->empty());
+    REQUIRE(view.curr_packed->xy.empty());
+    REQUIRE_FALSE(view.grid->indexed);
+    REQUIRE(view.grid->indices.empty());
+    REQUIRE(view.grid->cols * view.grid->rows == 1);
+    sim.end_read_draw(view);
+
+    cfg.draw_report.velocities = true;
+    cfg.draw_report.packed_positions = true;
+    sim.update_config(cfg);
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+    view = sim.begin_read_draw();
+    REQUIRE(view.curr->empty());
+    REQUIRE(view.curr_vel->size() == 100);
+    REQUIRE(view.curr_packed->xy.size() == 100);
+    REQUIRE(view.curr_packed->width == 1000.f);
+    REQUIRE(view.curr_packed->height == 800.f);
+    std::vector<float> unpacked;
+    view.curr_packed->unpack(unpacked);
+    for (size_t b = 0; b < unpacked.size(); b += 2) {
+        REQUIRE(unpacked[b] >= 0.f);
+        REQUIRE(unpacked[b] <= 1000.f);
+        REQUIRE(unpacked[b + 1] <= 800.f);
+    }
+    sim.end_read_draw(view);
+
+    cfg.draw_report.cells = true;
+    sim.update_config(cfg);
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+    view = sim.begin_read_draw();
+    REQUIRE(view.grid->indexed);
+    REQUIRE(view.grid->indices.size() == 50);
+    sim.end_read_draw(view);
+
+    sim.end();
+}
+
 TEST_CASE("Simulation step count behavior during pause/resume",
           "[simulation]") {
     mailbox::SimulationConfigSnapshot cfg;
@@ -860,10 +993,15 @@ TEST_CASE("Simulation step count behavior during reset", "[simulation]") {
     auto stats_after_reset = sim.get_stats();
     REQUIRE(stats_after_reset.num_steps < steps_before_reset);
 
-    // Let it run for a bit more to ensure it continues counting
+    // Nothing was seeded, so the reset world is empty and the thread idles
+    // instead of counting steps over no particles
     std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    REQUIRE(sim.get_stats().particles == 0);
+    REQUIRE(sim.get_stats().num_steps == stats_after_reset.num_steps);
 
-    // Check that step count starts increasing again after reset
+    // Check that step count starts increasing again once there are particles
+    sim.push_command(add_cmd);
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
     auto stats_after_running = sim.get_stats();
     REQUIRE(stats_after_running.num_steps > 0);
 
@@ -933,3 +1071,778 @@ TEST_CASE("Simulation step count behavior with manual stepping",
 
     sim.end();
 }
+
+namespace {
+
+/**
+ * @brief Seeds a paused simulation and returns the published positions
+ */
+std::vector<float> seeded_positions(int threads, uint64_t rng_seed) {
+    mailbox::SimulationConfigSnapshot cfg = {};
+    cfg.bounds_width = 800.0f;
+    cfg.bounds_height = 600.0f;
+    cfg.time_scale = 1.0f;
+    cfg.viscosity = 0.1f;
+    cfg.sim_threads = threads;
+
+    mailbox::command::SeedSpec seed;
+    seed.add_group(3000, RED, 80.f * 80.f, true);
+    seed.add_group(2100, BLUE, 80.f * 80.f, true);
+    seed.rng_seed = rng_seed;
+
+    Simulation sim(cfg);
+    sim.begin();
+    sim.pause();
+    sim.push_command(mailbox::command::SeedWorld{seed});
+
+    std::vector<float> positions;
+    for (int attempt = 0; attempt < 200 && positions.size() != 5100 * 2;
+         ++attempt) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        auto view = sim.begin_read_draw();
+        if (view.curr) {
+            positions = *view.curr;
+        }
+        sim.end_read_draw(view);
+    }
+    REQUIRE(sim.get_world_snapshot().rng_seed == rng_seed);
+    sim.end();
+    return positions;
+}
+
+} // namespace
+
+TEST_CASE("Simulation seeding is reproducible across thread counts",
+          "[simulation]") {
+    const auto serial = seeded_positions(1, 0x1234abcdULL);
+    const auto parallel = seeded_positions(4, 0x1234abcdULL);
+    REQUIRE(serial.size() == 5100 * 2);
+    REQUIRE(serial == parallel);
+
+    for (size_t i = 0; i < serial.size(); i += 2) {
+        REQUIRE(serial[i] >= 0.f);
+        REQUIRE(serial[i] <= 800.f);
+        REQUIRE(serial[i + 1] >= 0.f);
+        REQUIRE(serial[i + 1] <= 600.f);
+    }
+
+    const auto other = seeded_positions(4, 0x1234abceULL);
+    REQUIRE(other.size() == serial.size());
+    REQUIRE(other != serial);
+}
+
+TEST_CASE("Placing groups anew keeps the project seed", "[simulation]") {
+    mailbox::SimulationConfigSnapshot cfg = {};
+    cfg.bounds_width = 800.0f;
+    cfg.bounds_height = 600.0f;
+    cfg.time_scale = 1.0f;
+    cfg.viscosity = 0.1f;
+    cfg.sim_threads = 2;
+
+    mailbox::command::SeedSpec seed;
+    seed.add_group(3000, RED, 80.f * 80.f, true);
+    seed.add_group(2100, BLUE, 80.f * 80.f, true);
+    seed.rng_seed = 777;
+
+    Simulation sim(cfg);
+    sim.begin();
+    sim.pause();
+    sim.push_command(mailbox::command::SeedWorld{seed});
+
+    // A patch that is not hot places the groups again with new rules
+    mailbox::command::RulePatch patch;
+    patch.groups = 2;
+    patch.rules = {0.5f, 0.f, 0.f, 0.f};
+    patch.hot = false;
+    sim.push_command(mailbox::command::ApplyRules{patch});
+
+    bool applied = false;
+    for (int attempt = 0; attempt < 300 && !applied; ++attempt) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        const auto snapshot = sim.get_world_snapshot();
+        applied = snapshot.get_groups_size() == 2 &&
+                  snapshot.rule_val(0, 0) == 0.5f;
+    }
+    REQUIRE(applied);
+    REQUIRE(sim.get_world_snapshot().rng_seed == 777);
+
+    std::vector<float> positions;
+    auto view = sim.begin_read_draw();
+    positions = *view.curr;
+    sim.end_read_draw(view);
+    sim.end();
+    REQUIRE(positions == seeded_positions(1, 777));
+}
+
+TEST_CASE("Ensemble seeds worlds like Simulation", "[simulation]") {
+    mailbox::SimulationConfigSnapshot cfg = {};
+    cfg.bounds_width = 800.0f;
+    cfg.bounds_height = 600.0f;
+    cfg.time_scale = 1.0f;
+    cfg.viscosity = 0.1f;
+
+    mailbox::command::SeedSpec seed;
+    seed.add_group(3000, RED, 80.f * 80.f, true);
+    seed.add_group(2100, BLUE, 80.f * 80.f, true);
+    seed.rng_seed = 0x1234abcdULL;
+
+    Ensemble ensemble(1);
+    ensemble.add(seed, cfg);
+    const World &w = ensemble.world(0);
+
+    std::vector<float> positions;
+    for (int i = 0; i < w.get_particles_size(); ++i) {
+        positions.push_back(w.get_px(i));
+        positions.push_back(w.get_py(i));
+    }
+    REQUIRE(positions == seeded_positions(2, 0x1234abcdULL));
+}
+
+TEST_CASE("Simulation runs huge sparse worlds", "[simulation]") {
+    mailbox::SimulationConfigSnapshot cfg = {};
+    cfg.bounds_width = 100000.0f;
+    cfg.bounds_height = 100000.0f;
+    cfg.time_scale = 1.0f;
+    cfg.viscosity = 0.1f;
+    cfg.sim_threads = 2;
+
+    mailbox::command::SeedSpec seed;
+    seed.add_group(2000, RED, 20.f * 20.f, true);
+    seed.add_group(1000, BLUE, 20.f * 20.f, true);
+
+    Simulation sim(cfg);
+    sim.begin();
+    sim.push_command(mailbox::command::SeedWorld{seed});
+
+    // Wait until the world has stepped at least once with the new seed
+    bool stepped = false;
+    for (int attempt = 0; attempt < 300 && !stepped; ++attempt) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        stepped = sim.get_world_snapshot().get_particles_size() == 3000 &&
+                  sim.get_stats().num_steps > 2;
+    }
+    REQUIRE(stepped);
+
+    // The sparse index publishes a single unindexed cell for the world
+    auto view = sim.begin_read_draw();
+    REQUIRE(view.curr);
+    REQUIRE(view.curr->size() == 3000 * 2);
+    REQUIRE(view.grid);
+    REQUIRE(view.grid->cols == 1);
+    REQUIRE(view.grid->rows == 1);
+    REQUIRE_FALSE(view.grid->indexed);
+    for (float v : *view.curr) {
+        REQUIRE(std::isfinite(v));
+    }
+    sim.end_read_draw(view);
+    sim.end();
+}
+
+namespace {
+
+/**
+ * @brief Fills a two-group world with scattered particles and velocities
+ */
+void fill_analytics_world(World &w) {
+    w.add_group(6000, RED);
+    w.add_group(4000, BLUE);
+    w.finalize_groups();
+    w.init_rule_tables(2);
+    w.set_r2(0, 40.f * 40.f);
+    w.set_r2(1, 40.f * 40.f);
+    w.set_rule(0, 1, 0.3f);
+    w.set_rule(1, 0, -0.2f);
+
+    uint32_t state = 12345;
+    auto next = [&state]() {
+        state = state * 1664525u + 1013904223u;
+        return (float)(state >> 8) / (float)(1u << 24);
+    };
+    for (int i = 0; i < w.get_particles_size(); ++i) {
+        w.set_px(i, next() * 800.f);
+        w.set_py(i, next() * 600.f);
+        w.set_vx(i, next() * 4.f - 2.f);
+        w.set_vy(i, next() * 4.f - 2.f);
+    }
+}
+
+} // namespace
+
+TEST_CASE("Stepper analytics match direct sums for any thread count",
+          "[simulation]") {
+    mailbox::SimulationConfigSnapshot cfg = {};
+    cfg.bounds_width = 800.0f;
+    cfg.bounds_height = 600.0f;
+    cfg.time_scale = 1.0f;
+    cfg.viscosity = 0.1f;
+
+    World serial_world, pooled_world;
+    fill_analytics_world(serial_world);
+    fill_analytics_world(pooled_world);
+
+    Stepper serial, pooled;
+    serial.set_analytics(true);
+    pooled.set_analytics(true);
+    SimulationThreadPool pool(3);
+    for (int s = 0; s < 3; ++s) {
+        serial.step(serial_world, cfg);
+        pooled.step(pooled_world, pool, cfg);
+    }
+
+    const mailbox::AnalyticsSnapshot &a = serial.analytics();
+    const mailbox::AnalyticsSnapshot &b = pooled.analytics();
+    REQUIRE(a.kinetic_energy == b.kinetic_energy);
+    REQUIRE(a.momentum_x == b.momentum_x);
+    REQUIRE(a.momentum_y == b.momentum_y);
+    REQUIRE(a.speed_histogram == b.speed_histogram);
+    REQUIRE(a.centroid_x == b.centroid_x);
+    REQUIRE(a.centroid_y == b.centroid_y);
+    REQUIRE(a.cell_count_stddev == b.cell_count_stddev);
+
+    const World &w = serial_world;
+    const int n = w.get_particles_size();
+    double energy = 0.0, momentum_x = 0.0, max_speed = 0.0;
+    double sum_x[2] = {0.0, 0.0}, sum_y[2] = {0.0, 0.0};
+    for (int i = 0; i < n; ++i) {
+        const double vx = w.get_vx(i), vy = w.get_vy(i);
+        energy += 0.5 * (vx * vx + vy * vy);
+        momentum_x += vx;
+        max_speed = std::max(max_speed, std::sqrt(vx * vx + vy * vy));
+        sum_x[w.group_of(i)] += w.get_px(i);
+        sum_y[w.group_of(i)] += w.get_py(i);
+    }
+
+    REQUIRE(a.particles == n);
+    REQUIRE(a.kinetic_energy == Catch::Approx(energy).epsilon(1e-4));
+    REQUIRE(a.momentum_x == Catch::Approx(momentum_x).margin(1e-2));
+    REQUIRE(a.max_speed == Catch::Approx(max_speed).epsilon(1e-4));
+    REQUIRE(a.speed_range >= a.max_speed * 0.5f);
+    REQUIRE(a.centroid_x.size() == 2);
+    REQUIRE(a.centroid_x[0] == Catch::Approx(sum_x[0] / 6000).epsilon(1e-4));
+    REQUIRE(a.centroid_y[1] == Catch::Approx(sum_y[1] / 4000).epsilon(1e-4));
+
+    int binned = 0;
+    for (int count : a.speed_histogram) {
+        binned += count;
+    }
+    REQUIRE(binned == n);
+
+    // Every particle sits in exactly one cell of the step's grid
+    REQUIRE(a.cells > 0);
+    REQUIRE(a.occupied_cells > 0);
+    REQUIRE(a.occupied_cells <= a.cells);
+    REQUIRE(a.mean_cell_count * a.occupied_cells == Catch::Approx(n));
+    REQUIRE(a.max_cell_count >= a.mean_cell_count);
+    REQUIRE(a.cell_count_stddev >= 0.f);
+
+    Stepper off;
+    World off_world;
+    fill_analytics_world(off_world);
+    off.step(off_world, cfg);
+    REQUIRE(off.analytics().particles == 0);
+}
+
+TEST_CASE("Simulation publishes step analytics", "[simulation]") {
+    mailbox::SimulationConfigSnapshot cfg = {};
+    cfg.bounds_width = 800.0f;
+    cfg.bounds_height = 600.0f;
+    cfg.time_scale = 1.0f;
+    cfg.viscosity = 0.1f;
+    cfg.sim_threads = 2;
+    cfg.cluster_interval = 1;
+
+    mailbox::command::SeedSpec seed;
+    seed.add_group(1500, RED, 80.f * 80.f, true);
+    seed.add_group(500, BLUE, 80.f * 80.f, true);
+
+    Simulation sim(cfg);
+    REQUIRE(sim.get_analytics().particles == 0);
+    sim.begin();
+    sim.pause();
+    sim.push_command(mailbox::command::SeedWorld{seed});
+    sim.push_command(mailbox::command::OneStep{});
+
+    bool stepped = false;
+    for (int attempt = 0; attempt < 300 && !stepped; ++attempt) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        stepped = sim.get_stats().num_steps >= 1;
+    }
+    REQUIRE(stepped);
+
+    const auto analytics = sim.get_analytics();
+    REQUIRE(analytics.num_steps == sim.get_stats().num_steps);
+    REQUIRE(analytics.particles == 2000);
+    REQUIRE(analytics.centroid_x.size() == 2);
+    for (size_t g = 0; g < analytics.centroid_x.size(); ++g) {
+        REQUIRE(analytics.centroid_x[g] >= 0.f);
+        REQUIRE(analytics.centroid_x[g] <= 800.f);
+        REQUIRE(analytics.centroid_y[g] >= 0.f);
+        REQUIRE(analytics.centroid_y[g] <= 600.f);
+    }
+    REQUIRE(analytics.occupied_cells > 0);
+
+    const auto clusters = sim.get_clusters();
+    REQUIRE(clusters.num_steps == analytics.num_steps);
+    REQUIRE(clusters.particles == 2000);
+    REQUIRE(clusters.link_distance == cfg.cluster_distance);
+    sim.end();
+}
+
+namespace {
+
+/**
+ * @brief Velocities after one step, from a pairwise pass over the force law
+ * @details Assumes no particle reaches a wall and no wall or gravity forces.
+ */
+void reference_velocities(const World &w,
+                          const mailbox::SimulationConfigSnapshot &cfg,
+                          std::vector<float> &vx, std::vector<float> &vy) {
+    const int n = w.get_particles_size();
+    vx.resize(n);
+    vy.resize(n);
+    for (int i = 0; i < n; ++i) {
+        const int gi = w.group_of(i);
+        float fx = 0.f, fy = 0.f;
+        for (int j = 0; w.is_group_enabled(gi) && j < n; ++j) {
+            const int gj = w.group_of(j);
+            const float dx = w.get_px(i) - w.get_px(j);
+            const float dy = w.get_py(i) - w.get_py(j);
+            const float d2 = dx * dx + dy * dy;
+            if (j == i || !w.is_group_enabled(gj) || d2 <= 0.f ||
+                d2 >= w.r2_of(gi)) {
+                continue;
+            }
+            const float f = w.rules_of(gi).get(gj) * rsqrt_fast(d2);
+            fx += f * dx;
+            fy += f * dy;
+        }
+        vx[i] = w.get_vx(i) * (1.f - cfg.viscosity) + fx * cfg.time_scale;
+        vy[i] = w.get_vy(i) * (1.f - cfg.viscosity) + fy * cfg.time_scale;
+    }
+}
+
+/**
+ * @brief Scatters a world's particles away from the walls
+ */
+void scatter_inside(World &w, float width, float height, uint32_t state) {
+    auto next = [&state]() {
+        state = state * 1664525u + 1013904223u;
+        return (float)(state >> 8) / (float)(1u << 24);
+    };
+    for (int i = 0; i < w.get_particles_size(); ++i) {
+        w.set_px(i, width * (0.25f + next() * 0.5f));
+        w.set_py(i, height * (0.25f + next() * 0.5f));
+        w.set_vx(i, next() - 0.5f);
+        w.set_vy(i, next() - 0.5f);
+    }
+}
+
+} // namespace
+
+TEST_CASE("Stepper skips groups without rules and disabled groups",
+          "[simulation]") {
+    mailbox::SimulationConfigSnapshot cfg = {};
+    cfg.bounds_width = 800.0f;
+    cfg.bounds_height = 600.0f;
+    cfg.time_scale = 1.0f;
+    cfg.viscosity = 0.1f;
+
+    World w;
+    w.add_group(500, RED);
+    w.add_group(500, GREEN);
+    w.add_group(500, BLUE);
+    w.init_rule_tables(3);
+    for (int g = 0; g < 3; ++g) {
+        w.set_r2(g, 30.f * 30.f);
+    }
+    w.set_rule(0, 0, 0.1f);
+    w.set_rule(0, 1, 0.3f); // towards a disabled group
+    w.set_rule(1, 0, -0.2f);
+    w.set_rule(2, 1, 0.4f); // group 2 only reacts to the disabled group
+    w.finalize_groups();
+    w.set_group_enabled(1, false);
+
+    scatter_inside(w, cfg.bounds_width, cfg.bounds_height, 99);
+    const int n = w.get_particles_size();
+    std::vector<float> expected_vx, expected_vy;
+    reference_velocities(w, cfg, expected_vx, expected_vy);
+
+    Stepper stepper;
+    stepper.step(w, cfg);
+    for (int i = 0; i < n; ++i) {
+        REQUIRE(w.get_vx(i) == Catch::Approx(expected_vx[i]).margin(1e-4));
+        REQUIRE(w.get_vy(i) == Catch::Approx(expected_vy[i]).margin(1e-4));
+    }
+}
+
+TEST_CASE("Stepper prunes neighbor cells beyond the group radius",
+          "[simulation]") {
+    mailbox::SimulationConfigSnapshot cfg = {};
+    cfg.bounds_width = 800.0f;
+    cfg.bounds_height = 600.0f;
+    cfg.time_scale = 1.0f;
+    cfg.viscosity = 0.1f;
+
+    // The cell size follows the largest radius, so the small group's
+    // particles only reach the cells next to their own cell's near edges
+    World w;
+    w.add_group(1500, RED);
+    w.add_group(1500, BLUE);
+    w.init_rule_tables(2);
+    w.set_r2(0, 40.f * 40.f);
+    w.set_r2(1, 8.f * 8.f);
+    w.set_rule(0, 0, 0.1f);
+    w.set_rule(0, 1, -0.2f);
+    w.set_rule(1, 0, 0.3f);
+    w.set_rule(1, 1, -0.1f);
+    w.finalize_groups();
+    scatter_inside(w, cfg.bounds_width, cfg.bounds_height, 7);
+
+    const int n = w.get_particles_size();
+    std::vector<float> expected_vx, expected_vy;
+    reference_velocities(w, cfg, expected_vx, expected_vy);
+
+    Stepper stepper;
+    stepper.set_analytics(true);
+    stepper.step(w, cfg);
+    for (int i = 0; i < n; ++i) {
+        REQUIRE(w.get_vx(i) == Catch::Approx(expected_vx[i]).margin(1e-4));
+        REQUIRE(w.get_vy(i) == Catch::Approx(expected_vy[i]).margin(1e-4));
+    }
+
+    const mailbox::AnalyticsSnapshot &a = stepper.analytics();
+    REQUIRE(a.pruned_cells > 0);
+    REQUIRE(a.pruned_candidates > 0);
+    REQUIRE(a.scanned_cells > 0);
+    REQUIRE(a.scanned_cells + a.pruned_cells <= 9ll * n);
+    // The small group reaches at most 4 cells; corners of the large group's
+    // stencil are pruned too
+    REQUIRE(a.pruned_cells > 5ll * 1500);
+}
+
+TEST_CASE("Stepper counts examined and accepted force pairs",
+          "[simulation]") {
+    mailbox::SimulationConfigSnapshot cfg = {};
+    cfg.bounds_width = 800.0f;
+    cfg.bounds_height = 600.0f;
+    cfg.time_scale = 1.0f;
+    cfg.viscosity = 0.1f;
+
+    auto fill = [&cfg](World &w) {
+        w.add_group(800, RED);
+        w.add_group(800, BLUE);
+        w.init_rule_tables(2);
+        w.set_r2(0, 30.f * 30.f);
+        w.set_r2(1, 12.f * 12.f);
+        w.set_rule(0, 0, 0.1f);
+        w.set_rule(0, 1, -0.2f);
+        w.set_rule(1, 0, 0.3f);
+        w.set_rule(1, 1, -0.1f);
+        w.finalize_groups();
+        scatter_inside(w, cfg.bounds_width, cfg.bounds_height, 21);
+    };
+    World w, uncounted;
+    fill(w);
+    fill(uncounted);
+
+    // Every group reacts to every group, so each pair inside the radius is
+    // accepted exactly once per source particle
+    const int n = w.get_particles_size();
+    std::vector<int> expected(n, 0);
+    for (int i = 0; i < n; ++i) {
+        for (int j = 0; j < n; ++j) {
+            const float dx = w.get_px(i) - w.get_px(j);
+            const float dy = w.get_py(i) - w.get_py(j);
+            const float d2 = dx * dx + dy * dy;
+            if (j != i && d2 > 0.f && d2 < w.r2_of(w.group_of(i))) {
+                ++expected[i];
+            }
+        }
+    }
+
+    Stepper stepper;
+    stepper.set_pair_counts(true);
+    stepper.set_analytics(true);
+    stepper.step(w, cfg);
+    REQUIRE((int)stepper.accepted_pairs().size() == n);
+    long long examined = 0, accepted = 0;
+    for (int i = 0; i < n; ++i) {
+        REQUIRE(stepper.accepted_pairs()[i] == expected[i]);
+        REQUIRE(stepper.examined_pairs()[i] >= stepper.accepted_pairs()[i]);
+        examined += stepper.examined_pairs()[i];
+        accepted += stepper.accepted_pairs()[i];
+    }
+
+    const mailbox::AnalyticsSnapshot &a = stepper.analytics();
+    REQUIRE(a.examined_pairs == examined);
+    REQUIRE(a.accepted_pairs == accepted);
+    REQUIRE(accepted > 0);
+    REQUIRE(a.pair_acceptance ==
+            Catch::Approx((double)accepted / (double)examined));
+
+    // Counting does not change the forces
+    Stepper plain;
+    plain.step(uncounted, cfg);
+    REQUIRE(plain.examined_pairs().empty());
+    for (int i = 0; i < n; ++i) {
+        REQUIRE(w.get_vx(i) == uncounted.get_vx(i));
+        REQUIRE(w.get_vy(i) == uncounted.get_vy(i));
+    }
+}
+
+TEST_CASE("Simulation publishes per-cell force costs", "[simulation]") {
+    mailbox::SimulationConfigSnapshot cfg = {};
+    cfg.bounds_width = 800.0f;
+    cfg.bounds_height = 600.0f;
+    cfg.time_scale = 1.0f;
+    cfg.viscosity = 0.1f;
+    cfg.sim_threads = 2;
+    cfg.draw_report.grid_data = true;
+    cfg.draw_report.cell_costs = true;
+
+    mailbox::command::SeedSpec seed;
+    seed.add_group(600, RED, 40.f * 40.f, true);
+    seed.set_rule(0, 0, 0.2f);
+
+    Simulation sim(cfg);
+    sim.begin();
+    sim.push_command(mailbox::command::SeedWorld{seed});
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+    auto view = sim.begin_read_draw();
+    REQUIRE(view.grid != nullptr);
+    REQUIRE(view.grid->indexed);
+    const size_t cells = size_t(view.grid->cols) * view.grid->rows;
+    REQUIRE(view.grid->examined.size() == cells);
+    REQUIRE(view.grid->accepted.size() == cells);
+    long long examined = 0, accepted = 0;
+    for (size_t ci = 0; ci < cells; ++ci) {
+        REQUIRE(view.grid->accepted[ci] <= view.grid->examined[ci]);
+        // Only cells holding particles did any work
+        if (view.grid->count[ci] == 0) {
+            REQUIRE(view.grid->examined[ci] == 0);
+        }
+        examined += view.grid->examined[ci];
+        accepted += view.grid->accepted[ci];
+    }
+    sim.end_read_draw(view);
+    sim.end();
+
+    REQUIRE(examined > 0);
+    REQUIRE(accepted > 0);
+}
+
+TEST_CASE("Simulation publishes a memory report", "[simulation]") {
+    mailbox::SimulationConfigSnapshot cfg = {};
+    cfg.bounds_width = 800.0f;
+    cfg.bounds_height = 600.0f;
+    cfg.time_scale = 1.0f;
+    cfg.viscosity = 0.1f;
+    cfg.sim_threads = 1;
+
+    mailbox::command::SeedSpec seed;
+    seed.add_group(100'000, RED, 20.f * 20.f, true);
+    seed.add_group(2'000, BLUE, 20.f * 20.f, true);
+
+    Simulation sim(cfg);
+    sim.begin();
+    sim.push_command(mailbox::command::SeedWorld{seed});
+
+    // The report is refreshed with the TPS window, about once per second
+    mailbox::MemorySnapshot memory;
+    for (int attempt = 0; attempt < 300 && memory.world.used_bytes == 0;
+         ++attempt) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        memory = sim.get_memory();
+    }
+    REQUIRE(memory.published_ns > 0);
+    REQUIRE(memory.world.used_bytes >= 102'000ll * 5 * 4);
+    REQUIRE_FALSE(memory.world.wasteful());
+    REQUIRE(memory.grid_csr.used_bytes >= 102'000ll * 4);
+    REQUIRE(memory.stepper.used_bytes >= 102'000ll * 2 * 4);
+    REQUIRE(memory.draw_buffer.used_bytes >= 102'000ll * 4 * 4);
+    REQUIRE(memory.snapshots.used_bytes > 0);
+    const auto total = memory.total();
+    REQUIRE(total.used_bytes >=
+            memory.world.used_bytes + memory.draw_buffer.used_bytes);
+    REQUIRE(total.reserved_bytes >= total.used_bytes);
+
+    // Removing the big group leaves 1.6 MB of its columns allocated
+    sim.push_command(mailbox::command::RemoveGroup{0});
+    for (int attempt = 0; attempt < 300 && !memory.world.wasteful();
+         ++attempt) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        memory = sim.get_memory();
+    }
+    REQUIRE(memory.world.wasteful());
+    sim.end();
+}
+
+TEST_CASE("Simulation publishes step latency percentiles", "[simulation]") {
+    mailbox::SimulationConfigSnapshot cfg = {};
+    cfg.bounds_width = 800.0f;
+    cfg.bounds_height = 600.0f;
+    cfg.time_scale = 1.0f;
+    cfg.viscosity = 0.1f;
+    cfg.sim_threads = 1;
+    cfg.target_tps = 200;
+
+    mailbox::command::SeedSpec seed;
+    seed.add_group(2000, RED, 40.f * 40.f, true);
+
+    Simulation sim(cfg);
+    sim.begin();
+    sim.push_command(mailbox::command::SeedWorld{seed});
+
+    bool enough = false;
+    for (int attempt = 0; attempt < 500 && !enough; ++attempt) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        enough = sim.get_stats().step_latency.samples >= 20;
+    }
+    REQUIRE(enough);
+
+    const auto stats = sim.get_stats();
+    const auto &latency = stats.step_latency;
+    REQUIRE(latency.p50_ns > 0);
+    REQUIRE(latency.p50_ns <= latency.p95_ns);
+    REQUIRE(latency.p95_ns <= latency.p99_ns);
+    REQUIRE(latency.p99_ns <= latency.max_ns);
+    // Every paced tick either slept or missed its deadline
+    REQUIRE(stats.oversleep.samples + stats.missed_deadlines > 0);
+
+    // Reseeding restarts the histograms with the step count
+    sim.pause();
+    sim.push_command(mailbox::command::SeedWorld{seed});
+    bool restarted = false;
+    for (int attempt = 0; attempt < 300 && !restarted; ++attempt) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        const auto st = sim.get_stats();
+        restarted = st.num_steps == 0 && st.step_latency.samples == 0;
+    }
+    REQUIRE(restarted);
+    sim.end();
+}
+
+namespace {
+
+/** @brief Records what the simulation hands to its frame sink */
+class RecordingSink : public IFrameSink {
+  public:
+    void write(const World &world, float width, float height,
+               long long stamp_ns) override {
+        frames.fetch_add(1);
+        particles.store(world.get_particles_size());
+        last_width.store(width);
+        last_stamp.store(stamp_ns);
+        if (throw_next.load()) {
+            throw std::runtime_error("sink failure");
+        }
+    }
+
+    std::atomic<int> frames{0};
+    std::atomic<int> particles{0};
+    std::atomic<float> last_width{0.f};
+    std::atomic<long long> last_stamp{0};
+    std::atomic<bool> throw_next{false};
+};
+
+} // namespace
+
+TEST_CASE("Simulation hands published frames to its frame sink",
+          "[simulation]") {
+    mailbox::SimulationConfigSnapshot cfg = {};
+    cfg.bounds_width = 640.0f;
+    cfg.bounds_height = 480.0f;
+    cfg.time_scale = 1.0f;
+    cfg.sim_threads = 1;
+
+    mailbox::command::SeedSpec seed;
+    seed.add_group(300, RED, 20.f * 20.f, true);
+
+    auto sink = std::make_shared<RecordingSink>();
+    Simulation sim(cfg);
+    sim.set_frame_sink(sink);
+    sim.begin();
+    REQUIRE_THROWS_AS(sim.set_frame_sink(nullptr), particles::SimulationError);
+    sim.push_command(mailbox::command::SeedWorld{seed});
+
+    for (int attempt = 0; attempt < 300 && sink->particles.load() != 300;
+         ++attempt) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    REQUIRE(sink->particles.load() == 300);
+    REQUIRE(sink->last_width.load() == 640.0f);
+    REQUIRE(sink->last_stamp.load() > 0);
+
+    // A failing sink is detached; the simulation keeps running
+    sink->throw_next.store(true);
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    const int frames = sink->frames.load();
+    const long long steps = sim.get_stats().num_steps;
+    long long later = steps;
+    for (int attempt = 0; attempt < 300 && later <= steps; ++attempt) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        later = sim.get_stats().num_steps;
+    }
+    REQUIRE(later > steps);
+    REQUIRE(sink->frames.load() == frames);
+    sim.end();
+}
+
+TEST_CASE("Paused simulation idles until a command or config change",
+          "[simulation]") {
+    mailbox::SimulationConfigSnapshot cfg = {};
+    cfg.bounds_width = 640.0f;
+    cfg.bounds_height = 480.0f;
+    cfg.time_scale = 1.0f;
+    cfg.sim_threads = 1;
+
+    mailbox::command::SeedSpec seed;
+    seed.add_group(500, RED, 20.f * 20.f, true);
+
+    auto sink = std::make_shared<RecordingSink>();
+    Simulation sim(cfg);
+    sim.set_frame_sink(sink);
+    sim.begin();
+    sim.pause();
+    sim.push_command(mailbox::command::SeedWorld{seed});
+
+    for (int attempt = 0; attempt < 300 && sink->particles.load() != 500;
+         ++attempt) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    REQUIRE(sink->particles.load() == 500);
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+    // Nothing changes, so nothing is published
+    const int frames = sink->frames.load();
+    const long long published = sim.get_stats().published_ns;
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    REQUIRE(sink->frames.load() == frames);
+    REQUIRE(sim.get_stats().published_ns == published);
+    REQUIRE(sim.get_stats().num_steps == 0);
+
+    // A config change is republished without a step
+    cfg.bounds_width = 800.0f;
+    sim.update_config(cfg);
+    for (int attempt = 0; attempt < 300 && sink->last_width.load() != 800.0f;
+         ++attempt) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    REQUIRE(sink->last_width.load() == 800.0f);
+    REQUIRE(sim.get_stats().num_steps == 0);
+
+    // A single step wakes the thread, which then idles again
+    sim.push_command(mailbox::command::OneStep{});
+    for (int attempt = 0; attempt < 300 && sim.get_stats().num_steps != 1;
+         ++attempt) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    REQUIRE(sim.get_stats().num_steps == 1);
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    const int stepped_frames = sink->frames.load();
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    REQUIRE(sink->frames.load() == stepped_frames);
+    REQUIRE(sim.get_run_state() == Simulation::RunState::Paused);
+    sim.end();
+}
@@ -0,0 +1,229 @@
+#include <catch_amalgamated.hpp>
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <random>
+
+#include "render/software_renderer.hpp"
+#include "simulation/multicore.hpp"
+#include "utility/exceptions.hpp"
+
+#include "helpers.hpp"
+
+using test_helpers::make_world;
+
+namespace {
+
+Config make_config(bool glow) {
+    Config rcfg;
+    rcfg.glow_enabled = glow;
+    rcfg.core_size = 2.0f;
+    rcfg.outer_scale_mul = 8.0f;
+    rcfg.inner_scale_mul = 2.0f;
+    rcfg.background_color = {10, 20, 30, 255};
+    return rcfg;
+}
+
+const uint8_t *pixel_at(const SoftwareRenderer &r, int x, int y) {
+    return r.pixels().data() + ((size_t)y * r.width() + x) * 4;
+}
+
+} // namespace
+
+TEST_CASE("SoftwareRenderer validates framebuffer size", "[software_renderer]") {
+    REQUIRE_THROWS_AS(SoftwareRenderer(0, 10), particles::RenderError);
+    REQUIRE_THROWS_AS(SoftwareRenderer(10, -1), particles::RenderError);
+
+    SoftwareRenderer renderer(100, 50);
+    REQUIRE(renderer.width() == 100);
+    REQUIRE(renderer.height() == 50);
+    REQUIRE(renderer.pixels().size() == 100u * 50u * 4u);
+}
+
+TEST_CASE("SoftwareRenderer clears to background with no particles",
+          "[software_renderer]") {
+    SimulationThreadPool pool(2);
+    SoftwareRenderer renderer(130, 70);
+    std::vector<float> pos;
+    mailbox::render::ReadView view;
+    view.curr = &pos;
+    auto world = make_world({}, {}, {});
+
+    renderer.render(view, world, make_config(true), 130.f, 70.f, 1.f, pool);
+
+    for (int y = 0; y < renderer.height(); ++y) {
+        for (int x = 0; x < renderer.width(); ++x) {
+            const uint8_t *p = pixel_at(renderer, x, y);
+            REQUIRE(p[0] == 10);
+            REQUIRE(p[1] == 20);
+            REQUIRE(p[2] == 30);
+            REQUIRE(p[3] == 255);
+        }
+    }
+}
+
+TEST_CASE("SoftwareRenderer draws cores and glow falloff",
+          "[software_renderer]") {
+    SimulationThreadPool pool(2);
+    SoftwareRenderer renderer(128, 128);
+    // Bounds match the framebuffer so world and screen coordinates coincide
+    std::vector<float> pos = {64.f, 64.f};
+    mailbox::render::ReadView view;
+    view.curr = &pos;
+    auto world = make_world({1}, {{200, 100, 50, 255}}, {true});
+
+    SECTION("Core is drawn in the group color") {
+        renderer.render(view, world, make_config(false), 128.f, 128.f, 1.f,
+                        pool);
+        const uint8_t *center = pixel_at(renderer, 64, 64);
+        REQUIRE(center[0] == 200);
+        REQUIRE(center[1] == 100);
+        REQUIRE(center[2] == 50);
+        // Outside the core radius only background remains
+        const uint8_t *outside = pixel_at(renderer, 70, 64);
+        REQUIRE(outside[0] == 10);
+    }
+
+    SECTION("Glow decreases monotonically with distance") {
+        renderer.render(view, world, make_config(true), 128.f, 128.f, 1.f,
+                        pool);
+        int previous = 256;
+        for (int x = 67; x < 64 + 16; ++x) {
+            int r = pixel_at(renderer, x, 64)[0];
+            REQUIRE(r <= previous);
+            previous = r;
+        }
+        REQUIRE(pixel_at(renderer, 68, 64)[0] > 10);
+        // Beyond the outer glow radius (2 * 8 = 16px) nothing is drawn
+        REQUIRE(pixel_at(renderer, 64 + 17, 64)[0] == 10);
+    }
+
+    SECTION("Disabled groups are not drawn") {
+        auto disabled = make_world({1}, {{200, 100, 50, 255}}, {false});
+        renderer.render(view, disabled, make_config(true), 128.f, 128.f, 1.f,
+                        pool);
+        REQUIRE(pixel_at(renderer, 64, 64)[0] == 10);
+    }
+}
+
+TEST_CASE("SoftwareRenderer interpolates between frames",
+          "[software_renderer]") {
+    SimulationThreadPool pool(1);
+    SoftwareRenderer renderer(128, 128);
+    std::vector<float> prev = {20.f, 64.f};
+    std::vector<float> curr = {100.f, 64.f};
+    mailbox::render::ReadView view;
+    view.prev = &prev;
+    view.curr = &curr;
+    auto world = make_world({1}, {{255, 255, 255, 255}}, {true});
+
+    renderer.render(view, world, make_config(false), 128.f, 128.f, 0.5f, pool);
+    REQUIRE(pixel_at(renderer, 60, 64)[0] == 255);
+    REQUIRE(pixel_at(renderer, 100, 64)[0] == 10);
+}
+
+TEST_CASE("SoftwareRenderer output is independent of thread count",
+          "[software_renderer]") {
+    const int N = 20'000;
+    std::mt19937 rng(1234);
+    std::uniform_real_distribution<float> dx(0.f, 319.f);
+    std::uniform_real_distribution<float> dy(0.f, 239.f);
+    std::vector<float> pos(N * 2);
+    for (int i = 0; i < N; ++i) {
+        pos[i * 2 + 0] = dx(rng);
+        pos[i * 2 + 1] = dy(rng);
+    }
+    mailbox::render::ReadView view;
+    view.curr = &pos;
+    auto world = make_world({N / 2, N / 2},
+                            {{255, 0, 0, 255}, {0, 0, 255, 255}},
+                            {true, true});
+
+    SimulationThreadPool serial(1);
+    SimulationThreadPool parallel(4);
+    SoftwareRenderer a(320, 240);
+    SoftwareRenderer b(320, 240);
+    a.render(view, world, make_config(true), 320.f, 240.f, 1.f, serial);
+    b.render(view, world, make_config(true), 320.f, 240.f, 1.f, parallel);
+
+    REQUIRE(a.pixels() == b.pixels());
+}
+
+TEST_CASE("SoftwareRenderer dense glow field matches exact splatting",
+          "[software_renderer]") {
+    const int N = 20'000;
+    std::mt19937 rng(99);
+    std::uniform_real_distribution<float> dx(0.f, 319.f);
+    std::uniform_real_distribution<float> dy(0.f, 239.f);
+    std::vector<float> pos(N * 2);
+    for (int i = 0; i < N; ++i) {
+        pos[i * 2 + 0] = dx(rng);
+        pos[i * 2 + 1] = dy(rng);
+    }
+    mailbox::render::ReadView view;
+    view.curr = &pos;
+    // Single color: the field is exact up to grid reconstruction error
+    auto world = make_world({N}, {{255, 120, 40, 255}}, {true});
+    Config rcfg = make_config(true);
+    rcfg.core_size = 0.5f;
+    rcfg.inner_scale_mul = 0.f;
+
+    SimulationThreadPool pool(2);
+    SoftwareRenderer exact(320, 240);
+    SoftwareRenderer field(320, 240);
+    exact.set_glow_overdraw_limit(0.f);
+    field.set_glow_overdraw_limit(1.f);
+    exact.render(view, world, rcfg, 320.f, 240.f, 1.f, pool);
+    field.render(view, world, rcfg, 320.f, 240.f, 1.f, pool);
+
+    REQUIRE_FALSE(exact.glow_pass_convolved(0));
+    REQUIRE(field.glow_pass_convolved(0));
+
+    double total = 0.0;
+    for (size_t i = 0; i < exact.pixels().size(); ++i) {
+        total += std::abs((int)exact.pixels()[i] - (int)field.pixels()[i]);
+    }
+    REQUIRE(total / (double)exact.pixels().size() < 3.0);
+}
+
+TEST_CASE("SoftwareRenderer writes PNG and PPM files", "[software_renderer]") {
+    SimulationThreadPool pool(1);
+    SoftwareRenderer renderer(40, 30);
+    std::vector<float> pos = {20.f, 15.f};
+    mailbox::render::ReadView view;
+    view.curr = &pos;
+    auto world = make_world({1}, {{255, 255, 255, 255}}, {true});
+    renderer.render(view, world, make_config(true), 40.f, 30.f, 1.f, pool);
+
+    const auto dir = std::filesystem::temp_directory_path();
+    const auto png = (dir / "particles_sw_test.png").string();
+    const auto ppm = (dir / "particles_sw_test.ppm").string();
+
+    renderer.write_png(png);
+    renderer.write_ppm(ppm);
+
+    std::ifstream png_file(png, std::ios::binary);
+    std::vector<uint8_t> png_bytes((std::istreambuf_iterator<char>(png_file)),
+                                   std::istreambuf_iterator<char>());
+    REQUIRE(png_bytes.size() > 8);
+    REQUIRE(png_bytes[0] == 0x89);
+    REQUIRE(png_bytes[1] == 'P');
+    REQUIRE(png_bytes[2] == 'N');
+    REQUIRE(png_bytes[3] == 'G');
+    // IHDR width/height (big endian)
+    REQUIRE(png_bytes[16 + 3] == 40);
+    REQUIRE(png_bytes[20 + 3] == 30);
+    // Ends with the IEND chunk
+    REQUIRE(std::string(png_bytes.end() - 8, png_bytes.end() - 4) == "IEND");
+
+    // P6 header followed by raw RGB
+    const std::string header = "P6\n40 30\n255\n";
+    REQUIRE(std::filesystem::file_size(ppm) == header.size() + 40 * 30 * 3);
+
+    std::remove(png.c_str());
+    std::remove(ppm.c_str());
+
+    REQUIRE_THROWS_AS(renderer.write_png("/nonexistent_dir/frame.png"),
+                      particles::IOError);
+}
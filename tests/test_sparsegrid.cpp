@@ -0,0 +1,194 @@
+#include <catch_amalgamated.hpp>
+
+#include <random>
+#include <vector>
+
+#include "simulation/neighborindex.hpp"
+#include "simulation/sparsegrid.hpp"
+#include "simulation/uniformgrid.hpp"
+
+namespace {
+
+std::vector<int> cell_items(const auto &grid, int cx, int cy) {
+    std::vector<int> items;
+    const int ci = grid.cell_index(cx, cy);
+    if (ci < 0) {
+        return items;
+    }
+    const int start = grid.cell_start_at(ci);
+    const int end = start + grid.cell_count_at(ci);
+    for (int k = start; k < end; ++k) {
+        items.push_back(grid.indices()[k]);
+    }
+    return items;
+}
+
+} // namespace
+
+TEST_CASE("SparseGrid matches UniformGrid cell contents", "[sparsegrid]") {
+    const int N = 2000;
+    const float W = 500.f, H = 300.f, C = 7.f;
+
+    std::mt19937 rng(1234);
+    std::uniform_real_distribution<float> ux(-10.f, W + 10.f);
+    std::uniform_real_distribution<float> uy(-10.f, H + 10.f);
+    std::vector<float> xs(N), ys(N);
+    for (int i = 0; i < N; ++i) {
+        xs[i] = ux(rng);
+        ys[i] = uy(rng);
+    }
+    xs[5] = std::numeric_limits<float>::quiet_NaN();
+
+    auto get_x = [&](int i) {
+        return xs[i];
+    };
+    auto get_y = [&](int i) {
+        return ys[i];
+    };
+
+    UniformGrid dense;
+    dense.resize(W, H, C, N);
+    dense.build(N, get_x, get_y, W, H);
+
+    SparseGrid sparse;
+    sparse.resize(W, H, C, N);
+    sparse.build(N, get_x, get_y, W, H);
+
+    REQUIRE(sparse.cols() == dense.cols());
+    REQUIRE(sparse.rows() == dense.rows());
+
+    int occupied = 0;
+    for (int cy = -1; cy <= dense.rows(); ++cy) {
+        for (int cx = -1; cx <= dense.cols(); ++cx) {
+            const auto expected = cell_items(dense, cx, cy);
+            REQUIRE(cell_items(sparse, cx, cy) == expected);
+            occupied += expected.empty() ? 0 : 1;
+        }
+    }
+    REQUIRE(sparse.occupied_cells() == occupied);
+
+    // Rebuilding after motion reuses the table
+    for (int i = 0; i < N; ++i) {
+        xs[i] = W - xs[i];
+    }
+    dense.build(N, get_x, get_y, W, H);
+    sparse.build(N, get_x, get_y, W, H);
+    for (int cy = 0; cy < dense.rows(); ++cy) {
+        for (int cx = 0; cx < dense.cols(); ++cx) {
+            REQUIRE(cell_items(sparse, cx, cy) == cell_items(dense, cx, cy));
+        }
+    }
+}
+
+TEST_CASE("SparseGrid matches UniformGrid group masks", "[sparsegrid]") {
+    const int N = 1500;
+    const float W = 400.f, H = 300.f, C = 9.f;
+
+    std::mt19937 rng(77);
+    std::uniform_real_distribution<float> ux(0.f, W);
+    std::uniform_real_distribution<float> uy(0.f, H);
+    std::vector<float> xs(N), ys(N);
+    std::vector<int> groups(N);
+    for (int i = 0; i < N; ++i) {
+        xs[i] = ux(rng);
+        ys[i] = uy(rng);
+        groups[i] = i % 4 == 3 ? -1 : i % 3; // every fourth item left out
+    }
+
+    auto get_x = [&](int i) {
+        return xs[i];
+    };
+    auto get_y = [&](int i) {
+        return ys[i];
+    };
+    auto group_of = [&](int i) {
+        return groups[i];
+    };
+
+    UniformGrid dense;
+    dense.resize(W, H, C, N);
+    dense.build(N, get_x, get_y, W, H, group_of);
+    SparseGrid sparse;
+    sparse.resize(W, H, C, N);
+    sparse.build(N, get_x, get_y, W, H, group_of);
+
+    int indexed = 0;
+    for (int cy = 0; cy < dense.rows(); ++cy) {
+        for (int cx = 0; cx < dense.cols(); ++cx) {
+            const auto items = cell_items(dense, cx, cy);
+            REQUIRE(cell_items(sparse, cx, cy) == items);
+            uint64_t mask = 0;
+            for (int i : items) {
+                REQUIRE(groups[i] >= 0);
+                mask |= group_mask_bit(groups[i]);
+            }
+            REQUIRE(dense.cell_mask_at(dense.cell_index(cx, cy)) == mask);
+            if (!items.empty()) {
+                REQUIRE(sparse.cell_mask_at(sparse.cell_index(cx, cy)) ==
+                        mask);
+            }
+            indexed += (int)items.size();
+        }
+    }
+    REQUIRE(indexed == N - N / 4);
+}
+
+TEST_CASE("SparseGrid handles huge bounds with item-sized storage",
+          "[sparsegrid]") {
+    // 5000 x 5000 cells, far more than a dense grid should allocate
+    SparseGrid grid;
+    const float W = 100000.f, H = 100000.f, C = 20.f;
+    const int N = 4;
+    float xs[N] = {10.f, 15.f, 99990.f, 50000.f};
+    float ys[N] = {10.f, 12.f, 99990.f, 50000.f};
+    grid.resize(W, H, C, N);
+    grid.build(
+        N,
+        [&](int i) {
+            return xs[i];
+        },
+        [&](int i) {
+            return ys[i];
+        },
+        W, H);
+
+    REQUIRE(grid.cols() == 5000);
+    REQUIRE(grid.rows() == 5000);
+    REQUIRE(grid.occupied_cells() == 3);
+    REQUIRE(grid.indices().size() == (size_t)N);
+    REQUIRE(cell_items(grid, 0, 0) == std::vector<int>{0, 1});
+    REQUIRE(cell_items(grid, 4999, 4999) == std::vector<int>{2});
+    REQUIRE(cell_items(grid, 2500, 2500) == std::vector<int>{3});
+    REQUIRE(grid.cell_index(1, 0) == -1);
+    REQUIRE(grid.cell_index(5000, 0) == -1);
+
+    SparseGrid empty;
+    REQUIRE(empty.cell_index(0, 0) == -1);
+}
+
+TEST_CASE("NeighborIndex picks the layout from occupancy", "[sparsegrid]") {
+    REQUIRE_FALSE(NeighborIndex::use_sparse(1920.f, 1080.f, 20.f, 10000));
+    REQUIRE_FALSE(NeighborIndex::use_sparse(20000.f, 20000.f, 10.f, 500000));
+    REQUIRE(NeighborIndex::use_sparse(100000.f, 100000.f, 20.f, 300000));
+    REQUIRE(NeighborIndex::use_sparse(1e7f, 1e7f, 1.f, 1000));
+
+    World w;
+    w.add_group(100, RED);
+    w.finalize_groups();
+    for (int i = 0; i < 100; ++i) {
+        w.set_px(i, 50000.f + (float)i);
+        w.set_py(i, 50000.f);
+    }
+
+    NeighborIndex idx;
+    const float inv_cell = idx.ensure(w, 100000.f, 100000.f, 20.f);
+    REQUIRE(idx.sparse);
+    REQUIRE(inv_cell == Catch::Approx(1.f / 20.f));
+    REQUIRE(idx.sparse_grid.occupied_cells() == 5);
+    REQUIRE(idx.grid.head().empty());
+
+    idx.ensure(w, 1000.f, 1000.f, 20.f);
+    REQUIRE_FALSE(idx.sparse);
+    REQUIRE(idx.grid.cols() == 50);
+    REQUIRE(idx.sparse_grid.occupied_cells() == 0);
+}
@@ -623,4 +623,27 @@ TEST_CASE("UndoManager - Default Actions", "[undo_manager]") {
         manager.undo();
         REQUIRE(value == 0);
     }
-}
\ No newline at end of file
+}
+
+TEST_CASE("UndoManager - Memory usage counts group backups",
+          "[undo_manager]") {
+    UndoManager manager;
+    int counter = 0;
+    manager.push(std::make_unique<TestAction>("a", counter, 1));
+    const auto small = manager.memory_usage();
+    REQUIRE(small.used_bytes ==
+            (long long)sizeof(UndoManager::Entry)); // No backups
+
+    mailbox::command::SeedSpec backup;
+    backup.sizes.assign(64, 100);
+    backup.rules.assign(64 * 64, 0.5f);
+    manager.push(std::make_unique<ClearAllGroupsAction>(backup));
+    const auto with_backup = manager.memory_usage();
+    REQUIRE(with_backup.used_bytes >=
+            small.used_bytes + 64 * 4 + 64 * 64 * 4);
+
+    // Undone actions move to the redo stack and stay counted
+    manager.undo();
+    REQUIRE(manager.memory_usage().used_bytes == with_backup.used_bytes);
+}
+
@@ -78,3 +78,101 @@ TEST_CASE("UniformGrid clamps out-of-bounds and non-finite", "[uniformgrid]") {
     REQUIRE(cx == grid.cols() - 1);
     REQUIRE(cy == grid.rows() - 1);
 }
+
+TEST_CASE("UniformGrid records cell group masks and leaves out negative groups",
+          "[uniformgrid]") {
+    UniformGrid grid;
+    const int N = 5;
+    grid.resize(10.f, 10.f, 5.f, N);
+
+    float xs[N] = {1.f, 2.f, 6.f, 7.f, 8.f};
+    float ys[N] = {1.f, 2.f, 1.f, 7.f, 8.f};
+    int groups[N] = {0, 70, 2, -1, 1};
+
+    grid.build(
+        N,
+        [&](int i) {
+            return xs[i];
+        },
+        [&](int i) {
+            return ys[i];
+        },
+        10.f, 10.f,
+        [&](int i) {
+            return groups[i];
+        });
+
+    // Groups past 63 share the top bit
+    REQUIRE(grid.cell_mask_at(grid.cell_index(0, 0)) ==
+            (group_mask_bit(0) | group_mask_bit(63)));
+    REQUIRE(grid.cell_mask_at(grid.cell_index(1, 0)) == group_mask_bit(2));
+    REQUIRE(grid.cell_mask_at(grid.cell_index(0, 1)) == 0);
+
+    // Item 3 is in no list
+    const int ci11 = grid.cell_index(1, 1);
+    REQUIRE(grid.cell_mask_at(ci11) == group_mask_bit(1));
+    REQUIRE(grid.cell_count_at(ci11) == 1);
+    REQUIRE(grid.indices()[grid.cell_start_at(ci11)] == 4);
+    REQUIRE(grid.head_at(ci11) == 4);
+    REQUIRE(grid.next_at(4) == -1);
+    REQUIRE(grid.indices()[N - 1] == -1);
+
+    // Without a group getter every item is group 0
+    grid.build(
+        N,
+        [&](int i) {
+            return xs[i];
+        },
+        [&](int i) {
+            return ys[i];
+        },
+        10.f, 10.f);
+    REQUIRE(grid.cell_count_at(ci11) == 2);
+    REQUIRE(grid.cell_mask_at(ci11) == group_mask_bit(0));
+}
+
+TEST_CASE("UniformGrid builds only the CSR view with linked lists off",
+          "[uniformgrid]") {
+    const int N = 6;
+    float xs[N] = {1.f, 6.f, 2.f, 9.f, 3.f, 7.f};
+    float ys[N] = {1.f, 1.f, 6.f, 9.f, 2.f, 8.f};
+    auto fill = [&](UniformGrid &grid) {
+        grid.resize(10.f, 10.f, 5.f, N);
+        grid.build(
+            N,
+            [&](int i) {
+                return xs[i];
+            },
+            [&](int i) {
+                return ys[i];
+            },
+            10.f, 10.f);
+    };
+
+    UniformGrid lists;
+    UniformGrid csr;
+    csr.set_linked_lists(false);
+    fill(lists);
+    fill(csr);
+
+    REQUIRE(lists.linked_lists());
+    REQUIRE_FALSE(csr.linked_lists());
+    REQUIRE(csr.head().empty());
+    REQUIRE(csr.next().empty());
+    REQUIRE(csr.list_memory().reserved_bytes == 0);
+    REQUIRE(csr.cell_start() == lists.cell_start());
+    REQUIRE(csr.cell_count() == lists.cell_count());
+    REQUIRE(csr.indices() == lists.indices());
+
+    // Cell (0,0) holds items 0 and 4 in ascending order
+    const int ci00 = csr.cell_index(0, 0);
+    REQUIRE(csr.cell_count_at(ci00) == 2);
+    REQUIRE(csr.indices()[csr.cell_start_at(ci00)] == 0);
+    REQUIRE(csr.indices()[csr.cell_start_at(ci00) + 1] == 4);
+
+    // Turning the lists back on restores them from the next build
+    csr.set_linked_lists(true);
+    fill(csr);
+    REQUIRE(csr.head() == lists.head());
+    REQUIRE(csr.next() == lists.next());
+}
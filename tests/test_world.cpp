@@ -106,3 +106,70 @@ TEST_CASE("World rule table edge cases", "[world]") {
     w.set_r2(0, 25.0f);
     REQUIRE(w.r2_of(0) == Catch::Approx(25.0f));
 }
+
+TEST_CASE("World fills group mapping by range", "[world]") {
+    World world;
+    world.add_group(5, RED);
+    world.add_group(3, GREEN);
+    world.add_group(4, BLUE);
+    world.prepare_particle_groups();
+
+    // Ranges can be filled independently and in any order
+    world.finalize_groups(6, 12);
+    world.finalize_groups(0, 6);
+
+    const std::vector<int> expected = {0, 0, 0, 0, 0, 1, 1, 1, 2, 2, 2, 2};
+    REQUIRE(world.get_particle_groups() == expected);
+}
+
+TEST_CASE("World set_group_sizes keeps rules and allows empty groups",
+          "[world]") {
+    World w;
+    w.add_group(3, RED);
+    w.add_group(2, GREEN);
+    w.add_group(4, BLUE);
+    w.init_rule_tables(3);
+    w.set_rule(2, 0, -0.25f);
+    w.set_r2(1, 16.f);
+    w.set_group_enabled(2, false);
+
+    w.set_group_sizes({1, 0, 2});
+    REQUIRE(w.get_groups_size() == 3);
+    REQUIRE(w.get_particles_size() == 3);
+    REQUIRE(w.get_group_size(1) == 0);
+    REQUIRE(w.group_of(0) == 0);
+    REQUIRE(w.group_of(1) == 2);
+    REQUIRE(w.group_of(2) == 2);
+    REQUIRE(w.rule_val(2, 0) == Catch::Approx(-0.25f));
+    REQUIRE(w.r2_of(1) == Catch::Approx(16.f));
+    REQUIRE_FALSE(w.is_group_enabled(2));
+    REQUIRE(w.get_group_color(1).g == GREEN.g);
+
+    REQUIRE_THROWS_AS(w.set_group_sizes({1, 2}), particles::SimulationError);
+    REQUIRE_THROWS_AS(w.set_group_sizes({1, -1, 2}),
+                      particles::SimulationError);
+}
+
+TEST_CASE("World memory usage reports capacity left by remove_group",
+          "[world]") {
+    World w;
+    w.add_group(200'000, RED);
+    w.add_group(1'000, BLUE);
+    w.init_rule_tables(2);
+    w.finalize_groups();
+
+    const auto full = w.memory_usage();
+    // Four float columns and one group index per particle
+    REQUIRE(full.used_bytes >= 201'000ll * 5 * 4);
+    REQUIRE(full.reserved_bytes >= full.used_bytes);
+    REQUIRE_FALSE(full.wasteful());
+
+    w.remove_group(0);
+    const auto removed = w.memory_usage();
+    REQUIRE(removed.used_bytes < full.used_bytes / 100);
+    REQUIRE(removed.reserved_bytes >= 200'000ll * 4 * 4);
+    REQUIRE(removed.wasteful());
+
+    w.reset(true);
+    REQUIRE(w.memory_usage().reserved_bytes == 0);
+}
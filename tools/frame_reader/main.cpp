@@ -0,0 +1,166 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "distributed/frame_ring.hpp"
+#include "utility/exceptions.hpp"
+#include "utility/logger.hpp"
+
+/**
+ * @brief Command line options for the example frame reader
+ */
+struct ReaderOptions {
+    std::string name = "/particles";
+    int frames = 0; // Frames to print before exiting (0 = until closed)
+    int poll_ms = 10;
+};
+
+void print_usage() {
+    std::cout
+        << "Usage: particles_frame_reader [options]\n"
+           "  --name <name>            Shared-memory ring name (default "
+           "/particles)\n"
+           "  --frames <n>             Frames to print (0 = until the writer "
+           "exits)\n"
+           "  --poll-ms <ms>           Poll interval (default 10)\n";
+}
+
+ReaderOptions parse_options(int argc, char **argv) {
+    ReaderOptions opts;
+    auto next_value = [&](int &i) -> std::string {
+        if (i + 1 >= argc) {
+            throw particles::ConfigError(std::string("Missing value for ") +
+                                         argv[i]);
+        }
+        return argv[++i];
+    };
+    auto next_int = [&](int &i) -> int {
+        const std::string value = next_value(i);
+        try {
+            return std::stoi(value);
+        } catch (const std::exception &) {
+            throw particles::ConfigError("Invalid number for " +
+                                         std::string(argv[i - 1]) + ": " +
+                                         value);
+        }
+    };
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--name") {
+            opts.name = next_value(i);
+        } else if (arg == "--frames") {
+            opts.frames = next_int(i);
+        } else if (arg == "--poll-ms") {
+            opts.poll_ms = next_int(i);
+        } else if (arg == "--help" || arg == "-h") {
+            print_usage();
+            std::exit(0);
+        } else {
+            throw particles::ConfigError("Unknown option: " + arg);
+        }
+    }
+
+    if (opts.frames < 0 || opts.poll_ms < 0) {
+        throw particles::ConfigError("Frame count and poll interval must be "
+                                     ">= 0");
+    }
+    return opts;
+}
+
+/**
+ * @brief Follows the writer to the ring that replaced the current one
+ * @return False if no usable ring appeared under the name in time
+ *
+ * The writer may replace the ring again before a reopen lands, leaving the
+ * name briefly missing, so failures are retried for about a second.
+ */
+bool follow_ring(distributed::FrameRingReader &reader) {
+    constexpr int ATTEMPTS = 100;
+    for (int attempt = 0; attempt < ATTEMPTS; ++attempt) {
+        try {
+            reader.reopen();
+            if (!reader.stale()) {
+                return true;
+            }
+        } catch (const particles::IOError &) {
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    return false;
+}
+
+/**
+ * @brief Prints the particle count and group centroids of each new frame
+ *
+ * Reads straight from the mapped ring, then checks the frame was not
+ * overwritten meanwhile; a torn frame is skipped, never waited for.
+ */
+void run(const ReaderOptions &opts) {
+    distributed::FrameRingReader reader(opts.name);
+    std::vector<double> cx, cy;
+    uint64_t last = 0;
+    int printed = 0;
+
+    while (opts.frames == 0 || printed < opts.frames) {
+        if (reader.closed() || (reader.stale() && !follow_ring(reader))) {
+            std::cout << "Ring " << opts.name << " closed" << std::endl;
+            return;
+        }
+
+        distributed::FrameView frame;
+        if (!reader.latest(frame) || frame.number == last) {
+            std::this_thread::sleep_for(
+                std::chrono::milliseconds(opts.poll_ms));
+            continue;
+        }
+
+        cx.assign(frame.groups, 0.0);
+        cy.assign(frame.groups, 0.0);
+        for (uint32_t g = 0; g < frame.groups; ++g) {
+            const distributed::FrameGroup &group = frame.group[g];
+            const uint32_t end = std::min(group.end, frame.particles);
+            for (uint32_t i = group.begin; i < end; ++i) {
+                cx[g] += frame.xy[i * 2 + 0];
+                cy[g] += frame.xy[i * 2 + 1];
+            }
+            if (end > group.begin) {
+                cx[g] /= double(end - group.begin);
+                cy[g] /= double(end - group.begin);
+            }
+        }
+        if (!reader.still_valid(frame)) {
+            continue;
+        }
+
+        last = frame.number;
+        ++printed;
+        std::printf("frame %llu: %u particles, %u groups",
+                    (unsigned long long)frame.number, frame.particles,
+                    frame.groups);
+        for (uint32_t g = 0; g < frame.groups; ++g) {
+            std::printf(" [%u: %.1f, %.1f]", g, cx[g], cy[g]);
+        }
+        std::printf("\n");
+        std::fflush(stdout);
+    }
+}
+
+int main(int argc, char **argv) {
+    try {
+        run(parse_options(argc, argv));
+        return 0;
+    } catch (const particles::ParticlesException &e) {
+        LOG_ERROR("Particles error: " + std::string(e.what()));
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    } catch (const std::exception &e) {
+        LOG_ERROR("Standard error: " + std::string(e.what()));
+        std::cerr << "Unexpected error: " << e.what() << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,465 @@
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+
+#ifndef PLATFORM_WINDOWS
+#include "distributed/frame_export.hpp"
+#include "distributed/slab_coordinator.hpp"
+#include "metrics/metrics_server.hpp"
+#include "metrics/prometheus.hpp"
+#endif
+#include "mailbox/mailbox.hpp"
+#include "render/software_renderer.hpp"
+#include "render/types/config.hpp"
+#include "save_manager.hpp"
+#include "simulation/multicore.hpp"
+#include "simulation/simulation.hpp"
+#include "utility/default_seed.hpp"
+#include "utility/exceptions.hpp"
+#include "utility/logger.hpp"
+
+/**
+ * @brief Command line options for the headless frame exporter
+ */
+struct HeadlessOptions {
+    std::string project;
+    std::string out_dir = "frames";
+    std::string format = "png";
+    std::string analytics; // CSV of per-frame world analytics (empty = off)
+    std::string shm;       // Shared-memory frame ring name (empty = off)
+    std::string metrics;   // Metrics endpoint address (empty = off)
+    int width = 1920;
+    int height = 1080;
+    int frames = 60;
+    int steps_per_frame = 1;
+    int render_threads = -1;
+    int slabs = 0;
+    int cluster_interval = -1; // Overrides the project's setting when >= 0
+    bool exact_glow = false;
+};
+
+void print_usage() {
+    std::cout
+        << "Usage: particles_headless [options]\n"
+           "  --project <file>         Load sim/render config and seed\n"
+           "  --width <px>             Frame width (default 1920)\n"
+           "  --height <px>            Frame height (default 1080)\n"
+           "  --frames <n>             Number of frames to export (default "
+           "60)\n"
+           "  --steps-per-frame <n>    Simulation steps between frames "
+           "(default 1)\n"
+           "  --out <dir>              Output directory (default frames)\n"
+           "  --format <png|ppm>       Output image format (default png)\n"
+           "  --render-threads <n>     Render worker threads (-1 = auto)\n"
+           "  --slabs <n>              Simulate in n slab processes (0 = "
+           "off)\n"
+           "  --exact-glow             Always splat glow per particle\n"
+           "  --analytics <file>       Write per-frame world analytics as "
+           "CSV\n"
+           "  --clusters <n>           Find clusters every n steps (0 = off, "
+           "default from project)\n"
+           "  --shm <name>             Export frames to a shared-memory "
+           "ring\n"
+           "  --metrics <address>      Serve Prometheus metrics on a "
+           "127.0.0.1 port or unix:<path>\n";
+}
+
+HeadlessOptions parse_options(int argc, char **argv) {
+    HeadlessOptions opts;
+    auto next_value = [&](int &i) -> std::string {
+        if (i + 1 >= argc) {
+            throw particles::ConfigError(std::string("Missing value for ") +
+                                         argv[i]);
+        }
+        return argv[++i];
+    };
+    auto next_int = [&](int &i) -> int {
+        const std::string value = next_value(i);
+        try {
+            return std::stoi(value);
+        } catch (const std::exception &) {
+            throw particles::ConfigError("Invalid number for " +
+                                         std::string(argv[i - 1]) + ": " +
+                                         value);
+        }
+    };
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--project") {
+            opts.project = next_value(i);
+        } else if (arg == "--width") {
+            opts.width = next_int(i);
+        } else if (arg == "--height") {
+            opts.height = next_int(i);
+        } else if (arg == "--frames") {
+            opts.frames = next_int(i);
+        } else if (arg == "--steps-per-frame") {
+            opts.steps_per_frame = next_int(i);
+        } else if (arg == "--out") {
+            opts.out_dir = next_value(i);
+        } else if (arg == "--format") {
+            opts.format = next_value(i);
+        } else if (arg == "--render-threads") {
+            opts.render_threads = next_int(i);
+        } else if (arg == "--slabs") {
+            opts.slabs = next_int(i);
+        } else if (arg == "--exact-glow") {
+            opts.exact_glow = true;
+        } else if (arg == "--analytics") {
+            opts.analytics = next_value(i);
+        } else if (arg == "--clusters") {
+            opts.cluster_interval = next_int(i);
+        } else if (arg == "--shm") {
+            opts.shm = next_value(i);
+        } else if (arg == "--metrics") {
+            opts.metrics = next_value(i);
+        } else if (arg == "--help" || arg == "-h") {
+            print_usage();
+            std::exit(0);
+        } else {
+            throw particles::ConfigError("Unknown option: " + arg);
+        }
+    }
+
+    if (opts.width <= 0 || opts.height <= 0) {
+        throw particles::ConfigError("Frame size must be positive");
+    }
+    if (opts.slabs < 0) {
+        throw particles::ConfigError("Slab count must be >= 0");
+    }
+#ifdef PLATFORM_WINDOWS
+    if (opts.slabs > 0) {
+        throw particles::ConfigError("--slabs needs a POSIX platform");
+    }
+    if (!opts.shm.empty()) {
+        throw particles::ConfigError("--shm needs a POSIX platform");
+    }
+    if (!opts.metrics.empty()) {
+        throw particles::ConfigError("--metrics needs a POSIX platform");
+    }
+#endif
+    if (opts.slabs > 0 && !opts.analytics.empty()) {
+        throw particles::ConfigError(
+            "--analytics is not available with --slabs");
+    }
+    if (opts.slabs > 0 && !opts.shm.empty()) {
+        throw particles::ConfigError("--shm is not available with --slabs");
+    }
+    if (opts.slabs > 0 && !opts.metrics.empty()) {
+        throw particles::ConfigError(
+            "--metrics is not available with --slabs");
+    }
+    if (opts.frames < 0 || opts.steps_per_frame < 0) {
+        throw particles::ConfigError("Frame and step counts must be >= 0");
+    }
+    if (opts.format != "png" && opts.format != "ppm") {
+        throw particles::ConfigError("Unsupported format: " + opts.format);
+    }
+
+    return opts;
+}
+
+/**
+ * @brief Advances the paused simulation by one step and waits for it
+ * @param sim Simulation (must be paused)
+ */
+void step_and_wait(Simulation &sim) {
+    const long long target = sim.get_stats().num_steps + 1;
+    sim.push_command(mailbox::command::OneStep{});
+    while (sim.get_stats().num_steps < target) {
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+    }
+}
+
+/**
+ * @brief Prints the step time percentiles of a run
+ * @param stats Stats published after the last step
+ */
+void print_step_latency(const mailbox::SimulationStatsSnapshot &stats) {
+    const auto &latency = stats.step_latency;
+    if (latency.samples == 0) {
+        return;
+    }
+    std::cout << "Step time over " << latency.samples << " steps: p50 "
+              << latency.p50_ns / 1e6 << " ms, p95 " << latency.p95_ns / 1e6
+              << " ms, p99 " << latency.p99_ns / 1e6 << " ms, max "
+              << latency.max_ns / 1e6 << " ms" << std::endl;
+    if (stats.oversleep.samples > 0 || stats.missed_deadlines > 0) {
+        std::cout << "TPS deadlines missed: " << stats.missed_deadlines
+                  << ", oversleep p99 " << stats.oversleep.p99_ns / 1e6
+                  << " ms" << std::endl;
+    }
+}
+
+/**
+ * @brief Writes the renderer's current frame to the output directory
+ * @param renderer Renderer holding the frame
+ * @param opts Output options
+ * @param frame Frame number used in the file name
+ */
+void write_frame(const SoftwareRenderer &renderer, const HeadlessOptions &opts,
+                 int frame) {
+    char name[64];
+    std::snprintf(name, sizeof(name), "frame_%06d.%s", frame,
+                  opts.format.c_str());
+    const std::string path =
+        (std::filesystem::path(opts.out_dir) / name).string();
+    if (opts.format == "png") {
+        renderer.write_png(path);
+    } else {
+        renderer.write_ppm(path);
+    }
+}
+
+/**
+ * @brief Writes the column names of the analytics CSV
+ * @param out Output stream
+ * @param groups Number of groups (one centroid column pair each)
+ */
+void write_analytics_header(std::ostream &out, int groups) {
+    out << "frame,step,particles,kinetic_energy,momentum_x,momentum_y,"
+           "max_speed,occupied_cells,max_cell_count,mean_cell_count,"
+           "cell_count_stddev,scanned_cells,pruned_cells,pruned_candidates,"
+           "examined_pairs,accepted_pairs,clusters,largest_cluster";
+    for (int g = 0; g < groups; ++g) {
+        out << ",centroid_x_" << g << ",centroid_y_" << g;
+    }
+    out << "\n";
+}
+
+/**
+ * @brief Writes one frame's analytics as a CSV row
+ * @param out Output stream
+ * @param frame Frame number
+ * @param a Analytics of the step the frame shows
+ * @param clusters Latest cluster detection pass
+ */
+void write_analytics_row(std::ostream &out, int frame,
+                         const mailbox::AnalyticsSnapshot &a,
+                         const mailbox::ClusterSnapshot &clusters) {
+    out << frame << "," << a.num_steps << "," << a.particles << ","
+        << a.kinetic_energy << "," << a.momentum_x << "," << a.momentum_y
+        << "," << a.max_speed << "," << a.occupied_cells << ","
+        << a.max_cell_count << "," << a.mean_cell_count << ","
+        << a.cell_count_stddev << "," << a.scanned_cells << ","
+        << a.pruned_cells << "," << a.pruned_candidates << ","
+        << a.examined_pairs << "," << a.accepted_pairs << ","
+        << clusters.sizes.size() << "," << clusters.largest;
+    for (size_t g = 0; g < a.centroid_x.size(); ++g) {
+        out << "," << a.centroid_x[g] << "," << a.centroid_y[g];
+    }
+    out << "\n";
+}
+
+#ifndef PLATFORM_WINDOWS
+/**
+ * @brief Renders frames while the world is stepped by slab processes
+ *
+ * The in-process simulation only applies the seed; its state is then handed
+ * to the slab workers and shut down before they are forked.
+ */
+void run_slabs(const HeadlessOptions &opts,
+               const mailbox::SimulationConfigSnapshot &scfg,
+               const Config &rcfg, const mailbox::command::SeedSpec &seed) {
+    mailbox::WorldSnapshot world;
+    std::vector<float> pos, vel;
+    {
+        // The slabs continue from the published positions and velocities
+        mailbox::SimulationConfigSnapshot seed_cfg = scfg;
+        seed_cfg.draw_report.velocities = true;
+        Simulation sim(seed_cfg);
+        sim.begin();
+        sim.pause();
+        sim.push_command(mailbox::command::SeedWorld{seed});
+        step_and_wait(sim);
+        world = sim.get_world_snapshot();
+        auto view = sim.begin_read_draw();
+        pos = *view.curr;
+        vel = *view.curr_vel;
+        sim.end_read_draw(view);
+        sim.end();
+    }
+
+    const int threads_per_slab =
+        std::max(1, compute_sim_threads() / opts.slabs);
+    distributed::SlabCoordinator coordinator(world, pos, vel, scfg,
+                                             opts.slabs, threads_per_slab);
+
+    SimulationThreadPool render_pool(opts.render_threads);
+    SoftwareRenderer renderer(opts.width, opts.height);
+    if (opts.exact_glow) {
+        renderer.set_glow_overdraw_limit(0.f);
+    }
+
+    std::cout << "Rendering " << opts.frames << " frames with "
+              << opts.slabs << " slab processes x " << threads_per_slab
+              << " threads" << std::endl;
+
+    for (int frame = 0; frame < opts.frames; ++frame) {
+        coordinator.step(opts.steps_per_frame);
+        coordinator.gather(pos, vel);
+
+        mailbox::render::ReadView view;
+        view.prev = &pos;
+        view.curr = &pos;
+        view.curr_vel = &vel;
+        renderer.render(view, world, rcfg, scfg.bounds_width,
+                        scfg.bounds_height, 1.0f, render_pool);
+        write_frame(renderer, opts, frame);
+    }
+}
+#endif
+
+void run(const HeadlessOptions &opts) {
+    Config rcfg;
+    rcfg.core_size = 1.5f;
+    rcfg.glow_enabled = true;
+    rcfg.outer_scale_mul = 24.f;
+    rcfg.outer_rgb_gain = .78f;
+    rcfg.inner_scale_mul = 1.f;
+    rcfg.inner_rgb_gain = .52f;
+
+    mailbox::SimulationConfigSnapshot scfg = {};
+    scfg.bounds_width = (float)opts.width;
+    scfg.bounds_height = (float)opts.height;
+    scfg.target_tps = 0;
+    scfg.time_scale = 1.0f;
+    scfg.viscosity = 0.271f;
+    scfg.wall_repel = 86.0f;
+    scfg.wall_strength = 0.129f;
+    scfg.sim_threads = -1;
+
+    std::optional<mailbox::command::SeedSpec> seed;
+    if (!opts.project.empty()) {
+        SaveManager save_manager;
+        SaveManager::ProjectData data;
+        save_manager.load_project(opts.project, data);
+        scfg = data.sim_config;
+        rcfg = data.render_config;
+        seed = data.seed;
+    }
+    if (!seed.has_value()) {
+        seed = particles::utility::create_default_seed();
+    }
+    if (opts.cluster_interval >= 0) {
+        scfg.cluster_interval = opts.cluster_interval;
+    }
+    // Exported frames are drawn from full-precision positions
+    scfg.draw_report.packed_positions = false;
+
+    std::filesystem::create_directories(opts.out_dir);
+
+#ifndef PLATFORM_WINDOWS
+    if (opts.slabs > 0) {
+        run_slabs(opts, scfg, rcfg, seed.value());
+        return;
+    }
+#endif
+
+    Simulation sim(scfg);
+#ifndef PLATFORM_WINDOWS
+    if (!opts.shm.empty()) {
+        sim.set_frame_sink(
+            std::make_shared<distributed::FrameExport>(opts.shm));
+        LOG_INFO("Exporting frames to shared memory " + opts.shm);
+    }
+    // Reads only the published snapshots, on the server's own thread
+    std::unique_ptr<metrics::MetricsServer> metrics_server;
+    if (!opts.metrics.empty()) {
+        metrics_server = std::make_unique<metrics::MetricsServer>(
+            opts.metrics, [&sim](long long scrapes) {
+                const long long now =
+                    std::chrono::duration_cast<std::chrono::nanoseconds>(
+                        std::chrono::steady_clock::now().time_since_epoch())
+                        .count();
+                return metrics::prometheus_text(
+                    sim.get_stats(), sim.get_memory(), now, scrapes);
+            });
+        LOG_INFO("Serving metrics on " +
+                 (metrics_server->port() > 0
+                      ? "127.0.0.1:" + std::to_string(metrics_server->port())
+                      : opts.metrics));
+    }
+#endif
+    sim.begin();
+    sim.pause();
+    sim.push_command(mailbox::command::SeedWorld{seed.value()});
+    // The first step also guarantees the seed has been applied
+    step_and_wait(sim);
+
+    SimulationThreadPool render_pool(opts.render_threads);
+    SoftwareRenderer renderer(opts.width, opts.height);
+    if (opts.exact_glow) {
+        renderer.set_glow_overdraw_limit(0.f);
+    }
+
+    std::cout << "Rendering " << opts.frames << " frames at " << opts.width
+              << "x" << opts.height << " with " << render_pool.size()
+              << " render threads" << std::endl;
+
+    std::ofstream analytics_file;
+    if (!opts.analytics.empty()) {
+        analytics_file.open(opts.analytics);
+        if (!analytics_file) {
+            throw particles::IOError("Cannot write analytics to " +
+                                     opts.analytics);
+        }
+        write_analytics_header(analytics_file, seed->group_count());
+    }
+
+    double total_render_ms = 0.0;
+    for (int frame = 0; frame < opts.frames; ++frame) {
+        for (int s = 0; s < opts.steps_per_frame; ++s) {
+            step_and_wait(sim);
+        }
+
+        const auto world = sim.get_world_snapshot();
+        const auto current_cfg = sim.get_config();
+        const auto render_begin = std::chrono::steady_clock::now();
+        auto view = sim.begin_read_draw();
+        renderer.render(view, world, rcfg, current_cfg.bounds_width,
+                        current_cfg.bounds_height, 1.0f, render_pool);
+        sim.end_read_draw(view);
+        const auto render_end = std::chrono::steady_clock::now();
+        total_render_ms += std::chrono::duration<double, std::milli>(
+                               render_end - render_begin)
+                               .count();
+
+        write_frame(renderer, opts, frame);
+        if (analytics_file.is_open()) {
+            write_analytics_row(analytics_file, frame, sim.get_analytics(),
+                                sim.get_clusters());
+        }
+    }
+
+    const auto stats = sim.get_stats();
+    sim.end();
+
+    print_step_latency(stats);
+    if (opts.frames > 0) {
+        std::cout << "Average render time: "
+                  << total_render_ms / (double)opts.frames << " ms"
+                  << std::endl;
+    }
+}
+
+int main(int argc, char **argv) {
+    try {
+        run(parse_options(argc, argv));
+        return 0;
+    } catch (const particles::ParticlesException &e) {
+        LOG_ERROR("Particles error: " + std::string(e.what()));
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    } catch (const std::exception &e) {
+        LOG_ERROR("Standard error: " + std::string(e.what()));
+        std::cerr << "Unexpected error: " << e.what() << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,208 @@
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <iostream>
+#include <string>
+
+#include "render/types/config.hpp"
+#include "save_manager.hpp"
+#include "search/rule_search.hpp"
+#include "utility/default_seed.hpp"
+#include "utility/exceptions.hpp"
+#include "utility/logger.hpp"
+
+/**
+ * @brief Command line options for the rule search tool
+ */
+struct SearchToolOptions {
+    std::string project;
+    std::string out_dir = "search";
+    int width = 800;
+    int height = 600;
+    int particles = 600;
+    int generations = 20;
+    int keep = 5;
+    RuleSearchOptions search;
+};
+
+void print_usage() {
+    std::cout
+        << "Usage: particles_rule_search [options]\n"
+           "  --project <file>         Take groups and sim config from a "
+           "project\n"
+           "  --particles <n>          Particles per group (default 600, 0 = "
+           "keep project sizes)\n"
+           "  --width <px>             World width without --project "
+           "(default 800)\n"
+           "  --height <px>            World height without --project "
+           "(default 600)\n"
+           "  --population <n>         Candidates per generation (default "
+           "48)\n"
+           "  --generations <n>        Generations to evolve (default 20)\n"
+           "  --steps <n>              Steps per evaluation (default 300)\n"
+           "  --elite <n>              Best candidates kept unchanged "
+           "(default 4)\n"
+           "  --threads <n>            Evaluation threads (-1 = auto)\n"
+           "  --seed <n>               Search and placement seed (default 1)\n"
+           "  --keep <n>               Best candidates saved (default 5)\n"
+           "  --out <dir>              Output directory (default search)\n";
+}
+
+SearchToolOptions parse_options(int argc, char **argv) {
+    SearchToolOptions opts;
+    auto next_value = [&](int &i) -> std::string {
+        if (i + 1 >= argc) {
+            throw particles::ConfigError(std::string("Missing value for ") +
+                                         argv[i]);
+        }
+        return argv[++i];
+    };
+    auto next_int = [&](int &i) -> long long {
+        const std::string value = next_value(i);
+        try {
+            return std::stoll(value);
+        } catch (const std::exception &) {
+            throw particles::ConfigError("Invalid number for " +
+                                         std::string(argv[i - 1]) + ": " +
+                                         value);
+        }
+    };
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--project") {
+            opts.project = next_value(i);
+        } else if (arg == "--particles") {
+            opts.particles = (int)next_int(i);
+        } else if (arg == "--width") {
+            opts.width = (int)next_int(i);
+        } else if (arg == "--height") {
+            opts.height = (int)next_int(i);
+        } else if (arg == "--population") {
+            opts.search.population = (int)next_int(i);
+        } else if (arg == "--generations") {
+            opts.generations = (int)next_int(i);
+        } else if (arg == "--steps") {
+            opts.search.steps = (int)next_int(i);
+        } else if (arg == "--elite") {
+            opts.search.elite = (int)next_int(i);
+        } else if (arg == "--threads") {
+            opts.search.threads = (int)next_int(i);
+        } else if (arg == "--seed") {
+            opts.search.seed = (uint64_t)next_int(i);
+        } else if (arg == "--keep") {
+            opts.keep = (int)next_int(i);
+        } else if (arg == "--out") {
+            opts.out_dir = next_value(i);
+        } else if (arg == "--help" || arg == "-h") {
+            print_usage();
+            std::exit(0);
+        } else {
+            throw particles::ConfigError("Unknown option: " + arg);
+        }
+    }
+
+    if (opts.width <= 0 || opts.height <= 0) {
+        throw particles::ConfigError("World size must be positive");
+    }
+    if (opts.particles < 0 || opts.generations < 0 || opts.keep < 0) {
+        throw particles::ConfigError(
+            "Particle, generation and keep counts must be >= 0");
+    }
+
+    return opts;
+}
+
+void run(const SearchToolOptions &opts) {
+    SaveManager save_manager;
+    SaveManager::ProjectData project;
+    save_manager.new_project(project);
+    if (!opts.project.empty()) {
+        save_manager.load_project(opts.project, project);
+    }
+    if (!project.seed.has_value()) {
+        project.seed = particles::utility::create_default_seed();
+    }
+
+    mailbox::command::SeedSpec base = project.seed.value();
+    if (opts.particles > 0) {
+        for (int &size : base.sizes) {
+            size = opts.particles;
+        }
+    }
+    mailbox::SimulationConfigSnapshot cfg = project.sim_config;
+    if (opts.project.empty()) {
+        cfg.bounds_width = (float)opts.width;
+        cfg.bounds_height = (float)opts.height;
+    }
+
+    RuleSearch search(opts.search, base, cfg);
+    std::cout << "Searching " << base.group_count() << "-group rules: "
+              << opts.search.population << " candidates x "
+              << opts.generations << " generations, " << opts.search.steps
+              << " steps each" << std::endl;
+
+    const auto begin = std::chrono::steady_clock::now();
+    for (int g = 0; g <= opts.generations; ++g) {
+        if (g > 0) {
+            search.evolve();
+        }
+        search.evaluate();
+
+        const auto &population = search.population();
+        float mean = 0.f;
+        for (const Candidate &c : population) {
+            mean += c.score;
+        }
+        mean /= (float)population.size();
+
+        const double hours = std::chrono::duration<double>(
+                                 std::chrono::steady_clock::now() - begin)
+                                 .count() /
+                             3600.0;
+        const double rate =
+            hours > 0.0 ? (double)search.evaluations() / hours : 0.0;
+        const FitnessMetrics &m = population.front().metrics;
+        char line[200];
+        std::snprintf(line, sizeof(line),
+                      "gen %3d  best %.4f (cluster %.3f persist %.3f "
+                      "energy %.4f)  mean %.4f  %.0f evals/h",
+                      search.generation(), population.front().score,
+                      m.clustering, m.persistence, m.kinetic_energy, mean,
+                      rate);
+        std::cout << line << std::endl;
+    }
+
+    std::filesystem::create_directories(opts.out_dir);
+    const auto &population = search.population();
+    const int keep = std::min(opts.keep, (int)population.size());
+    // Best last, so it also becomes the project the app opens next
+    for (int rank = keep - 1; rank >= 0; --rank) {
+        SaveManager::ProjectData data = project;
+        data.sim_config = cfg;
+        data.seed = search.seed_of(population[rank]);
+
+        char name[64];
+        std::snprintf(name, sizeof(name), "rules_%02d.json", rank);
+        const std::string path =
+            (std::filesystem::path(opts.out_dir) / name).string();
+        save_manager.save_project(path, data);
+        std::cout << "Saved " << path << " (score "
+                  << population[rank].score << ")" << std::endl;
+    }
+}
+
+int main(int argc, char **argv) {
+    try {
+        run(parse_options(argc, argv));
+        return 0;
+    } catch (const particles::ParticlesException &e) {
+        LOG_ERROR("Particles error: " + std::string(e.what()));
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    } catch (const std::exception &e) {
+        LOG_ERROR("Standard error: " + std::string(e.what()));
+        std::cerr << "Unexpected error: " << e.what() << std::endl;
+        return 1;
+    }
+}